@@ -0,0 +1,152 @@
+#ifndef BLUE_NOISE_H
+#define BLUE_NOISE_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// ==================== RUÍDO AZUL (DITHER) ====================
+// Bloco 64x64 repetido lado a lado, usado como dither na volta para 8 bits
+// (CpuFilter, fragment e compute shader). Sem dither, uma LUT de 8 bits
+// interpolada vira degraus de 1 LSB em gradientes suaves; somar ruído de
+// até ±0.5 LSB antes de arredondar troca os degraus por um grão fino, que o
+// olho média. Ruído azul (só alta frequência, sem aglomerados) é o que
+// menos aparece como textura.
+//
+// Gerado uma vez por processo pelo void-and-cluster (Ulichney): cada pixel
+// recebe um posto 0..4095 na ordem em que entra no padrão, sempre no maior
+// vazio dos já escolhidos. Energia gaussiana (sigma 1.5) em um toro, então
+// o bloco emenda sem costura. Determinístico (LCG com semente fixa): CPU e
+// GPU usam o mesmo bloco, e o paritycheck sempre vê o mesmo ruído.
+//
+// Formas prontas para os kernels:
+//   threshold(x, y)  limiar Q7 (0..127) somado no lugar do +64 do
+//                    arredondamento do ponto fixo
+//   thresholdRow(y)  os 64 limiares da linha em BGRA (limiar em B, G e R,
+//                    0 no alfa), com 8 de folga repetindo o começo: uma
+//                    carga de 8 pixels a partir de qualquer x & 63 não sai
+//                    da linha
+//   offset(x, y)     deslocamento em LSB (0..1) para arredondar com floor
+//   textureBytes()   R8 64x64 (posto >> 4) para a textura da GPU
+class BlueNoise {
+public:
+    static const int size = 64;
+    static const int rowStride = size + 8;
+
+private:
+    std::vector<uint16_t> ranks;       // 0..4095
+    std::vector<uint32_t> thresholds;  // size linhas de rowStride
+    std::vector<uint8_t> bytes;
+
+public:
+    static const BlueNoise& tile() {
+        static const BlueNoise noise;
+        return noise;
+    }
+
+    int rank(int x, int y) const { return ranks[(size_t)(y & (size - 1)) * size + (x & (size - 1))]; }
+
+    int threshold(int x, int y) const { return rank(x, y) >> 5; }
+
+    float offset(int x, int y) const { return (threshold(x, y) + 0.5f) * (1.0f / 128.0f); }
+
+    const uint32_t* thresholdRow(int y) const { return &thresholds[(size_t)(y & (size - 1)) * rowStride]; }
+
+    const uint8_t* textureBytes() const { return bytes.data(); }
+
+private:
+    BlueNoise() {
+        generate();
+        thresholds.resize((size_t)size * rowStride);
+        bytes.resize((size_t)size * size);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < rowStride; x++) {
+                uint32_t t = (uint32_t)threshold(x, y);
+                thresholds[(size_t)y * rowStride + x] = t | (t << 8) | (t << 16);
+            }
+            for (int x = 0; x < size; x++) bytes[(size_t)y * size + x] = (uint8_t)(rank(x, y) >> 4);
+        }
+    }
+
+    // Energia de um pixel = soma da gaussiana toroidal dos pixels escolhidos.
+    // Como a soma da gaussiana sobre o bloco todo é constante, o maior vazio
+    // entre os não escolhidos também é o aglomerado mais denso dos não
+    // escolhidos: a segunda metade dos postos sai do mesmo laço da primeira.
+    void generate() {
+        const int count = size * size;
+        const float sigma = 1.5f;
+        const int radius = 6;  // exp(-36 / 4.5) ~ 3e-4: o resto não muda a ordem
+        std::vector<float> kernel((2 * radius + 1) * (2 * radius + 1));
+        for (int dy = -radius; dy <= radius; dy++) {
+            for (int dx = -radius; dx <= radius; dx++) {
+                kernel[(dy + radius) * (2 * radius + 1) + dx + radius] =
+                    std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+            }
+        }
+
+        std::vector<float> energy(count, 0.0f);
+        std::vector<uint8_t> chosen(count, 0);
+        auto toggle = [&](int index, bool on) {
+            chosen[index] = on ? 1 : 0;
+            const int px = index % size, py = index / size;
+            const float sign = on ? 1.0f : -1.0f;
+            for (int dy = -radius; dy <= radius; dy++) {
+                const int row = ((py + dy) & (size - 1)) * size;
+                for (int dx = -radius; dx <= radius; dx++) {
+                    energy[row + ((px + dx) & (size - 1))] += sign * kernel[(dy + radius) * (2 * radius + 1) + dx + radius];
+                }
+            }
+        };
+        // Maior energia entre os escolhidos (aglomerado) ou menor entre os livres (vazio)
+        auto extreme = [&](bool cluster) {
+            int best = -1;
+            for (int i = 0; i < count; i++) {
+                if ((chosen[i] != 0) != cluster) continue;
+                if (best < 0 || (cluster ? energy[i] > energy[best] : energy[i] < energy[best])) best = i;
+            }
+            return best;
+        };
+
+        // Padrão inicial: 10% aleatório, espalhado até o aglomerado mais
+        // denso ser o próprio maior vazio
+        const int initial = count / 10;
+        uint32_t seed = 0x2545F491u;
+        for (int placed = 0; placed < initial;) {
+            seed = seed * 1664525u + 1013904223u;
+            int index = (int)(seed >> 20) % count;
+            if (chosen[index]) continue;
+            toggle(index, true);
+            placed++;
+        }
+        while (true) {
+            int cluster = extreme(true);
+            toggle(cluster, false);
+            int voidIndex = extreme(false);
+            if (voidIndex == cluster) {
+                toggle(cluster, true);
+                break;
+            }
+            toggle(voidIndex, true);
+        }
+        std::vector<uint8_t> start = chosen;
+        std::vector<float> startEnergy = energy;
+
+        // Postos do padrão inicial: tira o aglomerado mais denso, do último posto para o primeiro
+        ranks.assign(count, 0);
+        for (int rankValue = initial - 1; rankValue >= 0; rankValue--) {
+            int cluster = extreme(true);
+            toggle(cluster, false);
+            ranks[cluster] = (uint16_t)rankValue;
+        }
+        // Os outros: sempre no maior vazio
+        chosen = start;
+        energy = startEnergy;
+        for (int rankValue = initial; rankValue < count; rankValue++) {
+            int voidIndex = extreme(false);
+            toggle(voidIndex, true);
+            ranks[voidIndex] = (uint16_t)rankValue;
+        }
+    }
+};
+
+#endif // BLUE_NOISE_H
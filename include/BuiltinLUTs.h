@@ -0,0 +1,29 @@
+#ifndef BUILTIN_LUTS_H
+#define BUILTIN_LUTS_H
+
+#include <cstring>
+
+// ==================== LUTs EMBUTIDAS NO EXECUTÁVEL ====================
+// As LUTs distribuídas em luts/ e as derivadas das correções matemáticas são
+// convertidas em arrays estáticos durante o build (tools/lutbake.cpp), então
+// a configuração padrão não precisa ler nem decodificar PNG ao iniciar.
+// Todas usam o formato de faixa horizontal de Lut3D (x = g*N + r, y = b).
+struct BuiltinLUT {
+    const char* name;
+    int width;
+    int height;
+    int channels;
+    const unsigned char* data;
+};
+
+// Gerado no diretório de build: define builtinLUTs[] e builtinLUTCount
+#include "BuiltinLUTData.inc"
+
+inline const BuiltinLUT* findBuiltinLUT(const char* name) {
+    for (int i = 0; i < builtinLUTCount; i++) {
+        if (std::strcmp(builtinLUTs[i].name, name) == 0) return &builtinLUTs[i];
+    }
+    return nullptr;
+}
+
+#endif // BUILTIN_LUTS_H
@@ -0,0 +1,139 @@
+#ifndef COLOR_CORRECTION_H
+#define COLOR_CORRECTION_H
+
+#include <algorithm>
+#include <cmath>
+#include "SRGB.h"
+
+// ==================== CORREÇÕES MATEMÁTICAS (CPU) ====================
+// Versões em C++ das funções dos shaders (shaders/fragment.glsl e o shader
+// embutido em main.cpp). Usadas para gerar LUTs e no caminho de CPU.
+//
+// ATENÇÃO: no GLSL, mat3(...) é preenchido por colunas. As matrizes abaixo
+// estão escritas por linhas, ou seja, transpostas em relação ao texto do
+// shader, para que o resultado seja idêntico.
+
+struct RGB {
+    float r, g, b;
+};
+
+enum class CorrectionMethod {
+    LMS,        // correctDeuteranopia (Machado/Oliveira/Fernandes)
+    Daltonize,  // daltonizeDeuteranopia
+    Hybrid,     // hybridCorrection (método padrão do filtro)
+    Machado     // simulação de Machado et al. (2009) + redistribuição do erro, em luz linear
+};
+
+class ColorCorrection {
+public:
+    static const char* methodName(CorrectionMethod method) {
+        switch (method) {
+            case CorrectionMethod::LMS: return "lms";
+            case CorrectionMethod::Daltonize: return "daltonize";
+            case CorrectionMethod::Hybrid: return "hybrid";
+            case CorrectionMethod::Machado: return "machado";
+        }
+        return "?";
+    }
+
+    static RGB apply(CorrectionMethod method, RGB c, bool linearLight = false) {
+        switch (method) {
+            case CorrectionMethod::LMS: return lms(c);
+            case CorrectionMethod::Daltonize: return daltonize(c);
+            case CorrectionMethod::Hybrid: return hybrid(c, linearLight);
+            case CorrectionMethod::Machado: return machado(c);
+        }
+        return c;
+    }
+
+    // Correção científica em espaço LMS
+    static RGB lms(RGB c) {
+        float l = 0.31399022f * c.r + 0.15537241f * c.g + 0.01775239f * c.b;
+        float m = 0.63951294f * c.r + 0.75789446f * c.g + 0.10944209f * c.b;
+        float s = 0.04649755f * c.r + 0.08670142f * c.g + 0.87256922f * c.b;
+
+        // Realçar diferenças vermelho-verde e mapear o que se perde para o azul
+        float redGreenDiff = l - m;
+        float cl = l + 0.7f * redGreenDiff;
+        float cm = m - 0.7f * redGreenDiff;
+        float cs = s + 0.3f * std::fabs(redGreenDiff);
+
+        RGB out;
+        out.r =  5.47221206f * cl - 1.1252419f  * cm + 0.02980165f * cs;
+        out.g = -4.6419601f  * cl + 2.29317094f * cm - 0.19318073f * cs;
+        out.b =  0.16963708f * cl - 0.1678952f  * cm + 1.16364789f * cs;
+        return clamp(out);
+    }
+
+    // Daltonize: soma ao azul o erro entre a cor e a simulação
+    static RGB daltonize(RGB c) {
+        RGB sim;
+        sim.r = 0.625f * c.r + 0.7f * c.g;
+        sim.g = 0.375f * c.r + 0.3f * c.g + 0.3f * c.b;
+        sim.b = 0.7f * c.b;
+
+        float errorR = c.r - sim.r;
+        float errorG = c.g - sim.g;
+
+        RGB out = c;
+        out.b += errorR * 0.7f + errorG * 0.7f;
+        return clamp(out);
+    }
+
+    // Correção híbrida (a mesma do shader de main.cpp), preservando luminância
+    static RGB hybrid(RGB c, bool linearLight = false) {
+        const float wr = linearLight ? 0.2126f : 0.299f;
+        const float wg = linearLight ? 0.7152f : 0.587f;
+        const float wb = linearLight ? 0.0722f : 0.114f;
+
+        float luminance = wr * c.r + wg * c.g + wb * c.b;
+        float redGreenRatio = c.r / std::max(c.g, 0.001f);
+
+        RGB corrected = c;
+        if (redGreenRatio > 1.2f) {
+            corrected.r = std::min(1.0f, c.r * 1.1f);
+            corrected.b = std::min(1.0f, c.b + (c.r - c.g) * 0.25f);
+        } else if (redGreenRatio < 0.8f) {
+            corrected.g = std::min(1.0f, c.g * 1.05f);
+            corrected.b = std::min(1.0f, c.b + (c.g - c.r) * 0.2f);
+        }
+
+        float newLuminance = wr * corrected.r + wg * corrected.g + wb * corrected.b;
+        if (newLuminance > 0.001f) {
+            float k = luminance / newLuminance;
+            corrected.r *= k;
+            corrected.g *= k;
+            corrected.b *= k;
+        }
+        return clamp(corrected);
+    }
+
+    // Deuteranopia pela matriz de Machado, Oliveira e Fernandes (2009) com
+    // severidade 1.0, em luz linear: o erro (cor - simulação) do vermelho vai
+    // para o verde e o azul, como no daltonize de Fidaner. Outras
+    // deficiências e severidades: CorrectionModels.h.
+    static RGB machado(RGB c) {
+        float r = SRGB::toLinear(c.r), g = SRGB::toLinear(c.g), b = SRGB::toLinear(c.b);
+        float simR =  0.367322f * r + 0.860646f * g - 0.227968f * b;
+        float simG =  0.280085f * r + 0.672501f * g + 0.047413f * b;
+        float simB = -0.011820f * r + 0.042940f * g + 0.968881f * b;
+        float errorR = r - simR;
+        RGB out;
+        out.r = r;
+        out.g = g + 0.7f * errorR + (g - simG);
+        out.b = b + 0.7f * errorR + (b - simB);
+        out = clamp(out);
+        return { SRGB::toSRGB(out.r), SRGB::toSRGB(out.g), SRGB::toSRGB(out.b) };
+    }
+
+    // mix(original, corrigido, intensidade) como no shader
+    static RGB mix(RGB a, RGB b, float t) {
+        return { a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t };
+    }
+
+private:
+    static float clamp01(float v) { return std::min(1.0f, std::max(0.0f, v)); }
+    static RGB clamp(RGB c) { return { clamp01(c.r), clamp01(c.g), clamp01(c.b) }; }
+};
+
+#endif // COLOR_CORRECTION_H
@@ -0,0 +1,315 @@
+#ifndef COMPUTE_FILTER_H
+#define COMPUTE_FILTER_H
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "OverlayShaders.h"
+#include "RegionOfInterest.h"
+#include "TestFrames.h"
+
+// ==================== FILTRO EM COMPUTE SHADER (GL 4.3) ====================
+// Caminho opcional da GPU: em vez de desenhar um quad de tela cheia com o
+// fragment shader, um dispatch lê a textura capturada como imagem e grava a
+// saída em outra imagem (ou na mesma: filtro no lugar). Só os blocos de
+// 16x16 marcados como alterados recebem um grupo; o resto do alvo fica como
+// estava.
+//
+// As imagens precisam de storage GL_RGBA8 (imagens sRGB não existem em
+// load/store: a luz linear é convertida no shader). A LUT é a mesma faixa
+// do fragment shader, ligada pelo chamador na unidade 1.
+//
+// Dois programas: LUT amostrada da textura (como o fragment) ou pontos da
+// LUT em shared, lidos uma vez por célula distinta do bloco. Qual é mais
+// rápido depende da GPU (no llvmpipe as barreiras custam mais do que as
+// leituras economizadas), então calibrate() mede os dois.
+
+// GL 4.3 fica fora do glad 3.3: entradas carregadas à mão
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#define GL_TEXTURE_UPDATE_BARRIER_BIT 0x00000100
+#define GL_FRAMEBUFFER_BARRIER_BIT 0x00000400
+#endif
+typedef void (APIENTRY *PFN_glDispatchCompute)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+typedef void (APIENTRY *PFN_glBindImageTexture)(GLuint unit, GLuint texture, GLint level, GLboolean layered,
+                                                GLint layer, GLenum access, GLenum format);
+typedef void (APIENTRY *PFN_glMemoryBarrier)(GLbitfield barriers);
+
+class ComputeFilter {
+public:
+    static const int tileSize = 16;  // = local_size do shader: um grupo por bloco
+
+    enum class LutFetch { Texture, Shared };
+    static const int lutFetchCount = 2;
+
+    static const char* lutFetchName(LutFetch fetch) {
+        return fetch == LutFetch::Shared ? "LUT em shared" : "LUT na textura";
+    }
+
+    struct Settings {
+        bool enableCorrection = true;
+        float strength = 1.0f;
+        bool useLUT = true;
+        bool linearLight = false;
+        bool dither = false;  // ruído azul na unidade 2 (BlueNoise::textureBytes())
+    };
+
+    // Contadores do último dispatch (lidos da GPU: só para diagnóstico)
+    struct Stats {
+        uint32_t filteredGroups = 0;
+        uint32_t lutCells = 0;  // células distintas buscadas (só LutFetch::Shared; 8 pontos cada)
+    };
+
+private:
+    PFN_glDispatchCompute dispatchCompute = nullptr;
+    PFN_glBindImageTexture bindImageTexture = nullptr;
+    PFN_glMemoryBarrier memoryBarrier = nullptr;
+    GLuint programs[lutFetchCount] = { 0, 0 };
+    LutFetch fetch = LutFetch::Texture;
+    GLuint tileBuffer = 0, statsBuffer = 0;
+
+    std::vector<RoiRect> pending;  // regiões alteradas desde o último dispatch
+    bool pendingAll = true;
+    std::vector<uint32_t> mask;    // 1 bit por bloco: regiões sobrepostas contam uma vez
+    std::vector<uint32_t> tiles;   // blocos marcados, x | y << 16
+    int lastDirtyTiles = 0, lastTotalTiles = 0;
+
+public:
+    ComputeFilter() {}
+    ~ComputeFilter() { destroy(); }
+
+    ComputeFilter(const ComputeFilter&) = delete;
+    ComputeFilter& operator=(const ComputeFilter&) = delete;
+
+    // Com o contexto ativo: versão 4.3+ e as três entradas presentes
+    static bool isSupported(GLADloadproc load) {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major < 4 || (major == 4 && minor < 3)) return false;
+        return load("glDispatchCompute") && load("glBindImageTexture") && load("glMemoryBarrier");
+    }
+
+    // false sem GL 4.3 ou se o shader não compilar ('log' recebe o motivo)
+    bool create(GLADloadproc load, std::string* log = nullptr) {
+        if (!isSupported(load)) {
+            if (log) *log = "GL 4.3 indisponível";
+            return false;
+        }
+        dispatchCompute = (PFN_glDispatchCompute)load("glDispatchCompute");
+        bindImageTexture = (PFN_glBindImageTexture)load("glBindImageTexture");
+        memoryBarrier = (PFN_glMemoryBarrier)load("glMemoryBarrier");
+
+        const char* headers[lutFetchCount] = { "#version 430 core\n", "#version 430 core\n#define SHARED_LUT_CACHE\n" };
+        for (int i = 0; i < lutFetchCount; i++) {
+            programs[i] = compile(headers[i], log);
+            if (!programs[i]) {
+                destroy();
+                return false;
+            }
+        }
+
+        // Buffers com pelo menos uma palavra: os SSBOs ficam sempre ligados
+        const uint32_t zeros[2] = { 0, 0 };
+        glGenBuffers(1, &tileBuffer);
+        glGenBuffers(1, &statsBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, tileBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_READ);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        pendingAll = true;
+        return true;
+    }
+
+    void destroy() {
+        for (GLuint& program : programs) {
+            if (program) glDeleteProgram(program);
+            program = 0;
+        }
+        if (tileBuffer) glDeleteBuffers(1, &tileBuffer);
+        if (statsBuffer) glDeleteBuffers(1, &statsBuffer);
+        tileBuffer = statsBuffer = 0;
+    }
+
+    bool isCreated() const { return programs[0] != 0; }
+
+    void setLutFetch(LutFetch value) { fetch = value; }
+    LutFetch getLutFetch() const { return fetch; }
+
+    // Blocos a refiltrar no próximo dispatch; acumulam até lá
+    void markDirty(const RoiRect& rect) {
+        if (rect.width > 0 && rect.height > 0) pending.push_back(rect);
+    }
+
+    // Tudo: mudou a força, a LUT ou o modo, ou o alvo foi recriado
+    void markAll() { pendingAll = true; }
+
+    bool hasPending() const { return pendingAll || !pending.empty(); }
+
+    // Filtra os blocos marcados de 'source' para 'target' (a mesma textura:
+    // no lugar), as duas com storage GL_RGBA8 de width x height. Sem bloco
+    // marcado não despacha nada. Depois do retorno o alvo pode ser
+    // amostrado, copiado (blit) ou lido.
+    void dispatch(GLuint source, GLuint target, int width, int height, const Settings& settings) {
+        GLuint program = programs[(int)fetch];
+        if (!program || width <= 0 || height <= 0 || !hasPending()) return;
+        int tilesPerRow = (width + tileSize - 1) / tileSize;
+        int tileRows = (height + tileSize - 1) / tileSize;
+        lastTotalTiles = tilesPerRow * tileRows;
+        bool all = pendingAll || buildTileList(tilesPerRow, tileRows) == lastTotalTiles;
+        if (all) lastDirtyTiles = lastTotalTiles;
+        pending.clear();
+        pendingAll = false;
+
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "lutTexture"), 1);
+        glUniform1i(glGetUniformLocation(program, "useTileList"), all ? 0 : 1);
+        glUniform1ui(glGetUniformLocation(program, "tileCount"), (GLuint)lastDirtyTiles);
+        glUniform1i(glGetUniformLocation(program, "enableCorrection"), settings.enableCorrection);
+        glUniform1f(glGetUniformLocation(program, "correctionStrength"), settings.strength);
+        glUniform1i(glGetUniformLocation(program, "useLUT"), settings.useLUT);
+        glUniform1i(glGetUniformLocation(program, "linearLight"), settings.linearLight);
+        glUniform1i(glGetUniformLocation(program, "noiseTexture"), 2);
+        glUniform1i(glGetUniformLocation(program, "dither"), settings.dither);
+
+        bool inPlace = source == target;
+        bindImageTexture(0, source, 0, GL_FALSE, 0, inPlace ? GL_READ_WRITE : GL_READ_ONLY, GL_RGBA8);
+        bindImageTexture(1, target, 0, GL_FALSE, 0, inPlace ? GL_READ_WRITE : GL_WRITE_ONLY, GL_RGBA8);
+
+        if (!all) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, tileBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, tiles.size() * sizeof(uint32_t), tiles.data(), GL_DYNAMIC_DRAW);
+        }
+        const uint32_t zeros[2] = { 0, 0 };
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zeros), zeros);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, tileBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, statsBuffer);
+
+        // Com a lista, os grupos vão em linhas de tilesPerRow; os que passam
+        // do fim da lista saem na primeira instrução
+        int groupRows = all ? tileRows : (lastDirtyTiles + tilesPerRow - 1) / tilesPerRow;
+        dispatchCompute((GLuint)tilesPerRow, (GLuint)groupRows, 1);
+        memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                      GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    }
+
+    int getDirtyTiles() const { return lastDirtyTiles; }
+    int getTotalTiles() const { return lastTotalTiles; }
+
+    // Espera a GPU (glGetBufferSubData sincroniza): não usar por frame
+    Stats readStats() {
+        uint32_t values[2] = { 0, 0 };
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, statsBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(values), values);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        Stats stats;
+        stats.filteredGroups = values[0];
+        stats.lutCells = values[1];
+        return stats;
+    }
+
+    // Mede os dois programas em um frame de texto width x height (texturas
+    // próprias; a LUT já ligada na unidade 1) e fica com o mais rápido. A LUT
+    // em shared só ganha se for pelo menos 5% mais rápida. Espera a GPU:
+    // chamar uma vez, na inicialização.
+    LutFetch calibrate(int width, int height, double times[lutFetchCount] = nullptr) {
+        std::vector<uint8_t> frame = TestFrames::make(TestFrames::Kind::Text, width, height);
+        GLuint textures[2];
+        glGenTextures(2, textures);
+        for (GLuint texture : textures) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, frame.data());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        }
+
+        // Rodadas alternando os programas; a primeira só aquece
+        double best[lutFetchCount] = { 1e30, 1e30 };
+        Settings settings;
+        for (int round = 0; round < 4; round++) {
+            for (int i = 0; i < lutFetchCount; i++) {
+                fetch = (LutFetch)i;
+                markAll();
+                auto start = std::chrono::steady_clock::now();
+                dispatch(textures[0], textures[1], width, height, settings);
+                glFinish();
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (round > 0) best[i] = std::min(best[i], ms);
+            }
+        }
+        glDeleteTextures(2, textures);
+        markAll();
+
+        fetch = best[(int)LutFetch::Shared] < best[(int)LutFetch::Texture] * 0.95 ? LutFetch::Shared : LutFetch::Texture;
+        if (times) {
+            for (int i = 0; i < lutFetchCount; i++) times[i] = best[i];
+        }
+        return fetch;
+    }
+
+private:
+    GLuint compile(const char* header, std::string* log) {
+        const char* sources[2] = { header, computeShaderSource };
+        GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(shader, 2, sources, nullptr);
+        glCompileShader(shader);
+        GLint status = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        GLuint program = 0;
+        if (status) {
+            program = glCreateProgram();
+            glAttachShader(program, shader);
+            glLinkProgram(program);
+            glGetProgramiv(program, GL_LINK_STATUS, &status);
+        }
+        if (!status) {
+            char buffer[1024] = {};
+            if (program) {
+                glGetProgramInfoLog(program, sizeof(buffer), nullptr, buffer);
+                glDeleteProgram(program);
+                program = 0;
+            } else {
+                glGetShaderInfoLog(shader, sizeof(buffer), nullptr, buffer);
+            }
+            if (log) *log = buffer;
+        }
+        glDeleteShader(shader);
+        return program;
+    }
+
+    // Blocos das regiões pendentes, sem repetir; devolve quantos
+    int buildTileList(int tilesPerRow, int tileRows) {
+        mask.assign((size_t)(tilesPerRow * tileRows + 31) / 32, 0);
+        tiles.clear();
+        for (const RoiRect& r : pending) {
+            int x0 = std::max(0, r.x / tileSize);
+            int y0 = std::max(0, r.y / tileSize);
+            int x1 = std::min(tilesPerRow - 1, (r.x + r.width - 1) / tileSize);
+            int y1 = std::min(tileRows - 1, (r.y + r.height - 1) / tileSize);
+            for (int ty = y0; ty <= y1; ty++) {
+                for (int tx = x0; tx <= x1; tx++) {
+                    int tile = ty * tilesPerRow + tx;
+                    if (mask[tile >> 5] & (1u << (tile & 31))) continue;
+                    mask[tile >> 5] |= 1u << (tile & 31);
+                    tiles.push_back((uint32_t)tx | ((uint32_t)ty << 16));
+                }
+            }
+        }
+        lastDirtyTiles = (int)tiles.size();
+        return lastDirtyTiles;
+    }
+};
+
+#endif // COMPUTE_FILTER_H
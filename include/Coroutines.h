@@ -0,0 +1,339 @@
+#ifndef COROUTINES_H
+#define COROUTINES_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// ==================== EXECUTOR ====================
+// Fila de corrotinas prontas. Com threads próprias (startThreads) elas
+// retomam as corrotinas; sem threads, quem é dono da thread chama runFor()
+// no próprio laço (a thread de render, dona do contexto GL). Uma corrotina
+// sempre retoma no executor em que foi iniciada.
+class Executor {
+private:
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::deque<std::coroutine_handle<>> ready;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+public:
+    Executor() {}
+    ~Executor() { stop(); }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    void startThreads(int count, bool lowPriority = false) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = false;
+        }
+        for (int i = 0; i < count; i++) {
+            threads.emplace_back(&Executor::threadLoop, this, lowPriority);
+        }
+    }
+
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(handle);
+        }
+        wakeCondition.notify_one();
+    }
+
+    // Retoma o que estiver pronto, esperando até 'timeout' pelo primeiro;
+    // devolve quantas corrotinas rodaram
+    int runFor(std::chrono::microseconds timeout) {
+        int resumed = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (ready.empty()) {
+            wakeCondition.wait_for(lock, timeout, [&] { return !ready.empty() || stopping; });
+        }
+        while (!ready.empty()) {
+            std::coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            handle.resume();
+            resumed++;
+            lock.lock();
+        }
+        return resumed;
+    }
+
+    // As corrotinas suspensas continuam sendo do dono (Task); só as threads param
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& t : threads) {
+            if (t.joinable()) t.join();
+        }
+        threads.clear();
+    }
+
+    // co_await executor.schedule(): continua a corrotina neste executor
+    auto schedule() {
+        struct Awaiter {
+            Executor* executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor->post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ this };
+    }
+
+private:
+    void threadLoop(bool lowPriority) {
+        if (lowPriority) {
+#ifdef _WIN32
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#else
+            setpriority(PRIO_PROCESS, 0, 10);  // Linux: vale só para esta thread
+#endif
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeCondition.wait(lock, [&] { return !ready.empty() || stopping; });
+            if (stopping) return;
+            std::coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+        }
+    }
+};
+
+// ==================== TAREFA ====================
+// Corrotina de um estágio: criada suspensa, start() a coloca no executor.
+// O frame da corrotina é destruído pela Task, depois de terminar (ou se
+// nunca começou).
+class Task {
+public:
+    struct promise_type {
+        Executor* executor = nullptr;
+        std::atomic<bool> done{false};
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Marca o fim só depois de suspensa: a partir daí destruir é seguro
+        auto final_suspend() noexcept {
+            struct Awaiter {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    handle.promise().done = true;
+                    handle.promise().done.notify_all();
+                }
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+    bool started = false;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+public:
+    Task() {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)), started(other.started) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle = std::exchange(other.handle, nullptr);
+            started = other.started;
+        }
+        return *this;
+    }
+    ~Task() { destroy(); }
+
+    void start(Executor& executor) {
+        handle.promise().executor = &executor;
+        started = true;
+        executor.post(handle);
+    }
+
+    bool isDone() const { return !handle || handle.promise().done.load(); }
+
+    // Bloqueia até a corrotina terminar (o executor dela precisa estar rodando)
+    void join() {
+        if (handle && started) handle.promise().done.wait(false);
+    }
+
+private:
+    void destroy() {
+        if (!handle) return;
+        join();
+        handle.destroy();
+        handle = nullptr;
+    }
+};
+
+// ==================== CANAL ====================
+// Fila limitada entre estágios. receive() suspende o estágio até chegar um
+// item (sem polling) e send() suspende enquanto a fila estiver cheia, o que
+// segura o estágio anterior quando o seguinte atrasa. Quem espera é retomado
+// no próprio executor. Depois de close() receive() devolve nullopt assim que
+// a fila esvazia e send() devolve false.
+template <typename T>
+class Channel {
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        Executor* executor;
+        std::optional<T>* received;  // receptor: onde entregar o item
+        T* sending;                  // remetente: item à espera de vaga
+        bool* accepted;
+    };
+
+    std::mutex mutex;
+    std::deque<T> items;
+    std::deque<Waiter> receivers;
+    std::deque<Waiter> senders;
+    size_t capacity;
+    bool closed = false;
+    uint64_t dropped = 0;
+
+public:
+    explicit Channel(size_t depth = 1) : capacity(depth > 0 ? depth : 1) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    auto receive() {
+        struct Awaiter {
+            Channel* channel;
+            std::optional<T> result;
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<Task::promise_type> handle) {
+                std::unique_lock<std::mutex> lock(channel->mutex);
+                if (channel->takeLocked(result, lock)) return false;
+                channel->receivers.push_back({ handle, handle.promise().executor, &result, nullptr, nullptr });
+                return true;
+            }
+            std::optional<T> await_resume() { return std::move(result); }
+        };
+        return Awaiter{ this, std::nullopt };
+    }
+
+    auto send(T value) {
+        struct Awaiter {
+            Channel* channel;
+            T value;
+            bool accepted = false;
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<Task::promise_type> handle) {
+                std::unique_lock<std::mutex> lock(channel->mutex);
+                if (channel->putLocked(value, accepted, lock)) return false;
+                channel->senders.push_back({ handle, handle.promise().executor, nullptr, &value, &accepted });
+                return true;
+            }
+            bool await_resume() const noexcept { return accepted; }
+        };
+        return Awaiter{ this, std::move(value) };
+    }
+
+    // Fora de corrotinas (thread da captura): nunca bloqueia. Com a fila
+    // cheia, 'dropOldest' troca o item mais antigo pelo novo (o estágio
+    // seguinte sempre pega o frame mais recente); sem ele o novo é descartado.
+    bool trySend(T value, bool dropOldest) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (closed) return false;
+        bool accepted = false;
+        if (putLocked(value, accepted, lock)) return true;
+        dropped++;
+        if (!dropOldest) return false;
+        items.pop_front();
+        items.push_back(std::move(value));
+        return true;
+    }
+
+    void close() {
+        std::deque<Waiter> waiting;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) return;
+            closed = true;
+            waiting.swap(receivers);
+            for (Waiter& sender : senders) waiting.push_back(sender);
+            senders.clear();
+        }
+        // Receptores saem com nullopt, remetentes com accepted = false
+        for (Waiter& waiter : waiting) waiter.executor->post(waiter.handle);
+    }
+
+    uint64_t getDropped() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dropped;
+    }
+
+private:
+    // true: resolvido sem suspender (item, ou canal fechado e vazio)
+    bool takeLocked(std::optional<T>& result, std::unique_lock<std::mutex>& lock) {
+        if (items.empty()) return closed;
+        result = std::move(items.front());
+        items.pop_front();
+        if (!senders.empty()) {
+            Waiter sender = senders.front();
+            senders.pop_front();
+            items.push_back(std::move(*sender.sending));
+            *sender.accepted = true;
+            lock.unlock();
+            sender.executor->post(sender.handle);
+        }
+        return true;
+    }
+
+    // true: resolvido sem suspender (entregue, enfileirado ou canal fechado)
+    bool putLocked(T& value, bool& accepted, std::unique_lock<std::mutex>& lock) {
+        if (closed) return true;
+        if (!receivers.empty()) {
+            Waiter receiver = receivers.front();
+            receivers.pop_front();
+            *receiver.received = std::move(value);
+            accepted = true;
+            lock.unlock();
+            receiver.executor->post(receiver.handle);
+            return true;
+        }
+        if (items.size() < capacity) {
+            items.push_back(std::move(value));
+            accepted = true;
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif // COROUTINES_H
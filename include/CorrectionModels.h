@@ -0,0 +1,487 @@
+#ifndef CORRECTION_MODELS_H
+#define CORRECTION_MODELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ColorCorrection.h"
+#include "CpuFeatures.h"
+#include "Lut3D.h"
+#include "SRGB.h"
+#include "ThreadPool.h"
+
+// ==================== MODELOS POR DEFICIÊNCIA E SEVERIDADE ====================
+// As correções de ColorCorrection.h são só para deuteranopia completa. Aqui
+// cada método vale para protan, deutan e tritan com severidade 0..1, na
+// mesma forma "compilada" (Params) para todos:
+//
+//   linear (lms, daltonize, machado)  y = B (A x + d u + |d| v), d = wd . (A x)
+//   híbrida                           razão entre dois canais (p / q) decide
+//                                     reforçar p ou q e empurrar a diferença
+//                                     para o terceiro (t); luminância mantida
+//
+// - lms: A leva RGB a LMS, B volta. Protan e deutan perdem o mesmo eixo L-M
+//   (d = L - M, reforçado e copiado para S); tritan perde S contra (L+M)/2,
+//   que é reforçado e copiado para L-M. Ganhos 0.7 e 0.3 vezes a severidade.
+// - daltonize: simulação S (interpolada da identidade pela severidade),
+//   erro x - S x somado ao canal que sobra: A = I + E (I - S), B = I. Deutan
+//   mantém a matriz do shader (transposta da clássica, ver ColorCorrection.h)
+//   para a LUT sair igual à embutida; protan e tritan usam as clássicas.
+// - machado: mesma forma do daltonize com as matrizes de Machado, Oliveira e
+//   Fernandes (2009), em luz linear; severidades entre as da tabela (passo
+//   0.1) são interpoladas.
+// - hybrid: deutan é a hybridCorrection; protan reforça mais o vermelho
+//   (protans o veem mais escuro); tritan usa o eixo azul-verde e empurra
+//   para o vermelho.
+//
+// Deutan com severidade 1 reproduz ColorCorrection::apply: as LUTs saem
+// iguais às de Lut3D::fromCorrection (o daltonize pré-multiplica a matriz,
+// então em float pode diferir no último bit, nunca no byte nos testes).
+//
+// generate/generateAll avaliam uma linha de r por vez (g e b fixos): o eixo
+// de r é uma tabela pronta (já em luz linear quando o modelo pede) e a
+// versão AVX2 faz 8 pontos por instrução, com as mesmas operações na mesma
+// ordem da escalar (sem FMA), então as duas dão a mesma LUT byte a byte. A
+// volta de luz linear para byte sRGB não usa pow: uma tabela por intervalo
+// de 1/4096 e uma comparação com o limiar linear do próximo byte
+// (encodeByte), que dá o mesmo byte que Lut3D::toByte(SRGB::toSRGB(v)).
+
+enum class Deficiency { Protan, Deutan, Tritan };
+
+struct CorrectionModel {
+    CorrectionMethod method = CorrectionMethod::Hybrid;
+    Deficiency deficiency = Deficiency::Deutan;
+    float severity = 1.0f;  // 0: sem correção; 1: dicromacia
+
+    static const char* deficiencyName(Deficiency deficiency) {
+        switch (deficiency) {
+            case Deficiency::Protan: return "protan";
+            case Deficiency::Deutan: return "deutan";
+            case Deficiency::Tritan: return "tritan";
+        }
+        return "?";
+    }
+
+    // "hybrid_deutan_100": método, deficiência, severidade em %
+    std::string name() const {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%s_%s_%03d", ColorCorrection::methodName(method),
+                      deficiencyName(deficiency), (int)std::lround(severity * 100.0f));
+        return text;
+    }
+};
+
+class CorrectionModels {
+public:
+    enum class Level { Scalar, AVX2 };
+
+    static Level bestLevel() { return CpuFeatures::get().avx2 ? Level::AVX2 : Level::Scalar; }
+
+    static bool isSupported(Level level) { return level == Level::Scalar || CpuFeatures::get().avx2; }
+
+    static const int maxSize = 256;
+
+    struct Params {
+        bool hybrid = false;
+        bool linearLight = false;  // entrada decodificada de sRGB, saída codificada
+        // Forma linear (matrizes por linhas)
+        float a[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+        float b[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+        float wd[3] = { 0, 0, 0 };
+        float u[3] = { 0, 0, 0 };
+        float v[3] = { 0, 0, 0 };
+        // Híbrida: canais e ganhos
+        int p = 0, q = 1, t = 2;
+        float boostHigh = 1.0f, shiftHigh = 0.0f;  // razão p/q > 1.2
+        float boostLow = 1.0f, shiftLow = 0.0f;    // razão p/q < 0.8
+        float luma[3] = { 0.299f, 0.587f, 0.114f };
+    };
+
+    static Params compile(const CorrectionModel& model) {
+        Params params;
+        const float s = std::min(1.0f, std::max(0.0f, model.severity));
+        const bool tritan = model.deficiency == Deficiency::Tritan;
+        switch (model.method) {
+            case CorrectionMethod::LMS: {
+                const float toLms[9] = { 0.31399022f, 0.15537241f, 0.01775239f,
+                                         0.63951294f, 0.75789446f, 0.10944209f,
+                                         0.04649755f, 0.08670142f, 0.87256922f };
+                const float toRgb[9] = {  5.47221206f, -1.1252419f,   0.02980165f,
+                                         -4.6419601f,   2.29317094f, -0.19318073f,
+                                          0.16963708f, -0.1678952f,   1.16364789f };
+                std::copy(toLms, toLms + 9, params.a);
+                std::copy(toRgb, toRgb + 9, params.b);
+                const float gain = 0.7f * s, spill = 0.3f * s;
+                if (tritan) {
+                    setVector(params.wd, -0.5f, -0.5f, 1.0f);
+                    setVector(params.u, spill, -spill, gain);
+                } else {
+                    setVector(params.wd, 1.0f, -1.0f, 0.0f);
+                    setVector(params.u, gain, -gain, 0.0f);
+                    setVector(params.v, 0.0f, 0.0f, spill);
+                }
+                break;
+            }
+            case CorrectionMethod::Daltonize: {
+                // Simulações em sRGB, por linhas
+                const float deutan[9] = { 0.625f, 0.7f, 0.0f, 0.375f, 0.3f, 0.3f, 0.0f, 0.0f, 0.7f };
+                const float protan[9] = { 0.567f, 0.433f, 0.0f, 0.558f, 0.442f, 0.0f, 0.0f, 0.242f, 0.758f };
+                const float tritanSim[9] = { 0.95f, 0.05f, 0.0f, 0.0f, 0.433f, 0.567f, 0.0f, 0.475f, 0.525f };
+                const float* full = tritan ? tritanSim : (model.deficiency == Deficiency::Protan ? protan : deutan);
+                float sim[9];
+                for (int i = 0; i < 9; i++) sim[i] = identity(i) + (full[i] - identity(i)) * s;
+                // Deutan do shader: só o erro de r e g, para o azul
+                const float rgError[9] = { 0, 0, 0, 0, 0, 0, 0.7f, 0.7f, 0 };
+                const float blueError[9] = { 0, 0, 0.7f, 0, 0, 0.7f, 0, 0, 0 };
+                daltonizeMatrix(sim, tritan ? blueError : rgError, params.a);
+                break;
+            }
+            case CorrectionMethod::Machado: {
+                float sim[9];
+                machadoMatrix(model.deficiency, s, sim);
+                // Fidaner: erro do canal perdido para os outros dois
+                const float rgError[9] = { 0, 0, 0, 0.7f, 1, 0, 0.7f, 0, 1 };
+                const float blueError[9] = { 1, 0, 0.7f, 0, 1, 0.7f, 0, 0, 0 };
+                daltonizeMatrix(sim, tritan ? blueError : rgError, params.a);
+                params.linearLight = true;
+                break;
+            }
+            case CorrectionMethod::Hybrid: {
+                params.hybrid = true;
+                if (tritan) {
+                    params.p = 2;
+                    params.q = 1;
+                    params.t = 0;
+                }
+                params.boostHigh = 1.0f + (model.deficiency == Deficiency::Protan ? 0.2f : 0.1f) * s;
+                params.shiftHigh = 0.25f * s;
+                params.boostLow = 1.0f + 0.05f * s;
+                params.shiftLow = 0.2f * s;
+                break;
+            }
+        }
+        return params;
+    }
+
+    // Referência escalar; entrada e saída em sRGB [0, 1]
+    static RGB evaluate(const Params& params, RGB c) {
+        float x[3] = { c.r, c.g, c.b };
+        if (params.linearLight) {
+            for (float& value : x) value = SRGB::toLinear(value);
+        }
+        float y[3];
+        evaluatePoint(params, x, y);
+        if (params.linearLight) {
+            for (float& value : y) value = SRGB::toSRGB(value);
+        }
+        return { y[0], y[1], y[2] };
+    }
+
+    static RGB apply(const CorrectionModel& model, RGB c) { return evaluate(compile(model), c); }
+
+    // Lut3D::toByte(SRGB::toSRGB(linear)) para linear em [0, 1], sem pow.
+    // thresholds[k] é o menor float que ainda vira o byte k (a conta é
+    // monotônica), achado por busca binária nos bits do float. Um intervalo
+    // de 1/4096 em luz linear cobre no máximo 0.8 byte (a inclinação máxima
+    // da curva é 12.92), então o byte do começo do intervalo mais uma
+    // comparação com o próximo limiar dão o byte exato
+    struct EncodeTables {
+        static const int bucketCount = 4096;
+        float thresholds[257];  // [0] abaixo de tudo, [256] acima de tudo
+        int32_t buckets[bucketCount + 1];
+    };
+
+    static const EncodeTables& encodeTables() {
+        static const EncodeTables tables = [] {
+            EncodeTables t;
+            t.thresholds[0] = -1.0f;
+            t.thresholds[256] = 2.0f;
+            uint32_t oneBits;
+            float one = 1.0f;
+            std::memcpy(&oneBits, &one, 4);
+            for (int k = 1; k < 256; k++) {
+                uint32_t low = 0, high = oneBits;  // toByte(1.0) = 255 >= k
+                while (low < high) {
+                    uint32_t middle = low + (high - low) / 2;
+                    float v;
+                    std::memcpy(&v, &middle, 4);
+                    if (Lut3D::toByte(SRGB::toSRGB(v)) >= k) {
+                        high = middle;
+                    } else {
+                        low = middle + 1;
+                    }
+                }
+                std::memcpy(&t.thresholds[k], &low, 4);
+            }
+            for (int i = 0; i <= EncodeTables::bucketCount; i++) {
+                t.buckets[i] = Lut3D::toByte(SRGB::toSRGB((float)i / EncodeTables::bucketCount));
+            }
+            return t;
+        }();
+        return tables;
+    }
+
+    static uint8_t encodeByte(float linear) {
+        const EncodeTables& t = encodeTables();
+        linear = clamp01(linear);
+        int byte = t.buckets[(int)(linear * EncodeTables::bucketCount)];
+        return (uint8_t)(byte + (linear >= t.thresholds[byte + 1] ? 1 : 0));
+    }
+
+    // Machado et al. (2009), por linhas, em RGB linear; severidade 0..1
+    static void machadoMatrix(Deficiency deficiency, float severity, float out[9]) {
+        const float (*table)[9] = deficiency == Deficiency::Protan ? machadoProtan
+                                : deficiency == Deficiency::Deutan ? machadoDeutan : machadoTritan;
+        float position = std::min(1.0f, std::max(0.0f, severity)) * 10.0f;
+        int index = std::min(9, (int)position);
+        float fraction = position - index;
+        for (int i = 0; i < 9; i++) {
+            float from = index == 0 ? identity(i) : table[index - 1][i];
+            out[i] = from + (table[index][i] - from) * fraction;
+        }
+    }
+
+    static Lut3D generate(const CorrectionModel& model, int size, Level level = bestLevel()) {
+        std::vector<Lut3D> luts = generateAll({ model }, size, nullptr, level);
+        return std::move(luts[0]);
+    }
+
+    // Todas de uma vez: cada tarefa é um plano b de uma LUT, espalhadas pelo
+    // pool (nullptr: tudo na thread chamadora)
+    static std::vector<Lut3D> generateAll(const std::vector<CorrectionModel>& models, int size, ThreadPool* pool,
+                                          Level level = bestLevel()) {
+        std::vector<Lut3D> luts(models.size());
+        if (size < 2 || size > maxSize) return luts;
+        if (!isSupported(level)) level = Level::Scalar;
+
+        std::vector<Params> params;
+        for (const CorrectionModel& model : models) params.push_back(compile(model));
+        for (Lut3D& lut : luts) {
+            lut.size = size;
+            lut.data.resize((size_t)size * size * size * 3);
+        }
+        // Eixo em sRGB e em luz linear, com folga para a última carga de 8
+        const float scale = 1.0f / (size - 1);
+        std::vector<float> axis(size + 8, 0.0f), axisLinear(size + 8, 0.0f);
+        for (int i = 0; i < size; i++) {
+            axis[i] = i * scale;
+            axisLinear[i] = SRGB::toLinear(axis[i]);
+        }
+
+        auto planes = [&](int begin, int end) {
+            int32_t out[3][maxSize + 8];
+            for (int task = begin; task < end; task++) {
+                const Params& p = params[task / size];
+                Lut3D& lut = luts[task / size];
+                const int b = task % size;
+                const float* in = p.linearLight ? axisLinear.data() : axis.data();
+                for (int g = 0; g < size; g++) {
+#if DALTONISMO_X86_SIMD
+                    if (level == Level::AVX2) {
+                        evaluateRow_AVX2(p, in, in[g], in[b], size, out[0], out[1], out[2]);
+                    } else
+#endif
+                    {
+                        evaluateRow(p, in, in[g], in[b], size, out[0], out[1], out[2]);
+                    }
+                    uint8_t* dst = lut.at(0, g, b);
+                    for (int r = 0; r < size; r++, dst += 3) {
+                        dst[0] = (uint8_t)out[0][r];
+                        dst[1] = (uint8_t)out[1][r];
+                        dst[2] = (uint8_t)out[2][r];
+                    }
+                }
+            }
+        };
+        const int tasks = (int)models.size() * size;
+        if (pool) {
+            pool->parallelFor(0, tasks, 1, planes);
+        } else {
+            planes(0, tasks);
+        }
+        return luts;
+    }
+
+private:
+    static float identity(int i) { return i % 4 == 0 ? 1.0f : 0.0f; }
+
+    static void setVector(float v[3], float x, float y, float z) {
+        v[0] = x;
+        v[1] = y;
+        v[2] = z;
+    }
+
+    // A = I + E (I - S): a cor mais o erro da simulação redistribuído
+    static void daltonizeMatrix(const float sim[9], const float error[9], float out[9]) {
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                float sum = identity(row * 3 + col);
+                for (int k = 0; k < 3; k++) sum += error[row * 3 + k] * (identity(k * 3 + col) - sim[k * 3 + col]);
+                out[row * 3 + col] = sum;
+            }
+        }
+    }
+
+    static float clamp01(float v) { return std::min(1.0f, std::max(0.0f, v)); }
+
+    // Um ponto; x já em luz linear se o modelo pede. As somas seguem a ordem
+    // das funções de ColorCorrection.h (e a do AVX2)
+    static void evaluatePoint(const Params& p, const float x[3], float y[3]) {
+        if (p.hybrid) {
+            float ratio = x[p.p] / std::max(x[p.q], 0.001f);
+            y[0] = x[0];
+            y[1] = x[1];
+            y[2] = x[2];
+            if (ratio > 1.2f) {
+                y[p.p] = std::min(1.0f, x[p.p] * p.boostHigh);
+                y[p.t] = std::min(1.0f, x[p.t] + (x[p.p] - x[p.q]) * p.shiftHigh);
+            } else if (ratio < 0.8f) {
+                y[p.q] = std::min(1.0f, x[p.q] * p.boostLow);
+                y[p.t] = std::min(1.0f, x[p.t] + (x[p.q] - x[p.p]) * p.shiftLow);
+            }
+            float luminance = p.luma[0] * x[0] + p.luma[1] * x[1] + p.luma[2] * x[2];
+            float newLuminance = p.luma[0] * y[0] + p.luma[1] * y[1] + p.luma[2] * y[2];
+            if (newLuminance > 0.001f) {
+                float k = luminance / newLuminance;
+                for (int c = 0; c < 3; c++) y[c] *= k;
+            }
+        } else {
+            float a[3];
+            for (int c = 0; c < 3; c++) a[c] = p.a[c * 3] * x[0] + p.a[c * 3 + 1] * x[1] + p.a[c * 3 + 2] * x[2];
+            float d = p.wd[0] * a[0] + p.wd[1] * a[1] + p.wd[2] * a[2];
+            float e[3];
+            for (int c = 0; c < 3; c++) e[c] = a[c] + p.u[c] * d + p.v[c] * std::fabs(d);
+            for (int c = 0; c < 3; c++) y[c] = p.b[c * 3] * e[0] + p.b[c * 3 + 1] * e[1] + p.b[c * 3 + 2] * e[2];
+        }
+        for (int c = 0; c < 3; c++) y[c] = clamp01(y[c]);
+    }
+
+    // Uma linha de r já quantizada: bytes sRGB em int32 por canal
+    static void evaluateRow(const Params& p, const float* red, float g, float b, int count,
+                            int32_t* outR, int32_t* outG, int32_t* outB) {
+        for (int i = 0; i < count; i++) {
+            float x[3] = { red[i], g, b }, y[3];
+            evaluatePoint(p, x, y);
+            int32_t* outs[3] = { outR, outG, outB };
+            for (int c = 0; c < 3; c++) outs[c][i] = p.linearLight ? encodeByte(y[c]) : Lut3D::toByte(y[c]);
+        }
+    }
+
+#if DALTONISMO_X86_SIMD
+    // w[0] v[0] + w[1] v[1] + w[2] v[2], na ordem da escalar
+    DALTONISMO_TARGET("avx2")
+    static __m256 dot3_AVX2(const float* w, const __m256* v) {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(w[0]), v[0]),
+                                           _mm256_mul_ps(_mm256_set1_ps(w[1]), v[1])),
+                             _mm256_mul_ps(_mm256_set1_ps(w[2]), v[2]));
+    }
+
+    // Lê 8 valores de r por vez (red tem folga até count + 8); as saídas
+    // também precisam de folga
+    DALTONISMO_TARGET("avx2")
+    static void evaluateRow_AVX2(const Params& p, const float* red, float g, float b, int count,
+                                 int32_t* outR, int32_t* outG, int32_t* outB) {
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const EncodeTables& tables = encodeTables();
+        int32_t* outs[3] = { outR, outG, outB };
+        for (int i = 0; i < count; i += 8) {
+            __m256 x[3] = { _mm256_loadu_ps(red + i), _mm256_set1_ps(g), _mm256_set1_ps(b) };
+            __m256 y[3];
+            if (p.hybrid) {
+                const __m256 xp = x[p.p], xq = x[p.q], xt = x[p.t];
+                __m256 ratio = _mm256_div_ps(xp, _mm256_max_ps(xq, _mm256_set1_ps(0.001f)));
+                __m256 high = _mm256_cmp_ps(ratio, _mm256_set1_ps(1.2f), _CMP_GT_OQ);
+                __m256 low = _mm256_andnot_ps(high, _mm256_cmp_ps(ratio, _mm256_set1_ps(0.8f), _CMP_LT_OQ));
+                __m256 highP = _mm256_min_ps(one, _mm256_mul_ps(xp, _mm256_set1_ps(p.boostHigh)));
+                __m256 highT = _mm256_min_ps(one, _mm256_add_ps(xt, _mm256_mul_ps(_mm256_sub_ps(xp, xq),
+                                                                                  _mm256_set1_ps(p.shiftHigh))));
+                __m256 lowQ = _mm256_min_ps(one, _mm256_mul_ps(xq, _mm256_set1_ps(p.boostLow)));
+                __m256 lowT = _mm256_min_ps(one, _mm256_add_ps(xt, _mm256_mul_ps(_mm256_sub_ps(xq, xp),
+                                                                                 _mm256_set1_ps(p.shiftLow))));
+                y[p.p] = _mm256_blendv_ps(xp, highP, high);
+                y[p.q] = _mm256_blendv_ps(xq, lowQ, low);
+                y[p.t] = _mm256_blendv_ps(_mm256_blendv_ps(xt, lowT, low), highT, high);
+                __m256 luminance = dot3_AVX2(p.luma, x);
+                __m256 newLuminance = dot3_AVX2(p.luma, y);
+                __m256 k = _mm256_div_ps(luminance, newLuminance);
+                __m256 scaled = _mm256_cmp_ps(newLuminance, _mm256_set1_ps(0.001f), _CMP_GT_OQ);
+                for (int c = 0; c < 3; c++) y[c] = _mm256_blendv_ps(y[c], _mm256_mul_ps(y[c], k), scaled);
+            } else {
+                __m256 a[3];
+                for (int c = 0; c < 3; c++) a[c] = dot3_AVX2(p.a + c * 3, x);
+                __m256 d = dot3_AVX2(p.wd, a);
+                __m256 absD = _mm256_andnot_ps(signMask, d);
+                __m256 e[3];
+                for (int c = 0; c < 3; c++) {
+                    e[c] = _mm256_add_ps(_mm256_add_ps(a[c], _mm256_mul_ps(_mm256_set1_ps(p.u[c]), d)),
+                                         _mm256_mul_ps(_mm256_set1_ps(p.v[c]), absD));
+                }
+                for (int c = 0; c < 3; c++) y[c] = dot3_AVX2(p.b + c * 3, e);
+            }
+            for (int c = 0; c < 3; c++) {
+                // max(0, ...) primeiro: NaN vira 0, como no clamp escalar
+                __m256 v = _mm256_min_ps(one, _mm256_max_ps(y[c], zero));
+                __m256i bytes;
+                if (p.linearLight) {
+                    // Como o encodeByte: byte do intervalo + 1 se passou do próximo limiar
+                    __m256i bucket = _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps((float)EncodeTables::bucketCount)));
+                    bytes = _mm256_i32gather_epi32(tables.buckets, bucket, 4);
+                    __m256 next = _mm256_i32gather_ps(tables.thresholds + 1, bytes, 4);
+                    __m256 above = _mm256_cmp_ps(v, next, _CMP_GE_OQ);
+                    bytes = _mm256_sub_epi32(bytes, _mm256_castps_si256(above));  // true = -1
+                } else {
+                    // toByte com v em [0, 1]: trunc(v * 255 + 0.5)
+                    bytes = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)),
+                                                              _mm256_set1_ps(0.5f)));
+                }
+                _mm256_storeu_si256((__m256i*)(outs[c] + i), bytes);
+            }
+        }
+    }
+#endif
+
+    // Tabela de Machado et al. (2009), severidades 0.1 a 1.0 (0 = identidade)
+    static constexpr float machadoProtan[10][9] = {
+        { 0.856167f, 0.182038f, -0.038205f, 0.029342f, 0.955115f, 0.015544f, -0.002880f, -0.001563f, 1.004443f },
+        { 0.734766f, 0.334872f, -0.069637f, 0.051840f, 0.919198f, 0.028963f, -0.004928f, -0.004209f, 1.009137f },
+        { 0.630323f, 0.465641f, -0.095964f, 0.069181f, 0.890046f, 0.040773f, -0.006308f, -0.007724f, 1.014032f },
+        { 0.539009f, 0.579343f, -0.118352f, 0.082546f, 0.866121f, 0.051332f, -0.007136f, -0.011959f, 1.019095f },
+        { 0.458064f, 0.679578f, -0.137642f, 0.092785f, 0.846313f, 0.060902f, -0.007494f, -0.016807f, 1.024301f },
+        { 0.385450f, 0.769005f, -0.154455f, 0.100526f, 0.829802f, 0.069673f, -0.007442f, -0.022190f, 1.029632f },
+        { 0.319627f, 0.849633f, -0.169261f, 0.106241f, 0.815969f, 0.077790f, -0.007025f, -0.028051f, 1.035076f },
+        { 0.259411f, 0.923008f, -0.182420f, 0.110296f, 0.804340f, 0.085364f, -0.006276f, -0.034346f, 1.040622f },
+        { 0.203876f, 0.990338f, -0.194214f, 0.112975f, 0.794542f, 0.092483f, -0.005222f, -0.041043f, 1.046265f },
+        { 0.152286f, 1.052583f, -0.204868f, 0.114503f, 0.786281f, 0.099216f, -0.003882f, -0.048116f, 1.051998f },
+    };
+    static constexpr float machadoDeutan[10][9] = {
+        { 0.866435f, 0.177704f, -0.044139f, 0.049567f, 0.939063f, 0.011370f, -0.003453f, 0.007233f, 0.996220f },
+        { 0.760729f, 0.319078f, -0.079807f, 0.090568f, 0.889315f, 0.020117f, -0.006027f, 0.013325f, 0.992702f },
+        { 0.675425f, 0.433850f, -0.109275f, 0.125303f, 0.847755f, 0.026942f, -0.007950f, 0.018572f, 0.989378f },
+        { 0.605511f, 0.528560f, -0.134071f, 0.155318f, 0.812366f, 0.032316f, -0.009376f, 0.023176f, 0.986200f },
+        { 0.547494f, 0.607765f, -0.155259f, 0.181692f, 0.781742f, 0.036566f, -0.010410f, 0.027275f, 0.983136f },
+        { 0.498864f, 0.674741f, -0.173604f, 0.205199f, 0.754872f, 0.039929f, -0.011131f, 0.030969f, 0.980162f },
+        { 0.457771f, 0.731899f, -0.189670f, 0.226409f, 0.731012f, 0.042579f, -0.011595f, 0.034333f, 0.977261f },
+        { 0.422823f, 0.781057f, -0.203881f, 0.245752f, 0.709602f, 0.044646f, -0.011843f, 0.037423f, 0.974421f },
+        { 0.392952f, 0.823610f, -0.216562f, 0.263559f, 0.690210f, 0.046232f, -0.011910f, 0.040281f, 0.971630f },
+        { 0.367322f, 0.860646f, -0.227968f, 0.280085f, 0.672501f, 0.047413f, -0.011820f, 0.042940f, 0.968881f },
+    };
+    static constexpr float machadoTritan[10][9] = {
+        { 0.926670f, 0.092514f, -0.019184f, 0.021191f, 0.964503f, 0.014306f, 0.008437f, 0.054813f, 0.936750f },
+        { 0.895720f, 0.133330f, -0.029050f, 0.029997f, 0.945400f, 0.024603f, 0.013027f, 0.104707f, 0.882266f },
+        { 0.905871f, 0.127791f, -0.033662f, 0.026856f, 0.941251f, 0.031893f, 0.013410f, 0.148296f, 0.838294f },
+        { 0.948035f, 0.089490f, -0.037526f, 0.014364f, 0.946792f, 0.038844f, 0.010853f, 0.193991f, 0.795156f },
+        { 1.017277f, 0.027029f, -0.044306f, -0.006113f, 0.958479f, 0.047634f, 0.006379f, 0.248708f, 0.744913f },
+        { 1.104996f, -0.046633f, -0.058363f, -0.032137f, 0.971635f, 0.060503f, 0.001336f, 0.317922f, 0.680742f },
+        { 1.193214f, -0.109812f, -0.083402f, -0.058496f, 0.979410f, 0.079086f, -0.002346f, 0.403492f, 0.598854f },
+        { 1.257728f, -0.139648f, -0.118081f, -0.078003f, 0.975409f, 0.102594f, -0.003316f, 0.501214f, 0.502102f },
+        { 1.278864f, -0.125333f, -0.153531f, -0.084748f, 0.957674f, 0.127074f, -0.000989f, 0.601151f, 0.399838f },
+        { 1.255528f, -0.076749f, -0.178779f, -0.078411f, 0.930809f, 0.147602f, 0.004733f, 0.691367f, 0.303900f },
+    };
+};
+
+#endif // CORRECTION_MODELS_H
@@ -0,0 +1,42 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Detecção de recursos SIMD em tempo de execução.
+// Os kernels são compilados com __attribute__((target(...))) para que o
+// executável continue rodando em CPUs sem AVX2 (sem precisar de -march).
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define DALTONISMO_X86_SIMD 1
+    #define DALTONISMO_TARGET(features) __attribute__((target(features)))
+    #include <immintrin.h>
+#else
+    #define DALTONISMO_X86_SIMD 0
+    #define DALTONISMO_TARGET(features)
+#endif
+
+struct CpuFeatures {
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool f16c = false;
+
+    static const CpuFeatures& get() {
+        static const CpuFeatures features = detect();
+        return features;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+#if DALTONISMO_X86_SIMD
+        __builtin_cpu_init();
+        f.ssse3 = __builtin_cpu_supports("ssse3");
+        f.sse41 = __builtin_cpu_supports("sse4.1");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        // Toda CPU com AVX2 (Haswell+/Zen+) também tem F16C
+        f.f16c = f.avx2;
+#endif
+        return f;
+    }
+};
+
+#endif // CPU_FEATURES_H
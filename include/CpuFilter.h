@@ -0,0 +1,472 @@
+#ifndef CPU_FILTER_H
+#define CPU_FILTER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "BlueNoise.h"
+#include "Frame.h"
+#include "Half.h"
+#include "Lut3D.h"
+#include "Lut3DFixed.h"
+#include "SRGB.h"
+#include "ThreadPool.h"
+
+// ==================== FILTRO DE CORREÇÃO NA CPU ====================
+// Aplica uma Lut3D (interpolação trilinear) a frames BGRA8, dividindo o frame
+// em faixas de linhas no ThreadPool. Mesma semântica do shader:
+//   saida = mix(original, LUT(original), intensidade)
+//
+// Frames de alta profundidade (RGB10A2, RGBA16F) passam por uma cópia float
+// da LUT, sem voltar para 8 bits. RGBA16F é scRGB linear e a LUT foi gerada
+// sobre sRGB: como no caminho linear do shader, a cor é codificada em sRGB
+// para a consulta, a saída volta para linear e a correção entra como delta
+// em luz linear. Valores HDR acima de 1.0 consultam a LUT na borda do cubo
+// e mantêm o excesso.
+//
+// Em BGRA8, com AVX2, a conta é inteira (Lut3DFixed.h, pesos Q15, 16 pixels
+// por iteração), a até 1 LSB do caminho em float e ~4x mais rápida; o ponto
+// mais próximo e o croma 2x2 também, para a escada do QualityGovernor
+// continuar descendo em custo. Sem AVX2 o padrão continua o float: o ponto
+// fixo escalar perde para ele (./colorbench fixed). O layout da tabela do
+// ponto fixo é o mais rápido medido para o tamanho da LUT (./colorbench layout).
+//
+// Com dither (setDither) a volta para 8 bits soma o ruído azul de
+// BlueNoise.h antes de arredondar, dentro do mesmo kernel: os contornos de
+// 1 LSB dos gradientes viram grão. O erro da interpolação entre os nós
+// continua; só uma LUT maior tira (./colorbench dither). Vale para o
+// frame inteiro em BGRA8; o croma 2x2 soma deltas já inteiros e continua
+// sem dither.
+//
+// A Lut3D fica em um shared_ptr imutável: vários filtros (um por saída, ver
+// MultiOutput.h) podem usar a mesma LUT sem cópia.
+class CpuFilter {
+public:
+    enum class ChromaMode {
+        Full,  // LUT avaliada em todos os pixels
+        Half   // LUT avaliada uma vez por bloco 2x2 (croma em meia resolução)
+    };
+
+    enum class Interpolation {
+        Trilinear,  // 8 pontos da grade
+        Nearest     // 1 ponto (mais barato, com degraus; ver QualityGovernor.h)
+    };
+
+    enum class Arithmetic {
+        FixedPoint,  // inteiros de 16 bits, pesos Q15 (padrão com AVX2)
+        Float        // referência (padrão sem AVX2)
+    };
+
+private:
+    std::shared_ptr<const Lut3D> lut;
+    Lut3DF lutFloat;
+    Lut3DSampler sampler;
+    Lut3DFixed fixedSampler;
+    float strength = 1.0f;
+    ChromaMode chromaMode = ChromaMode::Full;
+    Interpolation interpolation = Interpolation::Trilinear;
+    Arithmetic arithmetic = defaultArithmetic();
+    bool dither = false;
+    ThreadPool* pool;
+
+    // Croma 2x2: blocos com R-G ou B-G variando mais que isto (em 0..510,
+    // Lut3DFixed::chromaSpread) são corrigidos pixel a pixel
+    static constexpr int CHROMA_EDGE = 16;
+
+public:
+    explicit CpuFilter(ThreadPool& threadPool = ThreadPool::shared()) : pool(&threadPool) {
+        setLUT(Lut3D::fromCorrection(32, CorrectionMethod::Hybrid));
+    }
+
+    // O sampler aponta para 'lut': não copiar
+    CpuFilter(const CpuFilter&) = delete;
+    CpuFilter& operator=(const CpuFilter&) = delete;
+
+    void setLUT(const Lut3D& newLut) {
+        if (!newLut.isValid()) return;
+        setSharedLUT(std::make_shared<const Lut3D>(newLut));
+    }
+
+    // Usa a LUT sem copiar; quem compartilha não pode alterá-la depois
+    void setSharedLUT(std::shared_ptr<const Lut3D> newLut) {
+        if (!newLut || !newLut->isValid()) return;
+        lut = std::move(newLut);
+        lutFloat = Lut3DF::fromLut3D(*lut);
+        sampler.bind(*lut);
+        fixedSampler.bind(*lut, Lut3DFixed::fastestLayout(lut->size));
+    }
+
+    // LUT float de precisão total para o caminho HDR (ex.: Lut3DF::fromFunction)
+    void setFloatLUT(const Lut3DF& newLut) {
+        if (newLut.isValid()) lutFloat = newLut;
+    }
+
+    const Lut3D& getLUT() const { return *lut; }
+    std::shared_ptr<const Lut3D> getSharedLUT() const { return lut; }
+
+    // Layout da tabela do ponto fixo; por padrão o mais rápido medido para
+    // o tamanho da LUT (a saída é a mesma em todos)
+    void setFixedLayout(Lut3DFixed::Layout layout) { fixedSampler.bind(*lut, layout); }
+    Lut3DFixed::Layout getFixedLayout() const { return fixedSampler.getLayout(); }
+
+    void setStrength(float value) { strength = std::min(1.0f, std::max(0.0f, value)); }
+    float getStrength() const { return strength; }
+
+    void setChromaMode(ChromaMode mode) { chromaMode = mode; }
+    ChromaMode getChromaMode() const { return chromaMode; }
+
+    // Só frames de 8 bits; o caminho de alta profundidade é sempre trilinear
+    void setInterpolation(Interpolation mode) { interpolation = mode; }
+    Interpolation getInterpolation() const { return interpolation; }
+
+    // Só frames de 8 bits; o caminho de alta profundidade é sempre em float
+    void setArithmetic(Arithmetic mode) { arithmetic = mode; }
+    Arithmetic getArithmetic() const { return arithmetic; }
+
+    // Ruído azul no arredondamento para 8 bits (só frame inteiro, BGRA8)
+    void setDither(bool enable) {
+        if (enable) BlueNoise::tile();  // gerado aqui, não no primeiro frame
+        dither = enable;
+    }
+    bool getDither() const { return dither; }
+
+    static Arithmetic defaultArithmetic() {
+        return Lut3DFixed::bestLevel() == Lut3DFixed::Level::AVX2 ? Arithmetic::FixedPoint : Arithmetic::Float;
+    }
+
+    // Frames BGRA8 compactos (width*4 bytes por linha); src e dst podem ser iguais
+    void apply(const uint8_t* src, uint8_t* dst, int width, int height) {
+        applyBGRA(src, width * 4, dst, width * 4, width, height);
+    }
+
+    // BGRA8, RGB10A2 ou RGBA16F; src e dst com o mesmo formato e tamanho
+    bool apply(const FrameView& src, const FrameView& dst) {
+        if (src.format != dst.format || src.width != dst.width || src.height != dst.height) return false;
+
+        switch (src.format) {
+            case PixelFormat::BGRA8:
+                applyBGRA(src.planes[0], src.strides[0], dst.planes[0], dst.strides[0], src.width, src.height);
+                return true;
+            case PixelFormat::RGB10A2:
+            case PixelFormat::RGBA16F:
+                pool->parallelFor(0, src.height, 16, [&](int from, int to) {
+                    applyHighDepthRows(src, dst, from, to);
+                });
+                return true;
+            default:
+                return false;  // YUV: ver YuvFilter
+        }
+    }
+
+    // Trilinear em 8 pontos da grade (ou o mais próximo); saída em [0, 255]
+    void lookup(uint8_t r, uint8_t g, uint8_t b, float out[3]) const {
+        if (interpolation == Interpolation::Nearest) {
+            sampler.sampleNearest(r, g, b, out);
+        } else {
+            sampler.sample(r, g, b, out);
+        }
+    }
+
+private:
+    static uint8_t toByte(float v) {
+        return (uint8_t)std::min(255.0f, std::max(0.0f, v + 0.5f));
+    }
+
+    // 'offset' em (0, 1) no lugar do 0.5 (BlueNoise::offset)
+    static uint8_t toByteDithered(float v, float offset) {
+        return (uint8_t)std::min(255.0f, std::max(0.0f, v + offset));
+    }
+
+    void applyBGRA(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride, int width, int height) {
+        if (chromaMode == ChromaMode::Half) {
+            int blockRows = (height + 1) / 2;
+            pool->parallelFor(0, blockRows, 8, [&](int from, int to) {
+                applyHalfChromaRows(src, srcStride, dst, dstStride, width, height, from, to);
+            });
+        } else {
+            pool->parallelFor(0, height, 16, [&](int from, int to) {
+                applyFullRows(src, srcStride, dst, dstStride, width, from, to);
+            });
+        }
+    }
+
+    void applyFullRows(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+                       int width, int rowBegin, int rowEnd) const {
+        if (arithmetic == Arithmetic::FixedPoint) {
+            const int strengthQ15 = Lut3DFixed::strengthWeight(strength);
+            const BlueNoise& noise = BlueNoise::tile();
+            for (int y = rowBegin; y < rowEnd; y++) {
+                const uint8_t* s = src + (size_t)y * srcStride;
+                uint8_t* d = dst + (size_t)y * dstStride;
+                const bool nearestPoint = interpolation == Interpolation::Nearest;
+                if (dither) {
+                    const uint32_t* thresholds = noise.thresholdRow(y);
+                    if (nearestPoint) {
+                        fixedSampler.applyBGRANearestDithered(s, d, width, strengthQ15, thresholds, 0);
+                    } else {
+                        fixedSampler.applyBGRADithered(s, d, width, strengthQ15, thresholds, 0);
+                    }
+                } else if (nearestPoint) {
+                    fixedSampler.applyBGRANearest(s, d, width, strengthQ15);
+                } else {
+                    fixedSampler.applyBGRA(s, d, width, strengthQ15);
+                }
+            }
+            return;
+        }
+        const BlueNoise& noise = BlueNoise::tile();
+        float corrected[3];
+        for (int y = rowBegin; y < rowEnd; y++) {
+            const uint8_t* s = src + (size_t)y * srcStride;
+            uint8_t* d = dst + (size_t)y * dstStride;
+            for (int x = 0; x < width; x++, s += 4, d += 4) {
+                uint8_t b = s[0], g = s[1], r = s[2], a = s[3];
+                lookup(r, g, b, corrected);
+                if (dither) {
+                    float offset = noise.offset(x, y);
+                    d[0] = toByteDithered(b + (corrected[2] - b) * strength, offset);
+                    d[1] = toByteDithered(g + (corrected[1] - g) * strength, offset);
+                    d[2] = toByteDithered(r + (corrected[0] - r) * strength, offset);
+                } else {
+                    d[0] = toByte(b + (corrected[2] - b) * strength);
+                    d[1] = toByte(g + (corrected[1] - g) * strength);
+                    d[2] = toByte(r + (corrected[0] - r) * strength);
+                }
+                d[3] = a;
+            }
+        }
+    }
+
+    // Sem dither: o croma 2x2 também não tem
+    void correctPixels(const uint8_t* s, uint8_t* d, int count) const {
+        float corrected[3];
+        for (int x = 0; x < count; x++, s += 4, d += 4) {
+            uint8_t b = s[0], g = s[1], r = s[2], a = s[3];
+            lookup(r, g, b, corrected);
+            d[0] = toByte(b + (corrected[2] - b) * strength);
+            d[1] = toByte(g + (corrected[1] - g) * strength);
+            d[2] = toByte(r + (corrected[0] - r) * strength);
+            d[3] = a;
+        }
+    }
+
+    // Luma/croma separados: a correção é calculada sobre a média de cada
+    // bloco 2x2 e o deslocamento resultante (dY, dCb, dCr - por ser linear,
+    // equivale ao delta em RGB) é somado a cada pixel. Assim o detalhe de
+    // luminância continua em resolução total e a LUT roda 4x menos, mas a
+    // média e a soma dos deltas ficam: em 1080p o ganho medido é ~2.5-3x
+    // em conteúdo liso (./colorbench chroma).
+    //
+    // Em uma borda de croma a média é uma cor que nenhum pixel do bloco tem
+    // (ΔE ~140 com a LUT LMS nas barras): esses blocos são corrigidos pixel a
+    // pixel, e o par de linhas inteiro quando eles são a maioria. Texto
+    // colorido fica em ~1.4x e ruído custa o mesmo que a resolução total.
+    // A decisão é sobre os bytes de entrada (Lut3DFixed::chromaEdges), a
+    // mesma no float e no ponto fixo.
+    void applyHalfChromaRows(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+                             int width, int height, int blockRowBegin, int blockRowEnd) const {
+        if (arithmetic == Arithmetic::FixedPoint) {
+            applyHalfChromaRowsFixed(src, srcStride, dst, dstStride, width, height, blockRowBegin, blockRowEnd);
+            return;
+        }
+        const int blocks = (width + 1) / 2;
+        thread_local std::vector<int> edges;
+        edges.resize(blocks);
+
+        float corrected[3];
+        for (int by = blockRowBegin; by < blockRowEnd; by++) {
+            int y0 = by * 2;
+            int rows = std::min(2, height - y0);
+            const uint8_t* row0 = src + (size_t)y0 * srcStride;
+            const uint8_t* row1 = rows == 2 ? row0 + srcStride : row0;
+            size_t edgeCount = Lut3DFixed::chromaEdges(row0, row1, width, CHROMA_EDGE, edges.data());
+            if (edgeCount * 2 > (size_t)blocks) {
+                for (int dy = 0; dy < rows; dy++) {
+                    correctPixels(src + (size_t)(y0 + dy) * srcStride, dst + (size_t)(y0 + dy) * dstStride, width);
+                }
+                continue;
+            }
+
+            size_t nextEdge = 0;
+            for (int x0 = 0; x0 < width; x0 += 2) {
+                int cols = std::min(2, width - x0);
+
+                if (nextEdge < edgeCount && edges[nextEdge] == x0 / 2) {
+                    nextEdge++;
+                    for (int dy = 0; dy < rows; dy++) {
+                        size_t offset = (size_t)x0 * 4;
+                        correctPixels(src + (size_t)(y0 + dy) * srcStride + offset,
+                                      dst + (size_t)(y0 + dy) * dstStride + offset, cols);
+                    }
+                    continue;
+                }
+
+                int sum[3] = { 0, 0, 0 };
+                for (int dy = 0; dy < rows; dy++) {
+                    const uint8_t* s = src + (size_t)(y0 + dy) * srcStride + (size_t)x0 * 4;
+                    for (int dx = 0; dx < cols; dx++, s += 4) {
+                        sum[0] += s[0];
+                        sum[1] += s[1];
+                        sum[2] += s[2];
+                    }
+                }
+                int count = rows * cols;
+                uint8_t avgB = (uint8_t)((sum[0] + count / 2) / count);
+                uint8_t avgG = (uint8_t)((sum[1] + count / 2) / count);
+                uint8_t avgR = (uint8_t)((sum[2] + count / 2) / count);
+
+                lookup(avgR, avgG, avgB, corrected);
+                float deltaB = (corrected[2] - avgB) * strength;
+                float deltaG = (corrected[1] - avgG) * strength;
+                float deltaR = (corrected[0] - avgR) * strength;
+
+                for (int dy = 0; dy < rows; dy++) {
+                    const uint8_t* s = src + (size_t)(y0 + dy) * srcStride + (size_t)x0 * 4;
+                    uint8_t* d = dst + (size_t)(y0 + dy) * dstStride + (size_t)x0 * 4;
+                    for (int dx = 0; dx < cols; dx++, s += 4, d += 4) {
+                        uint8_t a = s[3];
+                        d[0] = toByte(s[0] + deltaB);
+                        d[1] = toByte(s[1] + deltaG);
+                        d[2] = toByte(s[2] + deltaR);
+                        d[3] = a;
+                    }
+                }
+            }
+        }
+    }
+
+    // Mesmo bloco 2x2 em inteiros: as médias de um par de linhas viram uma
+    // linha de meia largura, que passa pelo kernel de ponto fixo (SIMD) com
+    // a intensidade; o delta (saída - média) é somado a cada pixel do bloco.
+    // Os pixels dos blocos com borda de croma são copiados antes (src e dst
+    // podem ser iguais), passam juntos pelo kernel e sobrescrevem o delta.
+    void applyHalfChromaRowsFixed(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+                                  int width, int height, int blockRowBegin, int blockRowEnd) const {
+        const int strengthQ15 = Lut3DFixed::strengthWeight(strength);
+        const int blocks = (width + 1) / 2;
+        const bool nearestPoint = interpolation == Interpolation::Nearest;
+        thread_local std::vector<uint8_t> averages, mixed, edgePixels, edgeMixed;
+        thread_local std::vector<int> edges;
+        averages.resize((size_t)blocks * 4);
+        mixed.resize((size_t)blocks * 4);
+        edgePixels.resize((size_t)blocks * 16);
+        edgeMixed.resize((size_t)blocks * 16);
+        edges.resize(blocks);
+
+        auto filter = [&](const uint8_t* s, uint8_t* d, int count) {
+            if (nearestPoint) {
+                fixedSampler.applyBGRANearest(s, d, count, strengthQ15);
+            } else {
+                fixedSampler.applyBGRA(s, d, count, strengthQ15);
+            }
+        };
+
+        for (int by = blockRowBegin; by < blockRowEnd; by++) {
+            int y0 = by * 2;
+            int rows = std::min(2, height - y0);
+            const uint8_t* row0 = src + (size_t)y0 * srcStride;
+            const uint8_t* row1 = rows == 2 ? row0 + srcStride : row0;  // linha única: média só na horizontal
+            size_t edgeCount = Lut3DFixed::chromaEdges(row0, row1, width, CHROMA_EDGE, edges.data());
+            if (edgeCount * 2 > (size_t)blocks) {
+                for (int dy = 0; dy < rows; dy++) {
+                    filter(src + (size_t)(y0 + dy) * srcStride, dst + (size_t)(y0 + dy) * dstStride, width);
+                }
+                continue;
+            }
+
+            // Pixels das bordas: as linhas de cada bloco em sequência
+            uint8_t* gathered = edgePixels.data();
+            for (size_t e = 0; e < edgeCount; e++) {
+                int x0 = edges[e] * 2, cols = std::min(2, width - x0);
+                for (int dy = 0; dy < rows; dy++, gathered += cols * 4) {
+                    std::memcpy(gathered, (dy == 0 ? row0 : row1) + (size_t)x0 * 4, (size_t)cols * 4);
+                }
+            }
+            const int edgeLength = (int)((gathered - edgePixels.data()) / 4);
+
+            Lut3DFixed::averageBlocks(row0, row1, averages.data(), width);
+            filter(averages.data(), mixed.data(), blocks);
+            if (edgeLength > 0) filter(edgePixels.data(), edgeMixed.data(), edgeLength);
+
+            for (int dy = 0; dy < rows; dy++) {
+                Lut3DFixed::addBlockDeltas(src + (size_t)(y0 + dy) * srcStride, dst + (size_t)(y0 + dy) * dstStride,
+                                           width, averages.data(), mixed.data());
+            }
+
+            const uint8_t* corrected = edgeMixed.data();
+            for (size_t e = 0; e < edgeCount; e++) {
+                int x0 = edges[e] * 2, cols = std::min(2, width - x0);
+                for (int dy = 0; dy < rows; dy++, corrected += cols * 4) {
+                    std::memcpy(dst + (size_t)(y0 + dy) * dstStride + (size_t)x0 * 4, corrected, (size_t)cols * 4);
+                }
+            }
+        }
+    }
+
+    // ---------- Alta profundidade: linha -> float RGBA -> LUT float -> linha ----------
+
+    static void unpackRow(const FrameView& frame, int y, float* rgba) {
+        const uint8_t* row = frame.planes[0] + (size_t)y * frame.strides[0];
+        if (frame.format == PixelFormat::RGBA16F) {
+            Half::toFloat((const uint16_t*)row, rgba, (size_t)frame.width * 4);
+            return;
+        }
+        for (int x = 0; x < frame.width; x++) {
+            uint32_t v;
+            std::memcpy(&v, row + (size_t)x * 4, 4);
+            rgba[x * 4 + 0] = (v & 0x3FF) * (1.0f / 1023.0f);
+            rgba[x * 4 + 1] = ((v >> 10) & 0x3FF) * (1.0f / 1023.0f);
+            rgba[x * 4 + 2] = ((v >> 20) & 0x3FF) * (1.0f / 1023.0f);
+            rgba[x * 4 + 3] = (v >> 30) * (1.0f / 3.0f);
+        }
+    }
+
+    static void packRow(const float* rgba, const FrameView& frame, int y) {
+        uint8_t* row = frame.planes[0] + (size_t)y * frame.strides[0];
+        if (frame.format == PixelFormat::RGBA16F) {
+            Half::fromFloat(rgba, (uint16_t*)row, (size_t)frame.width * 4);
+            return;
+        }
+        auto quantize = [](float v, float maxValue) {
+            v = v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;
+            return (uint32_t)(v * maxValue + 0.5f);
+        };
+        for (int x = 0; x < frame.width; x++) {
+            const float* p = rgba + x * 4;
+            uint32_t v = quantize(p[0], 1023.0f) | (quantize(p[1], 1023.0f) << 10) |
+                         (quantize(p[2], 1023.0f) << 20) | (quantize(p[3], 3.0f) << 30);
+            std::memcpy(row + (size_t)x * 4, &v, 4);
+        }
+    }
+
+    void applyHighDepthRows(const FrameView& src, const FrameView& dst, int rowBegin, int rowEnd) const {
+        thread_local std::vector<float> rgba;
+        rgba.resize((size_t)src.width * 4);
+        float corrected[3];
+
+        const bool linear = src.format == PixelFormat::RGBA16F;
+        for (int y = rowBegin; y < rowEnd; y++) {
+            unpackRow(src, y, rgba.data());
+            for (int x = 0; x < src.width; x++) {
+                float* p = &rgba[(size_t)x * 4];
+                float cr = std::min(1.0f, std::max(0.0f, p[0]));
+                float cg = std::min(1.0f, std::max(0.0f, p[1]));
+                float cb = std::min(1.0f, std::max(0.0f, p[2]));
+                if (linear) {
+                    lutFloat.sample(SRGB::toSRGBFast(cr), SRGB::toSRGBFast(cg), SRGB::toSRGBFast(cb), corrected);
+                    for (float& c : corrected) c = SRGB::toLinearFast(c);
+                } else {
+                    lutFloat.sample(cr, cg, cb, corrected);
+                }
+                p[0] += (corrected[0] - cr) * strength;
+                p[1] += (corrected[1] - cg) * strength;
+                p[2] += (corrected[2] - cb) * strength;
+            }
+            packRow(rgba.data(), dst, y);
+        }
+    }
+};
+
+#endif // CPU_FILTER_H
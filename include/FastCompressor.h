@@ -0,0 +1,176 @@
+#ifndef FAST_COMPRESSOR_H
+#define FAST_COMPRESSOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ==================== COMPRESSOR RÁPIDO (LZ) ====================
+// LZ77 no estilo do LZ4, sem dependências: cada sequência é um token (4 bits
+// de comprimento de literais + 4 bits de comprimento do match), os literais,
+// e um deslocamento de 2 bytes para trás. Procura matches de 4 bytes em uma
+// tabela hash de uma entrada e acelera o passo quando não acha nada (dados
+// incompressíveis passam quase na velocidade de memcpy). Pensado para os
+// deltas da gravação: blocos XOR o frame anterior, com muitos zeros.
+//
+// Não é compatível com o formato LZ4 (o fim do bloco não segue as regras de
+// MFLIMIT/LASTLITERALS); o descompressor confere todos os limites.
+class FastCompressor {
+private:
+    static const int minMatch = 4;
+    static const int hashBits = 14;
+    static const int maxOffset = 65535;
+
+    static uint32_t read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    static uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - hashBits); }
+
+    static uint8_t* writeLength(uint8_t* out, size_t length) {
+        while (length >= 255) {
+            *out++ = 255;
+            length -= 255;
+        }
+        *out++ = (uint8_t)length;
+        return out;
+    }
+
+public:
+    // Pior caso (nada comprimível): um token + extensões a cada 255 literais
+    static size_t maxCompressedSize(size_t bytes) { return bytes + bytes / 255 + 16; }
+
+    // dst com pelo menos maxCompressedSize(bytes); devolve os bytes escritos
+    static size_t compress(const uint8_t* src, size_t bytes, uint8_t* dst) {
+        std::vector<uint32_t> table(1u << hashBits, 0);
+        const uint8_t* const end = src + bytes;
+        const uint8_t* const matchLimit = bytes > minMatch ? end - minMatch : src;
+        const uint8_t* anchor = src;
+        const uint8_t* ip = src + 1;  // posição 0 fica como "vazia" na tabela
+        uint8_t* out = dst;
+
+        while (ip < matchLimit) {
+            // Procura: o passo cresce a cada 32 tentativas sem match
+            const uint8_t* match = nullptr;
+            unsigned attempts = 0;
+            while (ip < matchLimit) {
+                uint32_t sequence = read32(ip);
+                uint32_t& entry = table[hash(sequence)];
+                const uint8_t* candidate = src + entry;
+                entry = (uint32_t)(ip - src);
+                if (candidate > src && ip - candidate <= maxOffset && read32(candidate) == sequence) {
+                    match = candidate;
+                    break;
+                }
+                ip += 1 + (attempts++ >> 5);
+            }
+            if (!match) break;
+
+            // Estende para trás sobre os literais pendentes
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+            const uint8_t* matchEnd = ip + minMatch;
+            const uint8_t* ref = match + minMatch;
+            // 8 bytes por vez (corridas longas de zeros nos deltas); o resto byte a byte
+            while (end - matchEnd >= 8) {
+                uint64_t a, b;
+                std::memcpy(&a, matchEnd, 8);
+                std::memcpy(&b, ref, 8);
+                if (a != b) break;
+                matchEnd += 8;
+                ref += 8;
+            }
+            while (matchEnd < end && *matchEnd == *ref) {
+                matchEnd++;
+                ref++;
+            }
+
+            size_t literals = (size_t)(ip - anchor);
+            size_t matchLength = (size_t)(matchEnd - ip) - minMatch;
+            uint8_t* token = out++;
+            *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4 | (matchLength >= 15 ? 15 : matchLength));
+            if (literals >= 15) out = writeLength(out, literals - 15);
+            std::memcpy(out, anchor, literals);
+            out += literals;
+            uint16_t offset = (uint16_t)(ip - match);
+            std::memcpy(out, &offset, 2);
+            out += 2;
+            if (matchLength >= 15) out = writeLength(out, matchLength - 15);
+
+            ip = matchEnd;
+            anchor = ip;
+            if (ip < matchLimit) table[hash(read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+        }
+
+        // Últimos literais: token sem match (deslocamento omitido)
+        size_t literals = (size_t)(end - anchor);
+        uint8_t* token = out++;
+        *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) out = writeLength(out, literals - 15);
+        std::memcpy(out, anchor, literals);
+        out += literals;
+        return (size_t)(out - dst);
+    }
+
+    // false se os dados estiverem corrompidos ou não derem exatamente dstBytes
+    static bool decompress(const uint8_t* src, size_t bytes, uint8_t* dst, size_t dstBytes) {
+        const uint8_t* ip = src;
+        const uint8_t* const end = src + bytes;
+        uint8_t* op = dst;
+        uint8_t* const outEnd = dst + dstBytes;
+
+        while (ip < end) {
+            uint8_t token = *ip++;
+            size_t literals = token >> 4;
+            if (literals == 15) {
+                uint8_t b;
+                do {
+                    if (ip >= end) return false;
+                    b = *ip++;
+                    literals += b;
+                } while (b == 255);
+            }
+            if ((size_t)(end - ip) < literals || (size_t)(outEnd - op) < literals) return false;
+            std::memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == end) break;  // última sequência: só literais
+
+            if (end - ip < 2) return false;
+            uint16_t offset;
+            std::memcpy(&offset, ip, 2);
+            ip += 2;
+            size_t matchLength = token & 15;
+            if (matchLength == 15) {
+                uint8_t b;
+                do {
+                    if (ip >= end) return false;
+                    b = *ip++;
+                    matchLength += b;
+                } while (b == 255);
+            }
+            matchLength += minMatch;
+            if (offset == 0 || offset > op - dst || (size_t)(outEnd - op) < matchLength) return false;
+
+            // Com offset < comprimento o match repete os últimos 'offset' bytes
+            // (corridas de zeros): copia em blocos que dobram, sem sobrepor
+            const uint8_t* ref = op - offset;
+            size_t done = 0;
+            while (done < matchLength) {
+                size_t chunk = std::min((size_t)offset + done, matchLength - done);
+                std::memcpy(op + done, ref, chunk);
+                done += chunk;
+            }
+            op += matchLength;
+        }
+        return op == outEnd;
+    }
+};
+
+#endif // FAST_COMPRESSOR_H
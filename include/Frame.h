@@ -0,0 +1,178 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// ==================== DESCRITOR DE FRAME ====================
+// Visão (não dona) de um frame em memória: formato, dimensões, ponteiro e
+// bytes por linha de cada plano. Formatos planares 4:2:0 têm croma com
+// ((width+1)/2) x ((height+1)/2) amostras.
+//
+// O stride é qualquer valor >= bytes úteis da linha (RowPitch do DXGI,
+// padding do FramePool, ímpar inclusive) e todos os estágios o respeitam:
+// filtros, upload (GL_UNPACK_ROW_LENGTH) e gravadores. Nenhum estágio
+// reempacota o frame só para remover o padding.
+enum class PixelFormat {
+    BGRA8,    // 1 plano, 4 bytes por pixel (GDI/DXGI)
+    NV12,     // Y + UV intercalado
+    I420,     // Y + U + V (YUV 4:2:0 planar, o formato do Y4M)
+    RGB10A2,  // 1 plano, 32 bits: R bits 0-9, G 10-19, B 20-29, A 30-31 (desktop 10 bits)
+    RGBA16F   // 1 plano, 4 x float16 (scRGB linear, desktop HDR)
+};
+
+inline const char* pixelFormatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BGRA8: return "BGRA8";
+        case PixelFormat::NV12: return "NV12";
+        case PixelFormat::I420: return "I420";
+        case PixelFormat::RGB10A2: return "RGB10A2";
+        case PixelFormat::RGBA16F: return "RGBA16F";
+    }
+    return "?";
+}
+
+// Bytes por pixel de formatos empacotados (0 para planares)
+inline int bytesPerPixel(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BGRA8: return 4;
+        case PixelFormat::RGB10A2: return 4;
+        case PixelFormat::RGBA16F: return 8;
+        default: return 0;
+    }
+}
+
+struct FrameView {
+    PixelFormat format = PixelFormat::BGRA8;
+    int width = 0;
+    int height = 0;
+    uint8_t* planes[3] = { nullptr, nullptr, nullptr };
+    int strides[3] = { 0, 0, 0 };  // bytes por linha de cada plano
+    int64_t timestampUs = 0;
+
+    int planeCount() const {
+        switch (format) {
+            case PixelFormat::NV12: return 2;
+            case PixelFormat::I420: return 3;
+            default: return 1;
+        }
+    }
+
+    int chromaWidth() const { return (width + 1) / 2; }
+    int chromaHeight() const { return (height + 1) / 2; }
+
+    int planeHeight(int plane) const { return plane == 0 ? height : chromaHeight(); }
+
+    // Bytes úteis de uma linha do plano (sem o padding do stride)
+    int rowBytes(int plane) const {
+        switch (format) {
+            case PixelFormat::NV12: return plane == 0 ? width : chromaWidth() * 2;
+            case PixelFormat::I420: return plane == 0 ? width : chromaWidth();
+            default: return width * bytesPerPixel(format);
+        }
+    }
+
+    uint8_t* row(int plane, int y) const { return planes[plane] + (size_t)y * strides[plane]; }
+
+    bool isCompact() const {
+        for (int p = 0; p < planeCount(); p++) {
+            if (strides[p] != rowBytes(p)) return false;
+        }
+        return true;
+    }
+
+    // Stride em pixels para GL_UNPACK_ROW_LENGTH (plano 0 de formatos
+    // empacotados), ou 0 se o stride não é múltiplo do pixel (ex.: ímpar)
+    int unpackRowLength() const {
+        int bpp = bytesPerPixel(format);
+        if (bpp == 0 || strides[0] % bpp != 0) return 0;
+        return strides[0] / bpp;
+    }
+
+    // Sub-retângulo sem cópia (mesmos strides). Em 4:2:0 x e y precisam ser
+    // pares para o croma alinhar; fora do frame devolve uma visão vazia.
+    FrameView subView(int x, int y, int w, int h) const {
+        FrameView v;
+        v.format = format;
+        v.timestampUs = timestampUs;
+        bool planar = planeCount() > 1;
+        if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > width || y + h > height ||
+            (planar && ((x | y) & 1))) {
+            return v;
+        }
+        v.width = w;
+        v.height = h;
+        for (int p = 0; p < planeCount(); p++) {
+            int px = x, py = y, bytes = bytesPerPixel(format);
+            if (planar) {
+                bytes = (format == PixelFormat::NV12 && p == 1) ? 2 : 1;
+                if (p > 0) { px = x / 2; py = y / 2; }
+            }
+            v.planes[p] = planes[p] + (size_t)py * strides[p] + (size_t)px * bytes;
+            v.strides[p] = strides[p];
+        }
+        return v;
+    }
+
+    // Tamanho em bytes de um frame compacto (sem padding entre linhas)
+    static size_t compactSize(PixelFormat format, int width, int height) {
+        size_t luma = (size_t)width * height;
+        size_t chroma = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+        switch (format) {
+            case PixelFormat::NV12: return luma + chroma * 2;
+            case PixelFormat::I420: return luma + chroma * 2;
+            default: return luma * bytesPerPixel(format);
+        }
+    }
+
+    // Visão sobre um buffer compacto, planos em sequência
+    static FrameView wrap(PixelFormat format, uint8_t* data, int width, int height) {
+        FrameView v;
+        v.format = format;
+        v.width = width;
+        v.height = height;
+        int cw = (width + 1) / 2, ch = (height + 1) / 2;
+        switch (format) {
+            case PixelFormat::BGRA8:
+            case PixelFormat::RGB10A2:
+            case PixelFormat::RGBA16F:
+                v.planes[0] = data;
+                v.strides[0] = width * bytesPerPixel(format);
+                break;
+            case PixelFormat::NV12:
+                v.planes[0] = data;
+                v.strides[0] = width;
+                v.planes[1] = data + (size_t)width * height;
+                v.strides[1] = cw * 2;
+                break;
+            case PixelFormat::I420:
+                v.planes[0] = data;
+                v.strides[0] = width;
+                v.planes[1] = data + (size_t)width * height;
+                v.strides[1] = cw;
+                v.planes[2] = v.planes[1] + (size_t)cw * ch;
+                v.strides[2] = cw;
+                break;
+        }
+        return v;
+    }
+};
+
+// Copia os pixels de 'src' para 'dst' (mesmo formato e tamanho), linha a
+// linha quando algum dos strides tem padding
+inline bool copyFrame(const FrameView& src, const FrameView& dst) {
+    if (src.format != dst.format || src.width != dst.width || src.height != dst.height) return false;
+    for (int p = 0; p < src.planeCount(); p++) {
+        size_t bytes = (size_t)src.rowBytes(p);
+        int rows = src.planeHeight(p);
+        if (src.strides[p] == dst.strides[p] && (size_t)src.strides[p] == bytes) {
+            std::memcpy(dst.planes[p], src.planes[p], bytes * rows);
+            continue;
+        }
+        for (int y = 0; y < rows; y++) std::memcpy(dst.row(p, y), src.row(p, y), bytes);
+    }
+    return true;
+}
+
+#endif // FRAME_H
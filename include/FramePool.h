@@ -0,0 +1,284 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Frame.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // std::min/std::max nos outros headers
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// ==================== POOL DE FRAMES ====================
+// Buffers de frame reaproveitados: alinhados em 64 bytes (linha de cache /
+// AVX-512), linhas com padding e, opcionalmente, em huge pages (2 MB), o que
+// tira um frame 4K (~33 MB) de ~8000 entradas de TLB para ~16. Em regime os
+// frames só circulam entre o pool e os handles: nenhuma alocação e nenhum
+// page fault por frame.
+//
+// FrameHandle é contado por referência (sem alocação: o contador fica no
+// slot); o último handle devolve o buffer ao pool. O pool precisa viver mais
+// que todos os handles.
+
+enum class HugePages {
+    Off,          // páginas normais
+    Transparent,  // THP: madvise(MADV_HUGEPAGE) em região alinhada a 2 MB
+    Explicit      // MAP_HUGETLB / MEM_LARGE_PAGES; cai para Transparent se o sistema negar
+};
+
+class FramePool;
+
+struct FrameSlot {
+    FramePool* owner = nullptr;
+    std::atomic<int> refs{0};
+    uint8_t* memory = nullptr;
+    size_t capacity = 0;
+    bool hugeMapped = false;   // veio de MAP_HUGETLB / MEM_LARGE_PAGES
+    FrameView view;
+};
+
+class FrameHandle {
+private:
+    FrameSlot* slot = nullptr;
+
+public:
+    FrameHandle() {}
+    explicit FrameHandle(FrameSlot* s) : slot(s) { if (slot) slot->refs++; }
+    FrameHandle(const FrameHandle& other) : slot(other.slot) { if (slot) slot->refs++; }
+    FrameHandle(FrameHandle&& other) noexcept : slot(other.slot) { other.slot = nullptr; }
+    ~FrameHandle() { reset(); }
+
+    FrameHandle& operator=(FrameHandle other) noexcept {
+        std::swap(slot, other.slot);
+        return *this;
+    }
+
+    void reset();
+
+    explicit operator bool() const { return slot != nullptr; }
+    FrameView& view() { return slot->view; }
+    const FrameView& view() const { return slot->view; }
+    uint8_t* data() const { return slot->view.planes[0]; }
+    int useCount() const { return slot ? slot->refs.load() : 0; }
+};
+
+class FramePool {
+public:
+    struct Options {
+        HugePages hugePages = HugePages::Transparent;
+        bool padStrides = true;  // false: linhas compactas (ex.: GetDIBits escreve width*4)
+        int preallocate = 3;     // front + back + um em uso pelo consumidor
+    };
+
+private:
+    std::mutex mutex;
+    std::vector<FrameSlot*> slots;
+    std::vector<FrameSlot*> freeSlots;  // capacidade = slots.size(): devolver não aloca
+
+    PixelFormat format;
+    int width, height;
+    Options options;
+    FrameView layout;       // planes[] são offsets a partir do início do buffer
+    size_t frameBytes = 0;
+    std::atomic<int> allocations{0};
+
+public:
+    FramePool(PixelFormat fmt, int w, int h, Options opts)
+        : format(fmt), width(w), height(h), options(opts) {
+        computeLayout();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < options.preallocate; i++) {
+            freeSlots.push_back(createSlot());
+        }
+    }
+
+    FramePool(PixelFormat fmt, int w, int h) : FramePool(fmt, w, h, Options()) {}
+
+    ~FramePool() {
+        for (FrameSlot* slot : slots) {
+            freeMemory(*slot);
+            delete slot;
+        }
+    }
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Troca de resolução/formato: slots maiores que o necessário são
+    // reaproveitados; os menores crescem quando forem adquiridos
+    void reconfigure(PixelFormat fmt, int w, int h) {
+        std::lock_guard<std::mutex> lock(mutex);
+        format = fmt;
+        width = w;
+        height = h;
+        computeLayout();
+    }
+
+    FrameHandle acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        FrameSlot* slot;
+        if (freeSlots.empty()) {
+            slot = createSlot();
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        if (slot->capacity < frameBytes) {
+            freeMemory(*slot);
+            allocateMemory(*slot);
+        }
+        if (!slot->memory) {
+            // Sem memória: handle vazio (o slot volta para a lista e tenta de novo no próximo)
+            freeSlots.push_back(slot);
+            return FrameHandle();
+        }
+        bindView(*slot);
+        return FrameHandle(slot);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    PixelFormat getFormat() const { return format; }
+    size_t getFrameBytes() const { return frameBytes; }
+    int getStride(int plane = 0) const { return layout.strides[plane]; }
+
+    // Total de alocações desde a criação: constante em regime
+    int getAllocationCount() const { return allocations; }
+    int getSlotCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int)slots.size();
+    }
+
+    // Linha arredondada para 64 bytes. Múltiplos de 4 KB ganham mais 64: com
+    // linhas de exatamente 4 KB, pixels na mesma coluna caem no mesmo conjunto
+    // da cache (aliasing) em passes verticais e blocos 2x2.
+    static int paddedStride(int rowBytes) {
+        int stride = (rowBytes + 63) & ~63;
+        if (stride % 4096 == 0) stride += 64;
+        return stride;
+    }
+
+private:
+    friend class FrameHandle;
+
+    void release(FrameSlot* slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeSlots.push_back(slot);
+    }
+
+    FrameSlot* createSlot() {
+        FrameSlot* slot = new FrameSlot();
+        slot->owner = this;
+        allocateMemory(*slot);
+        slots.push_back(slot);
+        freeSlots.reserve(slots.size());
+        return slot;
+    }
+
+    void computeLayout() {
+        FrameView compact = FrameView::wrap(format, nullptr, width, height);
+        layout = compact;
+        size_t offset = 0;
+        for (int p = 0; p < compact.planeCount(); p++) {
+            int rows = (p == 0) ? height : compact.chromaHeight();
+            int rowBytes = compact.strides[p];
+            layout.strides[p] = options.padStrides ? paddedStride(rowBytes) : rowBytes;
+            layout.planes[p] = (uint8_t*)(uintptr_t)offset;
+            offset += (size_t)layout.strides[p] * rows;
+            offset = (offset + 63) & ~(size_t)63;  // cada plano começa alinhado
+        }
+        frameBytes = offset;
+    }
+
+    void bindView(FrameSlot& slot) const {
+        slot.view = layout;
+        for (int p = 0; p < layout.planeCount(); p++) {
+            slot.view.planes[p] = slot.memory + (uintptr_t)layout.planes[p];
+        }
+    }
+
+    // ---------- Memória ----------
+
+    static const size_t hugePageSize = 2 * 1024 * 1024;
+
+    // capacity só muda quando a alocação deu certo: slot sem memória fica com 0
+    void allocateMemory(FrameSlot& slot) {
+        allocations++;
+        slot.hugeMapped = false;
+        const bool huge = options.hugePages != HugePages::Off;
+        size_t size = huge ? (frameBytes + hugePageSize - 1) & ~(hugePageSize - 1)
+                           : (frameBytes + 63) & ~(size_t)63;
+
+#ifdef _WIN32
+        if (options.hugePages == HugePages::Explicit) {
+            // Exige o privilégio SeLockMemoryPrivilege; sem ele cai para páginas normais
+            size_t large = GetLargePageMinimum();
+            if (large > 0) {
+                size_t largeSize = (size + large - 1) & ~(large - 1);
+                void* p = VirtualAlloc(NULL, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (p) {
+                    slot.memory = (uint8_t*)p;
+                    slot.capacity = largeSize;
+                    slot.hugeMapped = true;
+                    return;
+                }
+            }
+        }
+        slot.memory = (uint8_t*)VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (slot.memory) slot.capacity = size;
+#else
+#ifdef MAP_HUGETLB
+        if (options.hugePages == HugePages::Explicit) {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                slot.memory = (uint8_t*)p;
+                slot.capacity = size;
+                slot.hugeMapped = true;
+                return;
+            }
+        }
+#endif
+        void* p = nullptr;
+        if (posix_memalign(&p, huge ? hugePageSize : 64, size) != 0) p = nullptr;
+#ifdef MADV_HUGEPAGE
+        if (p && huge) madvise(p, size, MADV_HUGEPAGE);
+#endif
+        slot.memory = (uint8_t*)p;
+        if (p) slot.capacity = size;
+#endif
+    }
+
+    static void freeMemory(FrameSlot& slot) {
+        if (!slot.memory) return;
+#ifdef _WIN32
+        VirtualFree(slot.memory, 0, MEM_RELEASE);
+#else
+        if (slot.hugeMapped) {
+            munmap(slot.memory, slot.capacity);
+        } else {
+            std::free(slot.memory);
+        }
+#endif
+        slot.memory = nullptr;
+        slot.capacity = 0;
+    }
+};
+
+inline void FrameHandle::reset() {
+    if (slot && --slot->refs == 0) {
+        slot->owner->release(slot);
+    }
+    slot = nullptr;
+}
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,214 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+#include "FramePool.h"
+#include "TestFrames.h"
+#include "UploadRing.h"
+
+// ==================== FONTE DE FRAMES ====================
+// Interface comum das capturas (GDI por monitor em main.cpp) e das fontes
+// sintéticas usadas em Linux. A fonte mantém front/back buffers e publica o
+// frame mais recente; o consumidor lê com readLatest() enquanto o lock está
+// preso, então o buffer não é trocado no meio da leitura.
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    virtual bool initialize() = 0;
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+    virtual int getWidth() const = 0;
+    virtual int getHeight() const = 0;
+    virtual PixelFormat getFormat() const = 0;
+    virtual int getFrameCount() const = 0;
+
+    // Chama fn com o frame mais recente; false se ainda não há frame
+    virtual bool readLatest(const std::function<void(const FrameView&)>& fn) = 0;
+
+    // Zero cópia: a fonte passa a escrever cada frame direto em um slot do
+    // destino (PBOs de upload, anel compartilhado) e readLatest fica sem
+    // frames. false se a fonte não sabe escrever em memória externa.
+    virtual bool attachWriteTarget(FrameWriteTarget* target) { (void)target; return false; }
+
+    // Bytes de frame escritos pela própria fonte (para medir cópias por frame)
+    virtual uint64_t getBytesWritten() const { return 0; }
+
+    // Captura 1 de cada 'divisor' frames da taxa nominal (governador de
+    // qualidade); fontes que não controlam a própria taxa ignoram
+    virtual void setRateDivisor(int divisor) { (void)divisor; }
+
+    // Custo da última captura em ms (métricas por etapa)
+    virtual double getCaptureMs() const { return 0.0; }
+
+    // Recebe cada frame novo na thread da fonte, antes de publicá-lo (gravação,
+    // ver Recording.h). O listener pode guardar o handle: enquanto ele estiver
+    // em uso a fonte escreve os próximos frames em outro buffer do pool, então
+    // ninguém precisa copiar. Configurar antes de start(). Só no caminho com
+    // cópia: com destino de escrita o frame está em memória de upload, que a
+    // CPU não deve ler. false se a fonte não suporta.
+    using FrameListener = std::function<void(const FrameHandle&)>;
+    virtual bool setFrameListener(FrameListener listener) { (void)listener; return false; }
+};
+
+// ==================== FONTE SINTÉTICA ====================
+// Gera frames BGRA8 em uma thread própria, na taxa pedida, a partir de um
+// TestFrames deslocado a cada frame (simula conteúdo em movimento). Os
+// buffers vêm de um FramePool (linhas com padding, huge pages).
+class SyntheticFrameSource : public FrameSource {
+private:
+    int width, height;
+    int fps;
+    TestFrames::Kind kind;
+
+    std::vector<uint8_t> pattern;  // 2x a largura, para deslocar sem recalcular
+    FramePool pool;
+    FrameHandle frontBuffer;
+    FrameHandle backBuffer;
+    int64_t frontTimestampUs = 0;
+
+    std::mutex bufferMutex;
+    std::thread generatorThread;
+    std::atomic<bool> running;
+    std::atomic<int> frameCount;
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<int> rateDivisor{1};
+    std::atomic<int64_t> captureMicros{0};
+    std::atomic<int> movingRows;  // só as primeiras linhas se movem; o resto fica parado
+    FrameWriteTarget* writeTarget = nullptr;
+    FrameListener frameListener;
+
+public:
+    SyntheticFrameSource(int w, int h, int framesPerSecond = 60,
+                         TestFrames::Kind content = TestFrames::Kind::ColorBars)
+        : width(w), height(h), fps(framesPerSecond), kind(content),
+          pool(PixelFormat::BGRA8, w, h), running(false), frameCount(0), movingRows(h) {}
+
+    ~SyntheticFrameSource() override { stop(); }
+
+    bool initialize() override {
+        if (width <= 0 || height <= 0) return false;
+        pattern = TestFrames::make(kind, width * 2, height);
+        frontBuffer = pool.acquire();
+        backBuffer = pool.acquire();
+        return frontBuffer && backBuffer;
+    }
+
+    void start() override {
+        if (running) return;
+        running = true;
+        generatorThread = std::thread(&SyntheticFrameSource::generatorLoop, this);
+    }
+
+    void stop() override {
+        if (!running) return;
+        running = false;
+        if (generatorThread.joinable()) generatorThread.join();
+    }
+
+    int getWidth() const override { return width; }
+    int getHeight() const override { return height; }
+    PixelFormat getFormat() const override { return PixelFormat::BGRA8; }
+    int getFrameCount() const override { return frameCount; }
+
+    bool readLatest(const std::function<void(const FrameView&)>& fn) override {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (frameCount == 0 || writeTarget) return false;
+        FrameView view = frontBuffer.view();
+        view.timestampUs = frontTimestampUs;
+        fn(view);
+        return true;
+    }
+
+    bool attachWriteTarget(FrameWriteTarget* target) override {
+        if (running || target->getFormat() != PixelFormat::BGRA8 ||
+            target->getWidth() != width || target->getHeight() != height) {
+            return false;
+        }
+        writeTarget = target;
+        return true;
+    }
+
+    uint64_t getBytesWritten() const override { return bytesWritten; }
+
+    void setRateDivisor(int divisor) override { rateDivisor = std::max(1, divisor); }
+    double getCaptureMs() const override { return captureMicros / 1000.0; }
+
+    bool setFrameListener(FrameListener listener) override {
+        frameListener = std::move(listener);
+        return true;
+    }
+
+    // Fração das linhas (a partir do topo) que muda a cada frame; o resto é
+    // estático, como uma janela parada em volta de um gráfico que atualiza.
+    // Pode mudar com a fonte rodando
+    void setMovingFraction(float fraction) {
+        movingRows = std::max(0, std::min(height, (int)(height * fraction + 0.5f)));
+    }
+
+    // Gera o próximo frame imediatamente (usado por testes/benchmarks sem thread)
+    void produceFrame() {
+        using namespace std::chrono;
+        int n = frameCount.load();
+        int shift = (n * 8) % width;
+        auto begin = steady_clock::now();
+        int64_t now = duration_cast<microseconds>(begin.time_since_epoch()).count();
+
+        if (writeTarget) {
+            int slot = writeTarget->beginWrite();
+            if (slot < 0) return;  // upload atrasado: descarta
+            writePattern(writeTarget->view(slot), shift);
+            writeTarget->commitWrite(slot, now);
+            captureMicros = duration_cast<microseconds>(steady_clock::now() - begin).count();
+            frameCount++;
+            return;
+        }
+
+        if (!backBuffer || backBuffer.useCount() > 1) backBuffer = pool.acquire();  // ainda com o listener
+        if (!backBuffer) return;  // sem memória: perde este frame
+        writePattern(backBuffer.view(), shift);
+        backBuffer.view().timestampUs = now;
+        if (frameListener) frameListener(backBuffer);
+        {
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            std::swap(frontBuffer, backBuffer);
+            frontTimestampUs = now;
+        }
+        captureMicros = duration_cast<microseconds>(steady_clock::now() - begin).count();
+        frameCount++;
+    }
+
+private:
+    void writePattern(const FrameView& target, int shift) {
+        const int moving = movingRows;
+        for (int y = 0; y < height; y++) {
+            int rowShift = y < moving ? shift : 0;
+            std::memcpy(target.planes[0] + (size_t)y * target.strides[0],
+                        &pattern[((size_t)y * width * 2 + rowShift) * 4], (size_t)width * 4);
+        }
+        bytesWritten += (uint64_t)width * height * 4;
+    }
+
+    void generatorLoop() {
+        using namespace std::chrono;
+        const auto interval = microseconds(1000000 / (fps > 0 ? fps : 60));
+        auto next = steady_clock::now();
+        while (running) {
+            produceFrame();
+            next += interval * rateDivisor.load();
+            std::this_thread::sleep_until(next);
+        }
+    }
+};
+
+#endif // FRAME_SOURCE_H
@@ -0,0 +1,49 @@
+#ifndef GL_FORMATS_H
+#define GL_FORMATS_H
+
+#include <glad/glad.h>
+#include "Frame.h"
+
+// ==================== FORMATOS DE UPLOAD OPENGL ====================
+// Tradução PixelFormat -> (internalFormat, format, type) para glTexImage2D.
+// Fontes de 10 bits e FP16 sobem sem passar por 8 bits.
+struct GLPixelFormat {
+    GLint internalFormat;
+    GLenum format;
+    GLenum type;
+};
+
+// 'srgb': decodificação sRGB por hardware (só existe para 8 bits; FP16 já é linear)
+inline bool glFormatFor(PixelFormat pixelFormat, bool srgb, GLPixelFormat& out) {
+    switch (pixelFormat) {
+        case PixelFormat::BGRA8:
+            out = { srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE };
+            return true;
+        case PixelFormat::RGB10A2:
+            out = { GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV };
+            return true;
+        case PixelFormat::RGBA16F:
+            out = { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT };
+            return true;
+        default:
+            return false;  // Formatos planares não sobem como uma única textura
+    }
+}
+
+// Configura o unpack para ler o plano 0 de 'frame' com o stride dele
+// (GL_UNPACK_ROW_LENGTH), sem reempacotar. Retorna false se o stride não é
+// múltiplo do pixel; aí quem chama copia para um buffer compacto.
+inline bool setUnpackLayout(const FrameView& frame) {
+    int rowLength = frame.unpackRowLength();
+    if (rowLength == 0) return false;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength == frame.width ? 0 : rowLength);
+    return true;
+}
+
+inline void resetUnpackLayout() {
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+#endif // GL_FORMATS_H
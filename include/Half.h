@@ -0,0 +1,119 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "CpuFeatures.h"
+
+// ==================== FLOAT16 (HALF) ====================
+// Conversões IEEE 754 binary16 <-> float. Em lote usa F16C (vcvtph2ps /
+// vcvtps2ph, 8 valores por instrução); o caminho escalar é a referência.
+class Half {
+public:
+    static float toFloat(uint16_t h) {
+        uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+        uint32_t exponent = (h >> 10) & 0x1F;
+        uint32_t mantissa = h & 0x3FF;
+        uint32_t bits;
+
+        if (exponent == 0) {
+            if (mantissa == 0) {
+                bits = sign;
+            } else {
+                // Subnormal: normalizar
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400) == 0) {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+            }
+        } else if (exponent == 31) {
+            bits = sign | 0x7F800000 | (mantissa << 13);  // Inf/NaN
+        } else {
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // Arredondamento para o par mais próximo (igual ao vcvtps2ph modo 0)
+    static uint16_t fromFloat(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t absBits = bits & 0x7FFFFFFF;
+
+        if (absBits >= 0x7F800000) {
+            return (uint16_t)(sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0));
+        }
+        if (absBits >= 0x477FF000) {
+            return (uint16_t)(sign | 0x7C00);  // estouro -> Inf
+        }
+        if (absBits < 0x38800000) {
+            // Subnormal ou zero em half
+            if (absBits < 0x33000000) return (uint16_t)sign;
+            uint32_t exponent = absBits >> 23;
+            uint32_t mantissa = (absBits & 0x7FFFFF) | 0x800000;
+            uint32_t shift = 126 - exponent;
+            uint32_t value = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (value & 1))) value++;
+            return (uint16_t)(sign | value);
+        }
+
+        uint32_t value = ((absBits >> 13) - ((127 - 15) << 10));
+        uint32_t remainder = absBits & 0x1FFF;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (value & 1))) value++;
+        return (uint16_t)(sign | value);
+    }
+
+    static void toFloat(const uint16_t* src, float* dst, size_t count) {
+        size_t i = 0;
+#if DALTONISMO_X86_SIMD
+        if (CpuFeatures::get().f16c) {
+            i = toFloatF16C(src, dst, count);
+        }
+#endif
+        for (; i < count; i++) dst[i] = toFloat(src[i]);
+    }
+
+    static void fromFloat(const float* src, uint16_t* dst, size_t count) {
+        size_t i = 0;
+#if DALTONISMO_X86_SIMD
+        if (CpuFeatures::get().f16c) {
+            i = fromFloatF16C(src, dst, count);
+        }
+#endif
+        for (; i < count; i++) dst[i] = fromFloat(src[i]);
+    }
+
+private:
+#if DALTONISMO_X86_SIMD
+    DALTONISMO_TARGET("avx,f16c")
+    static size_t toFloatF16C(const uint16_t* src, float* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("avx,f16c")
+    static size_t fromFloatF16C(const float* src, uint16_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 f = _mm256_loadu_ps(src + i);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+        }
+        return i;
+    }
+#endif
+};
+
+#endif // HALF_H
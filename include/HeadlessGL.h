@@ -0,0 +1,85 @@
+#ifndef HEADLESS_GL_H
+#define HEADLESS_GL_H
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <string>
+
+// ==================== CONTEXTO OPENGL SEM JANELA ====================
+// Contexto GL 3.3 core via EGL "surfaceless" (Mesa): sem janela, sem X11 e
+// sem GPU - no CI cai no llvmpipe. As ferramentas renderizam em um FBO e
+// leem com glReadPixels. Só existe onde há EGL (Linux); o overlay continua
+// usando GLFW + WGL.
+class HeadlessGL {
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    bool ownsDisplay = false;  // contexto compartilhado: o display é do dono
+    EGLint version[2] = { 3, 3 };
+
+public:
+    ~HeadlessGL() { destroy(); }
+
+    bool create(int major = 3, int minor = 3) {
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                                     : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) return false;
+        ownsDisplay = true;
+        if (!eglBindAPI(EGL_OPENGL_API)) return false;
+
+        version[0] = major;
+        version[1] = minor;
+        const EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, major,
+            EGL_CONTEXT_MINOR_VERSION, minor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        // Sem superfície não precisamos de EGLConfig (EGL_KHR_no_config_context)
+        context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+        if (context == EGL_NO_CONTEXT) return false;
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) return false;
+        return gladLoadGLLoader((GLADloadproc)eglGetProcAddress) != 0;
+    }
+
+    // Segundo contexto que compartilha objetos com 'owner' (programas,
+    // texturas), para outra thread; não fica atual aqui: a thread dele chama
+    // makeCurrent(). Destruir antes do dono.
+    bool createShared(const HeadlessGL& owner) {
+        display = owner.display;
+        ownsDisplay = false;
+        const EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, owner.version[0],
+            EGL_CONTEXT_MINOR_VERSION, owner.version[1],
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, EGL_NO_CONFIG_KHR, owner.context, attributes);
+        return context != EGL_NO_CONTEXT;
+    }
+
+    bool isCreated() const { return context != EGL_NO_CONTEXT; }
+
+    bool makeCurrent() { return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context); }
+    void release() { eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT); }
+
+    void destroy() {
+        if (display == EGL_NO_DISPLAY) return;
+        if (ownsDisplay) eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+        if (ownsDisplay) eglTerminate(display);
+        context = EGL_NO_CONTEXT;
+        display = EGL_NO_DISPLAY;
+        ownsDisplay = false;
+    }
+
+    std::string renderer() const {
+        const char* name = (const char*)glGetString(GL_RENDERER);
+        const char* version = (const char*)glGetString(GL_VERSION);
+        return std::string(name ? name : "?") + " | " + (version ? version : "?");
+    }
+};
+
+#endif // HEADLESS_GL_H
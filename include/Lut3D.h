@@ -0,0 +1,253 @@
+#ifndef LUT_3D_H
+#define LUT_3D_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "ColorCorrection.h"
+
+// ==================== LUT 3D EM MEMÓRIA (CPU) ====================
+// Representação canônica de uma LUT NxNxN com saída RGB8.
+// Índice: ((b * N + g) * N + r) * 3  ->  vermelho varia mais rápido.
+//
+// Formato de "faixa" (strip) usado nos PNGs e na textura da GPU, o mesmo
+// lido pelo shader de main.cpp:
+//   horizontal (N*N x N): x = g * N + r, y = b   (verde escolhe a fatia)
+//   vertical   (N x N*N): x = b, y = g * N + r   (transposta da horizontal)
+struct Lut3D {
+    int size = 0;
+    std::vector<uint8_t> data;
+
+    bool isValid() const { return size >= 2 && data.size() == (size_t)size * size * size * 3; }
+
+    const uint8_t* at(int r, int g, int b) const {
+        return &data[(((size_t)b * size + g) * size + r) * 3];
+    }
+
+    uint8_t* at(int r, int g, int b) {
+        return &data[(((size_t)b * size + g) * size + r) * 3];
+    }
+
+    // Converte uma faixa (PNG/textura) para a forma canônica
+    static Lut3D fromStrip(const uint8_t* pixels, int width, int height, int channels) {
+        Lut3D lut;
+        bool horizontal = (width == height * height);
+        bool vertical = (height == width * width);
+        if (!pixels || channels < 3 || !(horizontal || vertical)) return lut;
+
+        lut.size = horizontal ? height : width;
+        const int n = lut.size;
+        lut.data.resize((size_t)n * n * n * 3);
+        for (int b = 0; b < n; b++) {
+            for (int g = 0; g < n; g++) {
+                for (int r = 0; r < n; r++) {
+                    int x = horizontal ? g * n + r : b;
+                    int y = horizontal ? b : g * n + r;
+                    const uint8_t* src = pixels + ((size_t)y * width + x) * channels;
+                    uint8_t* dst = lut.at(r, g, b);
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
+        }
+        return lut;
+    }
+
+    // Faixa horizontal RGB8 (N*N x N), pronta para glTexImage2D
+    std::vector<uint8_t> toStrip() const {
+        const int n = size;
+        const int width = n * n;
+        std::vector<uint8_t> strip((size_t)width * n * 3);
+        for (int b = 0; b < n; b++) {
+            for (int g = 0; g < n; g++) {
+                for (int r = 0; r < n; r++) {
+                    const uint8_t* src = at(r, g, b);
+                    uint8_t* dst = &strip[((size_t)b * width + g * n + r) * 3];
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
+        }
+        return strip;
+    }
+
+    // Amostra uma função de cor nos pontos da grade
+    static Lut3D fromFunction(int size, const std::function<RGB(RGB)>& fn) {
+        Lut3D lut;
+        lut.size = size;
+        lut.data.resize((size_t)size * size * size * 3);
+        const float scale = 1.0f / (size - 1);
+        for (int b = 0; b < size; b++) {
+            for (int g = 0; g < size; g++) {
+                for (int r = 0; r < size; r++) {
+                    RGB out = fn({ r * scale, g * scale, b * scale });
+                    uint8_t* dst = lut.at(r, g, b);
+                    dst[0] = toByte(out.r);
+                    dst[1] = toByte(out.g);
+                    dst[2] = toByte(out.b);
+                }
+            }
+        }
+        return lut;
+    }
+
+    static Lut3D fromCorrection(int size, CorrectionMethod method) {
+        return fromFunction(size, [method](RGB c) { return ColorCorrection::apply(method, c); });
+    }
+
+    static uint8_t toByte(float v) {
+        if (!(v > 0.0f)) return 0;
+        if (v >= 1.0f) return 255;
+        return (uint8_t)(v * 255.0f + 0.5f);
+    }
+};
+
+// ==================== LUT 3D EM FLOAT ====================
+// Mesma indexação de Lut3D, com saída float em [0, 1]. Usada para fontes de
+// alta profundidade (10 bits, FP16), onde a grade de 8 bits quantizaria o
+// resultado, e espelha a textura GL_RGB16F da GPU.
+struct Lut3DF {
+    int size = 0;
+    std::vector<float> data;
+
+    bool isValid() const { return size >= 2 && data.size() == (size_t)size * size * size * 3; }
+
+    const float* at(int r, int g, int b) const {
+        return &data[(((size_t)b * size + g) * size + r) * 3];
+    }
+
+    static Lut3DF fromLut3D(const Lut3D& lut) {
+        Lut3DF out;
+        out.size = lut.size;
+        out.data.resize(lut.data.size());
+        for (size_t i = 0; i < lut.data.size(); i++) {
+            out.data[i] = lut.data[i] / 255.0f;
+        }
+        return out;
+    }
+
+    // Sem quantização: as correções matemáticas mantêm precisão total
+    static Lut3DF fromFunction(int size, const std::function<RGB(RGB)>& fn) {
+        Lut3DF lut;
+        lut.size = size;
+        lut.data.resize((size_t)size * size * size * 3);
+        const float scale = 1.0f / (size - 1);
+        float* dst = lut.data.data();
+        for (int b = 0; b < size; b++) {
+            for (int g = 0; g < size; g++) {
+                for (int r = 0; r < size; r++) {
+                    RGB out = fn({ r * scale, g * scale, b * scale });
+                    *dst++ = out.r;
+                    *dst++ = out.g;
+                    *dst++ = out.b;
+                }
+            }
+        }
+        return lut;
+    }
+
+    // Trilinear; entradas fora de [0, 1] são limitadas à borda
+    void sample(float r, float g, float b, float out[3]) const {
+        int ir, ig, ib;
+        float fr = axis(r, ir), fg = axis(g, ig), fb = axis(b, ib);
+        const size_t strideG = (size_t)size * 3;
+        const size_t strideB = (size_t)size * size * 3;
+        const float* c000 = at(ir, ig, ib);
+
+        for (int ch = 0; ch < 3; ch++) {
+            const float* c = c000 + ch;
+            float c00 = c[0] + (c[3] - c[0]) * fr;
+            float c10 = c[strideG] + (c[strideG + 3] - c[strideG]) * fr;
+            float c01 = c[strideB] + (c[strideB + 3] - c[strideB]) * fr;
+            float c11 = c[strideB + strideG] + (c[strideB + strideG + 3] - c[strideB + strideG]) * fr;
+            float c0 = c00 + (c10 - c00) * fg;
+            float c1 = c01 + (c11 - c01) * fg;
+            out[ch] = c0 + (c1 - c0) * fb;
+        }
+    }
+
+private:
+    float axis(float v, int& index) const {
+        v = v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;  // NaN -> 0
+        float pos = v * (size - 1);
+        index = (int)pos < size - 2 ? (int)pos : size - 2;
+        return pos - index;
+    }
+};
+
+// ==================== AMOSTRAGEM TRILINEAR ====================
+// Consulta uma Lut3D com interpolação trilinear. A versão de 8 bits usa uma
+// tabela (índice, fração) por valor de entrada, montada em bind().
+// sampleNearest lê só o ponto mais próximo da grade (1 leitura em vez de 8),
+// o degrau mais barato do governador de qualidade.
+class Lut3DSampler {
+private:
+    struct AxisEntry {
+        int index;
+        float frac;
+    };
+
+    const Lut3D* lut = nullptr;
+    AxisEntry axis[256];
+    uint8_t nearest[256];
+
+public:
+    void bind(const Lut3D& target) {
+        lut = &target;
+        for (int v = 0; v < 256; v++) {
+            axis[v] = axisEntry(v / 255.0f);
+            nearest[v] = (uint8_t)(axis[v].index + (axis[v].frac >= 0.5f ? 1 : 0));
+        }
+    }
+
+    bool isBound() const { return lut && lut->isValid(); }
+
+    // Entradas de 8 bits; saída em [0, 255]
+    void sample(uint8_t r, uint8_t g, uint8_t b, float out[3]) const {
+        interpolate(axis[r], axis[g], axis[b], out);
+    }
+
+    // Ponto da grade mais próximo; saída em [0, 255]
+    void sampleNearest(uint8_t r, uint8_t g, uint8_t b, float out[3]) const {
+        const uint8_t* c = lut->at(nearest[r], nearest[g], nearest[b]);
+        out[0] = c[0];
+        out[1] = c[1];
+        out[2] = c[2];
+    }
+
+    // Entradas em [0, 1]; saída em [0, 255]
+    void sample(float r, float g, float b, float out[3]) const {
+        interpolate(axisEntry(r), axisEntry(g), axisEntry(b), out);
+    }
+
+private:
+    AxisEntry axisEntry(float v) const {
+        const int n = lut->size;
+        v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+        float pos = v * (n - 1);
+        int index = (int)pos < n - 2 ? (int)pos : n - 2;
+        return { index, pos - index };
+    }
+
+    void interpolate(const AxisEntry& ar, const AxisEntry& ag, const AxisEntry& ab, float out[3]) const {
+        const int n = lut->size;
+        const size_t strideG = (size_t)n * 3;
+        const size_t strideB = (size_t)n * n * 3;
+        const uint8_t* c000 = lut->at(ar.index, ag.index, ab.index);
+
+        for (int ch = 0; ch < 3; ch++) {
+            const uint8_t* c = c000 + ch;
+            float c00 = c[0] + (c[3] - c[0]) * ar.frac;
+            float c10 = c[strideG] + (c[strideG + 3] - c[strideG]) * ar.frac;
+            float c01 = c[strideB] + (c[strideB + 3] - c[strideB]) * ar.frac;
+            float c11 = c[strideB + strideG] + (c[strideB + strideG + 3] - c[strideB + strideG]) * ar.frac;
+            float c0 = c00 + (c10 - c00) * ag.frac;
+            float c1 = c01 + (c11 - c01) * ag.frac;
+            out[ch] = c0 + (c1 - c0) * ab.frac;
+        }
+    }
+};
+
+#endif // LUT_3D_H
@@ -0,0 +1,565 @@
+#ifndef LUT_3D_FIXED_H
+#define LUT_3D_FIXED_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "CpuFeatures.h"
+#include "Lut3D.h"
+
+// ==================== TRILINEAR EM PONTO FIXO (8 BITS) ====================
+// Caminho inteiro do CpuFilter para frames BGRA8: nada de float por pixel.
+// Cada canal vira um inteiro de 16 bits com 7 bits de fração (v << 7, até
+// 32640), os pesos são Q15 e cada interpolação é
+//   a + mulhrs(b - a, peso)      mulhrs(x, w) = (x * w + 2^14) >> 15
+// a mesma conta do pmulhrsw. São 7 interpolações (4 em r, 2 em g, 1 em b)
+// e uma oitava para a intensidade, com a origem como 'a'. O arredondamento
+// de cada passo fica abaixo de 1/128 de LSB: o resultado fica a até 1 LSB
+// do trilinear em float.
+//
+// A LUT é copiada para uma tabela de bytes em que um gather de 32 bits traz
+// os 3 canais de um ponto da grade (B, G, R, na ordem dos bytes do BGRA),
+// em um de três layouts:
+//   Linear    4 bytes por ponto, vermelho varia mais rápido (32^3: 128 KB)
+//   Packed24  3 bytes por ponto, mesma ordem (96 KB); o quarto byte lido é
+//             do ponto seguinte e é ignorado
+//   Tiled     4 bytes por ponto em blocos 4x4x4 de 256 bytes (Morton dentro
+//             do bloco): os 8 cantos de uma célula caem quase sempre em 4
+//             linhas de cache vizinhas, em vez de 4 linhas espalhadas por 4 KB
+// Os três dão a mesma saída; qual é mais rápido depende do cache da máquina,
+// então fastestLayout() mede uma vez por tamanho de LUT (./colorbench layout).
+//
+// O deslocamento de um ponto é a soma de uma parte por eixo, então bind()
+// monta, para cada valor de entrada e eixo, o deslocamento em bytes do ponto
+// de baixo, do de cima e do mais próximo, mais o peso Q15 (mesma conta do
+// Lut3DSampler). A versão AVX2 processa 16 pixels por iteração (dois grupos
+// de 8, contas em 16 bits nas duas metades); o laço escalar faz exatamente as
+// mesmas contas, então a saída não depende do nível nem de onde a linha
+// termina.
+//
+// O ponto mais próximo da grade (degrau barato do QualityGovernor) usa a
+// mesma tabela: 1 gather de cantos em vez de 8 e só a interpolação da
+// intensidade.
+//
+// Dither: as versões "Dithered" trocam o +64 do arredondamento final (Q7 ->
+// byte) pelo limiar do pixel em uma linha de ruído azul (BlueNoise.h,
+// thresholdRow), sem passada extra: a mesma conta com outra constante por
+// pixel. O resultado fica a até 1 LSB do arredondado. averageBlocks()/addBlockDeltas() são as duas pontas do croma
+// 2x2 do CpuFilter, com o meio (a linha de médias) no mesmo kernel.
+class Lut3DFixed {
+public:
+    enum class Level { Scalar, AVX2 };
+
+    enum class Layout { Linear, Packed24, Tiled };
+    static const int layoutCount = 3;
+
+    static Level bestLevel() {
+        static const Level level = CpuFeatures::get().avx2 ? Level::AVX2 : Level::Scalar;
+        return level;
+    }
+
+    static bool isSupported(Level level) { return level == Level::Scalar || CpuFeatures::get().avx2; }
+
+    static const char* levelName(Level level) { return level == Level::AVX2 ? "AVX2" : "escalar"; }
+
+    static const char* layoutName(Layout layout) {
+        switch (layout) {
+            case Layout::Packed24: return "24 bits";
+            case Layout::Tiled: return "blocos 4x4x4";
+            default: return "linear";
+        }
+    }
+
+    // Intensidade [0, 1] -> peso Q15 da última interpolação
+    static int strengthWeight(float strength) {
+        strength = strength < 0.0f ? 0.0f : (strength > 1.0f ? 1.0f : strength);
+        return (int)(strength * 32767.0f + 0.5f);
+    }
+
+private:
+    int size = 0;
+    Layout layout = Layout::Linear;
+    std::vector<uint8_t> table;   // pontos no layout escolhido + 4 bytes de folga
+    int32_t weight[256];          // peso Q15 do ponto de cima, igual nos 3 eixos
+    int32_t lower[3][256];        // por eixo (r, g, b): bytes até o ponto de baixo
+    int32_t upper[3][256];        // ... até o de cima
+    int32_t nearest[3][256];      // ... até o mais próximo
+
+public:
+    void bind(const Lut3D& lut, Layout newLayout = Layout::Linear) {
+        const int n = lut.size;
+        size = n;
+        layout = newLayout;
+        table.assign(tableBytes(n, layout) + 4, 0);
+        for (int b = 0; b < n; b++) {
+            for (int g = 0; g < n; g++) {
+                for (int r = 0; r < n; r++) {
+                    const uint8_t* c = lut.at(r, g, b);
+                    uint8_t* point = &table[axisOffset(0, r) + axisOffset(1, g) + axisOffset(2, b)];
+                    point[0] = c[2];
+                    point[1] = c[1];
+                    point[2] = c[0];
+                }
+            }
+        }
+        for (int v = 0; v < 256; v++) {
+            float pos = (v / 255.0f) * (n - 1);
+            int index = (int)pos < n - 2 ? (int)pos : n - 2;
+            int w = (int)((pos - index) * 32768.0f + 0.5f);
+            int closest = index + (pos - index >= 0.5f ? 1 : 0);
+            weight[v] = w < 32767 ? w : 32767;
+            for (int a = 0; a < 3; a++) {
+                lower[a][v] = (int32_t)axisOffset(a, index);
+                upper[a][v] = (int32_t)axisOffset(a, index + 1);
+                nearest[a][v] = (int32_t)axisOffset(a, closest);
+            }
+        }
+    }
+
+    Layout getLayout() const { return layout; }
+
+    // Bytes ocupados pelos pontos de uma LUT NxNxN no layout
+    static size_t tableBytes(int n, Layout layout) {
+        if (layout == Layout::Tiled) {
+            size_t tiles = (size_t)(n + 3) / 4;
+            return tiles * tiles * tiles * 256;
+        }
+        return (size_t)n * n * n * (layout == Layout::Packed24 ? 3 : 4);
+    }
+
+    // Layout mais rápido nesta máquina para LUTs NxNxN: mede os três uma vez
+    // por tamanho (LUT e pixels sintéticos, ~10 ms) e guarda o resultado.
+    // Outro layout só ganha do linear se for pelo menos 5% mais rápido.
+    static Layout fastestLayout(int n) {
+        static std::mutex mutex;
+        static std::map<int, Layout> measured;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = measured.find(n);
+        if (found != measured.end()) return found->second;
+
+        double times[layoutCount];
+        measureLayouts(n, 5, times);
+        Layout best = Layout::Linear;
+        for (int i = 1; i < layoutCount; i++) {
+            if (times[i] < times[(int)best] * 0.95) best = (Layout)i;
+        }
+        measured[n] = best;
+        return best;
+    }
+
+    // Melhor tempo (ms) de cada layout em 'rounds' passadas por 256x256
+    // pixels de ruído com uma LUT sintética NxNxN
+    static void measureLayouts(int n, int rounds, double times[layoutCount]) {
+        Lut3D lut;
+        lut.size = n;
+        lut.data.resize((size_t)n * n * n * 3);
+        uint32_t seed = 0x9E3779B9u;
+        for (uint8_t& v : lut.data) {
+            seed = seed * 1664525u + 1013904223u;
+            v = (uint8_t)(seed >> 24);
+        }
+        const size_t pixels = 256 * 256;
+        std::vector<uint8_t> src(pixels * 4), dst(pixels * 4);
+        for (uint8_t& v : src) {
+            seed = seed * 1664525u + 1013904223u;
+            v = (uint8_t)(seed >> 24);
+        }
+        // Layouts intercalados a cada passada: ruído da máquina afeta todos igual
+        Lut3DFixed fixed[layoutCount];
+        for (int i = 0; i < layoutCount; i++) {
+            fixed[i].bind(lut, (Layout)i);
+            times[i] = 1e30;
+        }
+        for (int round = 0; round < rounds; round++) {
+            for (int i = 0; i < layoutCount; i++) {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t row = 0; row < pixels; row += 256) {
+                    fixed[i].applyBGRA(&src[row * 4], &dst[row * 4], 256, 32767);
+                }
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                times[i] = ms < times[i] ? ms : times[i];
+            }
+        }
+    }
+
+    bool isBound() const { return size >= 2; }
+
+    // 'count' pixels BGRA8 contíguos (uma linha); src e dst podem ser iguais.
+    // O alfa passa direto.
+    void applyBGRA(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15, Level level = bestLevel()) const {
+        applyRow<false>(src, dst, count, strengthQ15, nullptr, 0, level);
+    }
+
+    void applyBGRANearest(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15,
+                          Level level = bestLevel()) const {
+        applyRow<true>(src, dst, count, strengthQ15, nullptr, 0, level);
+    }
+
+    // Com dither: 'thresholds' é a linha de limiares do ruído (64 + 8 de
+    // folga, limiar em B, G e R) e 'x' a coluna do primeiro pixel no frame
+    void applyBGRADithered(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15,
+                           const uint32_t* thresholds, int x, Level level = bestLevel()) const {
+        applyRow<false>(src, dst, count, strengthQ15, thresholds, x, level);
+    }
+
+    void applyBGRANearestDithered(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15,
+                                  const uint32_t* thresholds, int x, Level level = bestLevel()) const {
+        applyRow<true>(src, dst, count, strengthQ15, thresholds, x, level);
+    }
+
+    // Correção de um pixel BGRA, em Q7 (valor << 7), na ordem B, G, R
+    void sample(const uint8_t* bgra, int out[3]) const {
+        const uint8_t b = bgra[0], g = bgra[1], r = bgra[2];
+        const int wr = weight[r], wg = weight[g], wb = weight[b];
+        const int32_t gb00 = lower[1][g] + lower[2][b], gb10 = upper[1][g] + lower[2][b];
+        const int32_t gb01 = lower[1][g] + upper[2][b], gb11 = upper[1][g] + upper[2][b];
+        const int32_t r0 = lower[0][r], r1 = upper[0][r];
+        const uint32_t c000 = load(r0 + gb00), c100 = load(r1 + gb00), c010 = load(r0 + gb10), c110 = load(r1 + gb10);
+        const uint32_t c001 = load(r0 + gb01), c101 = load(r1 + gb01), c011 = load(r0 + gb11), c111 = load(r1 + gb11);
+        for (int ch = 0; ch < 3; ch++) {
+            const int shift = ch * 8;
+            int x00 = lerp(widen(c000, shift), widen(c100, shift), wr);
+            int x10 = lerp(widen(c010, shift), widen(c110, shift), wr);
+            int x01 = lerp(widen(c001, shift), widen(c101, shift), wr);
+            int x11 = lerp(widen(c011, shift), widen(c111, shift), wr);
+            out[ch] = lerp(lerp(x00, x10, wg), lerp(x01, x11, wg), wb);
+        }
+    }
+
+    void sampleNearest(const uint8_t* bgra, int out[3]) const {
+        uint32_t c = load(nearest[0][bgra[2]] + nearest[1][bgra[1]] + nearest[2][bgra[0]]);
+        for (int ch = 0; ch < 3; ch++) out[ch] = widen(c, ch * 8);
+    }
+
+    // Croma 2x2: média arredondada de cada bloco de 2x2 pixels de duas linhas
+    // ('row1' == 'row0' na última linha ímpar), um BGRA por bloco, alfa 0.
+    // Na última coluna ímpar o bloco tem só uma coluna.
+    static void averageBlocks(const uint8_t* row0, const uint8_t* row1, uint8_t* averages, size_t count,
+                              Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = averageBlocks_AVX2(row0, row1, averages, count);
+#endif
+        for (size_t x = done; x < count; x += 2) {
+            const uint8_t* s0 = row0 + x * 4;
+            const uint8_t* s1 = row1 + x * 4;
+            uint8_t* avg = averages + (x >> 1) * 4;
+            bool fullBlock = x + 1 < count;
+            for (int ch = 0; ch < 3; ch++) {
+                int sum = s0[ch] + s1[ch];
+                avg[ch] = (uint8_t)(fullBlock ? (sum + s0[ch + 4] + s1[ch + 4] + 2) >> 2 : (sum + 1) >> 1);
+            }
+            avg[3] = 0;
+        }
+    }
+
+    // Croma 2x2: variação de croma do bloco, a maior amplitude de R-G e de
+    // B-G entre os pixels (0..510). Borda só de luminância dá 0.
+    static int chromaSpread(const uint8_t* row0, const uint8_t* row1, int cols) {
+        int minRG = 255, maxRG = -255, minBG = 255, maxBG = -255;
+        for (int i = 0; i < cols * 2; i++) {
+            const uint8_t* p = (i < cols ? row0 : row1) + (i % cols) * 4;
+            int rg = p[2] - p[1], bg = p[0] - p[1];
+            minRG = std::min(minRG, rg);
+            maxRG = std::max(maxRG, rg);
+            minBG = std::min(minBG, bg);
+            maxBG = std::max(maxBG, bg);
+        }
+        return std::max(maxRG - minRG, maxBG - minBG);
+    }
+
+    // Croma 2x2: índices (em ordem) dos blocos com chromaSpread acima de
+    // 'threshold'; devolve quantos. 'edges' com espaço para um por bloco.
+    static size_t chromaEdges(const uint8_t* row0, const uint8_t* row1, size_t count, int threshold, int* edges,
+                              Level level = bestLevel()) {
+        size_t done = 0, found = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = chromaEdges_AVX2(row0, row1, count, threshold, edges, found);
+#endif
+        for (size_t x = done; x < count; x += 2) {
+            int cols = x + 1 < count ? 2 : 1;
+            if (chromaSpread(row0 + x * 4, row1 + x * 4, cols) > threshold) edges[found++] = (int)(x >> 1);
+        }
+        return found;
+    }
+
+    // Croma 2x2: o pixel x recebe (corrected - averages) do bloco x / 2, com
+    // saturação. 'averages' e 'corrected' têm um BGRA por bloco, alfa igual.
+    static void addBlockDeltas(const uint8_t* src, uint8_t* dst, size_t count, const uint8_t* averages,
+                               const uint8_t* corrected, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = addBlockDeltas_AVX2(src, dst, count, averages, corrected);
+#endif
+        for (size_t x = done; x < count; x++) {
+            const uint8_t* s = src + x * 4;
+            uint8_t* d = dst + x * 4;
+            const uint8_t* avg = averages + (x >> 1) * 4;
+            const uint8_t* out = corrected + (x >> 1) * 4;
+            uint8_t alpha = s[3];
+            for (int ch = 0; ch < 3; ch++) {
+                int v = s[ch] + out[ch] - avg[ch];
+                d[ch] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+            }
+            d[3] = alpha;
+        }
+    }
+
+private:
+    // Sem 'thresholds' todo pixel arredonda com +64 (meio LSB em Q7)
+    template <bool Nearest>
+    void applyRow(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15, const uint32_t* thresholds,
+                  int x, Level level) const {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = applyBGRA_AVX2<Nearest>(src, dst, count, strengthQ15, thresholds, x);
+#endif
+        int corrected[3];
+        for (size_t i = done; i < count; i++) {
+            if (Nearest) {
+                sampleNearest(src + i * 4, corrected);
+            } else {
+                sample(src + i * 4, corrected);
+            }
+            int rounding = thresholds ? (int)(thresholds[(x + i) & 63] & 0xFF) : 64;
+            blend(src + i * 4, corrected, strengthQ15, rounding, dst + i * 4);
+        }
+    }
+
+    // Bytes até o ponto de coordenada i no eixo a (0 = r, 1 = g, 2 = b)
+    size_t axisOffset(int a, int i) const {
+        const size_t n = (size_t)size;
+        switch (layout) {
+            case Layout::Packed24: return (size_t)i * (a == 0 ? 3 : (a == 1 ? 3 * n : 3 * n * n));
+            case Layout::Tiled: {
+                // Bloco (i / 4) e, dentro dele, bits de i intercalados com os
+                // dos outros eixos: r0 g0 b0 r1 g1 b1
+                const size_t tiles = (n + 3) / 4;
+                const size_t tileStride = a == 0 ? 1 : (a == 1 ? tiles : tiles * tiles);
+                const size_t inner = (size_t)((i & 1) | ((i & 2) << 2)) << a;
+                return ((size_t)(i >> 2) * tileStride * 64 + inner) * 4;
+            }
+            default: return (size_t)i * 4 * (a == 0 ? 1 : (a == 1 ? n : n * n));
+        }
+    }
+
+    uint32_t load(size_t offset) const {
+        uint32_t v;
+        std::memcpy(&v, &table[offset], 4);
+        return v;
+    }
+
+    static int widen(uint32_t packed, int shift) { return (int)((packed >> shift) & 0xFF) << 7; }
+
+    // Igual ao pmulhrsw: (x * w + 2^14) >> 15, com deslocamento aritmético
+    static int lerp(int a, int b, int w) { return a + (((b - a) * w + 0x4000) >> 15); }
+
+    static void blend(const uint8_t* s, const int corrected[3], int strengthQ15, int rounding, uint8_t* d) {
+        uint8_t a = s[3];
+        for (int ch = 0; ch < 3; ch++) {
+            d[ch] = (uint8_t)((lerp(s[ch] << 7, corrected[ch], strengthQ15) + rounding) >> 7);
+        }
+        d[3] = a;
+    }
+
+#if DALTONISMO_X86_SIMD
+    DALTONISMO_TARGET("avx2")
+    static __m256i lerp16(__m256i a, __m256i b, __m256i w) {
+        return _mm256_add_epi16(a, _mm256_mulhrs_epi16(_mm256_sub_epi16(b, a), w));
+    }
+
+    // Bytes -> 16 bits com 7 bits de fração. Metade 0 = pixels 0,1 | 4,5 do
+    // grupo de 8, metade 1 = 2,3 | 6,7 (unpack trabalha por metade de 128 bits)
+    template <int Half>
+    DALTONISMO_TARGET("avx2")
+    static __m256i widen(__m256i v) {
+        __m256i wide = Half == 0 ? _mm256_unpacklo_epi8(v, _mm256_setzero_si256())
+                                 : _mm256_unpackhi_epi8(v, _mm256_setzero_si256());
+        return _mm256_slli_epi16(wide, 7);
+    }
+
+    // Peso de cada pixel (nos dois 16 bits do lane) repetido nos 4 canais
+    template <int Half>
+    DALTONISMO_TARGET("avx2")
+    static __m256i spread(__m256i w) { return Half == 0 ? _mm256_unpacklo_epi32(w, w) : _mm256_unpackhi_epi32(w, w); }
+
+    template <int Half>
+    DALTONISMO_TARGET("avx2")
+    static __m256i interpolateHalf(__m256i px, __m256i c000, __m256i c100, __m256i c010, __m256i c110,
+                                   __m256i c001, __m256i c101, __m256i c011, __m256i c111,
+                                   __m256i wr, __m256i wg, __m256i wb, __m256i strength, __m256i rounding) {
+        __m256i r = spread<Half>(wr), g = spread<Half>(wg), b = spread<Half>(wb);
+        __m256i x00 = lerp16(widen<Half>(c000), widen<Half>(c100), r);
+        __m256i x10 = lerp16(widen<Half>(c010), widen<Half>(c110), r);
+        __m256i x01 = lerp16(widen<Half>(c001), widen<Half>(c101), r);
+        __m256i x11 = lerp16(widen<Half>(c011), widen<Half>(c111), r);
+        __m256i corrected = lerp16(lerp16(x00, x10, g), lerp16(x01, x11, g), b);
+        __m256i out = lerp16(widen<Half>(px), corrected, strength);
+        return _mm256_srli_epi16(_mm256_add_epi16(out, rounding), 7);
+    }
+
+    DALTONISMO_TARGET("avx2")
+    static __m256i gather(const int32_t* base, __m256i index) { return _mm256_i32gather_epi32((const int*)base, index, 4); }
+
+    // 8 pixels: deslocamentos e pesos pelas tabelas de eixo, cantos por
+    // gather em bytes, interpolação nas duas metades e volta para bytes.
+    // 'thresholds': arredondamento de cada pixel nos bytes B, G, R.
+    template <bool Nearest>
+    DALTONISMO_TARGET("avx2")
+    __m256i filter8(__m256i px, __m256i strength, __m256i thresholds) const {
+        const __m256i byteMask = _mm256_set1_epi32(0xFF);
+        const int* base = (const int*)table.data();
+        __m256i vb = _mm256_and_si256(px, byteMask);
+        __m256i vg = _mm256_and_si256(_mm256_srli_epi32(px, 8), byteMask);
+        __m256i vr = _mm256_and_si256(_mm256_srli_epi32(px, 16), byteMask);
+
+        const __m256i roundLo = _mm256_unpacklo_epi8(thresholds, _mm256_setzero_si256());
+        const __m256i roundHi = _mm256_unpackhi_epi8(thresholds, _mm256_setzero_si256());
+        __m256i lo, hi;
+        if (Nearest) {
+            __m256i offset = _mm256_add_epi32(_mm256_add_epi32(gather(nearest[0], vr), gather(nearest[1], vg)),
+                                              gather(nearest[2], vb));
+            __m256i c = _mm256_i32gather_epi32(base, offset, 1);
+            lo = lerp16(widen<0>(px), widen<0>(c), strength);
+            hi = lerp16(widen<1>(px), widen<1>(c), strength);
+            lo = _mm256_srli_epi16(_mm256_add_epi16(lo, roundLo), 7);
+            hi = _mm256_srli_epi16(_mm256_add_epi16(hi, roundHi), 7);
+        } else {
+            __m256i r0 = gather(lower[0], vr), r1 = gather(upper[0], vr);
+            __m256i g0 = gather(lower[1], vg), g1 = gather(upper[1], vg);
+            __m256i b0 = gather(lower[2], vb), b1 = gather(upper[2], vb);
+            __m256i gb00 = _mm256_add_epi32(g0, b0), gb10 = _mm256_add_epi32(g1, b0);
+            __m256i gb01 = _mm256_add_epi32(g0, b1), gb11 = _mm256_add_epi32(g1, b1);
+            __m256i c000 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r0, gb00), 1);
+            __m256i c100 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r1, gb00), 1);
+            __m256i c010 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r0, gb10), 1);
+            __m256i c110 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r1, gb10), 1);
+            __m256i c001 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r0, gb01), 1);
+            __m256i c101 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r1, gb01), 1);
+            __m256i c011 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r0, gb11), 1);
+            __m256i c111 = _mm256_i32gather_epi32(base, _mm256_add_epi32(r1, gb11), 1);
+
+            // Peso Q15 nos dois 16 bits de cada lane
+            __m256i wr = gather(weight, vr), wg = gather(weight, vg), wb = gather(weight, vb);
+            wr = _mm256_or_si256(wr, _mm256_slli_epi32(wr, 16));
+            wg = _mm256_or_si256(wg, _mm256_slli_epi32(wg, 16));
+            wb = _mm256_or_si256(wb, _mm256_slli_epi32(wb, 16));
+
+            lo = interpolateHalf<0>(px, c000, c100, c010, c110, c001, c101, c011, c111, wr, wg, wb, strength, roundLo);
+            hi = interpolateHalf<1>(px, c000, c100, c010, c110, c001, c101, c011, c111, wr, wg, wb, strength, roundHi);
+        }
+        // packus junta lo e hi de volta na ordem dos pixels em cada metade;
+        // o quarto byte dos pontos (lixo no layout de 24 bits) dá lugar ao alfa
+        __m256i result = _mm256_packus_epi16(lo, hi);
+        const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+        return _mm256_or_si256(_mm256_andnot_si256(alphaMask, result), _mm256_and_si256(px, alphaMask));
+    }
+
+    // Limiares de 8 pixels a partir da coluna x (a folga da linha cobre x & 63 > 56)
+    DALTONISMO_TARGET("avx2")
+    static __m256i thresholds8(const uint32_t* thresholds, size_t x, __m256i fallback) {
+        return thresholds ? _mm256_loadu_si256((const __m256i*)(thresholds + (x & 63))) : fallback;
+    }
+
+    template <bool Nearest>
+    DALTONISMO_TARGET("avx2")
+    size_t applyBGRA_AVX2(const uint8_t* src, uint8_t* dst, size_t count, int strengthQ15,
+                          const uint32_t* thresholds, int x) const {
+        const __m256i strength = _mm256_set1_epi16((short)strengthQ15);
+        const __m256i half = _mm256_set1_epi32(0x00404040);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + i * 4 + 32));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), filter8<Nearest>(a, strength, thresholds8(thresholds, x + i, half)));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4 + 32),
+                                filter8<Nearest>(b, strength, thresholds8(thresholds, x + i + 8, half)));
+        }
+        for (; i + 8 <= count; i += 8) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), filter8<Nearest>(a, strength, thresholds8(thresholds, x + i, half)));
+        }
+        return i;
+    }
+
+    // 8 pixels de cada linha = 4 blocos: soma das linhas em 16 bits, pares de
+    // pixels vizinhos somados trocando metades de 64 bits, (soma + 2) >> 2
+    DALTONISMO_TARGET("avx2")
+    static size_t averageBlocks_AVX2(const uint8_t* row0, const uint8_t* row1, uint8_t* averages, size_t count) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i two = _mm256_set1_epi16(2);
+        const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + i * 4));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + i * 4));
+            __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));  // 0,1 | 4,5
+            __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));  // 2,3 | 6,7
+            __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));  // blocos 0,1 | 2,3
+            sum = _mm256_srli_epi16(_mm256_add_epi16(sum, two), 2);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), 0x08);
+            __m128i blocks = _mm_and_si128(_mm256_castsi256_si128(packed), colorMask);
+            _mm_storeu_si128((__m128i*)(averages + i * 2), blocks);
+        }
+        return i;
+    }
+
+    // 8 pixels de cada linha = 4 blocos: (B-G, R-G) em 16 bits por pixel,
+    // mínimo e máximo entre as linhas e depois entre vizinhos (troca de
+    // metades de 64 bits); um bit por pixel, o do bloco no pixel par
+    DALTONISMO_TARGET("avx2")
+    static __m256i opponent_AVX2(__m256i px) {
+        __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 8), _mm256_set1_epi32(0x000000FF));
+        __m256i blueRed = _mm256_and_si256(px, _mm256_set1_epi32(0x00FF00FF));
+        return _mm256_sub_epi16(blueRed, _mm256_or_si256(g, _mm256_slli_epi32(g, 16)));
+    }
+
+    DALTONISMO_TARGET("avx2")
+    static size_t chromaEdges_AVX2(const uint8_t* row0, const uint8_t* row1, size_t count, int threshold,
+                                   int* edges, size_t& found) {
+        const __m256i limit = _mm256_set1_epi16((short)threshold);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i a = opponent_AVX2(_mm256_loadu_si256((const __m256i*)(row0 + i * 4)));
+            __m256i b = opponent_AVX2(_mm256_loadu_si256((const __m256i*)(row1 + i * 4)));
+            __m256i low = _mm256_min_epi16(a, b), high = _mm256_max_epi16(a, b);
+            low = _mm256_min_epi16(low, _mm256_shuffle_epi32(low, 0xB1));
+            high = _mm256_max_epi16(high, _mm256_shuffle_epi32(high, 0xB1));
+            __m256i over = _mm256_cmpgt_epi16(_mm256_sub_epi16(high, low), limit);
+            over = _mm256_or_si256(over, _mm256_slli_epi32(over, 16));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(over));
+            if (mask == 0) continue;
+            for (int block = 0; block < 4; block++) {  // sem desvio: ruído tem bordas ao acaso
+                edges[found] = (int)(i / 2 + block);
+                found += (mask >> (block * 2)) & 1;
+            }
+        }
+        return i;
+    }
+
+    // 8 pixels = 4 blocos: o delta vira duas partes sem sinal (só uma não
+    // nula por canal), somada e subtraída com saturação; o alfa tem delta 0
+    DALTONISMO_TARGET("avx2")
+    static size_t addBlockDeltas_AVX2(const uint8_t* src, uint8_t* dst, size_t count, const uint8_t* averages,
+                                      const uint8_t* corrected) {
+        const __m256i duplicate = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i avg = _mm_loadu_si128((const __m128i*)(averages + i * 2));
+            __m128i out = _mm_loadu_si128((const __m128i*)(corrected + i * 2));
+            __m256i up = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_subs_epu8(out, avg)), duplicate);
+            __m256i down = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_subs_epu8(avg, out)), duplicate);
+            __m256i px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_subs_epu8(_mm256_adds_epu8(px, up), down));
+        }
+        return i;
+    }
+#endif
+};
+
+#endif // LUT_3D_FIXED_H
@@ -0,0 +1,296 @@
+#ifndef LUT_COMPOSER_H
+#define LUT_COMPOSER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ColorCorrection.h"
+#include "Lut3D.h"
+#include "SRGB.h"
+#include "ThreadPool.h"
+
+// ==================== COMPOSIÇÃO DE LUTs ====================
+// Junta uma cadeia de transformações de cor em uma LUT só: calibração do
+// monitor + correção + reforço de contraste viram uma consulta por pixel,
+// qualquer que seja o tamanho da cadeia. Passos, na ordem em que são
+// adicionados:
+//
+//   addLut        LUT 3D (Lut3D ou Lut3DF), trilinear com entrada limitada à borda
+//   addMatrix     3x3 (por linhas) + deslocamento
+//   addGamma      pow(x, gamma) por canal; addToLinear / addToSRGB: curvas sRGB
+//   addContrast   pivot + (x - pivot) * ganho
+//   addFunction   qualquer RGB -> RGB (ColorCorrection, CorrectionModels...)
+//
+// Entre os passos nada é limitado (uma matriz pode sair de [0, 1] e a
+// próxima trazer de volta); curvas limitam a própria entrada e a saída
+// final é limitada a [0, 1], como na textura.
+//
+// bake() avalia a cadeia nos pontos da grade (um plano b por tarefa do
+// ThreadPool) e compara a LUT pronta com a cadeia avaliada direto em todos
+// os nós e pontos médios da grade (grade 2N-1: meio das arestas, das faces
+// e das células, onde a trilinear mais erra). O erro sai em LSB de 8 bits,
+// separado em interpolação (LUT em float) e interpolação + quantização (LUT
+// de 8 bits, lida como a textura RGB16F do overlay).
+//
+// O pool é usado em lotes de um plano por thread: um filtro de frame no
+// mesmo pool (ThreadPool::shared) espera no máximo um lote, não a LUT
+// inteira. bakeAsync() roda a composição em outra thread, fora da thread de
+// render; a cadeia é copiada (as LUTs são compartilhadas, não copiadas).
+class LutComposer {
+public:
+    struct ErrorStats {
+        float max = 0.0f;  // LSB de 8 bits, pior canal
+        float rms = 0.0f;
+        RGB worst = { 0.0f, 0.0f, 0.0f };  // entrada onde ficou o máximo
+    };
+
+    struct Result {
+        Lut3DF lut;   // sem quantização
+        Lut3D bytes;  // a que vai para arquivo / textura
+        ErrorStats interpolation;  // lut contra a cadeia
+        ErrorStats quantized;      // bytes contra a cadeia
+        double bakeMs = 0.0;
+        double verifyMs = 0.0;
+    };
+
+private:
+    enum class Kind { Lut, Matrix, Gamma, ToLinear, ToSRGB, Contrast, Function };
+
+    struct Step {
+        Step(Kind stepKind, std::string stepLabel) : kind(stepKind), label(std::move(stepLabel)) {}
+
+        Kind kind;
+        std::string label;
+        std::shared_ptr<const Lut3DF> lut;
+        float m[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+        float offset[3] = { 0, 0, 0 };
+        float value = 1.0f;  // gamma ou ganho do contraste
+        float pivot = 0.5f;
+        std::function<RGB(RGB)> fn;
+    };
+
+    std::vector<Step> steps;
+
+public:
+    LutComposer& addLut(std::shared_ptr<const Lut3DF> lut, const std::string& label = "lut") {
+        Step step(Kind::Lut, label);
+        step.lut = std::move(lut);
+        steps.push_back(std::move(step));
+        return *this;
+    }
+
+    LutComposer& addLut(const Lut3D& lut, const std::string& label = "lut") {
+        return addLut(std::make_shared<const Lut3DF>(Lut3DF::fromLut3D(lut)), label);
+    }
+
+    LutComposer& addMatrix(const float m[9], const float offset[3] = nullptr, const std::string& label = "matriz") {
+        Step step(Kind::Matrix, label);
+        std::copy(m, m + 9, step.m);
+        if (offset) std::copy(offset, offset + 3, step.offset);
+        steps.push_back(std::move(step));
+        return *this;
+    }
+
+    LutComposer& addGamma(float gamma) {
+        Step step(Kind::Gamma, "gamma");
+        step.value = gamma;
+        steps.push_back(std::move(step));
+        return *this;
+    }
+
+    LutComposer& addToLinear() {
+        steps.emplace_back(Kind::ToLinear, "sRGB->linear");
+        return *this;
+    }
+
+    LutComposer& addToSRGB() {
+        steps.emplace_back(Kind::ToSRGB, "linear->sRGB");
+        return *this;
+    }
+
+    LutComposer& addContrast(float gain, float pivot = 0.5f) {
+        Step step(Kind::Contrast, "contraste");
+        step.value = gain;
+        step.pivot = pivot;
+        steps.push_back(std::move(step));
+        return *this;
+    }
+
+    LutComposer& addFunction(std::function<RGB(RGB)> fn, const std::string& label = "função") {
+        Step step(Kind::Function, label);
+        step.fn = std::move(fn);
+        steps.push_back(std::move(step));
+        return *this;
+    }
+
+    size_t stepCount() const { return steps.size(); }
+
+    // "hybrid -> contraste 1.20 -> monitor"
+    std::string describe() const {
+        std::string text;
+        for (const Step& step : steps) {
+            if (!text.empty()) text += " -> ";
+            text += step.label;
+            if (step.kind == Kind::Gamma || step.kind == Kind::Contrast) {
+                char value[32];
+                std::snprintf(value, sizeof(value), " %.2f", step.value);
+                text += value;
+            }
+        }
+        return text.empty() ? "identidade" : text;
+    }
+
+    // A cadeia avaliada direto (a referência do erro)
+    RGB evaluate(RGB c) const {
+        for (const Step& step : steps) c = applyStep(step, c);
+        return { clamp01(c.r), clamp01(c.g), clamp01(c.b) };
+    }
+
+    // pool nullptr: tudo na thread chamadora
+    Result bake(int size, ThreadPool* pool) const {
+        using namespace std::chrono;
+        Result result;
+        if (size < 2 || size > 256) return result;
+
+        auto start = steady_clock::now();
+        result.lut.size = size;
+        result.lut.data.resize((size_t)size * size * size * 3);
+        result.bytes.size = size;
+        result.bytes.data.resize(result.lut.data.size());
+        const float scale = 1.0f / (size - 1);
+        forPlanes(size, pool, [&](int b) {
+            float* dst = &result.lut.data[(size_t)b * size * size * 3];
+            uint8_t* bytes = &result.bytes.data[(size_t)b * size * size * 3];
+            for (int g = 0; g < size; g++) {
+                for (int r = 0; r < size; r++) {
+                    RGB out = evaluate({ r * scale, g * scale, b * scale });
+                    *dst++ = out.r;
+                    *dst++ = out.g;
+                    *dst++ = out.b;
+                    *bytes++ = Lut3D::toByte(out.r);
+                    *bytes++ = Lut3D::toByte(out.g);
+                    *bytes++ = Lut3D::toByte(out.b);
+                }
+            }
+        });
+        auto baked = steady_clock::now();
+        result.bakeMs = duration<double, std::milli>(baked - start).count();
+
+        const Lut3DF quantized = Lut3DF::fromLut3D(result.bytes);
+        verify(result.lut, quantized, pool, result.interpolation, result.quantized);
+        result.verifyMs = duration<double, std::milli>(steady_clock::now() - baked).count();
+        return result;
+    }
+
+    // Fora da thread chamadora; o pool tem que viver até o future ficar pronto
+    std::future<Result> bakeAsync(int size, ThreadPool* pool) const {
+        LutComposer chain = *this;
+        return std::async(std::launch::async, [chain = std::move(chain), size, pool] { return chain.bake(size, pool); });
+    }
+
+private:
+    static float clamp01(float v) { return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f; }  // NaN -> 0
+
+    static RGB applyStep(const Step& step, RGB c) {
+        switch (step.kind) {
+            case Kind::Lut: {
+                float out[3];
+                step.lut->sample(c.r, c.g, c.b, out);
+                return { out[0], out[1], out[2] };
+            }
+            case Kind::Matrix: {
+                const float* m = step.m;
+                return { m[0] * c.r + m[1] * c.g + m[2] * c.b + step.offset[0],
+                         m[3] * c.r + m[4] * c.g + m[5] * c.b + step.offset[1],
+                         m[6] * c.r + m[7] * c.g + m[8] * c.b + step.offset[2] };
+            }
+            case Kind::Gamma:
+                return { std::pow(std::max(0.0f, c.r), step.value), std::pow(std::max(0.0f, c.g), step.value),
+                         std::pow(std::max(0.0f, c.b), step.value) };
+            case Kind::ToLinear:
+                return { SRGB::toLinear(clamp01(c.r)), SRGB::toLinear(clamp01(c.g)), SRGB::toLinear(clamp01(c.b)) };
+            case Kind::ToSRGB:
+                return { SRGB::toSRGB(c.r), SRGB::toSRGB(c.g), SRGB::toSRGB(c.b) };
+            case Kind::Contrast:
+                return { step.pivot + (c.r - step.pivot) * step.value, step.pivot + (c.g - step.pivot) * step.value,
+                         step.pivot + (c.b - step.pivot) * step.value };
+            case Kind::Function:
+                return step.fn(c);
+        }
+        return c;
+    }
+
+    // plane(b) para b em [0, count), em lotes de um plano por thread do pool
+    static void forPlanes(int count, ThreadPool* pool, const std::function<void(int)>& plane) {
+        auto range = [&](int begin, int end) {
+            for (int b = begin; b < end; b++) plane(b);
+        };
+        if (!pool) {
+            range(0, count);
+            return;
+        }
+        const int batch = pool->getThreadCount();
+        for (int begin = 0; begin < count; begin += batch) {
+            pool->parallelFor(begin, std::min(count, begin + batch), 1, range);
+        }
+    }
+
+    // Grade 2N-1 com os nós da LUT nos pontos pares. Um acumulador por plano
+    // e a redução no fim: o resultado não depende da ordem das threads
+    void verify(const Lut3DF& lut, const Lut3DF& quantized, ThreadPool* pool, ErrorStats& interpolation,
+                ErrorStats& quantizedStats) const {
+        struct Plane {
+            ErrorStats stats[2];
+            double sumSq[2] = { 0.0, 0.0 };
+        };
+        const int fine = 2 * lut.size - 1;
+        const float scale = 1.0f / (fine - 1);
+        std::vector<Plane> planes(fine);
+        forPlanes(fine, pool, [&](int b) {
+            Plane& plane = planes[b];
+            for (int g = 0; g < fine; g++) {
+                for (int r = 0; r < fine; r++) {
+                    const RGB in = { r * scale, g * scale, b * scale };
+                    const RGB direct = evaluate(in);
+                    const float reference[3] = { direct.r, direct.g, direct.b };
+                    float sampled[2][3];
+                    lut.sample(in.r, in.g, in.b, sampled[0]);
+                    quantized.sample(in.r, in.g, in.b, sampled[1]);
+                    for (int k = 0; k < 2; k++) {
+                        for (int c = 0; c < 3; c++) {
+                            float error = std::fabs(sampled[k][c] - reference[c]) * 255.0f;
+                            plane.sumSq[k] += (double)error * error;
+                            if (error > plane.stats[k].max) {
+                                plane.stats[k].max = error;
+                                plane.stats[k].worst = in;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        ErrorStats* out[2] = { &interpolation, &quantizedStats };
+        for (int k = 0; k < 2; k++) {
+            double sumSq = 0.0;
+            *out[k] = ErrorStats();
+            for (const Plane& plane : planes) {
+                sumSq += plane.sumSq[k];
+                if (plane.stats[k].max > out[k]->max) {
+                    out[k]->max = plane.stats[k].max;
+                    out[k]->worst = plane.stats[k].worst;
+                }
+            }
+            out[k]->rms = (float)std::sqrt(sumSq / ((double)fine * fine * fine * 3));
+        }
+    }
+};
+
+#endif // LUT_COMPOSER_H
@@ -0,0 +1,241 @@
+#ifndef LUT_FILES_H
+#define LUT_FILES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Lut3D.h"
+
+// ==================== ARQUIVOS DE LUT ====================
+// Gravação de uma Lut3D nos três formatos do lutgen (e leitura do .dlut e
+// do .cube, este em float):
+//
+//   .png   faixa horizontal RGB8 (N*N x N), a mesma que o overlay e o
+//          lutbake leem com stb_image. Sem compressão (deflate com blocos
+//          "stored"): o PNG continua válido e o gravador não depende de zlib.
+//   .cube  texto do Resolve/Adobe: LUT_3D_SIZE N e N^3 linhas "r g b" em
+//          [0, 1], vermelho variando mais rápido (a ordem canônica da Lut3D).
+//   .dlut  binário do projeto: cabeçalho de 16 bytes ("DLUT", versão,
+//          tamanho, reservado; uint32 little-endian) seguido de Lut3D::data
+//          como está. Carrega sem conversão nenhuma.
+class LutFiles {
+public:
+    static const uint32_t binaryVersion = 1;
+
+    static bool writeStripPng(const std::string& path, const Lut3D& lut) {
+        if (!lut.isValid()) return false;
+        std::vector<uint8_t> strip = lut.toStrip();
+        return writeFile(path, encodePng(strip.data(), lut.size * lut.size, lut.size));
+    }
+
+    static bool writeCube(const std::string& path, const Lut3D& lut, const std::string& title) {
+        if (!lut.isValid()) return false;
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+        std::fprintf(file, "TITLE \"%s\"\nLUT_3D_SIZE %d\nDOMAIN_MIN 0 0 0\nDOMAIN_MAX 1 1 1\n", title.c_str(), lut.size);
+        const uint8_t* p = lut.data.data();
+        for (size_t i = 0; i < lut.data.size(); i += 3) {
+            std::fprintf(file, "%.6f %.6f %.6f\n", p[i] / 255.0f, p[i + 1] / 255.0f, p[i + 2] / 255.0f);
+        }
+        bool ok = std::ferror(file) == 0;
+        return std::fclose(file) == 0 && ok;
+    }
+
+    static bool writeBinary(const std::string& path, const Lut3D& lut) {
+        if (!lut.isValid()) return false;
+        std::vector<uint8_t> bytes(16 + lut.data.size());
+        std::memcpy(bytes.data(), "DLUT", 4);
+        put32(&bytes[4], binaryVersion);
+        put32(&bytes[8], (uint32_t)lut.size);
+        put32(&bytes[12], 0);
+        std::memcpy(&bytes[16], lut.data.data(), lut.data.size());
+        return writeFile(path, bytes);
+    }
+
+    static bool readBinary(const std::string& path, Lut3D& lut) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        uint8_t header[16];
+        bool ok = std::fread(header, 1, 16, file) == 16 && std::memcmp(header, "DLUT", 4) == 0 &&
+                  get32(&header[4]) == binaryVersion;
+        uint32_t size = ok ? get32(&header[8]) : 0;
+        ok = ok && size >= 2 && size <= 256;
+        if (ok) {
+            lut.size = (int)size;
+            lut.data.resize((size_t)size * size * size * 3);
+            ok = std::fread(lut.data.data(), 1, lut.data.size(), file) == lut.data.size();
+        }
+        std::fclose(file);
+        if (!ok) lut = Lut3D();
+        return ok;
+    }
+
+    // .cube 3D (Resolve/Adobe) em float, para entrar em uma composição (ex.
+    // calibração do monitor). Aceita TITLE, comentários e DOMAIN_MIN/MAX;
+    // um domínio diferente de [0, 1] é reamostrado para [0, 1]. LUT_1D não.
+    static bool readCube(const std::string& path, Lut3DF& lut) {
+        lut = Lut3DF();
+        FILE* file = std::fopen(path.c_str(), "r");
+        if (!file) return false;
+        int size = 0;
+        float domainMin[3] = { 0, 0, 0 }, domainMax[3] = { 1, 1, 1 };
+        std::vector<float> values;
+        bool ok = true;
+        char line[512];
+        while (ok && std::fgets(line, sizeof(line), file)) {
+            const char* p = line;
+            while (*p == ' ' || *p == '\t') p++;
+            if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0' || std::strncmp(p, "TITLE", 5) == 0) continue;
+            float v[3];
+            if (std::strncmp(p, "LUT_3D_SIZE", 11) == 0) {
+                ok = std::sscanf(p + 11, "%d", &size) == 1 && size >= 2 && size <= 256;
+                if (ok) values.reserve((size_t)size * size * size * 3);
+            } else if (std::strncmp(p, "DOMAIN_MIN", 10) == 0) {
+                ok = std::sscanf(p + 10, "%f %f %f", &domainMin[0], &domainMin[1], &domainMin[2]) == 3;
+            } else if (std::strncmp(p, "DOMAIN_MAX", 10) == 0) {
+                ok = std::sscanf(p + 10, "%f %f %f", &domainMax[0], &domainMax[1], &domainMax[2]) == 3;
+            } else if (std::sscanf(p, "%f %f %f", &v[0], &v[1], &v[2]) == 3) {
+                values.insert(values.end(), v, v + 3);
+            } else {
+                ok = false;  // LUT_1D_SIZE e palavras desconhecidas
+            }
+        }
+        std::fclose(file);
+        if (!ok || size == 0 || values.size() != (size_t)size * size * size * 3) return false;
+        for (int c = 0; c < 3; c++) {
+            if (!(domainMax[c] > domainMin[c])) return false;
+        }
+
+        Lut3DF table;
+        table.size = size;
+        table.data = std::move(values);
+        if (domainMin[0] == 0 && domainMin[1] == 0 && domainMin[2] == 0 &&
+            domainMax[0] == 1 && domainMax[1] == 1 && domainMax[2] == 1) {
+            lut = std::move(table);
+            return true;
+        }
+        // Ponto x de [0, 1] -> (x - min) / (max - min) na tabela do arquivo
+        lut.size = size;
+        lut.data.resize(table.data.size());
+        float* dst = lut.data.data();
+        const float scale = 1.0f / (size - 1);
+        for (int b = 0; b < size; b++) {
+            for (int g = 0; g < size; g++) {
+                for (int r = 0; r < size; r++, dst += 3) {
+                    const float x[3] = { r * scale, g * scale, b * scale };
+                    float in[3];
+                    for (int c = 0; c < 3; c++) in[c] = (x[c] - domainMin[c]) / (domainMax[c] - domainMin[c]);
+                    table.sample(in[0], in[1], in[2], dst);
+                }
+            }
+        }
+        return true;
+    }
+
+    // PNG RGB8 sem compressão: filtro 0 por linha e deflate em blocos
+    // "stored" de até 65535 bytes
+    static std::vector<uint8_t> encodePng(const uint8_t* rgb, int width, int height) {
+        std::vector<uint8_t> raw;
+        raw.reserve((size_t)(width * 3 + 1) * height);
+        for (int y = 0; y < height; y++) {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgb + (size_t)y * width * 3, rgb + (size_t)(y + 1) * width * 3);
+        }
+
+        std::vector<uint8_t> zlib = { 0x78, 0x01 };
+        for (size_t offset = 0;;) {
+            size_t length = std::min<size_t>(65535, raw.size() - offset);
+            bool last = offset + length == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back((uint8_t)length);
+            zlib.push_back((uint8_t)(length >> 8));
+            zlib.push_back((uint8_t)~length);
+            zlib.push_back((uint8_t)(~length >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+            offset += length;
+            if (last) break;
+        }
+        uint8_t adler[4];
+        putBig32(adler, adler32(raw.data(), raw.size()));
+        zlib.insert(zlib.end(), adler, adler + 4);
+
+        std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        uint8_t header[13];
+        putBig32(header, (uint32_t)width);
+        putBig32(header + 4, (uint32_t)height);
+        header[8] = 8;   // bits por canal
+        header[9] = 2;   // RGB
+        header[10] = 0;  // deflate
+        header[11] = 0;  // filtros padrão
+        header[12] = 0;  // sem entrelaçamento
+        appendChunk(png, "IHDR", header, sizeof(header));
+        appendChunk(png, "IDAT", zlib.data(), zlib.size());
+        appendChunk(png, "IEND", nullptr, 0);
+        return png;
+    }
+
+private:
+    static bool writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    static void put32(uint8_t* p, uint32_t v) {
+        for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+    }
+
+    static uint32_t get32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    static void putBig32(uint8_t* p, uint32_t v) {
+        for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (24 - 8 * i));
+    }
+
+    static uint32_t adler32(const uint8_t* data, size_t length) {
+        uint32_t a = 1, b = 0;
+        while (length > 0) {
+            size_t block = std::min<size_t>(length, 5552);  // sem estouro antes do módulo
+            length -= block;
+            while (block--) {
+                a += *data++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0xFFFFFFFFu) {
+        static const std::vector<uint32_t> table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc;
+    }
+
+    static void appendChunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, size_t length) {
+        uint8_t word[4];
+        putBig32(word, (uint32_t)length);
+        png.insert(png.end(), word, word + 4);
+        size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        if (length) png.insert(png.end(), data, data + length);
+        putBig32(word, crc32(&png[start], png.size() - start) ^ 0xFFFFFFFFu);
+        png.insert(png.end(), word, word + 4);
+    }
+};
+
+#endif // LUT_FILES_H
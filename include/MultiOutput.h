@@ -0,0 +1,268 @@
+#ifndef MULTI_OUTPUT_H
+#define MULTI_OUTPUT_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CpuFilter.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "Lut3D.h"
+#include "QualityGovernor.h"
+#include "RegionOfInterest.h"
+#include "ThreadPool.h"
+
+// ==================== PIPELINE MULTI-SAÍDA (CPU) ====================
+// N saídas, cada uma com sua fonte, seus buffers e seu alvo, processadas em
+// threads próprias. Todas usam a mesma Lut3D (shared_ptr, sem cópia). Os
+// núcleos são divididos entre as saídas: cada uma tem um ThreadPool próprio,
+// então uma saída 4K não segura o frame de uma 1080p.
+//
+// Espelha o overlay de main.cpp (um contexto GL por monitor, LUT compartilhada
+// entre contextos) e permite exercitar várias resoluções em Linux com
+// SyntheticFrameSource.
+//
+// Com enableGovernor cada saída tem um QualityGovernor que troca o degrau de
+// qualidade (interpolação, croma, só blocos alterados, taxa de captura) para
+// manter o tempo de frame no orçamento.
+class MultiOutputPipeline {
+public:
+    struct Stats {
+        int width = 0, height = 0;
+        int framesCaptured = 0;   // frames publicados pela fonte
+        int framesProcessed = 0;  // frames filtrados por esta saída
+        double averageMs = 0.0;   // tempo médio de filtro por frame
+        int qualityLevel = -1;    // degrau do governador (-1: sem governador)
+    };
+
+private:
+    struct Output {
+        std::unique_ptr<FrameSource> source;
+        std::unique_ptr<ThreadPool> pool;
+        std::unique_ptr<CpuFilter> filter;
+
+        std::unique_ptr<FramePool> framePool;
+        FrameHandle workBuffer;
+        FrameHandle targetBuffer;  // último frame filtrado
+        std::mutex targetMutex;
+
+        std::unique_ptr<QualityGovernor> governor;
+        int appliedLevel = -1;
+        ChangeDetector changes;
+        std::vector<RoiRect> targetChanged;  // blocos refeitos no targetBuffer e ainda velhos no workBuffer
+        uint64_t changesRegionVersion = 0;
+        float changesStrength = -1.0f;
+
+        std::thread worker;
+        std::atomic<int> framesProcessed{0};
+        std::atomic<int64_t> totalMicros{0};
+    };
+
+    std::vector<std::unique_ptr<Output>> outputs;
+    std::shared_ptr<const Lut3D> lut;
+    RegionSet regions;  // coordenadas do frame de cada saída; vazio = frame inteiro
+    std::atomic<float> strength{1.0f};
+    std::atomic<float> slowdown{1.0f};
+    std::atomic<bool> running{false};
+
+public:
+    explicit MultiOutputPipeline(std::shared_ptr<const Lut3D> sharedLut)
+        : lut(std::move(sharedLut)) {}
+
+    ~MultiOutputPipeline() { stop(); }
+
+    MultiOutputPipeline(const MultiOutputPipeline&) = delete;
+    MultiOutputPipeline& operator=(const MultiOutputPipeline&) = delete;
+
+    // Só antes de start(); retorna o índice da saída
+    int addOutput(std::unique_ptr<FrameSource> source) {
+        auto output = std::make_unique<Output>();
+        output->source = std::move(source);
+        outputs.push_back(std::move(output));
+        return (int)outputs.size() - 1;
+    }
+
+    int getOutputCount() const { return (int)outputs.size(); }
+
+    void setStrength(float value) { strength = std::min(1.0f, std::max(0.0f, value)); }
+
+    // Pode ser chamado com o pipeline rodando; vale a partir do próximo frame
+    void setRegions(const std::vector<RoiRect>& rects) { regions.set(rects); }
+
+    // Só antes de start(): um governador por saída, com a escada padrão
+    void enableGovernor(const QualityGovernor::Config& config) {
+        for (auto& output : outputs) output->governor = std::make_unique<QualityGovernor>(config);
+    }
+
+    const QualityGovernor* getGovernor(int index) const { return outputs[index]->governor.get(); }
+    QualityGovernor* getGovernor(int index) { return outputs[index]->governor.get(); }
+
+    // Testes/benchmarks: simula uma máquina 'factor' vezes mais lenta (espera
+    // ocupada proporcional ao tempo real de filtro de cada frame)
+    void setSimulatedSlowdown(float factor) { slowdown = std::max(1.0f, factor); }
+
+    bool start() {
+        if (running || outputs.empty()) return false;
+
+        int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+        int perOutput = std::max(1, cores / (int)outputs.size());
+
+        for (auto& output : outputs) {
+            if (!output->source->initialize() || output->source->getFormat() != PixelFormat::BGRA8) {
+                return false;
+            }
+            output->framePool = std::make_unique<FramePool>(PixelFormat::BGRA8,
+                                                            output->source->getWidth(), output->source->getHeight());
+            output->workBuffer = output->framePool->acquire();
+            output->targetBuffer = output->framePool->acquire();
+            if (!output->workBuffer || !output->targetBuffer) return false;
+            output->pool = std::make_unique<ThreadPool>(perOutput);
+            output->filter = std::make_unique<CpuFilter>(*output->pool);
+            output->filter->setSharedLUT(lut);
+        }
+
+        running = true;
+        for (auto& output : outputs) {
+            output->source->start();
+            output->worker = std::thread(&MultiOutputPipeline::outputLoop, this, output.get());
+        }
+        return true;
+    }
+
+    void stop() {
+        if (!running) return;
+        running = false;
+        for (auto& output : outputs) {
+            if (output->worker.joinable()) output->worker.join();
+            output->source->stop();
+        }
+    }
+
+    Stats getStats(int index) const {
+        const Output& output = *outputs[index];
+        Stats stats;
+        stats.width = output.source->getWidth();
+        stats.height = output.source->getHeight();
+        stats.framesCaptured = output.source->getFrameCount();
+        stats.framesProcessed = output.framesProcessed;
+        if (stats.framesProcessed > 0) {
+            stats.averageMs = output.totalMicros / 1000.0 / stats.framesProcessed;
+        }
+        if (output.governor) stats.qualityLevel = output.governor->getLevel();
+        return stats;
+    }
+
+    // Copia o último frame filtrado da saída (BGRA8 compacto)
+    bool readOutput(int index, std::vector<uint8_t>& frame) {
+        Output& output = *outputs[index];
+        if (output.framesProcessed == 0) return false;
+        std::lock_guard<std::mutex> lock(output.targetMutex);
+        const FrameView& view = output.targetBuffer.view();
+        frame.resize(FrameView::compactSize(view.format, view.width, view.height));
+        return copyFrame(view, FrameView::wrap(view.format, frame.data(), view.width, view.height));
+    }
+
+private:
+    void outputLoop(Output* output) {
+        using namespace std::chrono;
+        int lastFrame = 0;
+
+        while (running) {
+            int frame = output->source->getFrameCount();
+            if (frame == lastFrame) {
+                std::this_thread::sleep_for(milliseconds(1));
+                continue;
+            }
+            lastFrame = frame;
+
+            bool tilesOnly = applyQuality(*output);
+            output->filter->setStrength(strength);
+            std::vector<RoiRect> rects = regions.get();
+            auto begin = steady_clock::now();
+            bool read = output->source->readLatest([&](const FrameView& src) {
+                if (tilesOnly) {
+                    filterChangedTiles(*output, src, rects);
+                } else {
+                    applyRegions(*output->filter, src, output->workBuffer.view(), rects);
+                }
+            });
+            if (!read) continue;  // sem frame: o workBuffer não mudou, não troca
+            auto filtered = steady_clock::now();
+            float factor = slowdown;
+            if (factor > 1.0f) {
+                auto until = filtered + (filtered - begin) * (factor - 1.0f);
+                while (steady_clock::now() < until) {}
+            }
+            int64_t micros = duration_cast<microseconds>(steady_clock::now() - begin).count();
+            output->totalMicros += micros;
+
+            if (output->governor) {
+                output->governor->recordStage(QualityGovernor::Capture, output->source->getCaptureMs());
+                output->governor->recordStage(QualityGovernor::Filter, micros / 1000.0);
+                output->governor->endFrame();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(output->targetMutex);
+                std::swap(output->workBuffer, output->targetBuffer);
+            }
+            output->framesProcessed++;
+        }
+    }
+
+    // Leva o degrau atual do governador para o filtro e a fonte; devolve se
+    // o modo "só blocos alterados" está ligado
+    bool applyQuality(Output& output) {
+        if (!output.governor) return false;
+        int level = output.governor->getLevel();
+        const QualityLevel& settings = output.governor->getSettings(level);
+        if (level != output.appliedLevel) {
+            output.filter->setInterpolation(settings.interpolation);
+            output.filter->setChromaMode(settings.chromaMode);
+            output.source->setRateDivisor(settings.captureDivisor);
+            output.changes.reset();  // a saída anterior foi feita com outra configuração
+            output.appliedLevel = level;
+        }
+        return settings.changedTilesOnly;
+    }
+
+    // Refaz só os blocos em que a fonte mudou (dentro das regiões de
+    // interesse, se houver), sem cópia do frame inteiro: o workBuffer é a
+    // saída de dois frames atrás, então só recebe do targetBuffer os blocos
+    // refeitos no frame anterior
+    void filterChangedTiles(Output& output, const FrameView& src, const std::vector<RoiRect>& rects) {
+        if (regions.getVersion() != output.changesRegionVersion || strength != output.changesStrength) {
+            output.changes.reset();
+            output.changesRegionVersion = regions.getVersion();
+            output.changesStrength = strength;
+        }
+
+        const FrameView& work = output.workBuffer.view();
+        const FrameView& target = output.targetBuffer.view();
+        std::vector<RoiRect> changed = output.changes.detect(src);
+        bool fullFrame = changed.size() == 1 && changed[0].width == src.width && changed[0].height == src.height;
+        if (!fullFrame) {
+            for (const RoiRect& r : output.targetChanged) {
+                copyFrame(target.subView(r.x, r.y, r.width, r.height), work.subView(r.x, r.y, r.width, r.height));
+            }
+        }
+
+        std::vector<RoiRect> filtered = changed;
+        if (!rects.empty()) {
+            // Fora das regiões o bloco novo fica com a fonte sem filtro
+            for (const RoiRect& r : changed) {
+                copyFrame(src.subView(r.x, r.y, r.width, r.height), work.subView(r.x, r.y, r.width, r.height));
+            }
+            filtered = RegionSet::intersect(changed, RegionSet::disjoint(rects, src.width, src.height));
+        }
+        filterRegions(*output.filter, src, work, filtered);
+        output.targetChanged = std::move(changed);  // o work vira o target no fim do frame
+    }
+};
+
+#endif // MULTI_OUTPUT_H
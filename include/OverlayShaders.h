@@ -0,0 +1,426 @@
+#ifndef OVERLAY_SHADERS_H
+#define OVERLAY_SHADERS_H
+
+// ==================== SHADERS DO OVERLAY ====================
+// Programa GLSL do overlay (main.cpp). Fica em um header para que o
+// tools/paritycheck.cpp compile exatamente o mesmo shader em um contexto sem
+// janela e compare a saída da GPU com os kernels de CPU.
+//
+// shaders/vertex.glsl e shaders/fragment.glsl são cópias destes textos: o
+// overlay usa os arquivos em runtime (ShaderReloader) e volta para estes
+// quando eles não compilam.
+//
+// Uniforms: screenTexture (unidade 0), lutTexture (unidade 1, faixa
+// horizontal 1024x32 GL_RGB16F com filtro linear: x = g * 32 + r, y = b),
+// enableCorrection, correctionStrength, useLUT, linearLight, inputLinear
+// (frame RGBA16F), noiseTexture (unidade 2, BlueNoise::textureBytes() em R8)
+// e dither.
+static const char* const vertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+out vec2 TexCoord;
+void main() {
+    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); 
+    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
+}
+)";
+
+static const char* const fragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+uniform sampler2D screenTexture;
+uniform sampler2D lutTexture;
+uniform bool enableCorrection;
+uniform float correctionStrength;
+uniform bool useLUT;
+uniform int correctionMethod;  // sem LUT: 0 híbrido (padrão), 1 LMS, 2 daltonize
+uniform bool linearLight;   // true: screenTexture é GL_SRGB8_ALPHA8 (já chega linear)
+uniform bool inputLinear;   // true: captura RGBA16F (scRGB), linear mesmo sem linearLight
+uniform sampler2D noiseTexture;  // ruído azul 64x64 R8 (BlueNoise.h)
+uniform bool dither;
+uniform bool lutNearest;    // governador, "LUT 1 ponto": só o nó mais próximo da grade
+uniform int chromaPass;     // governador, croma 2x2: 0 desligado, 1 delta por bloco, 2 soma o delta
+uniform sampler2D chromaTexture;  // deltas do passo 1 (RGBA16F em meia resolução; alfa 1 = borda)
+
+// Nos dois casos o framebuffer codifica sRGB na escrita (GL_FRAMEBUFFER_SRGB)
+bool linearDomain() {
+    return linearLight || inputLinear;
+}
+
+// Conversões exatas sRGB <-> linear (só usadas para indexar a LUT,
+// que foi gerada sobre valores sRGB)
+vec3 linearToSrgb(vec3 c) {
+    c = clamp(c, 0.0, 1.0);
+    return mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055, step(vec3(0.0031308), c));
+}
+
+vec3 srgbToLinear(vec3 c) {
+    return mix(c / 12.92, pow((c + 0.055) / 1.055, vec3(2.4)), step(vec3(0.04045), c));
+}
+
+vec3 applyLUT3D(vec3 color, sampler2D lut) {
+    color = clamp(color, 0.0, 1.0);
+    const float lutSize = 32.0;
+
+    // 1 leitura em vez de 2 amostras bilineares, arredondando como o
+    // Lut3DSampler::sampleNearest da CPU
+    if (lutNearest) {
+        ivec3 node = ivec3(color * (lutSize - 1.0) + 0.5);
+        return texelFetch(lut, ivec2(node.g * int(lutSize) + node.r, node.b), 0).rgb;
+    }
+
+    // Red -> u (x-coord in slice)
+    // Blue -> v (y-coord in slice)
+    // Green -> slice index
+    
+    float u = (color.r * (lutSize - 1.0) + 0.5) / lutSize;
+    float v = (color.b * (lutSize - 1.0) + 0.5) / lutSize;
+    float slice = color.g * (lutSize - 1.0);
+
+    float slice_floor = floor(slice);
+    float slice_frac = slice - slice_floor;
+
+    // The normalized WIDTH of a single 32x32 slice
+    float slice_width = 1.0 / lutSize;
+
+    // We calculate the X coordinate by finding the correct horizontal slice.
+    // We use 'v' for the Y coordinate directly.
+    vec2 uv0 = vec2( (u + slice_floor) * slice_width, v );
+    vec2 uv1 = vec2( (u + slice_floor + 1.0) * slice_width, v );
+
+    vec3 sample0 = texture(lut, uv0).rgb;
+    vec3 sample1 = texture(lut, uv1).rgb;
+
+    return mix(sample0, sample1, slice_frac);
+}
+
+// Ruído azul de ±0.5 LSB somado antes da conversão para os 8 bits do
+// framebuffer, que arredonda: os degraus de 1 LSB dos gradientes viram grão.
+// Em luz linear o framebuffer codifica sRGB depois do shader, então o ruído
+// entra em sRGB.
+vec3 ditherOutput(vec3 c) {
+    float noise = (texelFetch(noiseTexture, ivec2(gl_FragCoord.xy) & 63, 0).r * 255.0 + 0.5) / 256.0 - 0.5;
+    if (linearDomain()) return srgbToLinear(clamp(linearToSrgb(c) + noise / 255.0, 0.0, 1.0));
+    return c + noise / 255.0;
+}
+
+vec3 hybridCorrection(vec3 color) {
+    // Em luz linear a luminância usa os pesos Rec.709; em gamma, Rec.601
+    vec3 lumaWeights = linearDomain() ? vec3(0.2126, 0.7152, 0.0722) : vec3(0.299, 0.587, 0.114);
+    float luminance = dot(color, lumaWeights);
+    float redGreenRatio = color.r / max(color.g, 0.001);
+    
+    vec3 corrected = color;
+    if (redGreenRatio > 1.2) {
+        corrected.r = min(1.0, color.r * 1.1);
+        corrected.b = min(1.0, color.b + (color.r - color.g) * 0.25);
+    } else if (redGreenRatio < 0.8) {
+        corrected.g = min(1.0, color.g * 1.05);
+        corrected.b = min(1.0, color.b + (color.g - color.r) * 0.2);
+    }
+    
+    float newLuminance = dot(corrected, lumaWeights);
+    if (newLuminance > 0.001) {
+        corrected *= luminance / newLuminance;
+    }
+    
+    return clamp(corrected, 0.0, 1.0);
+}
+
+// Correção CIENTÍFICA em espaço LMS (Long, Medium, Short wavelengths),
+// baseada em Machado, Oliveira e Fernandes (2009)
+vec3 correctDeuteranopia(vec3 color) {
+    mat3 rgbToLms = mat3(
+        0.31399022, 0.63951294, 0.04649755,
+        0.15537241, 0.75789446, 0.08670142,
+        0.01775239, 0.10944209, 0.87256922
+    );
+    mat3 lmsToRgb = mat3(
+         5.47221206, -4.6419601,  0.16963708,
+        -1.1252419,   2.29317094, -0.1678952,
+         0.02980165, -0.19318073,  1.16364789
+    );
+    vec3 lms = rgbToLms * color;
+    
+    // DEUTERANOPIA: perda do canal M. Realçar diferenças vermelho-verde e
+    // mapear a informação perdida para o canal azul
+    vec3 correctedLms = lms;
+    float redGreenDiff = lms.r - lms.g;
+    correctedLms.r = lms.r + 0.7 * redGreenDiff;
+    correctedLms.g = lms.g - 0.7 * redGreenDiff;
+    correctedLms.b = lms.b + 0.3 * abs(redGreenDiff);
+    
+    return clamp(lmsToRgb * correctedLms, 0.0, 1.0);
+}
+
+// Método Daltonize: o erro entre a cor e a simulação vai para o azul
+vec3 daltonizeDeuteranopia(vec3 color) {
+    mat3 deuteranopia_sim = mat3(
+        0.625, 0.375, 0.0,
+        0.7,   0.3,   0.0,
+        0.0,   0.3,   0.7
+    );
+    vec3 error = color - deuteranopia_sim * color;
+    
+    vec3 corrected = color;
+    corrected.b += error.r * 0.7 + error.g * 0.7;
+    return clamp(corrected, 0.0, 1.0);
+}
+
+// LMS e daltonize são definidos sobre valores sRGB, como no ColorCorrection
+// da CPU; o híbrido tem pesos próprios para luz linear
+vec3 mathCorrection(vec3 color) {
+    if (correctionMethod == 0) return hybridCorrection(color);
+    bool linear = linearDomain();
+    vec3 c = linear ? linearToSrgb(color) : clamp(color, 0.0, 1.0);
+    c = correctionMethod == 1 ? correctDeuteranopia(c) : daltonizeDeuteranopia(c);
+    return linear ? srgbToLinear(c) : c;
+}
+
+vec3 correctColor(vec3 color) {
+    if (!useLUT) return mathCorrection(color);
+    if (linearDomain()) return srgbToLinear(applyLUT3D(linearToSrgb(color), lutTexture));
+    return applyLUT3D(color, lutTexture);
+}
+
+// A LUT vê a cor limitada a [0, 1]; acima disso (HDR) só o delta entra,
+// como no CpuFilter, e o excesso passa intacto
+vec3 correctionDelta(vec3 color) {
+    return (correctColor(color) - clamp(color, 0.0, 1.0)) * correctionStrength;
+}
+
+// Croma 2x2, passo 1 (alvo em meia resolução): a correção roda uma vez por
+// bloco, sobre a média dos 4 pixels, como o ChromaMode::Half da CPU. O
+// bloco vem de gl_FragCoord, não de TexCoord (invertido em v): o alvo fica
+// na orientação da textura. Na borda ímpar o pixel repetido pesa o mesmo
+// que a média só dos que existem.
+//
+// Com R-G ou B-G variando mais de 16 níveis de 8 bits no bloco (o
+// CHROMA_EDGE do CpuFilter, medido em sRGB) a média é uma cor que nenhum
+// pixel tem: o alfa sai 1 e o passo 2 corrige esses pixels um a um.
+vec4 blockDelta() {
+    ivec2 last = textureSize(screenTexture, 0) - 1;
+    ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+    vec3 texels[4] = vec3[4](texelFetch(screenTexture, p, 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(1, 0), last), 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(0, 1), last), 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(1, 1), last), 0).rgb);
+    vec2 low = vec2(2.0), high = vec2(-2.0);
+    for (int i = 0; i < 4; i++) {
+        vec3 c = linearDomain() ? linearToSrgb(texels[i]) : texels[i];
+        vec2 opponent = c.rb - c.gg;
+        low = min(low, opponent);
+        high = max(high, opponent);
+    }
+    vec2 spread = high - low;
+    if (max(spread.x, spread.y) > 16.5 / 255.0) return vec4(0.0, 0.0, 0.0, 1.0);
+    vec3 mean = (texels[0] + texels[1] + texels[2] + texels[3]) * 0.25;
+    return vec4(correctionDelta(mean), 0.0);
+}
+
+void main() {
+    vec3 color = texture(screenTexture, TexCoord).rgb;
+    
+    if (!enableCorrection) {
+        FragColor = vec4(color, 1.0);
+        return;
+    }
+    
+    if (chromaPass == 1) {
+        FragColor = blockDelta();
+        return;
+    }
+    
+    // Passo 2 do croma 2x2: o delta do bloco somado a cada pixel, o detalhe
+    // de luminância continua em resolução total
+    vec3 final;
+    if (chromaPass == 2) {
+        ivec2 block = ivec2(TexCoord * vec2(textureSize(screenTexture, 0))) / 2;
+        vec4 delta = texelFetch(chromaTexture, block, 0);
+        final = color + (delta.a > 0.5 ? correctionDelta(color) : delta.rgb);
+    } else {
+        final = color + correctionDelta(color);
+    }
+    if (dither) final = ditherOutput(final);
+    FragColor = vec4(final, 1.0);
+
+    // vec3 corrected = applyLUT3D(color, lutTexture);
+    // FragColor = vec4(corrected, 1.0);
+
+    // FragColor = vec4(1.0, 0.0, 0.0, 0.5); 
+}
+)";
+
+// ==================== COMPUTE SHADER (GL 4.3) ====================
+// Mesmo filtro do fragment shader sem quad nem rasterização: um grupo de
+// 16x16 invocações por bloco do frame lê 'sourceImage' e escreve
+// 'targetImage' (a mesma textura quando o filtro roda no lugar). Usado pelo
+// ComputeFilter (include/ComputeFilter.h), que monta o cabeçalho (#version
+// e a variante) antes deste texto.
+//
+// - Blocos alterados: com useTileList só são lançados grupos para os blocos
+//   da lista dirtyTiles (x | y << 16); os outros nem rodam e o alvo mantém o
+//   resultado anterior.
+// - SHARED_LUT_CACHE: cada célula distinta da LUT usada pelo grupo entra uma
+//   vez em uma tabela hash na shared e quem a insere busca os 8 cantos; os
+//   pixels interpolam lendo da shared. Um bloco de texto usa poucas células,
+//   então a LUT é lida poucas vezes por bloco em vez de 2 amostras
+//   bilineares por pixel. Sem a variante a LUT é amostrada como no fragment.
+//
+// Os pixels são lidos em sRGB (a imagem é sempre rgba8); em luz linear a
+// conversão é feita aqui, e a saída volta a sRGB antes de ser gravada.
+// Uniforms: lutTexture (unidade 1, a mesma faixa do fragment shader),
+// useTileList, tileCount, enableCorrection, correctionStrength, useLUT,
+// linearLight, noiseTexture (unidade 2) e dither (ruído na saída sRGB, como
+// no fragment shader).
+static const char* const computeShaderSource = R"(
+layout(local_size_x = 16, local_size_y = 16) in;
+layout(rgba8, binding = 0) uniform readonly image2D sourceImage;
+layout(rgba8, binding = 1) uniform writeonly image2D targetImage;
+layout(std430, binding = 0) readonly buffer DirtyTiles { uint dirtyTiles[]; };
+layout(std430, binding = 1) buffer ComputeStats { uint filteredGroups; uint lutCells; };
+uniform sampler2D lutTexture;
+uniform bool useTileList;
+uniform uint tileCount;
+uniform bool enableCorrection;
+uniform float correctionStrength;
+uniform bool useLUT;
+uniform bool linearLight;
+uniform sampler2D noiseTexture;
+uniform bool dither;
+
+const int lutSize = 32;
+
+vec3 linearToSrgb(vec3 c) {
+    c = clamp(c, 0.0, 1.0);
+    return mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055, step(vec3(0.0031308), c));
+}
+
+vec3 srgbToLinear(vec3 c) {
+    return mix(c / 12.92, pow((c + 0.055) / 1.055, vec3(2.4)), step(vec3(0.04045), c));
+}
+
+vec3 hybridCorrection(vec3 color) {
+    vec3 lumaWeights = linearLight ? vec3(0.2126, 0.7152, 0.0722) : vec3(0.299, 0.587, 0.114);
+    float luminance = dot(color, lumaWeights);
+    float redGreenRatio = color.r / max(color.g, 0.001);
+
+    vec3 corrected = color;
+    if (redGreenRatio > 1.2) {
+        corrected.r = min(1.0, color.r * 1.1);
+        corrected.b = min(1.0, color.b + (color.r - color.g) * 0.25);
+    } else if (redGreenRatio < 0.8) {
+        corrected.g = min(1.0, color.g * 1.05);
+        corrected.b = min(1.0, color.b + (color.g - color.r) * 0.2);
+    }
+
+    float newLuminance = dot(corrected, lumaWeights);
+    if (newLuminance > 0.001) {
+        corrected *= luminance / newLuminance;
+    }
+    return clamp(corrected, 0.0, 1.0);
+}
+
+#ifdef SHARED_LUT_CACHE
+const uint tableSize = 512u;  // 2x o grupo: sondagem linear curta
+const uint emptyKey = 0xFFFFFFFFu;
+shared uint cellKeys[tableSize];
+shared uint cellCorners[tableSize * 8u];  // RGB8 dos 8 cantos (a LUT é de 8 bits): 16 KB
+
+vec3 corner(uint slot, int index) {
+    return unpackUnorm4x8(cellCorners[slot * 8u + uint(index)]).rgb;
+}
+#else
+// Igual ao fragment shader: bilinear do hardware em r/b, mix entre fatias de g
+vec3 applyLUT3D(vec3 color) {
+    float u = (color.r * (lutSize - 1.0) + 0.5) / lutSize;
+    float v = (color.b * (lutSize - 1.0) + 0.5) / lutSize;
+    float slice = color.g * (lutSize - 1.0);
+    float sliceFloor = floor(slice);
+    float sliceWidth = 1.0 / lutSize;
+    vec3 sample0 = textureLod(lutTexture, vec2((u + sliceFloor) * sliceWidth, v), 0.0).rgb;
+    vec3 sample1 = textureLod(lutTexture, vec2((u + sliceFloor + 1.0) * sliceWidth, v), 0.0).rgb;
+    return mix(sample0, sample1, slice - sliceFloor);
+}
+#endif
+
+void main() {
+    // Decisão por grupo: sair aqui mantém as barreiras em fluxo uniforme
+    uvec2 tile = gl_WorkGroupID.xy;
+    if (useTileList) {
+        uint index = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+        if (index >= tileCount) return;
+        tile = uvec2(dirtyTiles[index] & 0xFFFFu, dirtyTiles[index] >> 16u);
+    }
+
+    ivec2 pixel = ivec2(tile * gl_WorkGroupSize.xy + gl_LocalInvocationID.xy);
+    bool inside = all(lessThan(pixel, imageSize(sourceImage)));
+    vec3 srgb = inside ? imageLoad(sourceImage, pixel).rgb : vec3(0.0);
+    bool lookup = enableCorrection && useLUT && inside;
+    if (gl_LocalInvocationIndex == 0u) atomicAdd(filteredGroups, 1u);
+
+#ifdef SHARED_LUT_CACHE
+    // Célula da LUT: cantos cell e cell + 1 (a última célula fecha em 1.0)
+    vec3 position = srgb * float(lutSize - 1);
+    ivec3 cell = min(ivec3(position), ivec3(lutSize - 2));
+    vec3 fraction = position - vec3(cell);
+
+    for (uint i = gl_LocalInvocationIndex; i < tableSize; i += 256u) cellKeys[i] = emptyKey;
+    barrier();
+
+    uint key = uint((cell.b * lutSize + cell.g) * lutSize + cell.r);
+    uint slot = (key * 2654435761u) >> 23u;
+    bool owner = false;
+    if (lookup) {
+        while (true) {
+            uint previous = atomicCompSwap(cellKeys[slot], emptyKey, key);
+            if (previous == emptyKey) {
+                owner = true;
+                break;
+            }
+            if (previous == key) break;
+            slot = (slot + 1u) & (tableSize - 1u);
+        }
+    }
+    if (owner) {
+        for (int index = 0; index < 8; index++) {
+            ivec3 p = cell + ivec3(index & 1, (index >> 1) & 1, index >> 2);
+            vec3 point = texelFetch(lutTexture, ivec2(p.g * lutSize + p.r, p.b), 0).rgb;
+            cellCorners[slot * 8u + uint(index)] = packUnorm4x8(vec4(point, 0.0));
+        }
+        atomicAdd(lutCells, 1u);
+    }
+    barrier();
+#endif
+    if (!inside) return;
+
+    vec3 color = linearLight ? srgbToLinear(srgb) : srgb;
+    vec3 corrected = color;
+    if (lookup) {
+#ifdef SHARED_LUT_CACHE
+        vec3 g0 = mix(mix(corner(slot, 0), corner(slot, 1), fraction.r),
+                      mix(corner(slot, 2), corner(slot, 3), fraction.r), fraction.g);
+        vec3 g1 = mix(mix(corner(slot, 4), corner(slot, 5), fraction.r),
+                      mix(corner(slot, 6), corner(slot, 7), fraction.r), fraction.g);
+        corrected = mix(g0, g1, fraction.b);
+#else
+        corrected = applyLUT3D(srgb);
+#endif
+        if (linearLight) corrected = srgbToLinear(corrected);
+    } else if (enableCorrection) {
+        corrected = hybridCorrection(color);
+    }
+
+    vec3 final = enableCorrection ? mix(color, corrected, correctionStrength) : color;
+    vec3 encoded = linearLight ? linearToSrgb(final) : final;
+    if (dither && enableCorrection) {
+        float noise = (texelFetch(noiseTexture, pixel & 63, 0).r * 255.0 + 0.5) / 256.0 - 0.5;
+        encoded = clamp(encoded + noise / 255.0, 0.0, 1.0);
+    }
+    imageStore(targetImage, pixel, vec4(encoded, 1.0));
+}
+)";
+
+#endif // OVERLAY_SHADERS_H
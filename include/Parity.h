@@ -0,0 +1,353 @@
+#ifndef PARITY_H
+#define PARITY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Frame.h"
+#include "Lut3D.h"
+#include "PixelConvert.h"
+#include "SRGB.h"
+
+// ==================== PARIDADE ENTRE KERNELS ====================
+// Base do tools/paritycheck.cpp: um filtro de referência simples (double,
+// trilinear direto na Lut3D, sem tabelas) e a comparação pixel a pixel de um
+// kernel contra ele ou contra outro kernel. Cada kernel tem uma regra:
+//   exata           todos os bytes iguais (ex.: sub-retângulo vs frame inteiro)
+//   até N LSB       arredondamento diferente (float vs double, 10 bits -> 8)
+//   ΔE              aproximações visuais (LUT de 1 ponto, croma 2x2, GPU)
+// ΔE é o CIE76 (distância em L*a*b*, D65): ~1 é o limiar de percepção. No
+// YUV 4:2:0 o erro em bordas duras é o esperado e não diz nada; a regra fica
+// só na média. O croma 2x2 corrige as bordas de croma pixel a pixel e tem
+// também um máximo.
+//
+// Convenção de eixos usada em todo lugar (ver Lut3D.h): faixa horizontal
+// x = g * N + r, y = b; a vertical é a transposta.
+struct ParityRule {
+    int maxChannelDiff = 0;      // maior diferença aceita em um canal (0 = exata)
+    double maxDeltaE = 0.0;      // 0 = não verifica
+    double p99DeltaE = 0.0;      // 0 = não verifica
+    double meanDeltaE = 0.0;     // 0 = não verifica
+
+    static ParityRule exact() { return ParityRule(); }
+
+    static ParityRule withinLsb(int lsb) {
+        ParityRule rule;
+        rule.maxChannelDiff = lsb;
+        return rule;
+    }
+
+    static ParityRule deltaE(double maxValue, double meanValue) {
+        ParityRule rule;
+        rule.maxChannelDiff = 255;
+        rule.maxDeltaE = maxValue;
+        rule.meanDeltaE = meanValue;
+        return rule;
+    }
+
+    static ParityRule deltaEPercentile(double p99Value, double meanValue) {
+        ParityRule rule;
+        rule.maxChannelDiff = 255;
+        rule.p99DeltaE = p99Value;
+        rule.meanDeltaE = meanValue;
+        return rule;
+    }
+
+    std::string describe() const {
+        if (maxChannelDiff == 0) return "exata";
+        char text[96];
+        if (maxDeltaE == 0.0 && p99DeltaE == 0.0 && meanDeltaE == 0.0) {
+            std::snprintf(text, sizeof(text), "até %d LSB", maxChannelDiff);
+            return text;
+        }
+        std::string result = "ΔE";
+        if (maxDeltaE > 0.0) {
+            std::snprintf(text, sizeof(text), " máx %.1f", maxDeltaE);
+            result += text;
+        }
+        if (p99DeltaE > 0.0) {
+            std::snprintf(text, sizeof(text), " p99 %.1f", p99DeltaE);
+            result += text;
+        }
+        if (meanDeltaE > 0.0) {
+            std::snprintf(text, sizeof(text), " médio %.2f", meanDeltaE);
+            result += text;
+        }
+        return result;
+    }
+};
+
+struct ParityReport {
+    int maxChannelDiff = 0;
+    size_t differingPixels = 0;
+    double maxDeltaE = 0.0;
+    double meanDeltaE = 0.0;
+    int worstX = -1, worstY = -1;  // pixel com o maior ΔE
+    bool pass = false;
+    size_t pixels = 0;             // pixels comparados
+    std::vector<uint32_t> histogram = std::vector<uint32_t>(HISTOGRAM_BINS, 0);  // ΔE em passos de 0.1
+
+    static constexpr int HISTOGRAM_BINS = 1001;  // último: ΔE >= 100
+
+    static int bin(double deltaE) { return std::min(HISTOGRAM_BINS - 1, (int)(deltaE * 10.0)); }
+
+    // ΔE abaixo do qual fica a fração 'p' dos pixels (limite superior do passo)
+    double percentile(double p) const {
+        size_t target = (size_t)std::ceil(p * pixels), seen = 0;
+        for (int i = 0; i < HISTOGRAM_BINS; i++) {
+            seen += histogram[i];
+            if (seen >= target) return i == 0 ? 0.0 : (i + 1) / 10.0;
+        }
+        return maxDeltaE;
+    }
+
+    // Junta o relatório de outro frame: pior caso; ΔE médio ponderado por pixel
+    void merge(const ParityReport& other) {
+        if (pixels == 0 || other.maxDeltaE > maxDeltaE) {
+            worstX = other.worstX;
+            worstY = other.worstY;
+        }
+        maxChannelDiff = std::max(maxChannelDiff, other.maxChannelDiff);
+        differingPixels += other.differingPixels;
+        maxDeltaE = std::max(maxDeltaE, other.maxDeltaE);
+        size_t total = pixels + other.pixels;
+        meanDeltaE = total ? (meanDeltaE * pixels + other.meanDeltaE * other.pixels) / total : 0.0;
+        for (int i = 0; i < HISTOGRAM_BINS; i++) histogram[i] += other.histogram[i];
+        pass = (pixels == 0 || pass) && other.pass;
+        pixels = total;
+    }
+};
+
+// Banding em gradientes (./colorbench dither), em LSB
+struct BandingReport {
+    double rms = 0.0;
+    double max = 0.0;
+};
+
+class Parity {
+public:
+    // sRGB 8 bits -> L*a*b* (D65)
+    static void toLab(uint8_t r8, uint8_t g8, uint8_t b8, double lab[3]) {
+        double r = SRGB::toLinear(r8 / 255.0f), g = SRGB::toLinear(g8 / 255.0f), b = SRGB::toLinear(b8 / 255.0f);
+        double x = (0.4124564 * r + 0.3575761 * g + 0.1804375 * b) / 0.95047;
+        double y = (0.2126729 * r + 0.7151522 * g + 0.0721750 * b);
+        double z = (0.0193339 * r + 0.1191920 * g + 0.9503041 * b) / 1.08883;
+        auto f = [](double t) { return t > 216.0 / 24389.0 ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0; };
+        double fx = f(x), fy = f(y), fz = f(z);
+        lab[0] = 116.0 * fy - 16.0;
+        lab[1] = 500.0 * (fx - fy);
+        lab[2] = 200.0 * (fy - fz);
+    }
+
+    static double deltaE(const uint8_t* bgraA, const uint8_t* bgraB) {
+        double a[3], b[3];
+        toLab(bgraA[2], bgraA[1], bgraA[0], a);
+        toLab(bgraB[2], bgraB[1], bgraB[0], b);
+        return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+    }
+
+    // Frames BGRA8 do mesmo tamanho; o alfa entra na diferença por canal
+    static ParityReport compare(const FrameView& reference, const FrameView& test, const ParityRule& rule) {
+        ParityReport report;
+        if (reference.format != PixelFormat::BGRA8 || test.format != PixelFormat::BGRA8 ||
+            reference.width != test.width || reference.height != test.height) {
+            return report;
+        }
+
+        double sumDeltaE = 0.0;
+        for (int y = 0; y < reference.height; y++) {
+            const uint8_t* a = reference.row(0, y);
+            const uint8_t* b = test.row(0, y);
+            for (int x = 0; x < reference.width; x++, a += 4, b += 4) {
+                int diff = 0;
+                for (int c = 0; c < 4; c++) diff = std::max(diff, std::abs((int)a[c] - (int)b[c]));
+                if (diff == 0) {
+                    report.histogram[0]++;
+                    continue;
+                }
+                report.differingPixels++;
+                report.maxChannelDiff = std::max(report.maxChannelDiff, diff);
+                double e = deltaE(a, b);
+                sumDeltaE += e;
+                report.histogram[ParityReport::bin(e)]++;
+                if (e > report.maxDeltaE || report.worstX < 0) {
+                    report.maxDeltaE = e;
+                    report.worstX = x;
+                    report.worstY = y;
+                }
+            }
+        }
+        report.pixels = (size_t)reference.width * reference.height;
+        report.meanDeltaE = report.pixels ? sumDeltaE / report.pixels : 0.0;
+
+        report.pass = report.maxChannelDiff <= rule.maxChannelDiff;
+        if (rule.maxDeltaE > 0.0) report.pass = report.pass && report.maxDeltaE <= rule.maxDeltaE;
+        if (rule.p99DeltaE > 0.0) report.pass = report.pass && report.percentile(0.99) <= rule.p99DeltaE;
+        if (rule.meanDeltaE > 0.0) report.pass = report.pass && report.meanDeltaE <= rule.meanDeltaE;
+        return report;
+    }
+
+    // Filtro de referência: a definição da correção, sem nenhuma otimização.
+    //   saida = mix(original, trilinear(LUT, original), intensidade)
+    // linearLight: a mistura é em luz linear (frames scRGB / RGBA16F, como o
+    // caminho linear do shader); a consulta continua em sRGB
+    static void referenceApply(const Lut3D& lut, float strength, const FrameView& src, const FrameView& dst,
+                               bool linearLight = false) {
+        const int n = lut.size;
+        for (int y = 0; y < src.height; y++) {
+            const uint8_t* s = src.row(0, y);
+            uint8_t* d = dst.row(0, y);
+            for (int x = 0; x < src.width; x++, s += 4, d += 4) {
+                double rgb[3] = { s[2] / 255.0, s[1] / 255.0, s[0] / 255.0 };
+                int i0[3], i1[3];
+                double f[3];
+                for (int c = 0; c < 3; c++) {
+                    double p = rgb[c] * (n - 1);
+                    i0[c] = std::min((int)p, n - 1);
+                    i1[c] = std::min(i0[c] + 1, n - 1);
+                    f[c] = p - i0[c];
+                }
+                double corrected[3] = { 0.0, 0.0, 0.0 };
+                for (int corner = 0; corner < 8; corner++) {
+                    int ir = corner & 1 ? i1[0] : i0[0];
+                    int ig = corner & 2 ? i1[1] : i0[1];
+                    int ib = corner & 4 ? i1[2] : i0[2];
+                    double w = (corner & 1 ? f[0] : 1.0 - f[0]) * (corner & 2 ? f[1] : 1.0 - f[1]) *
+                               (corner & 4 ? f[2] : 1.0 - f[2]);
+                    const uint8_t* t = lut.at(ir, ig, ib);
+                    for (int c = 0; c < 3; c++) corrected[c] += w * t[c];
+                }
+                for (int c = 0; c < 3; c++) {
+                    double v = rgb[c] * 255.0 + (corrected[c] - rgb[c] * 255.0) * strength;
+                    if (linearLight) {
+                        double from = SRGB::toLinear((float)rgb[c]);
+                        double to = SRGB::toLinear((float)(corrected[c] / 255.0));
+                        v = SRGB::toSRGB((float)(from + (to - from) * strength)) * 255.0;
+                    }
+                    d[2 - c] = (uint8_t)std::min(255.0, std::max(0.0, std::floor(v + 0.5)));
+                }
+                d[3] = s[3];
+            }
+        }
+    }
+
+    // Correção exata de cada pixel em float, sem LUT nem arredondamento:
+    // 3 valores por pixel em [0, 255], na ordem B, G, R do frame
+    static std::vector<float> exactOutput(const FrameView& src, const std::function<RGB(RGB)>& correction,
+                                          float strength) {
+        std::vector<float> exact((size_t)src.width * src.height * 3);
+        float* e = exact.data();
+        for (int y = 0; y < src.height; y++) {
+            const uint8_t* s = src.row(0, y);
+            for (int x = 0; x < src.width; x++, s += 4, e += 3) {
+                RGB c = { s[2] / 255.0f, s[1] / 255.0f, s[0] / 255.0f };
+                RGB out = ColorCorrection::mix(c, correction(c), strength);
+                e[0] = out.b * 255.0f;
+                e[1] = out.g * 255.0f;
+                e[2] = out.r * 255.0f;
+            }
+        }
+        return exact;
+    }
+
+    // Degraus do arredondamento: o erro (saída - exata) visto por um
+    // passa-faixa. A média em 7x7 faz o papel do olho (o grão do dither some
+    // nela); subtrair a média em 49x49 tira o erro lento. Sobra a estrutura
+    // entre as duas escalas: os contornos da volta para 8 bits, que o dither
+    // desfaz. Não separa tamanhos de LUT: o erro da interpolação é lento.
+    static BandingReport banding(const FrameView& output, const std::vector<float>& exact, int bandHeight) {
+        return filteredError(output, exact, bandHeight, true);
+    }
+
+    // Banding da interpolação: a mesma média em 7x7 do erro, sem o
+    // passa-alta, contra a correção analítica. Mede o quanto a rampa vista
+    // se afasta da exata entre os nós da grade (e pelo arredondamento dos
+    // nós para 8 bits); cai com o tamanho da LUT e o dither não tira.
+    static BandingReport interpolationBanding(const FrameView& output, const std::vector<float>& exact,
+                                              int bandHeight) {
+        return filteredError(output, exact, bandHeight, false);
+    }
+
+private:
+    // As médias não atravessam as faixas de 'bandHeight' linhas (rampas)
+    static BandingReport filteredError(const FrameView& output, const std::vector<float>& exact, int bandHeight,
+                                       bool highPass) {
+        BandingReport report;
+        const int width = output.width, height = output.height;
+        const int fine = 3, coarse = 24;  // raios das médias
+        std::vector<double> table((size_t)(width + 1) * (bandHeight + 1));
+        double sumSquares = 0.0;
+        size_t samples = 0;
+        for (int band = 0; band + bandHeight <= height; band += bandHeight) {
+            for (int c = 0; c < 3; c++) {
+                // Tabela de somas acumuladas do erro na faixa
+                for (int y = 0; y < bandHeight; y++) {
+                    const uint8_t* o = output.row(0, band + y);
+                    const float* e = &exact[((size_t)(band + y) * width) * 3];
+                    double rowSum = 0.0;
+                    for (int x = 0; x < width; x++) {
+                        rowSum += o[x * 4 + c] - e[x * 3 + c];
+                        table[(size_t)(y + 1) * (width + 1) + x + 1] = table[(size_t)y * (width + 1) + x + 1] + rowSum;
+                    }
+                }
+                auto mean = [&](int x, int y, int radius) {
+                    int x0 = std::max(0, x - radius), x1 = std::min(width, x + radius + 1);
+                    int y0 = std::max(0, y - radius), y1 = std::min(bandHeight, y + radius + 1);
+                    const size_t stride = width + 1;
+                    double sum = table[y1 * stride + x1] - table[y0 * stride + x1] - table[y1 * stride + x0] +
+                                 table[y0 * stride + x0];
+                    return sum / ((x1 - x0) * (y1 - y0));
+                };
+                for (int y = 0; y < bandHeight; y++) {
+                    for (int x = 0; x < width; x++) {
+                        double visible = mean(x, y, fine) - (highPass ? mean(x, y, coarse) : 0.0);
+                        sumSquares += visible * visible;
+                        report.max = std::max(report.max, std::fabs(visible));
+                        samples++;
+                    }
+                }
+            }
+        }
+        report.rms = samples ? std::sqrt(sumSquares / samples) : 0.0;
+        return report;
+    }
+
+public:
+    // PPM (P6, RGB) para inspecionar ou guardar imagens de referência
+    static bool writePPM(const std::string& path, const FrameView& frame) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        std::fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height);
+        std::vector<uint8_t> rgb((size_t)frame.width * 3);
+        bool ok = true;
+        for (int y = 0; y < frame.height && ok; y++) {
+            PixelConvert::pack3(frame.row(0, y), rgb.data(), frame.width, true);
+            ok = std::fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size();
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    // Lê um PPM gravado por writePPM para um frame BGRA8 (alfa 255)
+    static bool readPPM(const std::string& path, std::vector<uint8_t>& bgra, int& width, int& height) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        int maxValue = 0;
+        bool ok = std::fscanf(file, "P6 %d %d %d", &width, &height, &maxValue) == 3 && maxValue == 255 &&
+                  width > 0 && height > 0 && std::fgetc(file) != EOF;
+        if (ok) {
+            std::vector<uint8_t> rgb((size_t)width * height * 3);
+            ok = std::fread(rgb.data(), 1, rgb.size(), file) == rgb.size();
+            bgra.resize((size_t)width * height * 4);
+            if (ok) PixelConvert::unpack3(rgb.data(), bgra.data(), (size_t)width * height, true);
+        }
+        std::fclose(file);
+        return ok;
+    }
+};
+
+#endif // PARITY_H
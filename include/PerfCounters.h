@@ -0,0 +1,131 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ==================== CONTADORES DE HARDWARE ====================
+// Contadores da thread atual para os benchmarks: page faults (getrusage) e,
+// quando o kernel permite (perf_event_paranoid / VMs sem PMU), eventos de
+// hardware via perf_event_open. Contador indisponível fica com valor -1.
+class PerfCounters {
+public:
+    enum Event {
+        PageFaults,       // minor + major (software, sempre disponível em Linux)
+        DtlbLoadMisses,   // misses de TLB de dados em leituras
+        L1dLoadMisses,    // leituras que não acharam a linha no L1 de dados
+        CacheMisses,      // misses do último nível de cache
+        Instructions,
+        Cycles,
+        EventCount
+    };
+
+    struct Sample {
+        int64_t values[EventCount];
+        int64_t operator[](Event e) const { return values[e]; }
+    };
+
+private:
+    int fds[EventCount];
+    int64_t startFaults = 0;
+    Sample result;
+
+public:
+    PerfCounters() {
+        for (int i = 0; i < EventCount; i++) {
+            fds[i] = -1;
+            result.values[i] = -1;
+        }
+#ifdef __linux__
+        fds[DtlbLoadMisses] = open(PERF_TYPE_HW_CACHE,
+                                   PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds[L1dLoadMisses] = open(PERF_TYPE_HW_CACHE,
+                                  PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds[CacheMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[Instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[Cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event e) const { return e == PageFaults ? pageFaultsAvailable() : fds[e] >= 0; }
+
+    void start() {
+        startFaults = pageFaults();
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    const Sample& stop() {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; i++) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            result.values[i] = (read(fds[i], &value, sizeof(value)) == sizeof(value)) ? (int64_t)value : -1;
+        }
+#endif
+        result.values[PageFaults] = pageFaultsAvailable() ? pageFaults() - startFaults : -1;
+        return result;
+    }
+
+private:
+    static bool pageFaultsAvailable() {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static int64_t pageFaults() {
+#ifdef __linux__
+        struct rusage usage;
+        getrusage(RUSAGE_THREAD, &usage);
+        return (int64_t)usage.ru_minflt + usage.ru_majflt;
+#else
+        return 0;
+#endif
+    }
+
+#ifdef __linux__
+    static int open(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,380 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "CpuFeatures.h"
+
+// ==================== CONVERSÃO DE FORMATOS DE PIXEL (8 bits) ====================
+// Todas as trocas de layout de 8 bits por canal passam por aqui: captura
+// (GDI/DXGI entregam BGRA), LUTs em PNG (RGB ou RGBA), imagens de referência
+// em PPM (RGB24) e planos separados por canal. Cada conversão tem um laço
+// escalar (também o fim de cada linha) e versões SSSE3 (pshufb, 16 pixels
+// por iteração) e AVX2 (32 pixels); a melhor é escolhida em tempo de
+// execução, como em SRGB.h. As funções trabalham em 'count' pixels
+// contíguos, ou seja, uma linha de um FrameView.
+//
+//   swapRB      BGRA <-> RGBA (pode ser in-place)
+//   pack3       4 canais -> 3 (descarta o alfa; com swapRB, BGRA -> RGB24)
+//   unpack3     3 canais -> 4 (alfa 255; com swapRB, RGB24 -> BGRA)
+//   fillAlpha   alfa constante, in-place
+//   split4      intercalado -> 4 planos (planes[3] nullptr: sem o alfa)
+//   merge4      4 planos -> intercalado (planes[3] nullptr: alfa 255)
+class PixelConvert {
+public:
+    enum class Level { Scalar, SSSE3, AVX2 };
+
+    static Level bestLevel() {
+        static const Level level = detectLevel();
+        return level;
+    }
+
+    static bool isSupported(Level level) {
+        const CpuFeatures& f = CpuFeatures::get();
+        return level == Level::Scalar || (level == Level::SSSE3 && f.ssse3) || (level == Level::AVX2 && f.avx2);
+    }
+
+    static const char* levelName(Level level) {
+        switch (level) {
+            case Level::SSSE3: return "SSSE3";
+            case Level::AVX2: return "AVX2";
+            default: return "escalar";
+        }
+    }
+
+    static void swapRB(const uint8_t* src, uint8_t* dst, size_t count, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = swapRB_AVX2(src, dst, count);
+        if (level == Level::SSSE3) done = swapRB_SSSE3(src, dst, count);
+#endif
+        for (size_t i = done; i < count; i++) {
+            const uint8_t* s = src + i * 4;
+            uint8_t* d = dst + i * 4;
+            uint8_t c0 = s[0];
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = c0;
+            d[3] = s[3];
+        }
+    }
+
+    static void pack3(const uint8_t* src, uint8_t* dst, size_t count, bool swap, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = pack3_AVX2(src, dst, count, swap);
+        if (level == Level::SSSE3) done = pack3_SSSE3(src, dst, count, swap);
+#endif
+        const int r = swap ? 2 : 0, b = swap ? 0 : 2;
+        for (size_t i = done; i < count; i++) {
+            const uint8_t* s = src + i * 4;
+            uint8_t* d = dst + i * 3;
+            d[0] = s[r];
+            d[1] = s[1];
+            d[2] = s[b];
+        }
+    }
+
+    static void unpack3(const uint8_t* src, uint8_t* dst, size_t count, bool swap, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = unpack3_AVX2(src, dst, count, swap);
+        if (level == Level::SSSE3) done = unpack3_SSSE3(src, dst, count, swap);
+#endif
+        const int r = swap ? 2 : 0, b = swap ? 0 : 2;
+        for (size_t i = done; i < count; i++) {
+            const uint8_t* s = src + i * 3;
+            uint8_t* d = dst + i * 4;
+            d[0] = s[r];
+            d[1] = s[1];
+            d[2] = s[b];
+            d[3] = 255;
+        }
+    }
+
+    static void fillAlpha(uint8_t* pixels, size_t count, uint8_t alpha = 255, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = fillAlpha_AVX2(pixels, count, alpha);
+        if (level == Level::SSSE3) done = fillAlpha_SSSE3(pixels, count, alpha);
+#endif
+        for (size_t i = done; i < count; i++) pixels[i * 4 + 3] = alpha;
+    }
+
+    static void split4(const uint8_t* src, uint8_t* const planes[4], size_t count, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = split4_AVX2(src, planes, count);
+        if (level == Level::SSSE3) done = split4_SSSE3(src, planes, count);
+#endif
+        int channels = planes[3] ? 4 : 3;
+        for (size_t i = done; i < count; i++) {
+            for (int c = 0; c < channels; c++) planes[c][i] = src[i * 4 + c];
+        }
+    }
+
+    static void merge4(const uint8_t* const planes[4], uint8_t* dst, size_t count, Level level = bestLevel()) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (level == Level::AVX2) done = merge4_AVX2(planes, dst, count);
+        if (level == Level::SSSE3) done = merge4_SSSE3(planes, dst, count);
+#endif
+        for (size_t i = done; i < count; i++) {
+            dst[i * 4 + 0] = planes[0][i];
+            dst[i * 4 + 1] = planes[1][i];
+            dst[i * 4 + 2] = planes[2][i];
+            dst[i * 4 + 3] = planes[3] ? planes[3][i] : 255;
+        }
+    }
+
+private:
+    static Level detectLevel() {
+        const CpuFeatures& f = CpuFeatures::get();
+        if (f.avx2) return Level::AVX2;
+        if (f.ssse3) return Level::SSSE3;
+        return Level::Scalar;
+    }
+
+#if DALTONISMO_X86_SIMD
+    // ---------- Máscaras do pshufb (-1 zera o byte) ----------
+
+    DALTONISMO_TARGET("ssse3")
+    static __m128i swapMask() { return _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15); }
+
+    // 4 pixels de 4 bytes -> 12 bytes no começo do registro
+    DALTONISMO_TARGET("ssse3")
+    static __m128i packMask(bool swap) {
+        return swap ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                    : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    }
+
+    // 12 bytes -> 4 pixels com o byte de alfa zerado
+    DALTONISMO_TARGET("ssse3")
+    static __m128i unpackMask(bool swap) {
+        return swap ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                    : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    }
+
+    // Agrupa os canais de 4 pixels: um dword por canal
+    DALTONISMO_TARGET("ssse3")
+    static __m128i channelMask() { return _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15); }
+
+    // ---------- SSSE3 ----------
+
+    DALTONISMO_TARGET("ssse3")
+    static size_t swapRB_SSSE3(const uint8_t* src, uint8_t* dst, size_t count) {
+        const __m128i mask = swapMask();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i * 4 + 16));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_shuffle_epi8(a, mask));
+            _mm_storeu_si128((__m128i*)(dst + i * 4 + 16), _mm_shuffle_epi8(b, mask));
+        }
+        return i;
+    }
+
+    // 16 pixels (64 bytes) -> 48 bytes: quatro blocos de 12 emendados com shifts
+    DALTONISMO_TARGET("ssse3")
+    static size_t pack3_SSSE3(const uint8_t* src, uint8_t* dst, size_t count, bool swap) {
+        const __m128i mask = packMask(swap);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i* s = (const __m128i*)(src + i * 4);
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(s + 0), mask);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(s + 1), mask);
+            __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(s + 2), mask);
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(s + 3), mask);
+            __m128i* o = (__m128i*)(dst + i * 3);
+            _mm_storeu_si128(o + 0, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+            _mm_storeu_si128(o + 1, _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+            _mm_storeu_si128(o + 2, _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+        }
+        return i;
+    }
+
+    // 48 bytes -> 16 pixels; palignr separa as janelas de 12 bytes sem ler além
+    DALTONISMO_TARGET("ssse3")
+    static size_t unpack3_SSSE3(const uint8_t* src, uint8_t* dst, size_t count, bool swap) {
+        const __m128i mask = unpackMask(swap);
+        const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i* s = (const __m128i*)(src + i * 3);
+            __m128i in0 = _mm_loadu_si128(s + 0);
+            __m128i in1 = _mm_loadu_si128(s + 1);
+            __m128i in2 = _mm_loadu_si128(s + 2);
+            __m128i* o = (__m128i*)(dst + i * 4);
+            _mm_storeu_si128(o + 0, _mm_or_si128(_mm_shuffle_epi8(in0, mask), alpha));
+            _mm_storeu_si128(o + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), mask), alpha));
+            _mm_storeu_si128(o + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), mask), alpha));
+            _mm_storeu_si128(o + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(in2, 4), mask), alpha));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("ssse3")
+    static size_t fillAlpha_SSSE3(uint8_t* pixels, size_t count, uint8_t alpha) {
+        const __m128i keep = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i value = _mm_set1_epi32((int)((uint32_t)alpha << 24));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i* p = (__m128i*)(pixels + i * 4);
+            _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(p), keep), value));
+        }
+        return i;
+    }
+
+    // 16 pixels: agrupa os canais de cada 4 e transpõe a matriz 4x4 de dwords
+    DALTONISMO_TARGET("ssse3")
+    static size_t split4_SSSE3(const uint8_t* src, uint8_t* const planes[4], size_t count) {
+        const __m128i mask = channelMask();
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m128i* s = (const __m128i*)(src + i * 4);
+            __m128i t0 = _mm_shuffle_epi8(_mm_loadu_si128(s + 0), mask);
+            __m128i t1 = _mm_shuffle_epi8(_mm_loadu_si128(s + 1), mask);
+            __m128i t2 = _mm_shuffle_epi8(_mm_loadu_si128(s + 2), mask);
+            __m128i t3 = _mm_shuffle_epi8(_mm_loadu_si128(s + 3), mask);
+            __m128i lo01 = _mm_unpacklo_epi32(t0, t1), hi01 = _mm_unpackhi_epi32(t0, t1);
+            __m128i lo23 = _mm_unpacklo_epi32(t2, t3), hi23 = _mm_unpackhi_epi32(t2, t3);
+            _mm_storeu_si128((__m128i*)(planes[0] + i), _mm_unpacklo_epi64(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(planes[1] + i), _mm_unpackhi_epi64(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(planes[2] + i), _mm_unpacklo_epi64(hi01, hi23));
+            if (planes[3]) _mm_storeu_si128((__m128i*)(planes[3] + i), _mm_unpackhi_epi64(hi01, hi23));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("ssse3")
+    static size_t merge4_SSSE3(const uint8_t* const planes[4], uint8_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m128i c0 = _mm_loadu_si128((const __m128i*)(planes[0] + i));
+            __m128i c1 = _mm_loadu_si128((const __m128i*)(planes[1] + i));
+            __m128i c2 = _mm_loadu_si128((const __m128i*)(planes[2] + i));
+            __m128i c3 = planes[3] ? _mm_loadu_si128((const __m128i*)(planes[3] + i)) : _mm_set1_epi8((char)255);
+            __m128i lo01 = _mm_unpacklo_epi8(c0, c1), hi01 = _mm_unpackhi_epi8(c0, c1);
+            __m128i lo23 = _mm_unpacklo_epi8(c2, c3), hi23 = _mm_unpackhi_epi8(c2, c3);
+            __m128i* o = (__m128i*)(dst + i * 4);
+            _mm_storeu_si128(o + 0, _mm_unpacklo_epi16(lo01, lo23));
+            _mm_storeu_si128(o + 1, _mm_unpackhi_epi16(lo01, lo23));
+            _mm_storeu_si128(o + 2, _mm_unpacklo_epi16(hi01, hi23));
+            _mm_storeu_si128(o + 3, _mm_unpackhi_epi16(hi01, hi23));
+        }
+        return i;
+    }
+
+    // ---------- AVX2 (pshufb trabalha por metade de 128 bits) ----------
+
+    DALTONISMO_TARGET("avx2")
+    static __m256i broadcast(__m128i mask) { return _mm256_broadcastsi128_si256(mask); }
+
+    DALTONISMO_TARGET("avx2")
+    static size_t swapRB_AVX2(const uint8_t* src, uint8_t* dst, size_t count) {
+        const __m256i mask = broadcast(swapMask());
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + i * 4 + 32));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_shuffle_epi8(a, mask));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4 + 32), _mm256_shuffle_epi8(b, mask));
+        }
+        return i;
+    }
+
+    // 8 pixels -> 24 bytes: pshufb deixa 12 bytes no começo de cada metade e
+    // o permute junta as duas. A escrita é de 32 bytes (8 além dos 24), então
+    // o laço para antes dos últimos 3 pixels.
+    DALTONISMO_TARGET("avx2")
+    static size_t pack3_AVX2(const uint8_t* src, uint8_t* dst, size_t count, bool swap) {
+        const __m256i mask = broadcast(packMask(swap));
+        const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+        size_t i = 0;
+        for (; i + 8 + 3 <= count; i += 8) {
+            __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i * 4)), mask);
+            _mm256_storeu_si256((__m256i*)(dst + i * 3), _mm256_permutevar8x32_epi32(v, compact));
+        }
+        return i;
+    }
+
+    // 24 bytes -> 8 pixels: o permute leva os bytes 12-23 para a metade de
+    // cima. Lê 32 bytes (8 além), então o laço para antes dos últimos 3 pixels.
+    DALTONISMO_TARGET("avx2")
+    static size_t unpack3_AVX2(const uint8_t* src, uint8_t* dst, size_t count, bool swap) {
+        const __m256i mask = broadcast(unpackMask(swap));
+        const __m256i spread = _mm256_setr_epi32(0, 1, 2, 2, 3, 4, 5, 5);
+        const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+        size_t i = 0;
+        for (; i + 8 + 3 <= count; i += 8) {
+            __m256i v = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(src + i * 3)), spread);
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, mask), alpha));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("avx2")
+    static size_t fillAlpha_AVX2(uint8_t* pixels, size_t count, uint8_t alpha) {
+        const __m256i keep = _mm256_set1_epi32(0x00FFFFFF);
+        const __m256i value = _mm256_set1_epi32((int)((uint32_t)alpha << 24));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i* p = (__m256i*)(pixels + i * 4);
+            _mm256_storeu_si256(p, _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(p), keep), value));
+        }
+        return i;
+    }
+
+    // 32 pixels: mesma transposição por metade; no fim cada metade tem
+    // blocos de 4 pixels intercalados e o permute os põe em ordem
+    DALTONISMO_TARGET("avx2")
+    static size_t split4_AVX2(const uint8_t* src, uint8_t* const planes[4], size_t count) {
+        const __m256i mask = broadcast(channelMask());
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            const __m256i* s = (const __m256i*)(src + i * 4);
+            __m256i t0 = _mm256_shuffle_epi8(_mm256_loadu_si256(s + 0), mask);
+            __m256i t1 = _mm256_shuffle_epi8(_mm256_loadu_si256(s + 1), mask);
+            __m256i t2 = _mm256_shuffle_epi8(_mm256_loadu_si256(s + 2), mask);
+            __m256i t3 = _mm256_shuffle_epi8(_mm256_loadu_si256(s + 3), mask);
+            __m256i lo01 = _mm256_unpacklo_epi32(t0, t1), hi01 = _mm256_unpackhi_epi32(t0, t1);
+            __m256i lo23 = _mm256_unpacklo_epi32(t2, t3), hi23 = _mm256_unpackhi_epi32(t2, t3);
+            __m256i c0 = _mm256_unpacklo_epi64(lo01, lo23), c1 = _mm256_unpackhi_epi64(lo01, lo23);
+            __m256i c2 = _mm256_unpacklo_epi64(hi01, hi23), c3 = _mm256_unpackhi_epi64(hi01, hi23);
+            _mm256_storeu_si256((__m256i*)(planes[0] + i), _mm256_permutevar8x32_epi32(c0, order));
+            _mm256_storeu_si256((__m256i*)(planes[1] + i), _mm256_permutevar8x32_epi32(c1, order));
+            _mm256_storeu_si256((__m256i*)(planes[2] + i), _mm256_permutevar8x32_epi32(c2, order));
+            if (planes[3]) _mm256_storeu_si256((__m256i*)(planes[3] + i), _mm256_permutevar8x32_epi32(c3, order));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("avx2")
+    static size_t merge4_AVX2(const uint8_t* const planes[4], uint8_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            __m256i c0 = _mm256_loadu_si256((const __m256i*)(planes[0] + i));
+            __m256i c1 = _mm256_loadu_si256((const __m256i*)(planes[1] + i));
+            __m256i c2 = _mm256_loadu_si256((const __m256i*)(planes[2] + i));
+            __m256i c3 = planes[3] ? _mm256_loadu_si256((const __m256i*)(planes[3] + i))
+                                   : _mm256_set1_epi8((char)255);
+            // Por metade: lo* = pixels 0-7 | 16-23, hi* = 8-15 | 24-31
+            __m256i lo01 = _mm256_unpacklo_epi8(c0, c1), hi01 = _mm256_unpackhi_epi8(c0, c1);
+            __m256i lo23 = _mm256_unpacklo_epi8(c2, c3), hi23 = _mm256_unpackhi_epi8(c2, c3);
+            __m256i p0 = _mm256_unpacklo_epi16(lo01, lo23);  // 0-3 | 16-19
+            __m256i p1 = _mm256_unpackhi_epi16(lo01, lo23);  // 4-7 | 20-23
+            __m256i p2 = _mm256_unpacklo_epi16(hi01, hi23);  // 8-11 | 24-27
+            __m256i p3 = _mm256_unpackhi_epi16(hi01, hi23);  // 12-15 | 28-31
+            __m256i* o = (__m256i*)(dst + i * 4);
+            _mm256_storeu_si256(o + 0, _mm256_permute2x128_si256(p0, p1, 0x20));
+            _mm256_storeu_si256(o + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+            _mm256_storeu_si256(o + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+            _mm256_storeu_si256(o + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+        }
+        return i;
+    }
+#endif
+};
+
+#endif // PIXEL_CONVERT_H
@@ -0,0 +1,280 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CpuFilter.h"
+
+// ==================== GOVERNADOR DE QUALIDADE ====================
+// Segura o tempo de frame dentro de um orçamento. Cada etapa (captura, filtro,
+// upload) informa quanto custou; com a média acima do orçamento o governador
+// desce um degrau da escada de configurações mais baratas, e sobe de volta
+// quando sobra folga. Escada padrão (pipeline de CPU), na ordem do custo
+// medido (colorbench governor, 720p com 15% em movimento: ~6.3, 2.4, 1.3,
+// 0.95 e 0.54 ms de filtro por frame capturado):
+//   0  qualidade total     (LUT trilinear, croma cheio, frame inteiro)
+//   1  croma 2x2           (uma consulta trilinear por bloco 2x2)
+//   2  + LUT 1 ponto       (vizinho mais próximo em vez de 8 pontos)
+//   3  + só blocos alterados
+//   4  + captura a 1/2 da taxa
+//
+// Só blocos alterados compara o frame inteiro com o anterior, então só vale
+// depois que o filtro já ficou barato; o pipeline refaz os blocos na saída
+// anterior sem copiar o frame inteiro. O overlay da GPU usa os mesmos modos
+// em outra ordem (overlayLadder, computeLadder).
+//
+// Reduzir a taxa de captura dá mais tempo a cada frame: o orçamento efetivo
+// é o orçamento x divisor. Histerese: desce depois de 'downFrames' frames
+// seguidos acima do orçamento; sobe depois de 'upFrames' frames com folga e
+// só se o custo previsto do degrau de cima fica abaixo de orçamento x
+// upMargin. A previsão usa a razão de custo entre os dois degraus medida na
+// troca entre eles, descida ou subida (média com a medida anterior; não
+// depende da carga da máquina), aplicada à média atual; depois de 4x o prazo
+// com folga sobe mesmo sem a previsão, que pode ter sido medida num pico.
+//
+// Limiares assimétricos: descer de um degrau o trava por 'holdFrames'
+// frames. Enquanto travado, ele só volta a ser tentado com o custo previsto
+// abaixo de orçamento x upMargin x holdRelease (a carga diminuiu de verdade,
+// ou a descida foi um pico e o degrau cabe com folga), e nunca pela regra
+// dos 4x. Carga constante assenta em um degrau em vez de oscilar na borda do
+// orçamento, onde a previsão passa de upMargin a cada queda do ruído.
+//
+// Uma thread por governador alimenta as medidas; métricas podem ser lidas de
+// qualquer thread.
+struct QualityLevel {
+    const char* name;
+    CpuFilter::Interpolation interpolation;
+    CpuFilter::ChromaMode chromaMode;
+    bool changedTilesOnly;
+    int captureDivisor;
+};
+
+class QualityGovernor {
+public:
+    enum Stage { Capture, Filter, Upload, StageCount };
+
+    struct Config {
+        double budgetMs = 1000.0 / 60.0;
+        double headroom = 0.6;   // sobe com média abaixo de orçamento x headroom
+        double upMargin = 0.8;   // ... e custo previsto no degrau de cima abaixo de orçamento x upMargin
+        int downFrames = 5;
+        int upFrames = 60;
+        int settleFrames = 10;   // ignora os primeiros frames depois de uma troca
+        int holdFrames = 1800;     // duração da trava depois de uma descida (~30 s a 60 FPS)
+        double holdRelease = 0.9;  // degrau travado: upMargin x holdRelease
+        double smoothing = 0.2;  // peso do frame novo na média móvel
+    };
+
+    struct Decision {
+        uint64_t frame;
+        int from, to;
+        double averageMs;  // média que motivou a troca
+        double budgetMs;   // orçamento efetivo no degrau de origem
+    };
+
+private:
+    Config config;
+    std::vector<QualityLevel> ladder;
+    std::vector<double> stepRatio;  // custo(i) / custo(i+1); 0 = ainda não medido
+    int pendingRatio = -1;          // razão (i, i+1) a medir depois da troca
+    double pendingCostMs = 0.0;     // média no degrau de origem na hora da troca
+    bool pendingFromUpper = false;  // a origem foi o degrau i (descida) ou i+1 (subida)
+    std::vector<uint64_t> holdUntil;  // frame em que a trava de cada degrau vence; 0 = livre
+
+    mutable std::mutex mutex;
+    int level = 0;
+    bool fixed = false;  // setFixedLevel: mede, mas não troca de degrau
+    double stageMs[StageCount] = { 0.0, 0.0, 0.0 };
+    double stageAverageMs[StageCount] = { 0.0, 0.0, 0.0 };
+    double averageMs = 0.0;
+    uint64_t frames = 0;
+    int framesAtLevel = 0;
+    int overBudget = 0, underBudget = 0;
+    std::vector<Decision> decisions;  // últimas 32
+
+public:
+    explicit QualityGovernor(const Config& cfg, std::vector<QualityLevel> levels = defaultLadder())
+        : config(cfg), ladder(std::move(levels)), stepRatio(ladder.size(), 0.0), holdUntil(ladder.size(), 0) {}
+
+    static std::vector<QualityLevel> defaultLadder() {
+        using I = CpuFilter::Interpolation;
+        using C = CpuFilter::ChromaMode;
+        return {
+            { "qualidade total",      I::Trilinear, C::Full, false, 1 },
+            { "croma 2x2",            I::Trilinear, C::Half, false, 1 },
+            { "+ LUT 1 ponto",        I::Nearest,   C::Half, false, 1 },
+            { "+ só blocos alterados", I::Nearest,  C::Half, true,  1 },
+            { "+ captura 1/2",        I::Nearest,   C::Half, true,  2 },
+        };
+    }
+
+    // Overlay com fragment shader: os mesmos modos, na ordem do custo do
+    // overlay (captura + upload + draw). Só blocos alterados vem primeiro
+    // porque não muda a imagem, só o que sobe; 1 ponto e croma 2x2 viram
+    // uniforms do shader (croma 2x2 com um passo em meia resolução).
+    // 'changedTiles' false quando o upload não passa pela CPU (PBO) ou já é
+    // só dos blocos alterados (estágios): o degrau não mudaria nada.
+    static std::vector<QualityLevel> overlayLadder(bool changedTiles = true) {
+        using I = CpuFilter::Interpolation;
+        using C = CpuFilter::ChromaMode;
+        std::vector<QualityLevel> ladder = {
+            { "qualidade total",      I::Trilinear, C::Full, false, 1 },
+            { "só blocos alterados",  I::Trilinear, C::Full, true,  1 },
+            { "+ LUT 1 ponto",        I::Nearest,   C::Full, true,  1 },
+            { "+ croma 2x2",          I::Nearest,   C::Half, true,  1 },
+            { "+ captura 1/2",        I::Nearest,   C::Half, true,  2 },
+            { "+ captura 1/3",        I::Nearest,   C::Half, true,  3 },
+        };
+        if (!changedTiles) ladder.erase(ladder.begin() + 1);
+        return ladder;
+    }
+
+    // Compute shader: sem 1 ponto nem croma 2x2 (só BGRA8 trilinear), e já
+    // refiltra só os blocos que subiram; sobra o upload e a taxa de captura
+    static std::vector<QualityLevel> computeLadder(bool changedTiles = true) {
+        using I = CpuFilter::Interpolation;
+        using C = CpuFilter::ChromaMode;
+        std::vector<QualityLevel> ladder = {
+            { "qualidade total",      I::Trilinear, C::Full, false, 1 },
+            { "só blocos alterados",  I::Trilinear, C::Full, true,  1 },
+            { "+ captura 1/2",        I::Trilinear, C::Full, true,  2 },
+            { "+ captura 1/3",        I::Trilinear, C::Full, true,  3 },
+        };
+        if (!changedTiles) ladder.erase(ladder.begin() + 1);
+        return ladder;
+    }
+
+    void recordStage(Stage stage, double ms) { stageMs[stage] += ms; }
+
+    // Fecha o frame (soma das etapas) e decide; true se o degrau mudou
+    bool endFrame() {
+        std::lock_guard<std::mutex> lock(mutex);
+        double total = 0.0;
+        for (int s = 0; s < StageCount; s++) {
+            total += stageMs[s];
+            stageAverageMs[s] += (stageMs[s] - stageAverageMs[s]) * config.smoothing;
+            stageMs[s] = 0.0;
+        }
+        frames++;
+        framesAtLevel++;
+        if (framesAtLevel <= config.settleFrames) {
+            averageMs = total;  // recomeça a média no degrau novo
+            return false;
+        }
+        averageMs += (total - averageMs) * config.smoothing;
+        if (fixed) return false;
+        if (pendingRatio >= 0 && framesAtLevel >= config.settleFrames + config.downFrames) {
+            double upper = pendingFromUpper ? pendingCostMs : averageMs;
+            double lower = pendingFromUpper ? averageMs : pendingCostMs;
+            double ratio = upper / std::max(lower, 0.001);
+            // Média com a medida anterior: uma troca causada por um pico não apaga o histórico
+            double& known = stepRatio[pendingRatio];
+            known = known > 0.0 ? (known + ratio) * 0.5 : ratio;
+            pendingRatio = -1;
+        }
+
+        double budget = effectiveBudget(level);
+        overBudget = averageMs > budget ? overBudget + 1 : 0;
+        underBudget = averageMs < budget * config.headroom ? underBudget + 1 : 0;
+
+        if (overBudget >= config.downFrames && level + 1 < (int)ladder.size()) {
+            pendingRatio = level;
+            pendingCostMs = averageMs;
+            pendingFromUpper = true;
+            holdUntil[level] = frames + config.holdFrames;
+            changeLevel(level + 1, budget);
+            return true;
+        }
+        if (level > 0 && underBudget >= config.upFrames) {
+            int up = level - 1;
+            double predicted = averageMs * (stepRatio[up] > 0.0 ? stepRatio[up] : 1.0);
+            // Com folga por 4x o prazo a razão pode estar velha (medida num
+            // pico): tenta mesmo assim, a não ser que o degrau esteja travado
+            bool held = isHeld(up);
+            bool stale = !held && underBudget >= 4 * config.upFrames;
+            if (predicted < climbLimit(up, held) || stale) {
+                pendingRatio = up;
+                pendingCostMs = averageMs;
+                pendingFromUpper = false;
+                changeLevel(up, budget);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Ex.: taxa de atualização do monitor mudou
+    void setBudgetMs(double ms) {
+        std::lock_guard<std::mutex> lock(mutex);
+        config.budgetMs = ms;
+        overBudget = underBudget = 0;
+        std::fill(holdUntil.begin(), holdUntil.end(), 0);  // travas medidas contra o orçamento antigo
+    }
+
+    // Prende o degrau (benchmarks: custo de cada degrau); -1 volta ao automático
+    void setFixedLevel(int index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fixed = index >= 0 && index < (int)ladder.size();
+        std::fill(holdUntil.begin(), holdUntil.end(), 0);
+        if (fixed && index != level) {
+            level = index;  // fora do histórico de decisões: não foi o governador que decidiu
+            framesAtLevel = 0;
+        }
+        pendingRatio = -1;
+        overBudget = underBudget = 0;
+    }
+
+    int getLevel() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return level;
+    }
+
+    int getLevelCount() const { return (int)ladder.size(); }
+    const QualityLevel& getSettings() const { return ladder[getLevel()]; }
+    const QualityLevel& getSettings(int index) const { return ladder[index]; }
+
+    double getAverageMs() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return averageMs;
+    }
+
+    std::vector<Decision> getDecisions() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return decisions;
+    }
+
+    // Linha para o log de métricas
+    std::string describe() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        char line[224];
+        int n = std::snprintf(line, sizeof(line),
+                              "nível %d/%d (%s) | frame %.1f ms / orçamento %.1f | captura %.1f filtro %.1f upload %.1f",
+                              level, (int)ladder.size() - 1, ladder[level].name, averageMs, effectiveBudget(level),
+                              stageAverageMs[Capture], stageAverageMs[Filter], stageAverageMs[Upload]);
+        if (level > 0 && isHeld(level - 1) && n > 0 && n < (int)sizeof(line)) {
+            std::snprintf(line + n, sizeof(line) - n, " | sobe com previsão abaixo de %.1f ms", climbLimit(level - 1, true));
+        }
+        return line;
+    }
+
+private:
+    double effectiveBudget(int index) const { return config.budgetMs * ladder[index].captureDivisor; }
+    bool isHeld(int index) const { return frames < holdUntil[index]; }
+    double climbLimit(int index, bool held) const {
+        return effectiveBudget(index) * config.upMargin * (held ? config.holdRelease : 1.0);
+    }
+
+    void changeLevel(int to, double budget) {
+        decisions.push_back({ frames, level, to, averageMs, budget });
+        if (decisions.size() > 32) decisions.erase(decisions.begin());
+        level = to;
+        framesAtLevel = 0;
+        overBudget = underBudget = 0;
+    }
+};
+
+#endif // QUALITY_GOVERNOR_H
@@ -0,0 +1,962 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FastCompressor.h"
+#include "Frame.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "SharedMemory.h"
+#include "UploadRing.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ==================== GRAVAÇÃO DE CAPTURA ====================
+// Grava os frames capturados e os eventos de hotkey (liga/desliga,
+// intensidade, método) com o instante de cada um, para reproduzir depois
+// exatamente a mesma sequência - inclusive em Linux, contra um build novo.
+//
+// Arquivo (.drec, little-endian):
+//   RecordingHeader
+//   registros: RecordHeader + payload
+//     KeyFrame: TileFrameHeader + bitmap + todos os blocos, comprimidos
+//     DeltaFrame: TileFrameHeader + bitmap + blocos alterados em XOR com o
+//                 frame anterior, comprimidos
+//     Event: kind + value
+//     Frame (versão 1): frame compacto, sem compressão
+//   Index: uma IndexEntry por keyframe (escrito no close)
+//   RecordingTrailer: posição do índice, no fim do arquivo
+// Os instantes são em µs desde o início da gravação. Cada plano é dividido em
+// blocos de tileRows linhas x tileBytes bytes; num delta os blocos parados
+// nem entram e os alterados são quase só zeros depois do XOR, o que o
+// FastCompressor reduz a poucos bytes. Um keyframe a cada keyframeInterval
+// frames limita quanto é preciso decodificar para saltar (índice).
+
+struct RecordingHeader {
+    static const uint32_t magicValue = 0x43455244;  // "DREC"
+    static const uint32_t currentVersion = 2;
+    static const int maxDimension = 16384;  // o leitor recusa cabeçalhos com mais que isso
+
+    uint32_t magic;
+    uint32_t version;
+    int32_t format;
+    int32_t width, height;
+    uint32_t tileRows;           // versão 1: zero (sem blocos)
+    uint32_t tileBytes;
+    uint32_t keyframeInterval;
+};
+
+struct RecordHeader {
+    enum Type : uint32_t { Frame = 1, Event = 2, KeyFrame = 3, DeltaFrame = 4, Index = 5 };
+
+    uint32_t type;
+    uint32_t payloadBytes;
+    int64_t timestampUs;
+
+    bool isFrame() const { return type == Frame || type == KeyFrame || type == DeltaFrame; }
+};
+
+struct TileFrameHeader {
+    uint32_t changedTiles;
+    uint32_t compressedBytes;
+};
+
+struct IndexEntry {
+    uint32_t frame;        // número do frame (a partir de 0)
+    uint32_t reserved;
+    int64_t timestampUs;
+    uint64_t offset;       // do RecordHeader do keyframe
+};
+
+struct RecordingTrailer {
+    static const uint32_t magicValue = 0x58444944;  // "DIDX"
+
+    uint32_t magic;
+    uint32_t entries;
+    uint32_t frames;
+    uint32_t reserved;
+    uint64_t indexOffset;
+};
+
+struct RecordedEvent {
+    enum Kind : uint32_t {
+        Toggle = 1,       // value: 1 ligado, 0 desligado
+        Strength = 2,     // value: intensidade em [0, 1]
+        Method = 3,       // value: 1 LUT, 0 correção matemática
+        LinearLight = 4,  // value: 1 luz linear, 0 gamma
+    };
+
+    uint32_t kind;
+    float value;
+    int64_t timestampUs = 0;  // preenchido na leitura (não vai no payload)
+
+    static const char* kindName(uint32_t kind) {
+        switch (kind) {
+            case Toggle: return "toggle";
+            case Strength: return "intensidade";
+            case Method: return "método";
+            case LinearLight: return "luz linear";
+        }
+        return "?";
+    }
+};
+
+// ==================== BLOCOS + DELTA ====================
+// Mesmo estado dos dois lados: o gravador e o leitor guardam o último frame
+// (compacto) e percorrem os blocos na mesma ordem. Os bytes dos blocos
+// alterados saem em ordem de linha dentro de cada faixa de blocos (linha y
+// de todos os blocos alterados da faixa, depois a linha y+1): o compressor
+// continua vendo a linha de cima logo atrás, como no frame inteiro.
+class TileDeltaCodec {
+private:
+    struct Band {  // uma faixa de blocos: mesmas linhas, colunas em sequência
+        int plane;
+        int y, rows;
+        int firstTile, tileCount;
+    };
+    struct Tile {
+        int x, bytes;  // em bytes dentro da linha
+    };
+
+    std::vector<Band> bands;
+    std::vector<Tile> tiles;
+    std::vector<uint8_t> dirty;  // por bloco, no frame atual
+    std::vector<uint8_t> referenceData;
+    FrameView reference;
+    std::vector<uint8_t> scratch;  // blocos alterados, antes de comprimir
+
+    // 8 bytes por vez (o laço byte a byte não é vetorizado em -O2)
+    static void xorRow(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes) {
+        size_t i = 0;
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            x ^= y;
+            std::memcpy(dst + i, &x, 8);
+        }
+        for (; i < bytes; i++) dst[i] = a[i] ^ b[i];
+    }
+
+    static bool isSet(const uint8_t* bitmap, size_t t) { return (bitmap[t / 8] >> (t % 8)) & 1; }
+
+public:
+    static const int defaultTileRows = 64;
+    static const int defaultTileBytes = 256;  // 64 pixels BGRA8
+
+    void configure(PixelFormat format, int width, int height, int tileRows, int tileBytes) {
+        tileRows = std::max(1, tileRows);  // blocos vazios: os laços abaixo não andariam
+        tileBytes = std::max(1, tileBytes);
+        referenceData.assign(FrameView::compactSize(format, width, height), 0);
+        reference = FrameView::wrap(format, referenceData.data(), width, height);
+        bands.clear();
+        tiles.clear();
+        for (int p = 0; p < reference.planeCount(); p++) {
+            int rowBytes = reference.rowBytes(p);
+            for (int y = 0; y < reference.planeHeight(p); y += tileRows) {
+                Band band = { p, y, std::min(tileRows, reference.planeHeight(p) - y), (int)tiles.size(), 0 };
+                for (int x = 0; x < rowBytes; x += tileBytes) {
+                    tiles.push_back({ x, std::min(tileBytes, rowBytes - x) });
+                    band.tileCount++;
+                }
+                bands.push_back(band);
+            }
+        }
+        dirty.assign(tiles.size(), 0);
+        scratch.resize(referenceData.size());
+    }
+
+    const FrameView& frame() const { return reference; }
+    size_t frameBytes() const { return referenceData.size(); }
+    size_t bitmapBytes() const { return (tiles.size() + 7) / 8; }
+
+    // Payload de KeyFrame/DeltaFrame; atualiza o frame de referência
+    void encode(const FrameView& frame, bool keyframe, std::vector<uint8_t>& payload) {
+        size_t headerBytes = sizeof(TileFrameHeader) + bitmapBytes();
+        payload.assign(headerBytes, 0);
+        uint8_t* bitmap = payload.data() + sizeof(TileFrameHeader);
+        uint32_t changed = 0;
+
+        for (const Band& band : bands) {
+            for (int t = band.firstTile; t < band.firstTile + band.tileCount; t++) {
+                bool tileDirty = keyframe;
+                for (int y = band.y; y < band.y + band.rows && !tileDirty; y++) {
+                    tileDirty = std::memcmp(frame.row(band.plane, y) + tiles[t].x,
+                                            reference.row(band.plane, y) + tiles[t].x, tiles[t].bytes) != 0;
+                }
+                dirty[t] = tileDirty;
+                if (tileDirty) {
+                    bitmap[t / 8] |= (uint8_t)(1u << (t % 8));
+                    changed++;
+                }
+            }
+        }
+
+        uint8_t* out = scratch.data();
+        for (const Band& band : bands) {
+            for (int y = band.y; y < band.y + band.rows; y++) {
+                const uint8_t* srcRow = frame.row(band.plane, y);
+                uint8_t* refRow = reference.row(band.plane, y);
+                for (int t = band.firstTile; t < band.firstTile + band.tileCount; t++) {
+                    if (!dirty[t]) continue;
+                    const Tile& tile = tiles[t];
+                    if (keyframe) {
+                        std::memcpy(out, srcRow + tile.x, tile.bytes);
+                    } else {
+                        xorRow(out, srcRow + tile.x, refRow + tile.x, tile.bytes);
+                    }
+                    std::memcpy(refRow + tile.x, srcRow + tile.x, tile.bytes);
+                    out += tile.bytes;
+                }
+            }
+        }
+
+        size_t rawBytes = (size_t)(out - scratch.data());
+        payload.resize(headerBytes + FastCompressor::maxCompressedSize(rawBytes));
+        size_t compressed = FastCompressor::compress(scratch.data(), rawBytes, payload.data() + headerBytes);
+        payload.resize(headerBytes + compressed);
+        TileFrameHeader header = { changed, (uint32_t)compressed };
+        std::memcpy(payload.data(), &header, sizeof(header));
+    }
+
+    // Aplica um KeyFrame/DeltaFrame sobre o frame de referência
+    bool decode(uint32_t type, const uint8_t* payload, size_t bytes) {
+        size_t headerBytes = sizeof(TileFrameHeader) + bitmapBytes();
+        if (bytes < headerBytes) return false;
+        TileFrameHeader header;
+        std::memcpy(&header, payload, sizeof(header));
+        if (headerBytes + header.compressedBytes > bytes) return false;
+        const uint8_t* bitmap = payload + sizeof(TileFrameHeader);
+
+        size_t rawBytes = 0;
+        for (const Band& band : bands) {
+            for (int t = band.firstTile; t < band.firstTile + band.tileCount; t++) {
+                if (isSet(bitmap, t)) rawBytes += (size_t)tiles[t].bytes * band.rows;
+            }
+        }
+        if (!FastCompressor::decompress(payload + headerBytes, header.compressedBytes, scratch.data(), rawBytes)) {
+            return false;
+        }
+
+        const uint8_t* in = scratch.data();
+        for (const Band& band : bands) {
+            for (int y = band.y; y < band.y + band.rows; y++) {
+                uint8_t* refRow = reference.row(band.plane, y);
+                for (int t = band.firstTile; t < band.firstTile + band.tileCount; t++) {
+                    if (!isSet(bitmap, t)) continue;
+                    const Tile& tile = tiles[t];
+                    if (type == RecordHeader::KeyFrame) {
+                        std::memcpy(refRow + tile.x, in, tile.bytes);
+                    } else {
+                        xorRow(refRow + tile.x, refRow + tile.x, in, tile.bytes);
+                    }
+                    in += tile.bytes;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Frame cru da versão 1 (compacto)
+    bool loadRaw(const uint8_t* payload, size_t bytes) {
+        if (bytes != referenceData.size()) return false;
+        std::memcpy(referenceData.data(), payload, bytes);
+        return true;
+    }
+};
+
+// ==================== GRAVADOR ====================
+// A captura só põe o handle do frame na fila (sem cópia); uma thread de
+// escrita, com prioridade abaixo da captura, compara blocos, comprime e grava. Eventos entram na mesma
+// fila, então a ordem frame/evento do arquivo é a ordem de chegada. Se a
+// escrita ficar para trás (fila cheia), o frame é descartado e contado -
+// a captura nunca espera pelo disco.
+class CaptureRecorder {
+public:
+    struct Options {
+        int keyframeInterval = 60;  // 1 s a 60 FPS
+        int queueFrames = 4;        // frames copiados esperando a escrita
+        int tileRows = TileDeltaCodec::defaultTileRows;
+        int tileBytes = TileDeltaCodec::defaultTileBytes;
+    };
+
+private:
+    struct Item {
+        uint32_t type;
+        int64_t timestampUs;
+        FrameHandle frame;
+        uint32_t kind;
+        float value;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Item> queue;
+    int queuedFrames = 0;
+    bool stopping = false;
+    std::thread writerThread;
+    std::atomic<bool> recording{false};
+
+    // Só a thread de escrita mexe daqui para baixo (até o close)
+    FILE* file = nullptr;
+    std::unique_ptr<FramePool> pool;
+    PixelFormat format = PixelFormat::BGRA8;
+    int width = 0, height = 0;
+    Options options;
+    std::chrono::steady_clock::time_point startTime;
+    TileDeltaCodec codec;
+    std::vector<uint8_t> payload;
+    std::vector<IndexEntry> index;
+    uint64_t fileOffset = 0;
+    uint32_t framesEncoded = 0;
+    bool writeFailed = false;
+
+    std::atomic<uint64_t> frames{0}, events{0}, dropped{0};
+    std::atomic<uint64_t> bytes{0}, rawBytes{0}, frameBytes{0};
+    std::atomic<uint64_t> encodeMicros{0};
+
+public:
+    ~CaptureRecorder() { close(); }
+
+    bool open(const std::string& path, PixelFormat fmt, int w, int h) { return open(path, fmt, w, h, Options()); }
+
+    bool open(const std::string& path, PixelFormat fmt, int w, int h, const Options& opts) {
+        if (recording) return false;
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::fprintf(stderr, "Gravação: não foi possível criar %s\n", path.c_str());
+            return false;
+        }
+        format = fmt;
+        width = w;
+        height = h;
+        options = opts;
+        RecordingHeader header = {};
+        header.magic = RecordingHeader::magicValue;
+        header.version = RecordingHeader::currentVersion;
+        header.format = (int32_t)fmt;
+        header.width = w;
+        header.height = h;
+        header.tileRows = (uint32_t)options.tileRows;
+        header.tileBytes = (uint32_t)options.tileBytes;
+        header.keyframeInterval = (uint32_t)std::max(1, options.keyframeInterval);
+        std::fwrite(&header, sizeof(header), 1, file);
+
+        codec.configure(fmt, w, h, options.tileRows, options.tileBytes);
+        FramePool::Options poolOptions;
+        poolOptions.preallocate = options.queueFrames;
+        pool.reset(new FramePool(fmt, w, h, poolOptions));
+        index.clear();
+        fileOffset = sizeof(header);
+        framesEncoded = 0;
+        writeFailed = false;
+        frames = events = dropped = 0;
+        bytes = sizeof(header);
+        rawBytes = frameBytes = encodeMicros = 0;
+        stopping = false;
+        queuedFrames = 0;
+        startTime = std::chrono::steady_clock::now();
+        recording = true;
+        writerThread = std::thread(&CaptureRecorder::writerLoop, this);
+        return true;
+    }
+
+    // Esvazia a fila, grava o índice e fecha. Chamar com a captura parada.
+    void close() {
+        if (!recording) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writerThread.join();
+        recording = false;
+
+        RecordingTrailer trailer = {};
+        trailer.magic = RecordingTrailer::magicValue;
+        trailer.entries = (uint32_t)index.size();
+        trailer.frames = framesEncoded;
+        trailer.indexOffset = fileOffset;
+        writeRecord(RecordHeader::Index, 0, index.data(), index.size() * sizeof(IndexEntry));
+        std::fwrite(&trailer, sizeof(trailer), 1, file);
+        bytes += sizeof(trailer);
+        std::fclose(file);
+        file = nullptr;
+        pool.reset();
+    }
+
+    bool isOpen() const { return recording; }
+
+    // Thread da captura, sem cópia: a gravação segura o handle até escrever
+    // (a fonte passa a usar outro buffer do pool enquanto isso)
+    bool writeFrame(const FrameHandle& frame) {
+        if (!frame || !matches(frame.view())) return false;
+        return enqueueFrame(FrameHandle(frame));
+    }
+
+    // Frame que não é de um pool (ou que vai ser sobrescrito): copia antes
+    bool writeFrame(const FrameView& frame) {
+        if (!matches(frame)) return false;
+        FrameHandle copy = pool->acquire();
+        if (!copy) return false;
+        copyFrame(frame, copy.view());
+        return enqueueFrame(std::move(copy));
+    }
+
+    bool writeEvent(uint32_t kind, float value) {
+        if (!recording) return false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({ RecordHeader::Event, elapsedUs(), FrameHandle(), kind, value });
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    uint64_t getFrameCount() const { return frames; }
+    uint64_t getEventCount() const { return events; }
+    uint64_t getDroppedFrames() const { return dropped; }
+    uint64_t getBytesWritten() const { return bytes; }
+
+    // Frames sem compressão / payload dos frames no arquivo
+    uint64_t getRawFrameBytes() const { return rawBytes; }
+    uint64_t getCompressedFrameBytes() const { return frameBytes; }
+    double getCompressionRatio() const { return frameBytes ? (double)rawBytes / frameBytes : 0.0; }
+    double getEncodeMs() const { return encodeMicros / 1000.0; }
+
+
+private:
+    bool matches(const FrameView& frame) const {
+        return recording && frame.format == format && frame.width == width && frame.height == height;
+    }
+
+    bool enqueueFrame(FrameHandle frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queuedFrames >= options.queueFrames) {
+                dropped++;
+                return false;
+            }
+            queuedFrames++;
+            queue.push_back({ RecordHeader::Frame, elapsedUs(), std::move(frame), 0, 0.0f });
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    int64_t elapsedUs() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // Abaixo da captura: ao acordar, a escrita não toma a CPU da captura
+    // (que no Windows já roda em prioridade alta). No Linux só nice 10 não
+    // basta: com um núcleo o notify do writeFrame ainda cedia a CPU para a
+    // escrita e a captura esperava ms; SCHED_IDLE nunca preempta a captura.
+    static void lowerThreadPriority() {
+#ifdef _WIN32
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#else
+#ifdef SCHED_IDLE
+        sched_param param = {};
+        if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0) return;
+#endif
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 10);
+#endif
+    }
+
+    void writerLoop() {
+        lowerThreadPriority();
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                item = std::move(queue.front());
+                queue.pop_front();
+            }
+            if (item.type == RecordHeader::Frame) {
+                encodeFrame(item);
+                item.frame.reset();
+                std::lock_guard<std::mutex> lock(mutex);
+                queuedFrames--;
+            } else {
+                uint8_t event[sizeof(uint32_t) + sizeof(float)];
+                std::memcpy(event, &item.kind, sizeof(uint32_t));
+                std::memcpy(event + sizeof(uint32_t), &item.value, sizeof(float));
+                writeRecord(RecordHeader::Event, item.timestampUs, event, sizeof(event));
+                events++;
+            }
+        }
+    }
+
+    void encodeFrame(const Item& item) {
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        bool keyframe = framesEncoded % (uint32_t)std::max(1, options.keyframeInterval) == 0;
+        if (keyframe) index.push_back({ framesEncoded, 0, item.timestampUs, fileOffset });
+        codec.encode(item.frame.view(), keyframe, payload);
+        encodeMicros += (uint64_t)duration_cast<microseconds>(steady_clock::now() - begin).count();
+
+        writeRecord(keyframe ? RecordHeader::KeyFrame : RecordHeader::DeltaFrame, item.timestampUs,
+                    payload.data(), payload.size());
+        framesEncoded++;
+        frames++;
+        rawBytes += codec.frameBytes();
+        frameBytes += payload.size();
+    }
+
+    void writeRecord(uint32_t type, int64_t timestampUs, const void* data, size_t size) {
+        RecordHeader record = { type, (uint32_t)size, timestampUs };
+        bool ok = std::fwrite(&record, sizeof(record), 1, file) == 1 &&
+                  (size == 0 || std::fwrite(data, 1, size, file) == size);
+        if (!ok && !writeFailed) {
+            std::fprintf(stderr, "Gravação: erro de escrita (disco cheio?)\n");
+            writeFailed = true;
+        }
+        fileOffset += sizeof(record) + size;
+        bytes += sizeof(record) + size;
+    }
+};
+
+// ==================== LEITOR ====================
+// Arquivo mapeado em memória: os registros são lidos no lugar e o índice de
+// keyframes permite saltar para qualquer frame decodificando no máximo
+// keyframeInterval frames. Sem índice (gravação interrompida, versão 1) o
+// leitor monta um percorrendo só os cabeçalhos.
+class RecordingReader {
+private:
+    MappedFile file;
+    RecordingHeader header = {};
+    size_t position = 0;
+    TileDeltaCodec codec;
+    std::vector<IndexEntry> index;
+    int frameCount = 0;
+    int nextFrame = 0;  // número do próximo frame a ler
+
+public:
+    bool open(const std::string& path) {
+        close();
+        if (!file.open(path)) {
+            std::fprintf(stderr, "Gravação: não foi possível abrir %s\n", path.c_str());
+            return false;
+        }
+        bool valid = file.getSize() >= sizeof(header);
+        if (valid) std::memcpy(&header, file.getData(), sizeof(header));
+        valid = valid && header.magic == RecordingHeader::magicValue && header.version >= 1 &&
+                header.version <= RecordingHeader::currentVersion && header.format >= 0 &&
+                header.format <= (int32_t)PixelFormat::RGBA16F && header.width > 0 && header.height > 0 &&
+                header.width <= RecordingHeader::maxDimension && header.height <= RecordingHeader::maxDimension;
+        int tileRows = TileDeltaCodec::defaultTileRows, tileBytes = TileDeltaCodec::defaultTileBytes;
+        if (valid && header.version >= 2) {
+            // Blocos de 0 ou maiores que o plano 0 (o maior) não vêm do
+            // gravador; comparados ainda em uint32, antes de virar int
+            FrameView plane = FrameView::wrap(getFormat(), nullptr, header.width, header.height);
+            valid = header.tileRows > 0 && header.tileRows <= (uint32_t)plane.planeHeight(0) &&
+                    header.tileBytes > 0 && header.tileBytes <= (uint32_t)plane.rowBytes(0);
+            tileRows = (int)header.tileRows;
+            tileBytes = (int)header.tileBytes;
+        }
+        if (!valid) {
+            std::fprintf(stderr, "Gravação: %s não é uma gravação válida\n", path.c_str());
+            close();
+            return false;
+        }
+        codec.configure(getFormat(), header.width, header.height, tileRows, tileBytes);
+        if (!loadIndex()) buildIndex();
+        rewind();
+        return true;
+    }
+
+    void close() {
+        file.close();
+        index.clear();
+        frameCount = 0;
+        position = 0;
+    }
+
+    PixelFormat getFormat() const { return (PixelFormat)header.format; }
+    int getWidth() const { return header.width; }
+    int getHeight() const { return header.height; }
+    int getVersion() const { return (int)header.version; }
+    int getFrameCount() const { return frameCount; }
+    int getKeyframeCount() const { return (int)index.size(); }
+    int getNextFrame() const { return nextFrame; }
+    size_t getFileBytes() const { return file.getSize(); }
+
+    void rewind() {
+        position = sizeof(RecordingHeader);
+        nextFrame = 0;
+    }
+
+    // Cabeçalho do próximo registro, sem consumir o payload; false no fim
+    bool peek(RecordHeader& record) const { return peekAt(position, record); }
+
+    bool readEvent(RecordedEvent& event) {
+        RecordHeader record;
+        if (!peek(record) || record.type != RecordHeader::Event ||
+            record.payloadBytes < sizeof(uint32_t) + sizeof(float)) {
+            return false;
+        }
+        const uint8_t* payload = file.getData() + position + sizeof(RecordHeader);
+        std::memcpy(&event.kind, payload, sizeof(uint32_t));
+        std::memcpy(&event.value, payload + sizeof(uint32_t), sizeof(float));
+        event.timestampUs = record.timestampUs;
+        position += sizeof(RecordHeader) + record.payloadBytes;
+        return true;
+    }
+
+    // Decodifica o próximo frame e copia para target (com ou sem stride)
+    bool readFrame(const FrameView& target) {
+        if (!decodeNext()) return false;
+        return copyFrame(codec.frame(), target);
+    }
+
+    // Pula o próximo registro. Frames são decodificados mesmo assim: o delta
+    // seguinte depende deles.
+    bool skip() {
+        RecordHeader record;
+        if (!peek(record)) return false;
+        if (record.isFrame()) return decodeNext();
+        position += sizeof(RecordHeader) + record.payloadBytes;
+        return true;
+    }
+
+    // Posiciona antes do frame 'frame': volta ao keyframe anterior e
+    // decodifica até ele. Eventos no caminho são pulados.
+    bool seekFrame(int frame) {
+        if (index.empty() || frame < 0 || frame >= frameCount) return false;
+        size_t k = 0;
+        while (k + 1 < index.size() && (int)index[k + 1].frame <= frame) k++;
+        if (!(nextFrame <= frame && nextFrame >= (int)index[k].frame)) {
+            position = (size_t)index[k].offset;
+            nextFrame = (int)index[k].frame;
+        }
+        RecordHeader record;
+        while (nextFrame < frame) {
+            if (!peek(record) || !skip()) return false;
+        }
+        // Eventos antes do frame pedido (mesmo instante) também ficam para trás
+        while (peek(record) && !record.isFrame()) skip();
+        return true;
+    }
+
+    // Posiciona antes do primeiro frame gravado em 'timestampUs' ou depois
+    bool seekTime(int64_t timestampUs) {
+        if (index.empty()) return false;
+        size_t k = 0;
+        while (k + 1 < index.size() && index[k + 1].timestampUs <= timestampUs) k++;
+        position = (size_t)index[k].offset;
+        nextFrame = (int)index[k].frame;
+        RecordHeader record;
+        while (peek(record)) {
+            if (record.isFrame() && record.timestampUs >= timestampUs) return true;
+            if (!skip()) return false;
+        }
+        return false;
+    }
+
+    // Eventos gravados antes da posição atual (depois de um salto: o estado
+    // das hotkeys naquele ponto). Só os cabeçalhos são percorridos.
+    std::vector<RecordedEvent> eventsBefore() const {
+        std::vector<RecordedEvent> events;
+        size_t offset = sizeof(RecordingHeader);
+        RecordHeader record;
+        while (offset < position && peekAt(offset, record)) {
+            if (record.type == RecordHeader::Event && record.payloadBytes >= sizeof(uint32_t) + sizeof(float)) {
+                RecordedEvent event;
+                const uint8_t* payload = file.getData() + offset + sizeof(RecordHeader);
+                std::memcpy(&event.kind, payload, sizeof(uint32_t));
+                std::memcpy(&event.value, payload + sizeof(uint32_t), sizeof(float));
+                event.timestampUs = record.timestampUs;
+                events.push_back(event);
+            }
+            offset += sizeof(RecordHeader) + record.payloadBytes;
+        }
+        return events;
+    }
+
+private:
+    // Subtrações em vez de somas: offset vem do índice (do arquivo) e não
+    // pode dar a volta em size_t
+    bool peekAt(size_t offset, RecordHeader& record) const {
+        if (!file.isOpen() || offset > file.getSize() || file.getSize() - offset < sizeof(RecordHeader)) return false;
+        std::memcpy(&record, file.getData() + offset, sizeof(record));
+        if (record.type == RecordHeader::Index) return false;
+        return record.payloadBytes <= file.getSize() - offset - sizeof(RecordHeader);  // truncado
+    }
+
+    bool decodeNext() {
+        RecordHeader record;
+        if (!peek(record) || !record.isFrame()) return false;
+        const uint8_t* payload = file.getData() + position + sizeof(RecordHeader);
+        position += sizeof(RecordHeader) + record.payloadBytes;
+        nextFrame++;
+        if (record.type == RecordHeader::Frame) return codec.loadRaw(payload, record.payloadBytes);
+        return codec.decode(record.type, payload, record.payloadBytes);
+    }
+
+    bool loadIndex() {
+        RecordingTrailer trailer;
+        if (file.getSize() < sizeof(RecordingHeader) + sizeof(trailer)) return false;
+        std::memcpy(&trailer, file.getData() + file.getSize() - sizeof(trailer), sizeof(trailer));
+        RecordHeader record;
+        // O índice termina onde o trailer começa; indexOffset é conferido
+        // contra esse limite antes de qualquer soma (não pode dar a volta)
+        const size_t indexEnd = file.getSize() - sizeof(trailer);
+        const size_t entriesBytes = (size_t)trailer.entries * sizeof(IndexEntry);
+        if (trailer.magic != RecordingTrailer::magicValue || trailer.indexOffset < sizeof(RecordingHeader) ||
+            trailer.indexOffset > indexEnd || indexEnd - trailer.indexOffset < sizeof(RecordHeader) + entriesBytes ||
+            trailer.frames > (uint32_t)INT32_MAX) {
+            return false;
+        }
+        std::memcpy(&record, file.getData() + trailer.indexOffset, sizeof(record));
+        if (record.type != RecordHeader::Index || record.payloadBytes != entriesBytes) return false;
+        index.resize(trailer.entries);
+        std::memcpy(index.data(), file.getData() + trailer.indexOffset + sizeof(RecordHeader), entriesBytes);
+        // Keyframes antes do índice e em ordem; senão o índice é refeito
+        for (size_t k = 0; k < index.size(); k++) {
+            if (index[k].offset < sizeof(RecordingHeader) || index[k].offset >= trailer.indexOffset ||
+                index[k].frame >= trailer.frames || (k == 0 && index[k].frame != 0) ||
+                (k > 0 && index[k].frame <= index[k - 1].frame)) {
+                index.clear();
+                return false;
+            }
+        }
+        frameCount = (int)trailer.frames;
+        return true;
+    }
+
+    // Só os cabeçalhos: as páginas dos frames nem são tocadas
+    void buildIndex() {
+        index.clear();
+        frameCount = 0;
+        size_t offset = sizeof(RecordingHeader);
+        RecordHeader record;
+        while (peekAt(offset, record)) {
+            if (record.type == RecordHeader::KeyFrame || record.type == RecordHeader::Frame) {
+                index.push_back({ (uint32_t)frameCount, 0, record.timestampUs, (uint64_t)offset });
+            }
+            if (record.isFrame()) frameCount++;
+            offset += sizeof(RecordHeader) + record.payloadBytes;
+        }
+    }
+};
+
+// ==================== FONTE DE REPRODUÇÃO ====================
+// FrameSource que devolve uma gravação: no ritmo original (os instantes
+// gravados) ou na velocidade máxima. Os eventos vão para o handler na mesma
+// ordem em relação aos frames em que foram gravados. step() avança sem
+// thread, um frame por chamada - para benchmarks determinísticos.
+class ReplayFrameSource : public FrameSource {
+public:
+    enum class Pace { Original, Maximum };
+    using EventHandler = std::function<void(const RecordedEvent&)>;
+
+private:
+    std::string path;
+    Pace pace;
+    bool loop;
+    RecordingReader reader;
+
+    FramePool pool;
+    FrameHandle frontBuffer;
+    FrameHandle backBuffer;
+    int64_t frontTimestampUs = 0;
+
+    std::mutex bufferMutex;
+    std::thread replayThread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+    std::atomic<int> frameCount{0};
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<int64_t> captureMicros{0};
+    EventHandler eventHandler;
+    FrameWriteTarget* writeTarget = nullptr;
+    int passes = 0;            // voltas completas (com loop)
+    int64_t loopOffsetUs = 0;  // duração das voltas anteriores
+    int64_t lastTimestampUs = 0;
+    std::chrono::steady_clock::time_point playbackStart;
+    bool playbackStarted = false;
+
+public:
+    explicit ReplayFrameSource(const std::string& file, Pace replayPace = Pace::Original, bool repeat = false)
+        : path(file), pace(replayPace), loop(repeat), pool(PixelFormat::BGRA8, 1, 1) {}
+
+    ~ReplayFrameSource() override { stop(); }
+
+    bool initialize() override {
+        if (!reader.open(path)) return false;
+        pool.reconfigure(reader.getFormat(), reader.getWidth(), reader.getHeight());
+        frontBuffer = pool.acquire();
+        backBuffer = pool.acquire();
+        return frontBuffer && backBuffer;
+    }
+
+    void start() override {
+        if (running) return;
+        running = true;
+        replayThread = std::thread(&ReplayFrameSource::replayLoop, this);
+    }
+
+    void stop() override {
+        running = false;
+        if (replayThread.joinable()) replayThread.join();
+    }
+
+    int getWidth() const override { return reader.getWidth(); }
+    int getHeight() const override { return reader.getHeight(); }
+    PixelFormat getFormat() const override { return reader.getFormat(); }
+    int getFrameCount() const override { return frameCount; }
+
+    bool readLatest(const std::function<void(const FrameView&)>& fn) override {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (frameCount == 0 || writeTarget) return false;
+        FrameView view = frontBuffer.view();
+        view.timestampUs = frontTimestampUs;
+        fn(view);
+        return true;
+    }
+
+    bool attachWriteTarget(FrameWriteTarget* target) override {
+        if (running || target->getFormat() != getFormat() ||
+            target->getWidth() != getWidth() || target->getHeight() != getHeight()) {
+            return false;
+        }
+        writeTarget = target;
+        return true;
+    }
+
+    uint64_t getBytesWritten() const override { return bytesWritten; }
+    double getCaptureMs() const override { return captureMicros / 1000.0; }
+
+    // Chamado na thread da reprodução (ou na de quem chama step())
+    void setEventHandler(EventHandler handler) { eventHandler = std::move(handler); }
+
+    // Frames na gravação (uma volta)
+    int getRecordedFrameCount() const { return reader.getFrameCount(); }
+
+    // Gravação terminou (sem loop)
+    bool isFinished() const { return finished; }
+
+    // Voltas completas desde o início (só cresce com loop)
+    int getPass() const { return passes; }
+
+    // Instante gravado do último registro entregue (µs, somando as voltas)
+    int64_t getTimestampUs() const { return loopOffsetUs + lastTimestampUs; }
+
+    // Salta para o primeiro frame em 'timestampUs' ou depois (índice de
+    // keyframes); o ritmo original recomeça a contar dali. O handler recebe o
+    // último valor de cada evento anterior, para partir do mesmo estado das
+    // hotkeys. Sem a thread rodando.
+    bool seek(int64_t timestampUs) {
+        if (running || !reader.seekTime(timestampUs)) return false;
+        std::vector<RecordedEvent> events = reader.eventsBefore();
+        for (size_t i = 0; i < events.size(); i++) {
+            bool latest = true;
+            for (size_t j = i + 1; j < events.size() && latest; j++) latest = events[j].kind != events[i].kind;
+            if (latest && eventHandler) eventHandler(events[i]);
+        }
+        RecordHeader record;
+        lastTimestampUs = reader.peek(record) ? record.timestampUs : timestampUs;
+        playbackStarted = false;
+        finished = false;
+        return true;
+    }
+
+    // Entrega eventos até o próximo frame e publica o frame; false no fim
+    bool step() {
+        RecordHeader record;
+        while (true) {
+            if (!reader.peek(record)) {
+                if (!loop || frameCount == 0) {
+                    finished = true;
+                    return false;
+                }
+                loopOffsetUs += lastTimestampUs + 1;
+                passes++;
+                reader.rewind();
+                continue;
+            }
+            if (pace == Pace::Original) waitUntil(record.timestampUs);
+            lastTimestampUs = record.timestampUs;
+
+            if (record.type == RecordHeader::Event) {
+                RecordedEvent event;
+                if (!reader.readEvent(event)) return finish();
+                event.timestampUs += loopOffsetUs;
+                if (eventHandler) eventHandler(event);
+            } else if (record.isFrame()) {
+                return publishFrame(record) || finish();
+            } else if (!reader.skip()) {
+                return finish();
+            }
+        }
+    }
+
+private:
+    bool finish() {
+        finished = true;
+        return false;
+    }
+
+    void waitUntil(int64_t timestampUs) {
+        using namespace std::chrono;
+        if (!playbackStarted) {
+            playbackStart = steady_clock::now() - microseconds(timestampUs);
+            playbackStarted = true;
+        }
+        std::this_thread::sleep_until(playbackStart + microseconds(loopOffsetUs + timestampUs));
+    }
+
+    bool publishFrame(const RecordHeader& record) {
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        int64_t timestamp = loopOffsetUs + record.timestampUs;
+
+        if (writeTarget) {
+            int slot = writeTarget->beginWrite();
+            if (slot < 0) return reader.skip();  // consumidor atrasado: descarta, como a captura
+            if (!reader.readFrame(writeTarget->view(slot))) {
+                writeTarget->cancelWrite(slot);
+                return false;
+            }
+            writeTarget->commitWrite(slot, timestamp);
+        } else {
+            if (!reader.readFrame(backBuffer.view())) return false;
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            std::swap(frontBuffer, backBuffer);
+            frontTimestampUs = timestamp;
+        }
+        bytesWritten += FrameView::compactSize(getFormat(), getWidth(), getHeight());
+        captureMicros = duration_cast<microseconds>(steady_clock::now() - begin).count();
+        frameCount++;
+        return true;
+    }
+
+    void replayLoop() {
+        while (running && step()) {
+        }
+        running = false;
+    }
+};
+
+#endif // RECORDING_H
@@ -0,0 +1,223 @@
+#ifndef REGION_OF_INTEREST_H
+#define REGION_OF_INTEREST_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "Frame.h"
+
+// ==================== REGIÕES DE INTERESSE ====================
+// Retângulos onde a correção é aplicada; fora deles o frame passa intacto.
+// Conjunto vazio = frame inteiro (modo normal). O conjunto pode ser trocado
+// a qualquer momento (hotkey, linha de comando) enquanto as threads de
+// render/filtro leem: elas pegam uma cópia e comparam a versão para saber
+// quando recalcular os retângulos locais.
+struct RoiRect {
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+
+    int area() const { return width * height; }
+};
+
+class RegionSet {
+private:
+    mutable std::mutex mutex;
+    std::vector<RoiRect> rects;
+    std::atomic<uint64_t> version{0};
+
+public:
+    void set(const std::vector<RoiRect>& newRects) {
+        std::lock_guard<std::mutex> lock(mutex);
+        rects = newRects;
+        version++;
+    }
+
+    void add(const RoiRect& rect) {
+        std::lock_guard<std::mutex> lock(mutex);
+        rects.push_back(rect);
+        version++;
+    }
+
+    void clear() { set({}); }
+
+    std::vector<RoiRect> get() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return rects;
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return rects.empty();
+    }
+
+    uint64_t getVersion() const { return version; }
+
+    // Recorta os retângulos ao frame (width x height, origem em 'originX/Y'
+    // nas coordenadas dos retângulos) e devolve retângulos disjuntos, para
+    // nenhum pixel ser filtrado duas vezes. 'align' arredonda as bordas para
+    // fora (2 em 4:2:0, para o croma alinhar).
+    static std::vector<RoiRect> disjoint(const std::vector<RoiRect>& input, int width, int height,
+                                         int align = 1, int originX = 0, int originY = 0) {
+        std::vector<RoiRect> clipped;
+        for (const RoiRect& r : input) {
+            int x0 = std::max(0, r.x - originX), y0 = std::max(0, r.y - originY);
+            int x1 = std::min(width, r.x - originX + r.width), y1 = std::min(height, r.y - originY + r.height);
+            if (x0 >= x1 || y0 >= y1) continue;
+            x0 -= x0 % align;
+            y0 -= y0 % align;
+            x1 = std::min(width, x1 + (align - x1 % align) % align);
+            y1 = std::min(height, y1 + (align - y1 % align) % align);
+            clipped.push_back({ x0, y0, x1 - x0, y1 - y0 });
+        }
+
+        // Faixas horizontais entre bordas consecutivas; em cada faixa os
+        // intervalos em x que se sobrepõem são unidos
+        std::vector<int> edges;
+        for (const RoiRect& r : clipped) {
+            edges.push_back(r.y);
+            edges.push_back(r.y + r.height);
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        std::vector<RoiRect> result;
+        std::vector<std::pair<int, int>> spans;
+        for (size_t i = 0; i + 1 < edges.size(); i++) {
+            int bandTop = edges[i], bandBottom = edges[i + 1];
+            spans.clear();
+            for (const RoiRect& r : clipped) {
+                if (r.y <= bandTop && r.y + r.height >= bandBottom) spans.push_back({ r.x, r.x + r.width });
+            }
+            std::sort(spans.begin(), spans.end());
+            for (size_t s = 0; s < spans.size();) {
+                int from = spans[s].first, to = spans[s].second;
+                for (s++; s < spans.size() && spans[s].first <= to; s++) to = std::max(to, spans[s].second);
+
+                // Junta com o retângulo da faixa anterior se as colunas batem
+                bool merged = false;
+                for (RoiRect& prev : result) {
+                    if (prev.x == from && prev.width == to - from && prev.y + prev.height == bandTop) {
+                        prev.height += bandBottom - bandTop;
+                        merged = true;
+                        break;
+                    }
+                }
+                if (!merged) result.push_back({ from, bandTop, to - from, bandBottom - bandTop });
+            }
+        }
+        return result;
+    }
+
+    // Interseção de dois conjuntos disjuntos (o resultado também é disjunto)
+    static std::vector<RoiRect> intersect(const std::vector<RoiRect>& a, const std::vector<RoiRect>& b) {
+        std::vector<RoiRect> result;
+        for (const RoiRect& ra : a) {
+            for (const RoiRect& rb : b) {
+                int x0 = std::max(ra.x, rb.x), y0 = std::max(ra.y, rb.y);
+                int x1 = std::min(ra.x + ra.width, rb.x + rb.width);
+                int y1 = std::min(ra.y + ra.height, rb.y + rb.height);
+                if (x0 < x1 && y0 < y1) result.push_back({ x0, y0, x1 - x0, y1 - y0 });
+            }
+        }
+        return result;
+    }
+
+    // Fração do frame coberta por retângulos disjuntos
+    static double coverage(const std::vector<RoiRect>& disjointRects, int width, int height) {
+        int64_t covered = 0;
+        for (const RoiRect& r : disjointRects) covered += r.area();
+        return width > 0 && height > 0 ? covered / ((double)width * height) : 0.0;
+    }
+};
+
+// Aplica 'filter' (CpuFilter ou YuvFilter) só nos retângulos (já disjuntos e
+// dentro do frame) e não toca no resto de dst. Cada região é uma sub-visão do
+// frame (sem cópia) e o filtro só distribui no ThreadPool as linhas dela,
+// então o custo acompanha a área coberta.
+template <typename Filter>
+bool filterRegions(Filter& filter, const FrameView& src, const FrameView& dst, const std::vector<RoiRect>& rects) {
+    for (const RoiRect& r : rects) {
+        if (!filter.apply(src.subView(r.x, r.y, r.width, r.height), dst.subView(r.x, r.y, r.width, r.height))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Filtra só dentro das regiões; fora delas dst recebe src sem alteração.
+// Conjunto vazio filtra o frame inteiro.
+template <typename Filter>
+bool applyRegions(Filter& filter, const FrameView& src, const FrameView& dst, const std::vector<RoiRect>& rects) {
+    if (rects.empty()) return filter.apply(src, dst);
+    if (src.format != dst.format || src.width != dst.width || src.height != dst.height) return false;
+
+    int align = src.planeCount() > 1 ? 2 : 1;
+    if (src.planes[0] != dst.planes[0]) copyFrame(src, dst);
+    return filterRegions(filter, src, dst, RegionSet::disjoint(rects, src.width, src.height, align));
+}
+
+// ==================== BLOCOS ALTERADOS ====================
+// Compara cada bloco do frame com o frame anterior e devolve só os blocos que
+// mudaram (vizinhos na mesma linha de blocos viram um retângulo). Com a saída
+// anterior preservada, só esses blocos precisam passar pelo filtro. Mantém
+// uma cópia compacta do último frame; o primeiro frame volta inteiro.
+class ChangeDetector {
+private:
+    int tileSize;
+    std::vector<uint8_t> previous;
+    FrameView previousView;
+    bool hasPrevious = false;
+
+public:
+    explicit ChangeDetector(int tile = 64) : tileSize(tile) {}
+
+    // Próxima chamada devolve o frame inteiro (ex.: a saída foi descartada)
+    void reset() { hasPrevious = false; }
+
+    std::vector<RoiRect> detect(const FrameView& frame) {
+        std::vector<RoiRect> changed;
+        bool sameLayout = hasPrevious && previousView.format == frame.format &&
+                          previousView.width == frame.width && previousView.height == frame.height;
+        if (!sameLayout) {
+            previous.resize(FrameView::compactSize(frame.format, frame.width, frame.height));
+            previousView = FrameView::wrap(frame.format, previous.data(), frame.width, frame.height);
+            copyFrame(frame, previousView);
+            hasPrevious = true;
+            changed.push_back({ 0, 0, frame.width, frame.height });
+            return changed;
+        }
+
+        // Só o plano 0 (em 4:2:0 o luma; blocos pares mantêm o croma alinhado)
+        int bpp = std::max(1, bytesPerPixel(frame.format));
+        for (int ty = 0; ty < frame.height; ty += tileSize) {
+            int rows = std::min(tileSize, frame.height - ty);
+            int runStart = -1;
+            for (int tx = 0; tx <= frame.width; tx += tileSize) {
+                bool dirty = false;
+                if (tx < frame.width) {
+                    size_t bytes = (size_t)std::min(tileSize, frame.width - tx) * bpp;
+                    for (int y = ty; y < ty + rows && !dirty; y++) {
+                        dirty = std::memcmp(frame.row(0, y) + (size_t)tx * bpp,
+                                            previousView.row(0, y) + (size_t)tx * bpp, bytes) != 0;
+                    }
+                }
+                if (dirty && runStart < 0) runStart = tx;
+                if (!dirty && runStart >= 0) {
+                    int runEnd = std::min(tx, frame.width);
+                    changed.push_back({ runStart, ty, runEnd - runStart, rows });
+                    runStart = -1;
+                }
+            }
+        }
+
+        for (const RoiRect& r : changed) {
+            copyFrame(frame.subView(r.x, r.y, r.width, r.height), previousView.subView(r.x, r.y, r.width, r.height));
+        }
+        return changed;
+    }
+};
+
+#endif // REGION_OF_INTEREST_H
@@ -0,0 +1,178 @@
+#ifndef SRGB_H
+#define SRGB_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "CpuFeatures.h"
+
+// ==================== CONVERSÃO sRGB <-> LINEAR ====================
+// As correções (LMS, daltonize, híbrida) são definidas em luz linear, mas a
+// captura entrega valores sRGB (gamma). Na GPU a conversão é feita de graça
+// pelo hardware (GL_SRGB8_ALPHA8 + GL_FRAMEBUFFER_SRGB); na CPU usamos
+// tabelas: 256 entradas para decodificar (uint8 -> float linear) e 4096
+// entradas para codificar (float linear -> uint8).
+//
+// Layout dos buffers: BGRA8 intercalado <-> 4 floats por pixel na mesma
+// ordem (B, G, R, A). O alfa é sempre linear (só é normalizado por 255).
+class SRGB {
+public:
+    static constexpr int ENCODE_TABLE_SIZE = 4096;
+    static constexpr int CURVE_TABLE_SIZE = 4096;
+
+    // Fórmulas exatas (IEC 61966-2-1) - usadas para montar as tabelas
+    static float toLinear(float c) {
+        return (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float toSRGB(float c) {
+        if (c <= 0.0f) return 0.0f;
+        if (c >= 1.0f) return 1.0f;
+        return (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    static float decode(uint8_t v) { return tables().decode[v]; }
+
+    static uint8_t encode(float linear) {
+        return tables().encode[encodeIndex(linear)];
+    }
+
+    // Curvas em float sem pow: tabela de 4096 intervalos com interpolação
+    // linear (erro < 1e-4, bem abaixo de 1 LSB de 8 bits). Entrada limitada a
+    // [0, 1]. Usadas pelo filtro de RGBA16F, que indexa a LUT em sRGB
+    static float toSRGBFast(float linear) { return interpolate(tables().encodeCurve, linear); }
+    static float toLinearFast(float c) { return interpolate(tables().decodeCurve, c); }
+
+    static const float* decodeTable() { return tables().decode; }
+    static const uint8_t* encodeTable() { return tables().encode; }
+
+    // Decodifica 'pixelCount' pixels BGRA8 para float linear (4 floats/pixel)
+    static void decodeBGRA(const uint8_t* src, float* dst, size_t pixelCount) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (CpuFeatures::get().avx2) {
+            done = decodeBGRA_AVX2(src, dst, pixelCount);
+        }
+#endif
+        const Tables& t = tables();
+        for (size_t i = done; i < pixelCount; i++) {
+            const uint8_t* s = src + i * 4;
+            float* d = dst + i * 4;
+            d[0] = t.decode[s[0]];
+            d[1] = t.decode[s[1]];
+            d[2] = t.decode[s[2]];
+            d[3] = s[3] * (1.0f / 255.0f);
+        }
+    }
+
+    // Codifica float linear (4 floats/pixel) de volta para BGRA8 sRGB
+    static void encodeBGRA(const float* src, uint8_t* dst, size_t pixelCount) {
+        size_t done = 0;
+#if DALTONISMO_X86_SIMD
+        if (CpuFeatures::get().avx2) {
+            done = encodeBGRA_AVX2(src, dst, pixelCount);
+        }
+#endif
+        const Tables& t = tables();
+        for (size_t i = done; i < pixelCount; i++) {
+            const float* s = src + i * 4;
+            uint8_t* d = dst + i * 4;
+            d[0] = t.encode[encodeIndex(s[0])];
+            d[1] = t.encode[encodeIndex(s[1])];
+            d[2] = t.encode[encodeIndex(s[2])];
+            float a = s[3] < 0.0f ? 0.0f : (s[3] > 1.0f ? 1.0f : s[3]);
+            d[3] = (uint8_t)(a * 255.0f + 0.5f);
+        }
+    }
+
+private:
+    struct Tables {
+        float decode[256];
+        // +4 bytes de folga: o gather AVX2 lê 32 bits a partir de cada índice
+        uint8_t encode[ENCODE_TABLE_SIZE + 4];
+        float encodeCurve[CURVE_TABLE_SIZE + 2];  // +1 de folga para v = 1.0
+        float decodeCurve[CURVE_TABLE_SIZE + 2];
+
+        Tables() {
+            for (int i = 0; i <= CURVE_TABLE_SIZE + 1; i++) {
+                float v = std::fmin(1.0f, i / (float)CURVE_TABLE_SIZE);
+                encodeCurve[i] = toSRGB(v);
+                decodeCurve[i] = toLinear(v);
+            }
+            for (int i = 0; i < 256; i++) {
+                decode[i] = toLinear(i / 255.0f);
+            }
+            for (int i = 0; i < ENCODE_TABLE_SIZE; i++) {
+                float s = toSRGB(i / (float)(ENCODE_TABLE_SIZE - 1));
+                encode[i] = (uint8_t)(s * 255.0f + 0.5f);
+            }
+            for (int i = ENCODE_TABLE_SIZE; i < ENCODE_TABLE_SIZE + 4; i++) {
+                encode[i] = 255;
+            }
+        }
+    };
+
+    static float interpolate(const float* curve, float v) {
+        v = v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;  // NaN -> 0
+        float position = v * CURVE_TABLE_SIZE;
+        int index = (int)position;
+        return curve[index] + (curve[index + 1] - curve[index]) * (position - index);
+    }
+
+    static const Tables& tables() {
+        static const Tables t;
+        return t;
+    }
+
+    static int encodeIndex(float linear) {
+        if (!(linear > 0.0f)) return 0;  // também trata NaN
+        if (linear >= 1.0f) return ENCODE_TABLE_SIZE - 1;
+        return (int)(linear * (ENCODE_TABLE_SIZE - 1) + 0.5f);
+    }
+
+#if DALTONISMO_X86_SIMD
+    // 2 pixels (8 canais) por iteração via gather da tabela de 256 floats
+    DALTONISMO_TARGET("avx2")
+    static size_t decodeBGRA_AVX2(const uint8_t* src, float* dst, size_t pixelCount) {
+        const float* table = tables().decode;
+        const __m256 alphaScale = _mm256_set1_ps(1.0f / 255.0f);
+        size_t i = 0;
+        for (; i + 2 <= pixelCount; i += 2) {
+            __m128i bytes = _mm_loadl_epi64((const __m128i*)(src + i * 4));
+            __m256i idx = _mm256_cvtepu8_epi32(bytes);
+            __m256 lin = _mm256_i32gather_ps(table, idx, 4);
+            __m256 alpha = _mm256_mul_ps(_mm256_cvtepi32_ps(idx), alphaScale);
+            _mm256_storeu_ps(dst + i * 4, _mm256_blend_ps(lin, alpha, 0x88));
+        }
+        return i;
+    }
+
+    DALTONISMO_TARGET("avx2")
+    static size_t encodeBGRA_AVX2(const float* src, uint8_t* dst, size_t pixelCount) {
+        const int* table = (const int*)tables().encode;
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 scale = _mm256_setr_ps(4095.0f, 4095.0f, 4095.0f, 255.0f,
+                                            4095.0f, 4095.0f, 4095.0f, 255.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256i lowByte = _mm256_set1_epi32(0xFF);
+        size_t i = 0;
+        for (; i + 2 <= pixelCount; i += 2) {
+            __m256 v = _mm256_loadu_ps(src + i * 4);
+            // max/min com 'v' como primeiro operando: NaN vira 0
+            v = _mm256_min_ps(_mm256_max_ps(v, zero), one);
+            __m256i idx = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v, scale), half));
+            __m256i enc = _mm256_and_si256(_mm256_i32gather_epi32(table, idx, 1), lowByte);
+            __m256i out = _mm256_blend_epi32(enc, idx, 0x88);
+
+            __m128i lo = _mm256_castsi256_si128(out);
+            __m128i hi = _mm256_extracti128_si256(out, 1);
+            __m128i words = _mm_packus_epi32(lo, hi);
+            _mm_storel_epi64((__m128i*)(dst + i * 4), _mm_packus_epi16(words, words));
+        }
+        return i;
+    }
+#endif
+};
+
+#endif // SRGB_H
@@ -0,0 +1,283 @@
+#ifndef SCREEN_CAPTURE_H
+#define SCREEN_CAPTURE_H
+
+#ifdef _WIN32
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "UploadRing.h"
+
+#include <windows.h>
+
+// Captura de tela GDI, compartilhada pelo overlay (src/main.cpp) e pelo
+// daemon de captura (tools/capturedaemon.cpp). Só Windows.
+
+// ==================== MONITORES ====================
+// Retângulos de todos os monitores em coordenadas da tela virtual (podem ser
+// negativos à esquerda/acima do principal). O principal vem primeiro.
+inline BOOL CALLBACK collectMonitor(HMONITOR monitor, HDC, LPRECT, LPARAM userData) {
+    MONITORINFO info;
+    info.cbSize = sizeof(MONITORINFO);
+    if (GetMonitorInfo(monitor, &info)) {
+        auto* rects = (std::vector<RECT>*)userData;
+        if (info.dwFlags & MONITORINFOF_PRIMARY) {
+            rects->insert(rects->begin(), info.rcMonitor);
+        } else {
+            rects->push_back(info.rcMonitor);
+        }
+    }
+    return TRUE;
+}
+
+inline std::vector<RECT> enumerateMonitors() {
+    std::vector<RECT> rects;
+    EnumDisplayMonitors(NULL, NULL, collectMonitor, (LPARAM)&rects);
+    if (rects.empty()) {
+        RECT primary = { 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) };
+        rects.push_back(primary);
+    }
+    return rects;
+}
+
+// ==================== CAPTURA INDEPENDENTE ====================
+// Captura GDI de um monitor (retângulo da tela virtual)
+class IndependentScreenCapture : public FrameSource {
+private:
+    HDC hdcScreen, hdcMemDC;
+    HBITMAP hbmScreen, hbmOld;
+    int originX, originY;
+    int screenWidth, screenHeight;
+    // HWND overlayHwnd;
+    // std::atomic<bool>* correctionEnabled;
+
+    // GetDIBits escreve linhas compactas (width*4): pool sem padding de linha
+    FramePool pool;
+    FrameHandle frontBuffer;
+    FrameHandle backBuffer;
+
+    std::mutex bufferMutex;
+    std::thread captureThread;
+    std::atomic<bool> running;
+    std::atomic<bool> initialized;
+    std::atomic<int> frameCount;
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<int> rateDivisor{1};
+    std::atomic<int64_t> captureMicros{0};  // BitBlt + GetDIBits do último frame
+    FrameWriteTarget* writeTarget = nullptr;  // != nullptr: GetDIBits escreve direto no destino
+    FrameListener frameListener;  // gravação (só no caminho com cópia)
+
+public:
+    explicit IndependentScreenCapture(const RECT& region) 
+        : originX(region.left), originY(region.top),
+          screenWidth(region.right - region.left), screenHeight(region.bottom - region.top),
+          pool(PixelFormat::BGRA8, region.right - region.left, region.bottom - region.top, compactLayout()),
+          running(false), initialized(false), frameCount(0) {
+        frontBuffer = pool.acquire();
+        backBuffer = pool.acquire();
+    }
+
+    ~IndependentScreenCapture() {
+        stop();
+        cleanup();
+    }
+
+    bool initialize() override {
+        if (!frontBuffer || !backBuffer) return false;  // o pool não conseguiu memória no construtor
+
+        hdcScreen = GetDC(NULL);
+        if (!hdcScreen) return false;
+
+        hdcMemDC = CreateCompatibleDC(hdcScreen);
+        if (!hdcMemDC) {
+            ReleaseDC(NULL, hdcScreen);
+            return false;
+        }
+
+        hbmScreen = CreateCompatibleBitmap(hdcScreen, screenWidth, screenHeight);
+        if (!hbmScreen) {
+            DeleteDC(hdcMemDC);
+            ReleaseDC(NULL, hdcScreen);
+            return false;
+        }
+
+        hbmOld = (HBITMAP)SelectObject(hdcMemDC, hbmScreen);
+
+        initialized = true;
+        std::cout << "✅ Captura independente: " << screenWidth << "x" << screenHeight
+                  << " em (" << originX << ", " << originY << ")" << std::endl;
+        return true;
+    }
+
+    void start() override {
+        if (running) return;
+
+        running = true;
+        captureThread = std::thread(&IndependentScreenCapture::captureLoop, this);
+
+        // CRITICAL: Aumentar prioridade da thread
+        HANDLE threadHandle = (HANDLE)captureThread.native_handle();
+        SetThreadPriority(threadHandle, THREAD_PRIORITY_HIGHEST);
+
+        std::cout << "✅ Thread de captura em ALTA PRIORIDADE" << std::endl;
+    }
+
+    void stop() override {
+        if (!running) return;
+        running = false;
+        if (captureThread.joinable()) {
+            captureThread.join();
+        }
+    }
+
+    // O lock fica preso durante fn: a thread de captura não troca o buffer no meio do upload
+    bool readLatest(const std::function<void(const FrameView&)>& fn) override {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (frameCount == 0 || writeTarget) return false;
+        fn(frontBuffer.view());
+        return true;
+    }
+
+    // Só antes de start(); o destino precisa ter linhas compactas (layout do GetDIBits)
+    bool attachWriteTarget(FrameWriteTarget* target) override {
+        if (running || target->getWidth() != screenWidth || target->getHeight() != screenHeight ||
+            target->getFormat() != PixelFormat::BGRA8 || target->view(0).strides[0] != screenWidth * 4) {
+            return false;
+        }
+        writeTarget = target;
+        return true;
+    }
+
+    uint64_t getBytesWritten() const override { return bytesWritten; }
+
+    void setRateDivisor(int divisor) override { rateDivisor = divisor > 1 ? divisor : 1; }
+    double getCaptureMs() const override { return captureMicros / 1000.0; }
+
+    bool setFrameListener(FrameListener listener) override {
+        frameListener = std::move(listener);
+        return true;
+    }
+
+    // void setOverlayWindow(HWND hwnd) {
+    //     overlayHwnd = hwnd;
+    // }
+
+    // void setCorrectionState(std::atomic<bool>* state) {
+    //     correctionEnabled = state;
+    // }
+
+    int getWidth() const override { return screenWidth; }
+    int getHeight() const override { return screenHeight; }
+    PixelFormat getFormat() const override { return PixelFormat::BGRA8; }  // GDI: sempre 8 bits
+    bool isInitialized() const { return initialized; }
+    int getFrameCount() const override { return frameCount; }
+
+private:
+    static FramePool::Options compactLayout() {
+        FramePool::Options options;
+        options.padStrides = false;
+        return options;
+    }
+
+    void captureLoop() {
+        using namespace std::chrono;
+
+        BITMAPINFOHEADER bi;
+        ZeroMemory(&bi, sizeof(BITMAPINFOHEADER));
+        bi.biSize = sizeof(BITMAPINFOHEADER);
+        bi.biWidth = screenWidth;
+        bi.biHeight = -screenHeight;
+        bi.biPlanes = 1;
+        bi.biBitCount = 32;
+        bi.biCompression = BI_RGB;
+
+        auto lastCapture = steady_clock::now();
+
+        while (running) {
+            auto now = steady_clock::now();
+            auto elapsed = duration_cast<milliseconds>(now - lastCapture).count();
+
+            // if (overlayHwnd) ShowWindow(overlayHwnd, SW_HIDE);
+
+            // Capturar a cada 16ms (~60 FPS) independente de qualquer coisa
+            // (x divisor quando o governador de qualidade reduz a taxa)
+            if (elapsed >= 16 * rateDivisor.load()) {
+                if (BitBlt(hdcMemDC, 0, 0, screenWidth, screenHeight, 
+                        hdcScreen, originX, originY, SRCCOPY | CAPTUREBLT)) {
+
+                    if (!writeTarget && (!backBuffer || backBuffer.useCount() > 1)) {
+                        backBuffer = pool.acquire();  // o anterior ainda está com o listener
+                    }
+                    if (writeTarget) {
+                        captureIntoTarget(bi);
+                    } else if (backBuffer && GetDIBits(hdcScreen, hbmScreen, 0, screenHeight,
+                                backBuffer.data(), (BITMAPINFO*)&bi, DIB_RGB_COLORS)) {
+
+                        backBuffer.view().timestampUs = duration_cast<microseconds>(now.time_since_epoch()).count();
+                        if (frameListener) frameListener(backBuffer);
+                        {
+                            std::lock_guard<std::mutex> lock(bufferMutex);
+                            std::swap(frontBuffer, backBuffer);
+                        }
+
+                        bytesWritten += (uint64_t)screenWidth * screenHeight * 4;
+                        frameCount++;
+                    }
+                }
+
+                captureMicros = duration_cast<microseconds>(steady_clock::now() - now).count();
+                lastCapture = now;
+            }
+
+            // Dormir apenas 1ms para manter responsividade
+            Sleep(1);
+        }
+    }
+
+    // GetDIBits escreve direto no destino (PBO mapeado, anel compartilhado):
+    // a única passagem do frame pela CPU
+    void captureIntoTarget(BITMAPINFOHEADER& bi) {
+        int slot = writeTarget->beginWrite();
+        if (slot < 0) return;  // GPU ainda lendo todos os slots: descarta o frame
+
+        if (GetDIBits(hdcScreen, hbmScreen, 0, screenHeight,
+                      writeTarget->view(slot).planes[0], (BITMAPINFO*)&bi, DIB_RGB_COLORS)) {
+            int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            writeTarget->commitWrite(slot, now);
+            bytesWritten += (uint64_t)screenWidth * screenHeight * 4;
+            frameCount++;
+        } else {
+            writeTarget->cancelWrite(slot);
+        }
+    }
+
+    void cleanup() {
+        if (hbmScreen) {
+            SelectObject(hdcMemDC, hbmOld);
+            DeleteObject(hbmScreen);
+            hbmScreen = NULL;
+        }
+        if (hdcMemDC) {
+            DeleteDC(hdcMemDC);
+            hdcMemDC = NULL;
+        }
+        if (hdcScreen) {
+            ReleaseDC(NULL, hdcScreen);
+            hdcScreen = NULL;
+        }
+        initialized = false;
+    }
+};
+
+#endif // _WIN32
+
+#endif // SCREEN_CAPTURE_H
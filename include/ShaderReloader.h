@@ -0,0 +1,298 @@
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ==================== COMPILAÇÃO COM VERIFICAÇÃO ====================
+// Compila e linka um programa vertex + fragment. Qualquer erro devolve 0
+// com o log do driver em 'log' (nada de programa meio quebrado em uso).
+inline std::string shaderLog(const char* stage, const char* text) {
+    std::string log = std::string(stage) + ": " + text;
+    while (!log.empty() && (log.back() == '\n' || log.back() == ' ')) log.pop_back();  // logs terminam em \n
+    return log;
+}
+
+inline GLuint compileShaderStage(GLenum type, const std::string& source, std::string* log) {
+    GLuint shader = glCreateShader(type);
+    const char* text = source.c_str();
+    glShaderSource(shader, 1, &text, nullptr);
+    glCompileShader(shader);
+    GLint status = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        char buffer[2048] = {};
+        glGetShaderInfoLog(shader, sizeof(buffer), nullptr, buffer);
+        if (log) *log = shaderLog(type == GL_VERTEX_SHADER ? "vertex" : "fragment", buffer);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+inline GLuint linkProgram(const std::string& vertexSource, const std::string& fragmentSource, std::string* log) {
+    GLuint vertex = compileShaderStage(GL_VERTEX_SHADER, vertexSource, log);
+    GLuint fragment = vertex ? compileShaderStage(GL_FRAGMENT_SHADER, fragmentSource, log) : 0;
+    GLuint program = 0;
+    if (vertex && fragment) {
+        program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        GLint status = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (!status) {
+            char buffer[2048] = {};
+            glGetProgramInfoLog(program, sizeof(buffer), nullptr, buffer);
+            if (log) *log = shaderLog("link", buffer);
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (vertex) glDeleteShader(vertex);
+    if (fragment) glDeleteShader(fragment);
+    return program;
+}
+
+// Liga cada sampler à sua unidade (fica gravado no programa) e roda
+// glValidateProgram: pega samplers de tipos diferentes na mesma unidade,
+// que só apareceriam como erro no primeiro draw
+inline bool validateProgram(GLuint program, const std::vector<std::pair<std::string, int>>& samplers,
+                            std::string* log) {
+    glUseProgram(program);
+    for (const auto& sampler : samplers) {
+        glUniform1i(glGetUniformLocation(program, sampler.first.c_str()), sampler.second);
+    }
+    glValidateProgram(program);
+    glUseProgram(0);
+    GLint status = 0;
+    glGetProgramiv(program, GL_VALIDATE_STATUS, &status);
+    if (!status) {
+        char buffer[2048] = {};
+        glGetProgramInfoLog(program, sizeof(buffer), nullptr, buffer);
+        if (log) *log = shaderLog("validação", buffer);
+    }
+    return status != 0;
+}
+
+// ==================== RECARGA DE SHADERS ====================
+// Programa do overlay carregado de shaders/ e recompilado quando um dos
+// arquivos muda, sem rebuild nem restart. A compilação roda em uma thread
+// própria com um contexto GL compartilhado com os de render, então um
+// shader grande não trava nenhum frame; o programa pronto só é entregue
+// depois de glFinish() e a thread de render troca o seu no início do
+// próximo frame (take). Se o arquivo não compilar, não linkar ou não
+// validar, o log do driver vai para o console e volta o shader embutido
+// no executável.
+//
+// Um programa por consumidor: uniforms são estado do programa e cada thread
+// de render ajusta os seus.
+class ShaderReloader {
+public:
+    struct Options {
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string fallbackVertex;    // embutidos: usados quando o arquivo falha
+        std::string fallbackFragment;
+        std::vector<std::pair<std::string, int>> samplers;  // nome -> unidade de textura
+        int consumers = 1;
+        std::chrono::milliseconds interval{ 250 };  // consulta à data dos arquivos
+        std::function<void()> makeCurrent;  // thread da compilação: liga o contexto compartilhado
+        std::function<void()> release;      // e o solta no fim
+        // Os consumidores já começam com programas compilados por quem chamou
+        // (a partir dos arquivos se filesInUse): sem a compilação inicial,
+        // só mudanças nos arquivos depois do start() recompilam
+        bool compiledByCaller = false;
+        bool filesInUse = false;
+    };
+
+private:
+    Options options;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    bool stopping = false;
+    bool reloadRequested = false;
+    std::vector<GLuint> ready;  // por consumidor; 0: nada novo desde o último take()
+
+    std::filesystem::file_time_type vertexTime{}, fragmentTime{};
+    bool fromFiles = false;     // o último programa entregue veio dos arquivos
+    std::atomic<uint64_t> reloads{0};
+    std::atomic<uint64_t> failures{0};
+
+public:
+    ShaderReloader() {}
+    ~ShaderReloader() { stop(); }
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    // A primeira compilação dos arquivos sai logo no início da thread; até lá
+    // (e se eles não existirem) os consumidores seguem com o embutido
+    void start(const Options& reloaderOptions) {
+        stop();
+        options = reloaderOptions;
+        ready.assign(options.consumers, 0);
+        stopping = false;
+        reloadRequested = !options.compiledByCaller;
+        fromFiles = options.compiledByCaller && options.filesInUse;
+        if (options.compiledByCaller) {
+            std::error_code error;
+            vertexTime = std::filesystem::last_write_time(options.vertexPath, error);
+            fragmentTime = std::filesystem::last_write_time(options.fragmentPath, error);
+        }
+        worker = std::thread(&ShaderReloader::workerLoop, this);
+    }
+
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        worker.join();
+    }
+
+    // Recompila na próxima volta mesmo sem mudança nos arquivos
+    void requestReload() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            reloadRequested = true;
+        }
+        wakeCondition.notify_all();
+    }
+
+    // Thread de render do consumidor: programa novo (quem recebe passa a ser
+    // dono e apaga o anterior) ou 0 se nada mudou
+    GLuint take(int consumer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (consumer >= (int)ready.size()) return 0;  // ainda não iniciado
+        GLuint program = ready[consumer];
+        ready[consumer] = 0;
+        return program;
+    }
+
+    uint64_t getReloads() const { return reloads; }
+    uint64_t getFailures() const { return failures; }
+
+private:
+    void workerLoop() {
+        if (options.makeCurrent) options.makeCurrent();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            bool forced = reloadRequested;
+            reloadRequested = false;
+            lock.unlock();
+            if (filesChanged() || forced) reload();
+            lock.lock();
+            wakeCondition.wait_for(lock, options.interval, [&] { return stopping || reloadRequested; });
+        }
+        // Programas que ninguém pegou morrem aqui (o contexto é compartilhado)
+        for (GLuint& program : ready) {
+            if (program) glDeleteProgram(program);
+            program = 0;
+        }
+        lock.unlock();
+        if (options.release) options.release();
+    }
+
+    // Editores salvam em mais de uma escrita: só recompila quando a data
+    // dos arquivos ficou igual por uma volta inteira
+    bool filesChanged() {
+        std::error_code error;
+        auto vertex = std::filesystem::last_write_time(options.vertexPath, error);
+        if (error) return false;
+        auto fragment = std::filesystem::last_write_time(options.fragmentPath, error);
+        if (error) return false;
+        if (vertex == vertexTime && fragment == fragmentTime) return false;
+        std::this_thread::sleep_for(options.interval);
+        if (std::filesystem::last_write_time(options.vertexPath, error) != vertex || error) return false;
+        if (std::filesystem::last_write_time(options.fragmentPath, error) != fragment || error) return false;
+        vertexTime = vertex;
+        fragmentTime = fragment;
+        return true;
+    }
+
+    static std::string readText(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) return "";
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    void reload() {
+        using namespace std::chrono;
+        auto start = steady_clock::now();
+        std::string vertexSource = readText(options.vertexPath);
+        std::string fragmentSource = readText(options.fragmentPath);
+        if (vertexSource.empty() || fragmentSource.empty()) {
+            std::printf("⚠️ %s / %s não encontrados: shader embutido\n",
+                        options.vertexPath.c_str(), options.fragmentPath.c_str());
+            fallback();
+            return;
+        }
+
+        std::vector<GLuint> programs;
+        std::string log;
+        for (int i = 0; i < options.consumers; i++) {
+            GLuint program = linkProgram(vertexSource, fragmentSource, &log);
+            if (!program || !validateProgram(program, options.samplers, &log)) {
+                if (program) glDeleteProgram(program);
+                for (GLuint built : programs) glDeleteProgram(built);
+                failures++;
+                std::printf("❌ Shader de %s não compilou (%s)\n", options.fragmentPath.c_str(), log.c_str());
+                fallback();
+                return;
+            }
+            programs.push_back(program);
+        }
+        publish(programs);
+        fromFiles = true;
+        reloads++;
+        std::printf("🔄 Shaders recarregados de %s (%.1f ms)\n", options.fragmentPath.c_str(),
+                    duration<double, std::milli>(steady_clock::now() - start).count());
+    }
+
+    // Volta ao embutido só se o programa em uso veio dos arquivos: no
+    // início os consumidores já rodam o embutido
+    void fallback() {
+        if (!fromFiles) return;
+        std::vector<GLuint> programs;
+        for (int i = 0; i < options.consumers; i++) {
+            std::string log;
+            GLuint program = linkProgram(options.fallbackVertex, options.fallbackFragment, &log);
+            if (program) validateProgram(program, options.samplers, &log);
+            programs.push_back(program);
+        }
+        publish(programs);
+        fromFiles = false;
+        std::printf("   Voltando ao shader embutido\n");
+    }
+
+    // glFinish antes de entregar: o programa fica completo para os outros
+    // contextos antes de alguém fazer glUseProgram nele
+    void publish(const std::vector<GLuint>& programs) {
+        glFinish();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < options.consumers; i++) {
+            if (ready[i]) glDeleteProgram(ready[i]);  // versão anterior que ninguém pegou
+            ready[i] = programs[i];
+        }
+    }
+};
+
+#endif // SHADER_RELOADER_H
@@ -0,0 +1,473 @@
+#ifndef SHARED_FRAME_RING_H
+#define SHARED_FRAME_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Frame.h"
+#include "FrameSource.h"
+#include "SharedMemory.h"
+#include "UploadRing.h"
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <time.h>
+#endif
+
+// ==================== ANEL DE FRAMES EM MEMÓRIA COMPARTILHADA ====================
+// O daemon de captura publica frames em um segmento compartilhado (memfd em
+// Linux, seção nomeada no Windows) e qualquer número de processos lê os
+// frames no lugar, sem cópia.
+//
+// O escritor nunca espera leitores: cada slot é um seqlock. Antes de escrever
+// o frame N no slot N % slotCount o escritor marca o slot com 2N+1 (ímpar =
+// escrevendo) e, ao terminar, com 2N. O leitor pega o frame mais novo, usa os
+// pixels direto da memória compartilhada e depois confere se o slot ainda tem
+// 2N (isIntact); se o escritor deu a volta no anel, o frame é descartado.
+//
+// Notificação: futex compartilhado (Linux) sobre os 32 bits baixos da
+// sequência. O escritor só faz a syscall de wake se houver leitor dormindo,
+// e faz uma só por frame, qualquer que seja o número de leitores. No Windows
+// (WaitOnAddress não funciona entre processos) o leitor consulta a sequência
+// a cada 1 ms.
+
+struct SharedFrameRingHeader {
+    static const uint32_t magicValue = 0x52544C44;  // "DLTR"
+    static const uint32_t currentVersion = 1;
+    static const int maxSlots = 8;
+    static const int maxDimension = 16384;  // o leitor recusa cabeçalhos com mais que isso
+
+    struct SlotMeta {
+        std::atomic<uint64_t> state;  // 2N: frame N pronto, 2N+1: escrevendo, 0: vazio
+        int64_t timestampUs;
+    };
+
+    uint32_t magic;
+    uint32_t version;
+    int32_t format;
+    int32_t width, height;
+    int32_t stride;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotBytes;
+    uint64_t dataOffset;
+    uint64_t totalBytes;
+
+    alignas(64) std::atomic<uint64_t> latestSequence;  // 0: nenhum frame ainda
+    std::atomic<uint32_t> notifyWord;                  // palavra do futex
+    std::atomic<uint32_t> waiters;                     // leitores dormindo no futex
+
+    alignas(64) SlotMeta slots[maxSlots];
+};
+
+// Escritor: usado pelo daemon como destino de escrita de uma fonte
+class SharedFrameRing : public FrameWriteTarget {
+private:
+    SharedMemory memory;
+    SharedFrameRingHeader* header = nullptr;
+    FrameView views[SharedFrameRingHeader::maxSlots];
+    uint64_t nextSequence = 1;
+    std::string name;
+
+#ifdef __linux__
+    int listenFd = -1;
+    std::thread serverThread;
+    std::atomic<bool> serving{false};
+#endif
+
+public:
+    ~SharedFrameRing() { stopServing(); }
+
+    // Frames compactos (GetDIBits escreve width*4 por linha); slots alinhados em 4 KB
+    bool create(const std::string& ringName, PixelFormat format, int width, int height, int slotCount = 4) {
+        if (slotCount < 2 || slotCount > SharedFrameRingHeader::maxSlots) return false;
+        name = ringName;
+
+        const uint64_t pageSize = 4096;
+        uint64_t frameBytes = FrameView::compactSize(format, width, height);
+        uint64_t slotBytes = (frameBytes + pageSize - 1) & ~(pageSize - 1);
+        uint64_t dataOffset = (sizeof(SharedFrameRingHeader) + pageSize - 1) & ~(pageSize - 1);
+        uint64_t totalBytes = dataOffset + slotBytes * slotCount;
+
+        if (!memory.create(segmentName(ringName), (size_t)totalBytes)) return false;
+
+        header = new (memory.getData()) SharedFrameRingHeader();
+        header->magic = SharedFrameRingHeader::magicValue;
+        header->version = SharedFrameRingHeader::currentVersion;
+        header->format = (int32_t)format;
+        header->width = width;
+        header->height = height;
+        header->stride = FrameView::wrap(format, nullptr, width, height).strides[0];
+        header->slotCount = (uint32_t)slotCount;
+        header->slotBytes = slotBytes;
+        header->dataOffset = dataOffset;
+        header->totalBytes = totalBytes;
+        header->latestSequence.store(0);
+        header->notifyWord.store(0);
+        header->waiters.store(0);
+        for (int i = 0; i < SharedFrameRingHeader::maxSlots; i++) {
+            header->slots[i].state.store(0);
+            header->slots[i].timestampUs = 0;
+        }
+
+        for (int i = 0; i < slotCount; i++) {
+            views[i] = FrameView::wrap(format, memory.getData() + dataOffset + slotBytes * i, width, height);
+        }
+        return true;
+    }
+
+    uint8_t* getBase() const { return memory.getData(); }
+    size_t getSize() const { return memory.getSize(); }
+
+    PixelFormat getFormat() const override { return (PixelFormat)header->format; }
+    int getWidth() const override { return header->width; }
+    int getHeight() const override { return header->height; }
+    uint64_t getLatestSequence() const { return header->latestSequence.load(); }
+
+    // Sempre há slot: o mais antigo é sobrescrito, sem esperar leitores
+    int beginWrite() override {
+        int slot = (int)(nextSequence % header->slotCount);
+        header->slots[slot].state.store(nextSequence * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return slot;
+    }
+
+    const FrameView& view(int index) const override { return views[index]; }
+
+    void commitWrite(int index, int64_t timestampUs) override {
+        uint64_t sequence = nextSequence++;
+        header->slots[index].timestampUs = timestampUs;
+        header->slots[index].state.store(sequence * 2, std::memory_order_release);
+        header->latestSequence.store(sequence, std::memory_order_seq_cst);
+        header->notifyWord.store((uint32_t)sequence, std::memory_order_seq_cst);
+        if (header->waiters.load(std::memory_order_seq_cst) > 0) wakeReaders();
+    }
+
+    void cancelWrite(int index) override {
+        header->slots[index].state.store(0, std::memory_order_release);
+    }
+
+    // ---------- Entrega do segmento a outros processos ----------
+
+#ifdef __linux__
+    // Socket unix abstrato "\0daltonismo-<nome>": cada cliente que conecta
+    // recebe o memfd (SCM_RIGHTS) e o tamanho do segmento
+    bool startServing() {
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) return false;
+        sockaddr_un address;
+        socklen_t length = socketAddress(name, address);
+        if (bind(listenFd, (sockaddr*)&address, length) != 0 || listen(listenFd, 8) != 0) {
+            std::perror("SharedFrameRing: bind");
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        serving = true;
+        serverThread = std::thread(&SharedFrameRing::serveLoop, this);
+        return true;
+    }
+
+    void stopServing() {
+        if (!serving) return;
+        serving = false;
+        shutdown(listenFd, SHUT_RDWR);
+        ::close(listenFd);
+        listenFd = -1;
+        if (serverThread.joinable()) serverThread.join();
+    }
+
+    static socklen_t socketAddress(const std::string& ringName, sockaddr_un& address) {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::string path = "daltonismo-" + ringName;
+        std::strncpy(address.sun_path + 1, path.c_str(), sizeof(address.sun_path) - 2);
+        return (socklen_t)(offsetof(sockaddr_un, sun_path) + 1 + std::min(path.size(), sizeof(address.sun_path) - 2));
+    }
+#else
+    // Windows: os leitores abrem a seção pelo nome
+    bool startServing() { return true; }
+    void stopServing() {}
+#endif
+
+    static std::string segmentName(const std::string& ringName) {
+#ifdef _WIN32
+        return "Local\\daltonismo-" + ringName;
+#else
+        return "daltonismo-" + ringName;
+#endif
+    }
+
+private:
+    void wakeReaders() {
+#ifdef __linux__
+        syscall(SYS_futex, (uint32_t*)&header->notifyWord, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+#ifdef __linux__
+    void serveLoop() {
+        while (serving) {
+            int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) continue;
+
+            uint64_t size = memory.getSize();
+            iovec payload = { &size, sizeof(size) };
+            char control[CMSG_SPACE(sizeof(int))];
+            std::memset(control, 0, sizeof(control));
+            msghdr message;
+            std::memset(&message, 0, sizeof(message));
+            message.msg_iov = &payload;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            int fd = memory.getFd();
+            std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+            sendmsg(client, &message, MSG_NOSIGNAL);
+            ::close(client);
+        }
+    }
+#endif
+};
+
+// Leitor: mapeia o segmento e lê os frames no lugar
+class SharedFrameRingReader {
+public:
+    struct Frame {
+        FrameView view;
+        uint64_t sequence = 0;
+        int slot = -1;
+    };
+
+private:
+    SharedMemory memory;         // dono do mapeamento quando conectado por nome
+    uint8_t* base = nullptr;
+    SharedFrameRingHeader* header = nullptr;
+    // Layout copiado do cabeçalho já validado: o escritor (outro processo)
+    // pode mudar o segmento depois, e os endereços dos slots não dependem dele
+    PixelFormat format = PixelFormat::BGRA8;
+    int width = 0, height = 0;
+    uint32_t slotCount = 0;
+    uint64_t slotBytes = 0, dataOffset = 0;
+    uint64_t lastSequence = 0;
+    uint64_t framesRead = 0, framesTorn = 0, framesSkipped = 0;
+
+public:
+    // Conecta ao daemon pelo nome do anel
+    bool attach(const std::string& ringName) {
+#ifdef __linux__
+        int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) return false;
+        sockaddr_un address;
+        socklen_t length = SharedFrameRing::socketAddress(ringName, address);
+        if (connect(sock, (sockaddr*)&address, length) != 0) {
+            ::close(sock);
+            return false;
+        }
+
+        uint64_t size = 0;
+        iovec payload = { &size, sizeof(size) };
+        char control[CMSG_SPACE(sizeof(int))];
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = &payload;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t received = recvmsg(sock, &message, MSG_CMSG_CLOEXEC);
+        ::close(sock);
+
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        if (received != sizeof(size) || !cmsg || cmsg->cmsg_type != SCM_RIGHTS) return false;
+        int fd;
+        std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+        // O tamanho vem do outro processo: mapear além do fim do memfd dá SIGBUS no acesso
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size == 0 || size > (uint64_t)info.st_size) {
+            ::close(fd);
+            std::fprintf(stderr, "SharedFrameRing: tamanho do segmento inválido\n");
+            return false;
+        }
+        if (!memory.attach(fd, (size_t)size)) return false;
+#else
+        if (!memory.open(SharedFrameRing::segmentName(ringName), sizeof(SharedFrameRingHeader))) return false;
+        uint64_t size = ((SharedFrameRingHeader*)memory.getData())->totalBytes;
+        if (size < sizeof(SharedFrameRingHeader)) return false;
+        if (!memory.open(SharedFrameRing::segmentName(ringName), (size_t)size)) return false;
+#endif
+        return attachMemory(memory.getData(), memory.getSize());
+    }
+
+    // Segmento já mapeado (ex.: herdado via fork), com o tamanho do mapeamento.
+    // Nada do cabeçalho é usado antes de conferido contra size
+    bool attachMemory(uint8_t* segment, size_t size) {
+        header = nullptr;
+        if (!segment || size < sizeof(SharedFrameRingHeader)) return reject("segmento menor que o cabeçalho");
+        SharedFrameRingHeader* candidate = (SharedFrameRingHeader*)segment;
+        if (candidate->magic != SharedFrameRingHeader::magicValue ||
+            candidate->version != SharedFrameRingHeader::currentVersion) {
+            return reject("segmento inválido");
+        }
+
+        const int32_t candidateFormat = candidate->format;
+        const int candidateWidth = candidate->width, candidateHeight = candidate->height;
+        const uint32_t candidateSlots = candidate->slotCount;
+        const uint64_t candidateSlotBytes = candidate->slotBytes;
+        const uint64_t candidateOffset = candidate->dataOffset;
+        const uint64_t candidateTotal = candidate->totalBytes;
+        if (candidateFormat < (int32_t)PixelFormat::BGRA8 || candidateFormat > (int32_t)PixelFormat::RGBA16F ||
+            candidateWidth <= 0 || candidateHeight <= 0 || candidateWidth > SharedFrameRingHeader::maxDimension ||
+            candidateHeight > SharedFrameRingHeader::maxDimension) {
+            return reject("formato ou dimensões inválidos");
+        }
+        if (candidateSlots == 0 || candidateSlots > (uint32_t)SharedFrameRingHeader::maxSlots) {
+            return reject("número de slots inválido");
+        }
+        // slotBytes <= totalBytes <= size e no máximo maxSlots slots: o produto não estoura 64 bits
+        const uint64_t frameBytes =
+            FrameView::compactSize((PixelFormat)candidateFormat, candidateWidth, candidateHeight);
+        if (candidateTotal > size || candidateOffset < sizeof(SharedFrameRingHeader) ||
+            candidateOffset > candidateTotal || candidateSlotBytes < frameBytes || candidateSlotBytes > candidateTotal ||
+            candidateSlotBytes * candidateSlots > candidateTotal - candidateOffset) {
+            return reject("slots fora do segmento");
+        }
+
+        base = segment;
+        header = candidate;
+        format = (PixelFormat)candidateFormat;
+        width = candidateWidth;
+        height = candidateHeight;
+        slotCount = candidateSlots;
+        slotBytes = candidateSlotBytes;
+        dataOffset = candidateOffset;
+        lastSequence = 0;
+        return true;
+    }
+
+    bool isAttached() const { return header != nullptr; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    PixelFormat getFormat() const { return format; }
+    uint64_t getLatestSequence() const { return header->latestSequence.load(); }
+
+    // Frame mais novo que o último lido; espera até timeoutMs (0 = não espera)
+    bool waitFrame(Frame& out, int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            if (tryLatest(out)) return true;
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) return false;
+            sleepUntilNotified((int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1);
+        }
+    }
+
+    // true se o escritor não sobrescreveu o slot enquanto o frame era usado
+    bool isIntact(const Frame& frame) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        bool intact = header->slots[frame.slot].state.load(std::memory_order_relaxed) == frame.sequence * 2;
+        if (!intact) framesTorn++;
+        return intact;
+    }
+
+    uint64_t getFramesRead() const { return framesRead; }
+    uint64_t getFramesTorn() const { return framesTorn; }
+    uint64_t getFramesSkipped() const { return framesSkipped; }  // frames publicados que este leitor não viu
+
+private:
+    bool tryLatest(Frame& out) {
+        uint64_t sequence = header->latestSequence.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence == lastSequence) return false;
+
+        int slot = (int)(sequence % slotCount);
+        if (header->slots[slot].state.load(std::memory_order_acquire) != sequence * 2) return false;
+
+        if (lastSequence != 0 && sequence > lastSequence + 1) framesSkipped += sequence - lastSequence - 1;
+        lastSequence = sequence;
+        framesRead++;
+
+        out.sequence = sequence;
+        out.slot = slot;
+        out.view = FrameView::wrap(format, base + dataOffset + slotBytes * slot, width, height);
+        out.view.timestampUs = header->slots[slot].timestampUs;
+        return true;
+    }
+
+    static bool reject(const char* why) {
+        std::fprintf(stderr, "SharedFrameRing: %s\n", why);
+        return false;
+    }
+
+    void sleepUntilNotified(int timeoutMs) {
+#ifdef __linux__
+        uint32_t expected = header->notifyWord.load(std::memory_order_seq_cst);
+        if (expected != (uint32_t)lastSequence) return;  // já há frame novo
+        header->waiters.fetch_add(1, std::memory_order_seq_cst);
+        timespec timeout = { timeoutMs / 1000, (long)(timeoutMs % 1000) * 1000000L };
+        syscall(SYS_futex, (uint32_t*)&header->notifyWord, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+        header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+#else
+        (void)timeoutMs;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+    }
+};
+
+// ==================== FONTE LIGADA AO DAEMON ====================
+// FrameSource que lê do anel compartilhado: o overlay usa os frames do
+// daemon em vez de capturar a tela de novo (main.cpp --attach <nome>).
+// Diferente dos outros leitores, copia cada frame antes de entregar.
+class SharedRingFrameSource : public FrameSource {
+private:
+    std::string ringName;
+    SharedFrameRingReader reader;
+    std::vector<uint8_t> copy;  // último frame íntegro (readLatest)
+
+public:
+    explicit SharedRingFrameSource(const std::string& name) : ringName(name) {}
+
+    bool initialize() override { return reader.attach(ringName); }
+    void start() override {}
+    void stop() override {}
+
+    int getWidth() const override { return reader.getWidth(); }
+    int getHeight() const override { return reader.getHeight(); }
+    PixelFormat getFormat() const override { return reader.getFormat(); }
+    int getFrameCount() const override { return (int)reader.getLatestSequence(); }
+    uint64_t getFramesTorn() const { return reader.getFramesTorn(); }
+
+    // fn pode demorar (upload, filtro) e não sabe desfazer o que fez com um
+    // frame rasgado: copia o slot para um buffer próprio, confere a sequência
+    // depois da cópia e só entrega frames íntegros. Rasgado conta como não lido
+    bool readLatest(const std::function<void(const FrameView&)>& fn) override {
+        SharedFrameRingReader::Frame frame;
+        if (!reader.waitFrame(frame, 0)) return false;
+        const FrameView& shared = frame.view;
+        copy.resize(FrameView::compactSize(shared.format, shared.width, shared.height));
+        FrameView local = FrameView::wrap(shared.format, copy.data(), shared.width, shared.height);
+        copyFrame(shared, local);
+        if (!reader.isIntact(frame)) return false;
+        local.timestampUs = shared.timestampUs;
+        fn(local);
+        return true;
+    }
+};
+
+#endif // SHARED_FRAME_RING_H
@@ -0,0 +1,193 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ==================== MEMÓRIA COMPARTILHADA ====================
+// Segmento anônimo mapeado em memória: memfd_create em Linux (o fd pode ser
+// herdado ou passado por socket para outro processo), seção nomeada
+// (CreateFileMapping) no Windows. Usado como memória de upload (a captura
+// escreve direto nele) e como anel de frames entre processos.
+class SharedMemory {
+private:
+    uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+public:
+    SharedMemory() {}
+    ~SharedMemory() { close(); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Cria um segmento novo de 'bytes' bytes (zerado)
+    bool create(const std::string& name, size_t bytes) {
+        close();
+#ifdef _WIN32
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                     (DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, name.c_str());
+        if (!mapping) {
+            std::fprintf(stderr, "SharedMemory: CreateFileMapping falhou (%lu)\n", GetLastError());
+            return false;
+        }
+        return mapView(bytes);
+#else
+        fd = memfd_create(name.c_str(), MFD_CLOEXEC);
+        if (fd < 0 || ftruncate(fd, (off_t)bytes) != 0) {
+            std::perror("SharedMemory: memfd_create");
+            close();
+            return false;
+        }
+        return mapView(bytes);
+#endif
+    }
+
+#ifdef _WIN32
+    // Abre um segmento criado por outro processo
+    bool open(const std::string& name, size_t bytes) {
+        close();
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (!mapping) return false;
+        return mapView(bytes);
+    }
+#else
+    // Mapeia um memfd recebido de outro processo (a instância passa a ser dona do fd)
+    bool attach(int sharedFd, size_t bytes) {
+        close();
+        fd = sharedFd;
+        return mapView(bytes);
+    }
+
+    int getFd() const { return fd; }
+#endif
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        mapping = NULL;
+#else
+        if (data) munmap(data, size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+    bool isValid() const { return data != nullptr; }
+
+private:
+    bool mapView(size_t bytes) {
+#ifdef _WIN32
+        void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+        if (!view) {
+            close();
+            return false;
+        }
+#else
+        void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            std::perror("SharedMemory: mmap");
+            close();
+            return false;
+        }
+#endif
+        data = (uint8_t*)view;
+        size = bytes;
+        return true;
+    }
+};
+
+// ==================== ARQUIVO MAPEADO ====================
+// Arquivo inteiro mapeado só para leitura (mmap / MapViewOfFile): o leitor de
+// gravações anda pelos registros direto na page cache, sem fread para buffers
+// intermediários, e salta para qualquer posição (índice de keyframes).
+class MappedFile {
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            close();
+            return false;
+        }
+        size = (size_t)fileSize.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        off_t fileSize = lseek(fd, 0, SEEK_END);
+        void* view = fileSize > 0 ? mmap(nullptr, (size_t)fileSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);  // o mapeamento continua válido
+        if (view == MAP_FAILED) return false;
+        madvise(view, (size_t)fileSize, MADV_SEQUENTIAL);
+        size = (size_t)fileSize;
+#endif
+        data = (const uint8_t*)view;
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+    bool isOpen() const { return data != nullptr; }
+};
+
+#endif // SHARED_MEMORY_H
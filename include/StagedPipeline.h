@@ -0,0 +1,257 @@
+#ifndef STAGED_PIPELINE_H
+#define STAGED_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "Coroutines.h"
+#include "CpuFilter.h"
+#include "Frame.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "RegionOfInterest.h"
+
+// ==================== PIPELINE EM ESTÁGIOS ====================
+// Captura -> blocos alterados -> filtro de CPU -> upload -> apresentação,
+// cada estágio uma corrotina ligada aos vizinhos por canais de 1 frame.
+// Cada estágio suspende esperando a entrada (nada de laço com Sleep(1)
+// consultando getFrameCount) e frames sucessivos ficam em estágios
+// diferentes ao mesmo tempo: o frame N+1 é comparado enquanto o N é
+// filtrado e o N-1 apresentado.
+//
+// A captura é o listener da fonte (thread da própria fonte): entrega o handle
+// do frame sem cópia e, se o estágio seguinte ainda não pegou o anterior,
+// o substitui (sempre o mais recente). Blocos alterados e filtro têm uma
+// thread cada; upload e apresentação rodam no executor de apresentação, que
+// pode ter thread própria ou ser rodado por quem chama runPresent() (a
+// thread dona do contexto GL). Frames sem nenhum bloco alterado param no
+// segundo estágio.
+struct StagedFrame {
+    FrameHandle source;            // frame da captura (buffer do pool da fonte)
+    FrameHandle output;            // saída filtrada; vazio sem filtro de CPU
+    std::vector<RoiRect> changed;  // blocos alterados desde o frame anterior
+    uint64_t sequence = 0;
+    int64_t captureUs = 0;         // timestamp da fonte (steady_clock, µs)
+};
+
+class StagedPipeline {
+public:
+    using StageFn = std::function<void(StagedFrame&)>;
+
+    struct Options {
+        CpuFilter* filter = nullptr;  // nullptr: sem filtro de CPU (o shader filtra)
+        StageFn upload;               // nullptr: estágio só repassa
+        StageFn present;
+        bool presentThread = true;    // false: quem chama runPresent() roda upload/apresentação
+        int tileSize = 64;
+    };
+
+    struct Stats {
+        uint64_t captured = 0;
+        uint64_t replaced = 0;   // substituídos na entrada antes de serem comparados
+        uint64_t unchanged = 0;  // sem blocos alterados: não seguem
+        uint64_t presented = 0;
+        double latencyP50Ms = 0.0;  // captura -> fim da apresentação
+        double latencyP99Ms = 0.0;
+        double latencyMaxMs = 0.0;
+    };
+
+private:
+    Options options;
+    FrameSource* source = nullptr;
+    FrameSource::FrameListener chained;  // listener anterior (gravação) continua recebendo
+
+    Channel<StagedFrame> captured;
+    Channel<StagedFrame> diffed;
+    Channel<StagedFrame> filtered;
+    Channel<StagedFrame> uploaded;
+
+    Executor diffExecutor, filterExecutor, presentExecutor;
+    Task diffTask, filterTask, uploadTask, presentTask;
+    bool running = false;
+
+    ChangeDetector changes;
+    std::atomic<bool> resetRequested{false};
+    FramePool* outputPool = nullptr;
+    FrameHandle previousOutput;
+
+    std::atomic<uint64_t> capturedFrames{0};
+    std::atomic<uint64_t> unchangedFrames{0};
+    std::atomic<uint64_t> presentedFrames{0};
+    std::mutex latencyMutex;
+    std::vector<double> latencies;  // últimas 'latencyWindow' apresentações, em anel
+    size_t latencyNext = 0;
+    static const size_t latencyWindow = 4096;
+
+public:
+    StagedPipeline() : changes(64) {}
+    ~StagedPipeline() { stop(); }
+
+    StagedPipeline(const StagedPipeline&) = delete;
+    StagedPipeline& operator=(const StagedPipeline&) = delete;
+
+    // Uma vez por instância, antes de frameSource->start(). 'chain' recebe
+    // os frames antes do pipeline (ex.: o gravador): a fonte tem um listener só.
+    bool start(FrameSource* frameSource, const Options& pipelineOptions,
+               FrameSource::FrameListener chain = nullptr) {
+        if (running) return false;
+        options = pipelineOptions;
+        source = frameSource;
+        chained = std::move(chain);
+        changes = ChangeDetector(options.tileSize);
+        if (!source->setFrameListener([this](const FrameHandle& frame) { onFrame(frame); })) return false;
+        if (options.filter) {
+            outputPool = new FramePool(source->getFormat(), source->getWidth(), source->getHeight());
+        }
+
+        diffExecutor.startThreads(1);
+        filterExecutor.startThreads(1);
+        if (options.presentThread) presentExecutor.startThreads(1);
+
+        diffTask = diffStage();
+        filterTask = filterStage();
+        uploadTask = uploadStage();
+        presentTask = presentStage();
+        diffTask.start(diffExecutor);
+        filterTask.start(filterExecutor);
+        uploadTask.start(presentExecutor);
+        presentTask.start(presentExecutor);
+        running = true;
+        return true;
+    }
+
+    // Depois de parar a fonte. Fechar a entrada encerra os estágios em
+    // cascata; sem thread de apresentação, chamar na thread de runPresent().
+    void stop() {
+        if (!running) return;
+        captured.close();
+        while (!presentTask.isDone()) {
+            if (options.presentThread) {
+                presentTask.join();
+            } else {
+                presentExecutor.runFor(std::chrono::milliseconds(1));
+            }
+        }
+        diffTask.join();
+        filterTask.join();
+        uploadTask.join();
+        diffExecutor.stop();
+        filterExecutor.stop();
+        presentExecutor.stop();
+        previousOutput.reset();
+        delete outputPool;
+        outputPool = nullptr;
+        running = false;
+    }
+
+    // Laço da thread de apresentação quando presentThread = false
+    int runPresent(std::chrono::microseconds timeout) { return presentExecutor.runFor(timeout); }
+
+    // Próximo frame segue inteiro (mudou algo fora da fonte: força, LUT,
+    // storage da textura recriado)
+    void resetChanges() { resetRequested = true; }
+
+    Stats getStats() {
+        Stats stats;
+        stats.captured = capturedFrames;
+        stats.replaced = captured.getDropped();
+        stats.unchanged = unchangedFrames;
+        stats.presented = presentedFrames;
+        std::vector<double> sorted;
+        {
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            sorted = latencies;
+        }
+        if (!sorted.empty()) {
+            std::sort(sorted.begin(), sorted.end());
+            stats.latencyP50Ms = sorted[sorted.size() / 2];
+            stats.latencyP99Ms = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+            stats.latencyMaxMs = sorted.back();
+        }
+        return stats;
+    }
+
+private:
+    // Thread da fonte: só entrega o handle, sem cópia
+    void onFrame(const FrameHandle& frame) {
+        if (chained) chained(frame);
+        StagedFrame staged;
+        staged.source = frame;
+        staged.sequence = capturedFrames++;
+        staged.captureUs = frame.view().timestampUs;
+        captured.trySend(std::move(staged), true);
+    }
+
+    Task diffStage() {
+        while (std::optional<StagedFrame> frame = co_await captured.receive()) {
+            if (resetRequested.exchange(false)) changes.reset();
+            frame->changed = changes.detect(frame->source.view());
+            if (frame->changed.empty()) {
+                unchangedFrames++;
+                continue;
+            }
+            if (!co_await diffed.send(std::move(*frame))) break;
+        }
+        diffed.close();
+    }
+
+    // Parte da saída anterior e filtra só os blocos alterados
+    Task filterStage() {
+        while (std::optional<StagedFrame> frame = co_await diffed.receive()) {
+            if (options.filter) {
+                const FrameView& src = frame->source.view();
+                frame->output = outputPool->acquire();
+                if (!frame->output) {
+                    // Sem memória: descarta o frame; o próximo é filtrado inteiro, já que
+                    // os blocos deste nunca chegaram à saída
+                    previousOutput.reset();
+                    continue;
+                }
+                const FrameView& dst = frame->output.view();
+                if (!previousOutput) frame->changed = { RoiRect{ 0, 0, src.width, src.height } };
+                bool fullFrame = frame->changed.size() == 1 && frame->changed[0].width == src.width &&
+                                 frame->changed[0].height == src.height;
+                if (!fullFrame) copyFrame(previousOutput.view(), dst);
+                filterRegions(*options.filter, src, dst, frame->changed);
+                previousOutput = frame->output;
+            }
+            if (!co_await filtered.send(std::move(*frame))) break;
+        }
+        filtered.close();
+    }
+
+    Task uploadStage() {
+        while (std::optional<StagedFrame> frame = co_await filtered.receive()) {
+            if (options.upload) options.upload(*frame);
+            if (!co_await uploaded.send(std::move(*frame))) break;
+        }
+        uploaded.close();
+    }
+
+    Task presentStage() {
+        using namespace std::chrono;
+        while (std::optional<StagedFrame> frame = co_await uploaded.receive()) {
+            if (options.present) options.present(*frame);
+            int64_t now = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+            if (frame->captureUs > 0) recordLatency((now - frame->captureUs) / 1000.0);
+            presentedFrames++;
+        }
+    }
+
+    void recordLatency(double ms) {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        if (latencies.size() < latencyWindow) {
+            latencies.push_back(ms);
+        } else {
+            latencies[latencyNext] = ms;
+            latencyNext = (latencyNext + 1) % latencyWindow;
+        }
+    }
+};
+
+#endif // STAGED_PIPELINE_H
@@ -0,0 +1,249 @@
+#ifndef STARTUP_GRAPH_H
+#define STARTUP_GRAPH_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ==================== GRAFO DE INICIALIZAÇÃO ====================
+// Passos da inicialização com as dependências entre eles. Um passo roda
+// assim que todas as dependências terminam: os marcados Worker em uma thread
+// própria (decodificar PNG, ler arquivos, abrir a captura), os Main na
+// thread que chamou run(), que é a dona das janelas e do contexto GL. Um
+// passo que falha (devolve false) cancela os que dependem dele; os outros
+// seguem.
+//
+// Cada passo vira um intervalo na linha do tempo (ms desde 'origin', em
+// geral o início do processo), impressa no console e exportada no formato
+// de trace do Chrome (chrome://tracing, Perfetto) junto com marcas avulsas
+// como o primeiro frame filtrado.
+class StartupGraph {
+public:
+    enum class Where { Main, Worker };
+    using Step = std::function<bool()>;
+
+    struct Span {
+        std::string name;
+        Where where = Where::Main;
+        double startMs = 0.0, endMs = 0.0;
+        int lane = 0;  // 0: thread principal; workers a partir de 1
+        bool ran = false, ok = false;
+    };
+
+    struct Mark {
+        std::string name;
+        double atMs;
+    };
+
+private:
+    struct Node {
+        Where where;
+        std::vector<int> dependencies;
+        Step step;
+        int pending = 0;        // dependências ainda não concluídas
+        bool queued = false, done = false, ok = false;
+    };
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<Node> nodes;
+    std::vector<Span> spans;
+    std::vector<Mark> marks;
+    std::mutex mutex;
+    std::condition_variable doneCondition;
+    bool serial = false;
+
+public:
+    explicit StartupGraph(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now())
+        : origin(start) {}
+
+    // As dependências precisam ter sido adicionadas antes: a ordem de add()
+    // já é uma ordem topológica, usada como está no modo serial
+    int add(const std::string& name, Where where, const std::vector<int>& dependencies, Step step) {
+        Node node;
+        node.where = where;
+        node.dependencies = dependencies;
+        node.step = std::move(step);
+        nodes.push_back(std::move(node));
+        Span span;
+        span.name = name;
+        span.where = where;
+        spans.push_back(span);
+        return (int)nodes.size() - 1;
+    }
+
+    // Tudo na thread chamadora, na ordem de add() (referência para medir o ganho)
+    void setSerial(bool enable) { serial = enable; }
+
+    // Bloqueia até todos os passos terminarem ou serem cancelados; true se
+    // todos rodaram e deram certo
+    bool run() {
+        for (Node& node : nodes) node.pending = (int)node.dependencies.size();
+        return serial ? runSerial() : runParallel();
+    }
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    // Marca avulsa na linha do tempo (pode vir de qualquer thread)
+    void mark(const std::string& name) {
+        double at = elapsedMs();
+        std::lock_guard<std::mutex> lock(mutex);
+        marks.push_back({ name, at });
+    }
+
+    std::vector<Span> getSpans() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return spans;
+    }
+
+    bool stepOk(int id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return spans[id].ok;
+    }
+
+    // Uma barra por passo, na escala do passo que termina por último
+    void printTimeline(FILE* out = stdout) {
+        std::lock_guard<std::mutex> lock(mutex);
+        double total = 0.0, busy = 0.0;
+        for (const Span& span : spans) {
+            total = std::max(total, span.endMs);
+            busy += span.endMs - span.startMs;
+        }
+        for (const Mark& m : marks) total = std::max(total, m.atMs);
+        if (total <= 0.0) return;
+        const int columns = 40;
+        for (const Span& span : spans) {
+            char bar[columns + 1];
+            for (int c = 0; c < columns; c++) {
+                double t = (c + 0.5) * total / columns;
+                bar[c] = span.ran && t >= span.startMs && t < span.endMs ? '#' : '.';
+            }
+            bar[columns] = 0;
+            const char* state = !span.ran ? " (cancelado)" : (span.ok ? "" : " (falhou)");
+            std::fprintf(out, "   %-18s %s %7.1f -> %7.1f ms  %s%s\n", span.name.c_str(), bar, span.startMs,
+                         span.endMs, span.where == Where::Main ? "principal" : "worker", state);
+        }
+        for (const Mark& m : marks) std::fprintf(out, "   %-18s %7.1f ms\n", m.name.c_str(), m.atMs);
+        std::fprintf(out, "   soma dos passos %.1f ms em %.1f ms de relógio\n", busy, total);
+    }
+
+    // Formato "trace event" do Chrome: intervalos 'X' por passo (uma linha
+    // por thread) e marcas 'i'; tempos em µs
+    bool writeTrace(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::fprintf(file, "{\"traceEvents\":[\n");
+        bool first = true;
+        for (const Span& span : spans) {
+            if (!span.ran) continue;
+            std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                         "\"ts\":%.0f,\"dur\":%.0f,\"args\":{\"ok\":%s}}",
+                         first ? "" : ",\n", span.name.c_str(), span.lane, span.startMs * 1000.0,
+                         (span.endMs - span.startMs) * 1000.0, span.ok ? "true" : "false");
+            first = false;
+        }
+        for (const Mark& m : marks) {
+            std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,"
+                         "\"tid\":0,\"ts\":%.0f}", first ? "" : ",\n", m.name.c_str(), m.atMs * 1000.0);
+            first = false;
+        }
+        std::fprintf(file, "\n]}\n");
+        std::fclose(file);
+        return true;
+    }
+
+private:
+    bool runSerial() {
+        bool allOk = true;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            bool ready = true;
+            for (int dependency : nodes[i].dependencies) ready = ready && nodes[dependency].ok;
+            if (ready) {
+                execute((int)i, 0);
+            } else {
+                nodes[i].done = true;
+            }
+            allOk = allOk && nodes[i].ok;
+        }
+        return allOk;
+    }
+
+    bool runParallel() {
+        std::vector<std::thread> workers;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            // Workers prontos saem primeiro, para rodarem durante o passo principal
+            int mainStep = -1;
+            bool remaining = false;
+            for (size_t i = 0; i < nodes.size(); i++) {
+                Node& node = nodes[i];
+                if (node.done) continue;
+                remaining = true;
+                if (node.queued || node.pending > 0) continue;
+                if (node.where == Where::Worker) {
+                    node.queued = true;
+                    int lane = (int)workers.size() + 1;
+                    workers.emplace_back([this, i, lane] { execute((int)i, lane); });
+                } else if (mainStep < 0) {
+                    mainStep = (int)i;
+                }
+            }
+            if (!remaining) break;
+            if (mainStep >= 0) {
+                nodes[mainStep].queued = true;
+                lock.unlock();
+                execute(mainStep, 0);
+                lock.lock();
+                continue;
+            }
+            doneCondition.wait(lock);
+        }
+        lock.unlock();
+        for (std::thread& worker : workers) worker.join();
+        bool allOk = true;
+        for (const Node& node : nodes) allOk = allOk && node.ok;
+        return allOk;
+    }
+
+    void execute(int id, int lane) {
+        double start = elapsedMs();
+        bool ok = nodes[id].step();
+        double end = elapsedMs();
+        std::lock_guard<std::mutex> lock(mutex);
+        Span& span = spans[id];
+        span.startMs = start;
+        span.endMs = end;
+        span.lane = lane;
+        span.ran = true;
+        span.ok = ok;
+        finishLocked(id, ok);
+        doneCondition.notify_all();
+    }
+
+    // Concluído: libera os dependentes, ou os cancela (em cascata) se falhou
+    void finishLocked(int id, bool ok) {
+        nodes[id].done = true;
+        nodes[id].ok = ok;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            Node& node = nodes[i];
+            if (node.done || std::find(node.dependencies.begin(), node.dependencies.end(), id) == node.dependencies.end()) {
+                continue;
+            }
+            if (ok) {
+                node.pending--;
+            } else if (!node.queued) {
+                finishLocked((int)i, false);
+            }
+        }
+    }
+};
+
+#endif // STARTUP_GRAPH_H
@@ -0,0 +1,95 @@
+#ifndef TEST_FRAMES_H
+#define TEST_FRAMES_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// ==================== FRAMES DE TESTE SINTÉTICOS ====================
+// Conteúdos padrão (BGRA8, alfa 255) usados pelos benchmarks para comparar
+// qualidade e desempenho sempre sobre os mesmos frames.
+class TestFrames {
+public:
+    enum class Kind {
+        Gradient,   // gradientes suaves (banding, precisão)
+        ColorBars,  // blocos saturados com bordas duras (vazamento de croma)
+        Noise,      // ruído (pior caso para cache/compressão)
+        Text,       // "texto" fino sobre fundo claro (detalhe de alta frequência)
+        Ramps       // faixas horizontais com rampas lentas entre pares de cores (banding)
+    };
+
+    static const int rampCount = 8;  // faixas de Ramps, de cima para baixo
+
+    static const char* kindName(Kind kind) {
+        switch (kind) {
+            case Kind::Gradient: return "gradiente";
+            case Kind::ColorBars: return "barras";
+            case Kind::Noise: return "ruido";
+            case Kind::Text: return "texto";
+            case Kind::Ramps: return "rampas";
+        }
+        return "?";
+    }
+
+    static std::vector<uint8_t> make(Kind kind, int width, int height, uint32_t seed = 12345) {
+        std::vector<uint8_t> frame((size_t)width * height * 4);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint8_t* p = &frame[((size_t)y * width + x) * 4];
+                seed = seed * 1664525u + 1013904223u;
+                switch (kind) {
+                    case Kind::Gradient:
+                        p[0] = (uint8_t)((x + y) * 255 / (width + height));
+                        p[1] = (uint8_t)(y * 255 / height);
+                        p[2] = (uint8_t)(x * 255 / width);
+                        break;
+                    case Kind::ColorBars: {
+                        static const uint8_t bars[8][3] = {
+                            {255, 255, 255}, {0, 255, 255}, {255, 255, 0}, {0, 255, 0},
+                            {255, 0, 255}, {0, 0, 255}, {255, 0, 0}, {40, 80, 160}
+                        };
+                        int bar = (x * 8 / width + (y * 4 / height)) % 8;
+                        p[0] = bars[bar][0];
+                        p[1] = bars[bar][1];
+                        p[2] = bars[bar][2];
+                        break;
+                    }
+                    case Kind::Noise:
+                        p[0] = (uint8_t)(seed >> 8);
+                        p[1] = (uint8_t)(seed >> 16);
+                        p[2] = (uint8_t)(seed >> 24);
+                        break;
+                    case Kind::Ramps: {
+                        // Pares RGB: cinza, azul, verde, pele, céu, vermelho -> verde,
+                        // ardósia, oliva -> lilás. Só x varia: cada nível de 8 bits
+                        // ocupa vários pixels, como num fundo degradê
+                        static const uint8_t ends[rampCount][2][3] = {
+                            {{0, 0, 0}, {255, 255, 255}},     {{13, 5, 5}, {64, 89, 230}},
+                            {{5, 26, 8}, {128, 242, 140}},    {{51, 13, 5}, {255, 204, 153}},
+                            {{38, 51, 77}, {191, 217, 255}},  {{102, 26, 26}, {26, 128, 26}},
+                            {{26, 26, 26}, {102, 128, 153}},  {{77, 102, 51}, {153, 77, 128}}
+                        };
+                        const uint8_t (*pair)[3] = ends[y * rampCount / height];
+                        for (int c = 0; c < 3; c++) {
+                            p[2 - c] = (uint8_t)std::lround(pair[0][c] + (pair[1][c] - pair[0][c]) * (double)x / (width - 1));
+                        }
+                        break;
+                    }
+                    case Kind::Text: {
+                        // Traços de 1-2 px em vermelho/verde sobre fundo claro
+                        bool stroke = ((x / 3 + y / 7) % 5 == 0) && ((y % 12) < 9);
+                        bool red = ((x / 48 + y / 24) % 2) == 0;
+                        p[0] = stroke ? 30 : 235;
+                        p[1] = stroke ? (red ? 30 : 170) : 235;
+                        p[2] = stroke ? (red ? 200 : 40) : 235;
+                        break;
+                    }
+                }
+                p[3] = 255;
+            }
+        }
+        return frame;
+    }
+};
+
+#endif // TEST_FRAMES_H
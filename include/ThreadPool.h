@@ -0,0 +1,126 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ==================== POOL DE THREADS ====================
+// Pool fixo usado pelos caminhos de CPU para dividir um frame em faixas de
+// linhas. As threads ficam dormindo entre frames (sem criar/destruir threads
+// a cada chamada). Várias threads podem chamar parallelFor no mesmo pool (ex.:
+// uma por saída); os jobs são atendidos um de cada vez.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;  // um job por vez
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    std::function<void(int, int)> job;  // (inicio, fim) de uma faixa
+    int jobBegin = 0, jobEnd = 0, jobGrain = 1;
+    std::atomic<int> nextChunk{0};
+    int pendingWorkers = 0;
+    unsigned long generation = 0;
+    bool stopping = false;
+
+public:
+    explicit ThreadPool(int threadCount = 0) {
+        if (threadCount <= 0) {
+            threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+        }
+        // A thread chamadora também trabalha, então criamos N-1 workers
+        for (int i = 1; i < threadCount; i++) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& t : workers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getThreadCount() const { return (int)workers.size() + 1; }
+
+    // Executa fn(inicio, fim) sobre [begin, end) em blocos de 'grain' itens.
+    // Bloqueia até todos os blocos terminarem.
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn) {
+        if (end <= begin) return;
+        grain = std::max(1, grain);
+        if (workers.empty() || end - begin <= grain) {
+            fn(begin, end);
+            return;
+        }
+
+        std::lock_guard<std::mutex> submitLock(submitMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = fn;
+            jobBegin = begin;
+            jobEnd = end;
+            jobGrain = grain;
+            nextChunk = 0;
+            pendingWorkers = (int)workers.size();
+            generation++;
+        }
+        wakeCondition.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this] { return pendingWorkers == 0; });
+        job = nullptr;
+    }
+
+    // Pool global compartilhado pelos filtros de CPU
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    void runChunks() {
+        for (;;) {
+            int chunk = nextChunk.fetch_add(1);
+            int from = jobBegin + chunk * jobGrain;
+            if (from >= jobEnd) break;
+            job(from, std::min(jobEnd, from + jobGrain));
+        }
+    }
+
+    void workerLoop() {
+        unsigned long seenGeneration = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) return;
+                seenGeneration = generation;
+            }
+
+            runChunks();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pendingWorkers--;
+            }
+            doneCondition.notify_one();
+        }
+    }
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,146 @@
+#ifndef UPLOAD_RING_H
+#define UPLOAD_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "Frame.h"
+
+// ==================== DESTINO DE ESCRITA DE FRAMES ====================
+// Memória externa onde uma fonte escreve cada frame diretamente (sem buffer
+// próprio). Implementado pelo UploadRing (PBOs / memória de upload) e pelo
+// anel em memória compartilhada do daemon de captura (SharedFrameRing.h).
+class FrameWriteTarget {
+public:
+    virtual ~FrameWriteTarget() {}
+
+    virtual PixelFormat getFormat() const = 0;
+    virtual int getWidth() const = 0;
+    virtual int getHeight() const = 0;
+
+    // Índice de um slot para escrever, ou -1 (a fonte descarta o frame)
+    virtual int beginWrite() = 0;
+    virtual const FrameView& view(int index) const = 0;
+    virtual void commitWrite(int index, int64_t timestampUs) = 0;
+    virtual void cancelWrite(int index) = 0;
+};
+
+// ==================== ANEL DE UPLOAD ====================
+// Slots de frame em memória que pertence ao estágio de upload (PBO mapeado de
+// forma persistente, segmento de memória compartilhada). A captura escreve o
+// frame direto em um slot livre, e o upload consome o slot sem nenhuma cópia
+// na CPU: o frame atravessa a CPU uma única vez.
+//
+// Estados: Free -> Writing (captura) -> Ready -> InUse (upload/GPU) -> Free.
+// Só o frame pronto mais novo interessa: ao publicar um frame, um Ready mais
+// antigo volta para Free. Sem slot livre a captura descarta o frame.
+class UploadRing : public FrameWriteTarget {
+public:
+    enum class SlotState { Free, Writing, Ready, InUse };
+
+private:
+    struct Slot {
+        FrameView view;
+        SlotState state = SlotState::Free;
+        uint64_t sequence = 0;
+        void* userData = nullptr;  // ex.: id do PBO
+    };
+
+    std::mutex mutex;
+    std::vector<Slot> slots;
+    PixelFormat format;
+    int width, height;
+    uint64_t nextSequence = 1;
+    std::atomic<uint64_t> bytesCopied{0};
+    std::atomic<uint64_t> framesPublished{0};
+    std::atomic<uint64_t> framesDropped{0};
+
+public:
+    UploadRing(PixelFormat fmt, int w, int h) : format(fmt), width(w), height(h) {}
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // Registra memória do estágio de upload (1 plano; stride em bytes)
+    void addSlot(uint8_t* memory, int stride, void* userData = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot slot;
+        slot.view = FrameView::wrap(format, memory, width, height);
+        slot.view.strides[0] = stride;
+        slot.userData = userData;
+        slots.push_back(slot);
+    }
+
+    int getSlotCount() const { return (int)slots.size(); }
+    int getWidth() const override { return width; }
+    int getHeight() const override { return height; }
+    PixelFormat getFormat() const override { return format; }
+
+    // ---------- Escritor (captura) ----------
+
+    // Índice de um slot para escrever, ou -1 se todos estão ocupados
+    int beginWrite() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].state == SlotState::Free) {
+                slots[i].state = SlotState::Writing;
+                return (int)i;
+            }
+        }
+        framesDropped++;
+        return -1;
+    }
+
+    const FrameView& view(int index) const override { return slots[index].view; }
+    void* getUserData(int index) const { return slots[index].userData; }
+
+    void commitWrite(int index, int64_t timestampUs = 0) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Slot& slot : slots) {
+            if (slot.state == SlotState::Ready) slot.state = SlotState::Free;
+        }
+        slots[index].state = SlotState::Ready;
+        slots[index].sequence = nextSequence++;
+        slots[index].view.timestampUs = timestampUs;
+        framesPublished++;
+    }
+
+    // Escrita abortada (ex.: GetDIBits falhou)
+    void cancelWrite(int index) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[index].state = SlotState::Free;
+    }
+
+    // ---------- Leitor (upload) ----------
+
+    // Slot pronto mais novo (passa para InUse), ou -1 se não há frame novo
+    int acquireLatest() {
+        std::lock_guard<std::mutex> lock(mutex);
+        int best = -1;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].state == SlotState::Ready &&
+                (best < 0 || slots[i].sequence > slots[best].sequence)) {
+                best = (int)i;
+            }
+        }
+        if (best >= 0) slots[best].state = SlotState::InUse;
+        return best;
+    }
+
+    // Depois que a GPU terminou de ler o slot (fence sinalizada)
+    void release(int index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[index].state = SlotState::Free;
+    }
+
+    // ---------- Métricas ----------
+
+    // Quem copia bytes de frame na CPU registra aqui (captura e upload)
+    void recordCopy(uint64_t bytes) { bytesCopied += bytes; }
+    uint64_t getBytesCopied() const { return bytesCopied; }
+    uint64_t getFramesPublished() const { return framesPublished; }
+    uint64_t getFramesDropped() const { return framesDropped; }
+};
+
+#endif // UPLOAD_RING_H
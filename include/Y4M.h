@@ -0,0 +1,166 @@
+#ifndef Y4M_H
+#define Y4M_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Frame.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// ==================== ARQUIVOS / PIPES Y4M ====================
+// YUV4MPEG2: cabeçalho de texto + frames I420 precedidos de "FRAME\n".
+// "-" como caminho usa stdin/stdout, para encadear com ffmpeg:
+//   ffmpeg -i in.mp4 -f yuv4mpegpipe - | y4mfilter - - | ffmpeg -i - out.mp4
+// Apenas 4:2:0 de 8 bits (C420, C420jpeg, C420paldv, C420mpeg2).
+
+class Y4MReader {
+private:
+    FILE* file = nullptr;
+    bool ownsFile = false;
+    std::string header;  // linha de cabeçalho sem o '\n'
+    int width = 0, height = 0;
+
+public:
+    ~Y4MReader() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        if (path == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            file = stdin;
+        } else {
+            file = std::fopen(path.c_str(), "rb");
+            ownsFile = true;
+        }
+        if (!file) {
+            std::fprintf(stderr, "Y4M: não foi possível abrir %s\n", path.c_str());
+            return false;
+        }
+        return readHeader();
+    }
+
+    void close() {
+        if (file && ownsFile) std::fclose(file);
+        file = nullptr;
+        ownsFile = false;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::string& getHeader() const { return header; }
+
+    // Lê o próximo frame para 'buffer' (I420 compacto). false no fim do arquivo.
+    bool readFrame(std::vector<uint8_t>& buffer) {
+        std::string line;
+        if (!readLine(line)) return false;
+        if (line.compare(0, 5, "FRAME") != 0) {
+            std::fprintf(stderr, "Y4M: marcador FRAME inválido\n");
+            return false;
+        }
+        buffer.resize(FrameView::compactSize(PixelFormat::I420, width, height));
+        return std::fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    }
+
+private:
+    bool readLine(std::string& line) {
+        line.clear();
+        int c;
+        while ((c = std::fgetc(file)) != EOF && c != '\n') line.push_back((char)c);
+        return c != EOF || !line.empty();
+    }
+
+    bool readHeader() {
+        if (!readLine(header) || header.compare(0, 9, "YUV4MPEG2") != 0) {
+            std::fprintf(stderr, "Y4M: cabeçalho YUV4MPEG2 ausente\n");
+            return false;
+        }
+
+        size_t pos = 9;
+        while (pos < header.size()) {
+            while (pos < header.size() && header[pos] == ' ') pos++;
+            size_t end = header.find(' ', pos);
+            if (end == std::string::npos) end = header.size();
+            std::string token = header.substr(pos, end - pos);
+            pos = end;
+            if (token.empty()) continue;
+
+            if (token[0] == 'W') width = std::atoi(token.c_str() + 1);
+            if (token[0] == 'H') height = std::atoi(token.c_str() + 1);
+            if (token[0] == 'C' && token != "C420" && token != "C420jpeg" &&
+                token != "C420paldv" && token != "C420mpeg2") {
+                std::fprintf(stderr, "Y4M: espaço de cor %s não suportado (apenas 4:2:0 8 bits)\n", token.c_str());
+                return false;
+            }
+        }
+
+        if (width <= 0 || height <= 0) {
+            std::fprintf(stderr, "Y4M: dimensões inválidas\n");
+            return false;
+        }
+        return true;
+    }
+};
+
+class Y4MWriter {
+private:
+    FILE* file = nullptr;
+    bool ownsFile = false;
+
+public:
+    ~Y4MWriter() { close(); }
+
+    // 'header' normalmente é o do Y4MReader, para preservar taxa/aspecto
+    bool open(const std::string& path, const std::string& header) {
+        close();
+        if (path == "-") {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            file = stdout;
+        } else {
+            file = std::fopen(path.c_str(), "wb");
+            ownsFile = true;
+        }
+        if (!file) {
+            std::fprintf(stderr, "Y4M: não foi possível criar %s\n", path.c_str());
+            return false;
+        }
+        return std::fprintf(file, "%s\n", header.c_str()) > 0;
+    }
+
+    void close() {
+        if (file) std::fflush(file);
+        if (file && ownsFile) std::fclose(file);
+        file = nullptr;
+        ownsFile = false;
+    }
+
+    bool writeFrame(const uint8_t* data, size_t size) {
+        if (std::fwrite("FRAME\n", 1, 6, file) != 6) return false;
+        return std::fwrite(data, 1, size, file) == size;
+    }
+
+    // Frame I420 com qualquer stride (ex.: sub-retângulo): escreve linha a
+    // linha direto da visão, sem compactar antes
+    bool writeFrame(const FrameView& frame) {
+        if (frame.format != PixelFormat::I420) return false;
+        if (std::fwrite("FRAME\n", 1, 6, file) != 6) return false;
+        for (int p = 0; p < 3; p++) {
+            size_t bytes = (size_t)frame.rowBytes(p);
+            for (int y = 0; y < frame.planeHeight(p); y++) {
+                if (std::fwrite(frame.row(p, y), 1, bytes, file) != bytes) return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // Y4M_H
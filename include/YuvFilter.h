@@ -0,0 +1,197 @@
+#ifndef YUV_FILTER_H
+#define YUV_FILTER_H
+
+#include <algorithm>
+#include <cstdint>
+#include "Frame.h"
+#include "Lut3D.h"
+#include "ThreadPool.h"
+
+// ==================== FILTRO NATIVO EM YUV 4:2:0 ====================
+// Aplica a correção direto em frames NV12/I420, sem nunca montar um frame RGB.
+//
+// A LUT RGB (com a intensidade já misturada) é convertida uma vez em uma LUT
+// no domínio YUV: entrada (Y, U, V) -> saída (Y', U', V'), com a conversão
+// YUV<->RGB embutida. No kernel, cada bloco 2x2 compartilha uma amostra de
+// croma: a LUT é consultada com a média de Y do bloco, o croma de saída vem
+// direto da LUT e cada Y recebe o deslocamento de luminância do bloco (o mesmo
+// esquema luma/croma de CpuFilter::ChromaMode::Half).
+class YuvFilter {
+public:
+    enum class Matrix { BT601, BT709 };  // faixa limitada (16-235 / 16-240)
+
+private:
+    Lut3D rgbLut;
+    Lut3D yuvLut;
+    Lut3DSampler yuvSampler;
+    float strength = 1.0f;
+    Matrix matrix = Matrix::BT709;
+    int yuvLutSize = 33;
+    ThreadPool* pool;
+
+public:
+    explicit YuvFilter(ThreadPool& threadPool = ThreadPool::shared()) : pool(&threadPool) {
+        setLUT(Lut3D::fromCorrection(32, CorrectionMethod::Hybrid));
+    }
+
+    YuvFilter(const YuvFilter&) = delete;
+    YuvFilter& operator=(const YuvFilter&) = delete;
+
+    void setLUT(const Lut3D& lut) {
+        if (!lut.isValid()) return;
+        rgbLut = lut;
+        rebuild();
+    }
+
+    void setStrength(float value) {
+        strength = std::min(1.0f, std::max(0.0f, value));
+        rebuild();
+    }
+
+    void setMatrix(Matrix value) {
+        matrix = value;
+        rebuild();
+    }
+
+    const Lut3D& getYuvLUT() const { return yuvLut; }
+
+    // src e dst: mesmo formato (NV12 ou I420) e dimensões; podem ser o mesmo frame
+    bool apply(const FrameView& src, const FrameView& dst) {
+        if (src.format != dst.format || src.width != dst.width || src.height != dst.height) return false;
+        if (src.format != PixelFormat::NV12 && src.format != PixelFormat::I420) return false;
+
+        pool->parallelFor(0, src.chromaHeight(), 8, [&](int from, int to) {
+            applyBlockRows(src, dst, from, to);
+        });
+        return true;
+    }
+
+    // Conversões de referência (códigos de 8 bits em float)
+    void yuvToRgb(float y, float u, float v, float rgb[3]) const {
+        float kr, kb;
+        coefficients(kr, kb);
+        float yn = (y - 16.0f) / 219.0f;
+        float pb = (u - 128.0f) / 224.0f;
+        float pr = (v - 128.0f) / 224.0f;
+        rgb[0] = yn + 2.0f * (1.0f - kr) * pr;
+        rgb[2] = yn + 2.0f * (1.0f - kb) * pb;
+        rgb[1] = (yn - kr * rgb[0] - kb * rgb[2]) / (1.0f - kr - kb);
+    }
+
+    void rgbToYuv(const float rgb[3], float yuv[3]) const {
+        float kr, kb;
+        coefficients(kr, kb);
+        float yn = kr * rgb[0] + (1.0f - kr - kb) * rgb[1] + kb * rgb[2];
+        yuv[0] = 16.0f + 219.0f * yn;
+        yuv[1] = 128.0f + 224.0f * (rgb[2] - yn) / (2.0f * (1.0f - kb));
+        yuv[2] = 128.0f + 224.0f * (rgb[0] - yn) / (2.0f * (1.0f - kr));
+    }
+
+private:
+    void coefficients(float& kr, float& kb) const {
+        if (matrix == Matrix::BT601) {
+            kr = 0.299f;
+            kb = 0.114f;
+        } else {
+            kr = 0.2126f;
+            kb = 0.0722f;
+        }
+    }
+
+    void rebuild() {
+        Lut3DSampler rgbSampler;
+        rgbSampler.bind(rgbLut);
+
+        const int n = yuvLutSize;
+        yuvLut.size = n;
+        yuvLut.data.resize((size_t)n * n * n * 3);
+        for (int vi = 0; vi < n; vi++) {
+            for (int ui = 0; ui < n; ui++) {
+                for (int yi = 0; yi < n; yi++) {
+                    float rgb[3], inGamut[3];
+                    yuvToRgb(yi * 255.0f / (n - 1), ui * 255.0f / (n - 1), vi * 255.0f / (n - 1), rgb);
+                    for (int c = 0; c < 3; c++) inGamut[c] = std::min(1.0f, std::max(0.0f, rgb[c]));
+
+                    // A correção entra como delta: pontos fora do gamut RGB (a maior
+                    // parte do cubo YUV) não são cortados, e intensidade 0 é identidade
+                    float corrected[3];
+                    rgbSampler.sample(inGamut[0], inGamut[1], inGamut[2], corrected);
+                    for (int c = 0; c < 3; c++) {
+                        corrected[c] = rgb[c] + (corrected[c] / 255.0f - inGamut[c]) * strength;
+                    }
+
+                    float yuv[3];
+                    rgbToYuv(corrected, yuv);
+                    uint8_t* dst = yuvLut.at(yi, ui, vi);
+                    for (int c = 0; c < 3; c++) {
+                        dst[c] = Lut3D::toByte(yuv[c] / 255.0f);
+                    }
+                }
+            }
+        }
+        yuvSampler.bind(yuvLut);
+    }
+
+    static uint8_t clampByte(float v) {
+        return (uint8_t)std::min(255.0f, std::max(0.0f, v + 0.5f));
+    }
+
+    void applyBlockRows(const FrameView& src, const FrameView& dst, int blockRowBegin, int blockRowEnd) const {
+        const bool nv12 = (src.format == PixelFormat::NV12);
+        const int chromaWidth = src.chromaWidth();
+        float out[3];
+
+        for (int cy = blockRowBegin; cy < blockRowEnd; cy++) {
+            const int y0 = cy * 2;
+            const int rows = std::min(2, src.height - y0);
+            const uint8_t* srcY[2] = { src.planes[0] + (size_t)y0 * src.strides[0],
+                                       src.planes[0] + (size_t)(y0 + rows - 1) * src.strides[0] };
+            uint8_t* dstY[2] = { dst.planes[0] + (size_t)y0 * dst.strides[0],
+                                 dst.planes[0] + (size_t)(y0 + rows - 1) * dst.strides[0] };
+
+            const uint8_t* srcU;
+            const uint8_t* srcV;
+            uint8_t* dstU;
+            uint8_t* dstV;
+            int chromaStep;
+            if (nv12) {
+                srcU = src.planes[1] + (size_t)cy * src.strides[1];
+                srcV = srcU + 1;
+                dstU = dst.planes[1] + (size_t)cy * dst.strides[1];
+                dstV = dstU + 1;
+                chromaStep = 2;
+            } else {
+                srcU = src.planes[1] + (size_t)cy * src.strides[1];
+                srcV = src.planes[2] + (size_t)cy * src.strides[2];
+                dstU = dst.planes[1] + (size_t)cy * dst.strides[1];
+                dstV = dst.planes[2] + (size_t)cy * dst.strides[2];
+                chromaStep = 1;
+            }
+
+            for (int cx = 0; cx < chromaWidth; cx++) {
+                const int x0 = cx * 2;
+                const int cols = std::min(2, src.width - x0);
+
+                int sum = 0;
+                for (int r = 0; r < rows; r++) {
+                    for (int c = 0; c < cols; c++) sum += srcY[r][x0 + c];
+                }
+                const int count = rows * cols;
+                const uint8_t avgY = (uint8_t)((sum + count / 2) / count);
+
+                yuvSampler.sample(avgY, srcU[cx * chromaStep], srcV[cx * chromaStep], out);
+                const float deltaY = out[0] - avgY;
+
+                for (int r = 0; r < rows; r++) {
+                    for (int c = 0; c < cols; c++) {
+                        dstY[r][x0 + c] = clampByte(srcY[r][x0 + c] + deltaY);
+                    }
+                }
+                dstU[cx * chromaStep] = clampByte(out[1]);
+                dstV[cx * chromaStep] = clampByte(out[2]);
+            }
+        }
+    }
+};
+
+#endif // YUV_FILTER_H
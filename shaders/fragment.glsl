@@ -1,140 +1,224 @@
 #version 330 core
-
 out vec4 FragColor;
 in vec2 TexCoord;
-
 uniform sampler2D screenTexture;
+uniform sampler2D lutTexture;
 uniform bool enableCorrection;
 uniform float correctionStrength;
+uniform bool useLUT;
+uniform int correctionMethod;  // sem LUT: 0 híbrido (padrão), 1 LMS, 2 daltonize
+uniform bool linearLight;   // true: screenTexture é GL_SRGB8_ALPHA8 (já chega linear)
+uniform bool inputLinear;   // true: captura RGBA16F (scRGB), linear mesmo sem linearLight
+uniform sampler2D noiseTexture;  // ruído azul 64x64 R8 (BlueNoise.h)
+uniform bool dither;
+uniform bool lutNearest;    // governador, "LUT 1 ponto": só o nó mais próximo da grade
+uniform int chromaPass;     // governador, croma 2x2: 0 desligado, 1 delta por bloco, 2 soma o delta
+uniform sampler2D chromaTexture;  // deltas do passo 1 (RGBA16F em meia resolução; alfa 1 = borda)
+
+// Nos dois casos o framebuffer codifica sRGB na escrita (GL_FRAMEBUFFER_SRGB)
+bool linearDomain() {
+    return linearLight || inputLinear;
+}
+
+// Conversões exatas sRGB <-> linear (só usadas para indexar a LUT,
+// que foi gerada sobre valores sRGB)
+vec3 linearToSrgb(vec3 c) {
+    c = clamp(c, 0.0, 1.0);
+    return mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055, step(vec3(0.0031308), c));
+}
+
+vec3 srgbToLinear(vec3 c) {
+    return mix(c / 12.92, pow((c + 0.055) / 1.055, vec3(2.4)), step(vec3(0.04045), c));
+}
+
+vec3 applyLUT3D(vec3 color, sampler2D lut) {
+    color = clamp(color, 0.0, 1.0);
+    const float lutSize = 32.0;
+
+    // 1 leitura em vez de 2 amostras bilineares, arredondando como o
+    // Lut3DSampler::sampleNearest da CPU
+    if (lutNearest) {
+        ivec3 node = ivec3(color * (lutSize - 1.0) + 0.5);
+        return texelFetch(lut, ivec2(node.g * int(lutSize) + node.r, node.b), 0).rgb;
+    }
+
+    // Red -> u (x-coord in slice)
+    // Blue -> v (y-coord in slice)
+    // Green -> slice index
+    
+    float u = (color.r * (lutSize - 1.0) + 0.5) / lutSize;
+    float v = (color.b * (lutSize - 1.0) + 0.5) / lutSize;
+    float slice = color.g * (lutSize - 1.0);
+
+    float slice_floor = floor(slice);
+    float slice_frac = slice - slice_floor;
+
+    // The normalized WIDTH of a single 32x32 slice
+    float slice_width = 1.0 / lutSize;
+
+    // We calculate the X coordinate by finding the correct horizontal slice.
+    // We use 'v' for the Y coordinate directly.
+    vec2 uv0 = vec2( (u + slice_floor) * slice_width, v );
+    vec2 uv1 = vec2( (u + slice_floor + 1.0) * slice_width, v );
+
+    vec3 sample0 = texture(lut, uv0).rgb;
+    vec3 sample1 = texture(lut, uv1).rgb;
+
+    return mix(sample0, sample1, slice_frac);
+}
 
-// Correção CIENTÍFICA para Deuteranopia baseada em pesquisa
+// Ruído azul de ±0.5 LSB somado antes da conversão para os 8 bits do
+// framebuffer, que arredonda: os degraus de 1 LSB dos gradientes viram grão.
+// Em luz linear o framebuffer codifica sRGB depois do shader, então o ruído
+// entra em sRGB.
+vec3 ditherOutput(vec3 c) {
+    float noise = (texelFetch(noiseTexture, ivec2(gl_FragCoord.xy) & 63, 0).r * 255.0 + 0.5) / 256.0 - 0.5;
+    if (linearDomain()) return srgbToLinear(clamp(linearToSrgb(c) + noise / 255.0, 0.0, 1.0));
+    return c + noise / 255.0;
+}
+
+vec3 hybridCorrection(vec3 color) {
+    // Em luz linear a luminância usa os pesos Rec.709; em gamma, Rec.601
+    vec3 lumaWeights = linearDomain() ? vec3(0.2126, 0.7152, 0.0722) : vec3(0.299, 0.587, 0.114);
+    float luminance = dot(color, lumaWeights);
+    float redGreenRatio = color.r / max(color.g, 0.001);
+    
+    vec3 corrected = color;
+    if (redGreenRatio > 1.2) {
+        corrected.r = min(1.0, color.r * 1.1);
+        corrected.b = min(1.0, color.b + (color.r - color.g) * 0.25);
+    } else if (redGreenRatio < 0.8) {
+        corrected.g = min(1.0, color.g * 1.05);
+        corrected.b = min(1.0, color.b + (color.g - color.r) * 0.2);
+    }
+    
+    float newLuminance = dot(corrected, lumaWeights);
+    if (newLuminance > 0.001) {
+        corrected *= luminance / newLuminance;
+    }
+    
+    return clamp(corrected, 0.0, 1.0);
+}
+
+// Correção CIENTÍFICA em espaço LMS (Long, Medium, Short wavelengths),
+// baseada em Machado, Oliveira e Fernandes (2009)
 vec3 correctDeuteranopia(vec3 color) {
-    // Transformação RGB para espaço LMS (Long, Medium, Short wavelengths)
     mat3 rgbToLms = mat3(
         0.31399022, 0.63951294, 0.04649755,
         0.15537241, 0.75789446, 0.08670142,
         0.01775239, 0.10944209, 0.87256922
     );
-    
-    // Transformação LMS de volta para RGB
     mat3 lmsToRgb = mat3(
          5.47221206, -4.6419601,  0.16963708,
         -1.1252419,   2.29317094, -0.1678952,
          0.02980165, -0.19318073,  1.16364789
     );
-    
-    // Converter RGB para LMS
     vec3 lms = rgbToLms * color;
     
-    // DEUTERANOPIA: Perda do canal M (médio)
-    // Algoritmo baseado em Machado, Oliveira e Fernandes (2009)
-    
-    // Simulação da deuteranopia (para referência - não usada diretamente)
-    // lms.g = 0.494207 * lms.r + 1.24827 * lms.b;
-    
-    // CORREÇÃO: Redistribuir informação para melhorar discriminação
+    // DEUTERANOPIA: perda do canal M. Realçar diferenças vermelho-verde e
+    // mapear a informação perdida para o canal azul
     vec3 correctedLms = lms;
-    
-    // Método 1: Realçar diferenças Red-Green
     float redGreenDiff = lms.r - lms.g;
     correctedLms.r = lms.r + 0.7 * redGreenDiff;
     correctedLms.g = lms.g - 0.7 * redGreenDiff;
-    
-    // Método 2: Mapear informação perdida para canal azul
     correctedLms.b = lms.b + 0.3 * abs(redGreenDiff);
     
-    // Converter de volta para RGB
-    vec3 correctedRgb = lmsToRgb * correctedLms;
-    
-    // Garantir valores válidos
-    return clamp(correctedRgb, 0.0, 1.0);
+    return clamp(lmsToRgb * correctedLms, 0.0, 1.0);
 }
 
-// Correção alternativa: Método Daltonize
+// Método Daltonize: o erro entre a cor e a simulação vai para o azul
 vec3 daltonizeDeuteranopia(vec3 color) {
-    // Simular como pessoa com deuteranopia vê
     mat3 deuteranopia_sim = mat3(
         0.625, 0.375, 0.0,
         0.7,   0.3,   0.0,
         0.0,   0.3,   0.7
     );
+    vec3 error = color - deuteranopia_sim * color;
     
-    vec3 simulated = deuteranopia_sim * color;
-    vec3 error = color - simulated;
-    
-    // Adicionar erro aos canais que podem ser percebidos
     vec3 corrected = color;
-    corrected.r += error.r * 0.0;
-    corrected.g += error.g * 0.0; 
     corrected.b += error.r * 0.7 + error.g * 0.7;
-    
     return clamp(corrected, 0.0, 1.0);
 }
 
-// Correção híbrida otimizada
-vec3 hybridDeuteranopiaCorrection(vec3 color) {
-    // Preservar luminância original
-    float luminance = dot(color, vec3(0.299, 0.587, 0.114));
-    
-    // Aplicar correção baseada em contraste Red-Green
-    float redGreenRatio = color.r / max(color.g, 0.001);
-    
-    vec3 corrected = color;
-    
-    if (redGreenRatio > 1.2) {
-        // Área mais vermelha - realçar diferença
-        corrected.r = min(1.0, color.r * 1.2);
-        corrected.b = min(1.0, color.b + (color.r - color.g) * 0.4);
-    } else if (redGreenRatio < 0.8) {
-        // Área mais verde - realçar diferença  
-        corrected.g = min(1.0, color.g * 1.1);
-        corrected.b = min(1.0, color.b + (color.g - color.r) * 0.3);
-    }
-    
-    // Preservar luminância aproximada
-    float newLuminance = dot(corrected, vec3(0.299, 0.587, 0.114));
-    if (newLuminance > 0.001) {
-        corrected *= luminance / newLuminance;
+// LMS e daltonize são definidos sobre valores sRGB, como no ColorCorrection
+// da CPU; o híbrido tem pesos próprios para luz linear
+vec3 mathCorrection(vec3 color) {
+    if (correctionMethod == 0) return hybridCorrection(color);
+    bool linear = linearDomain();
+    vec3 c = linear ? linearToSrgb(color) : clamp(color, 0.0, 1.0);
+    c = correctionMethod == 1 ? correctDeuteranopia(c) : daltonizeDeuteranopia(c);
+    return linear ? srgbToLinear(c) : c;
+}
+
+vec3 correctColor(vec3 color) {
+    if (!useLUT) return mathCorrection(color);
+    if (linearDomain()) return srgbToLinear(applyLUT3D(linearToSrgb(color), lutTexture));
+    return applyLUT3D(color, lutTexture);
+}
+
+// A LUT vê a cor limitada a [0, 1]; acima disso (HDR) só o delta entra,
+// como no CpuFilter, e o excesso passa intacto
+vec3 correctionDelta(vec3 color) {
+    return (correctColor(color) - clamp(color, 0.0, 1.0)) * correctionStrength;
+}
+
+// Croma 2x2, passo 1 (alvo em meia resolução): a correção roda uma vez por
+// bloco, sobre a média dos 4 pixels, como o ChromaMode::Half da CPU. O
+// bloco vem de gl_FragCoord, não de TexCoord (invertido em v): o alvo fica
+// na orientação da textura. Na borda ímpar o pixel repetido pesa o mesmo
+// que a média só dos que existem.
+//
+// Com R-G ou B-G variando mais de 16 níveis de 8 bits no bloco (o
+// CHROMA_EDGE do CpuFilter, medido em sRGB) a média é uma cor que nenhum
+// pixel tem: o alfa sai 1 e o passo 2 corrige esses pixels um a um.
+vec4 blockDelta() {
+    ivec2 last = textureSize(screenTexture, 0) - 1;
+    ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+    vec3 texels[4] = vec3[4](texelFetch(screenTexture, p, 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(1, 0), last), 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(0, 1), last), 0).rgb,
+                             texelFetch(screenTexture, min(p + ivec2(1, 1), last), 0).rgb);
+    vec2 low = vec2(2.0), high = vec2(-2.0);
+    for (int i = 0; i < 4; i++) {
+        vec3 c = linearDomain() ? linearToSrgb(texels[i]) : texels[i];
+        vec2 opponent = c.rb - c.gg;
+        low = min(low, opponent);
+        high = max(high, opponent);
     }
-    
-    return clamp(corrected, 0.0, 1.0);
+    vec2 spread = high - low;
+    if (max(spread.x, spread.y) > 16.5 / 255.0) return vec4(0.0, 0.0, 0.0, 1.0);
+    vec3 mean = (texels[0] + texels[1] + texels[2] + texels[3]) * 0.25;
+    return vec4(correctionDelta(mean), 0.0);
 }
 
-void main()
-{
-    vec3 originalColor = texture(screenTexture, TexCoord).rgb;
+void main() {
+    vec3 color = texture(screenTexture, TexCoord).rgb;
     
     if (!enableCorrection) {
-        FragColor = vec4(originalColor, 1.0);
+        FragColor = vec4(color, 1.0);
         return;
     }
     
-    // Escolher método de correção (teste diferentes)
-    vec3 correctedColor;
-    
-    // MÉTODO 1: Científico LMS (mais preciso)
-    // correctedColor = correctDeuteranopia(originalColor);
-    
-    // MÉTODO 2: Daltonize (mais suave)
-    // correctedColor = daltonizeDeuteranopia(originalColor);
-    
-    // MÉTODO 3: Híbrido (recomendado)
-    correctedColor = hybridDeuteranopiaCorrection(originalColor);
-    
-    // Misturar com original baseado na intensidade
-    vec3 finalColor = mix(originalColor, correctedColor, correctionStrength);
+    if (chromaPass == 1) {
+        FragColor = blockDelta();
+        return;
+    }
     
-    FragColor = vec4(finalColor, 1.0);
-}
+    // Passo 2 do croma 2x2: o delta do bloco somado a cada pixel, o detalhe
+    // de luminância continua em resolução total
+    vec3 final;
+    if (chromaPass == 2) {
+        ivec2 block = ivec2(TexCoord * vec2(textureSize(screenTexture, 0))) / 2;
+        vec4 delta = texelFetch(chromaTexture, block, 0);
+        final = color + (delta.a > 0.5 ? correctionDelta(color) : delta.rgb);
+    } else {
+        final = color + correctionDelta(color);
+    }
+    if (dither) final = ditherOutput(final);
+    FragColor = vec4(final, 1.0);
 
-/*
-TESTANDO OS MÉTODOS:
-1. Descomente um método por vez no main()
-2. Teste com diferentes valores de correctionStrength
-3. Use imagens de teste para daltonismo (Ishihara plates)
-
-CONTROLES SUGERIDOS:
-- ESPAÇO: Liga/desliga correção
-- 1,2,3: Alternar entre métodos de correção
-- +/-: Ajustar intensidade
-*/
\ No newline at end of file
+    // vec3 corrected = applyLUT3D(color, lutTexture);
+    // FragColor = vec4(corrected, 1.0);
+
+    // FragColor = vec4(1.0, 0.0, 0.0, 0.5); 
+}
@@ -11,10 +11,33 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include "BlueNoise.h"
+#include "BuiltinLUTs.h"
+#include "ComputeFilter.h"
+#include "Frame.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "GLFormats.h"
+#include "OverlayShaders.h"
+#include "PixelConvert.h"
+#include "QualityGovernor.h"
+#include "Recording.h"
+#include "RegionOfInterest.h"
+#include "ScreenCapture.h"
+#include "ShaderReloader.h"
+#include "SharedFrameRing.h"
+#include "StagedPipeline.h"
+#include "StartupGraph.h"
+#include "UploadRing.h"
+
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
@@ -28,6 +51,9 @@ using namespace std::chrono;
 #define HOTKEY_DECREASE 3
 #define HOTKEY_METHOD 4
 #define HOTKEY_QUIT 5
+#define HOTKEY_LINEAR 6
+#define HOTKEY_ROI_ADD 7
+#define HOTKEY_ROI_CLEAR 8
 
 // Forward declaration
 class FinalOverlayFilter;
@@ -36,31 +62,30 @@ class FinalOverlayFilter;
 FinalOverlayFilter* g_filterInstance = nullptr;
 WNDPROC g_originalWndProc = nullptr;
 
+// Origem da linha do tempo da inicialização (inicializada antes do main)
+const steady_clock::time_point g_processStart = steady_clock::now();
+
 // ==================== CLASSE SHADER ====================
 class Shader {
 private:
     unsigned int ID;
     
-    unsigned int compileShader(const std::string& source, GLenum type) {
-        unsigned int shader = glCreateShader(type);
-        const char* src = source.c_str();
-        glShaderSource(shader, 1, &src, NULL);
-        glCompileShader(shader);
-        return shader;
-    }
-    
 public:
     Shader(const std::string& vertexSource, const std::string& fragmentSource) {
-        unsigned int vertex = compileShader(vertexSource, GL_VERTEX_SHADER);
-        unsigned int fragment = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
-        
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        std::string log;
+        ID = linkProgram(vertexSource, fragmentSource, &log);
+        if (!ID) std::cerr << "❌ Shader embutido não compilou (" << log << ")" << std::endl;
+    }
+    
+    // Programa já linkado e validado (shaders/ lidos na inicialização)
+    explicit Shader(unsigned int program) : ID(program) {}
+    
+    ~Shader() { glDeleteProgram(ID); }
+    
+    // Programa recompilado pelo ShaderReloader (contexto compartilhado)
+    void replace(unsigned int program) {
+        glDeleteProgram(ID);
+        ID = program;
     }
     
     void use() { glUseProgram(ID); }
@@ -81,6 +106,7 @@ private:
     unsigned int lutTextureID;
     bool isLoaded;
     int width, height, channels;
+    std::vector<float> texels;  // decodificada, esperando upload()
     
 public:
     LUTLoader() : lutTextureID(0), isLoaded(false), width(0), height(0), channels(0) {}
@@ -91,27 +117,58 @@ public:
         }
     }
     
-    bool loadLUT(const std::string& filepath) {
-        unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
+    // Decodificar não usa GL (roda em um worker durante a inicialização);
+    // upload() cria a textura no contexto atual
+    bool decodeFile(const std::string& filepath) {
+        int fileWidth, fileHeight, fileChannels;
+        unsigned char* data = stbi_load(filepath.c_str(), &fileWidth, &fileHeight, &fileChannels, 0);
         if (!data) return false;
         
-        if (!((width == 1024 && height == 32) || (width == 32 && height == 1024))) {
-            stbi_image_free(data);
+        bool ok = decodeMemory(data, fileWidth, fileHeight, fileChannels);
+        stbi_image_free(data);
+        return ok;
+    }
+    
+    // LUT gerada no build (sem I/O nem decodificação de PNG)
+    bool decodeBuiltin(const BuiltinLUT& lut) {
+        return decodeMemory(lut.data, lut.width, lut.height, lut.channels);
+    }
+    
+    bool decodeMemory(const unsigned char* data, int w, int h, int ch) {
+        if (!((w == 1024 && h == 32) || (w == 32 && h == 1024)) || (ch != 3 && ch != 4)) {
             return false;
         }
+        width = w;
+        height = h;
+        channels = ch;
+        
+        // PNG com alfa: descarta o canal antes (a faixa é sempre RGB)
+        std::vector<unsigned char> rgb;
+        if (channels == 4) {
+            rgb.resize((size_t)width * height * 3);
+            PixelConvert::pack3(data, rgb.data(), (size_t)width * height, false);
+            data = rgb.data();
+        }
         
+        // Armazenamento float (GL_RGB16F): a interpolação da LUT não é
+        // quantizada em 8 bits, o que importa para fontes de 10 bits/HDR
+        texels.resize((size_t)width * height * 3);
+        for (size_t i = 0; i < texels.size(); i++) {
+            texels[i] = data[i] / 255.0f;
+        }
+        return true;
+    }
+    
+    bool upload() {
+        if (texels.empty()) return false;
         glGenTextures(1, &lutTextureID);
         glBindTexture(GL_TEXTURE_2D, lutTextureID);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        
-        GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
-        GLenum internalFormat = (channels == 4) ? GL_RGBA8 : GL_RGB8;
-        
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        stbi_image_free(data);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, texels.data());
+        std::vector<float>().swap(texels);
         isLoaded = true;
         return true;
     }
@@ -126,288 +183,255 @@ public:
     bool getIsLoaded() const { return isLoaded; }
 };
 
-// ==================== CAPTURA INDEPENDENTE ====================
-class IndependentScreenCapture {
+// ==================== PBOs PERSISTENTES (UPLOAD ZERO CÓPIA) ====================
+// glBufferStorage é GL 4.4 / ARB_buffer_storage: fora do glad 3.3, carregado à mão
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+typedef void (APIENTRY *PFN_glBufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// Três PBOs mapeados permanentemente e registrados como slots de um
+// UploadRing: a captura escreve no PBO e glTexSubImage2D lê dele por DMA,
+// sem a cópia que glTexImage2D faz de memória do cliente. Uma fence por slot
+// diz quando a GPU terminou de ler e o slot pode voltar para a captura.
+class PersistentUploadBuffers {
 private:
-    HDC hdcScreen, hdcMemDC;
-    HBITMAP hbmScreen, hbmOld;
-    int screenWidth, screenHeight;
-    // HWND overlayHwnd;
-    // std::atomic<bool>* correctionEnabled;
-    
-    std::vector<unsigned char> frontBuffer;
-    std::vector<unsigned char> backBuffer;
-    
-    std::mutex bufferMutex;
-    std::thread captureThread;
-    std::atomic<bool> running;
-    std::atomic<bool> initialized;
-    std::atomic<int> frameCount;
+    static const int slotCount = 3;
+    unsigned int pbos[slotCount] = { 0, 0, 0 };
+    GLsync fences[slotCount] = { 0, 0, 0 };
+    UploadRing* ring = nullptr;
+    size_t frameBytes = 0;
     
 public:
-    IndependentScreenCapture() 
-        : running(false), initialized(false), frameCount(0) {
-        screenWidth = GetSystemMetrics(SM_CXSCREEN);
-        screenHeight = GetSystemMetrics(SM_CYSCREEN);
-        frontBuffer.resize(screenWidth * screenHeight * 4);
-        backBuffer.resize(screenWidth * screenHeight * 4);
-    }
+    ~PersistentUploadBuffers() { destroy(); }
     
-    ~IndependentScreenCapture() {
-        stop();
-        cleanup();
+    static bool isSupported() {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool supported = major > 4 || (major == 4 && minor >= 4);
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount && !supported; i++) {
+            const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            supported = name && std::string(name) == "GL_ARB_buffer_storage";
+        }
+        return supported && glfwGetProcAddress("glBufferStorage") != nullptr;
     }
     
-    bool initialize() {
-        hdcScreen = GetDC(NULL);
-        if (!hdcScreen) return false;
+    // Chamado com o contexto da saída ativo
+    bool create(int width, int height) {
+        if (!isSupported()) return false;
+        auto bufferStorage = (PFN_glBufferStorage)glfwGetProcAddress("glBufferStorage");
         
-        hdcMemDC = CreateCompatibleDC(hdcScreen);
-        if (!hdcMemDC) {
-            ReleaseDC(NULL, hdcScreen);
-            return false;
-        }
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        frameBytes = FrameView::compactSize(PixelFormat::BGRA8, width, height);
+        ring = new UploadRing(PixelFormat::BGRA8, width, height);
         
-        hbmScreen = CreateCompatibleBitmap(hdcScreen, screenWidth, screenHeight);
-        if (!hbmScreen) {
-            DeleteDC(hdcMemDC);
-            ReleaseDC(NULL, hdcScreen);
-            return false;
+        glGenBuffers(slotCount, pbos);
+        for (int i = 0; i < slotCount; i++) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[i]);
+            bufferStorage(GL_PIXEL_UNPACK_BUFFER, frameBytes, NULL, flags | GL_CLIENT_STORAGE_BIT);
+            void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBytes, flags);
+            if (!mapped) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                destroy();
+                return false;
+            }
+            ring->addSlot((uint8_t*)mapped, width * 4, (void*)(uintptr_t)i);
         }
-        
-        hbmOld = (HBITMAP)SelectObject(hdcMemDC, hbmScreen);
-        
-        initialized = true;
-        std::cout << "✅ Captura independente: " << screenWidth << "x" << screenHeight << std::endl;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         return true;
     }
     
-    void start() {
-        if (running) return;
-        
-        running = true;
-        captureThread = std::thread(&IndependentScreenCapture::captureLoop, this);
-        
-        // CRITICAL: Aumentar prioridade da thread
-        HANDLE threadHandle = (HANDLE)captureThread.native_handle();
-        SetThreadPriority(threadHandle, THREAD_PRIORITY_HIGHEST);
-            
-        std::cout << "✅ Thread de captura em ALTA PRIORIDADE" << std::endl;
-    }
+    UploadRing* getRing() const { return ring; }
     
-    void stop() {
-        if (!running) return;
-        running = false;
-        if (captureThread.joinable()) {
-            captureThread.join();
+    // Thread de render: devolve slots já lidos pela GPU e envia o frame mais
+    // novo (se houver) para 'texture', que já deve ter storage alocado.
+    // Com 'regions' só os retângulos sobem (offset no PBO + ROW_LENGTH).
+    bool upload(unsigned int texture, const GLPixelFormat& format, const std::vector<RoiRect>* regions = nullptr) {
+        for (int i = 0; i < slotCount; i++) {
+            if (!fences[i]) continue;
+            GLenum status = glClientWaitSync(fences[i], 0, 0);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                glDeleteSync(fences[i]);
+                fences[i] = 0;
+                ring->release(i);
+            }
         }
-    }
-    
-    unsigned char* getPixelData() {
-        std::lock_guard<std::mutex> lock(bufferMutex);
-        return frontBuffer.data();
-    }
-
-    // void setOverlayWindow(HWND hwnd) {
-    //     overlayHwnd = hwnd;
-    // }
-
-    // void setCorrectionState(std::atomic<bool>* state) {
-    //     correctionEnabled = state;
-    // }
-    
-    int getWidth() const { return screenWidth; }
-    int getHeight() const { return screenHeight; }
-    bool isInitialized() const { return initialized; }
-    int getFrameCount() const { return frameCount; }
-    
-private:
-    void captureLoop() {
-        BITMAPINFOHEADER bi;
-        ZeroMemory(&bi, sizeof(BITMAPINFOHEADER));
-        bi.biSize = sizeof(BITMAPINFOHEADER);
-        bi.biWidth = screenWidth;
-        bi.biHeight = -screenHeight;
-        bi.biPlanes = 1;
-        bi.biBitCount = 32;
-        bi.biCompression = BI_RGB;
-        
-        auto lastCapture = steady_clock::now();
-        
-        while (running) {
-            auto now = steady_clock::now();
-            auto elapsed = duration_cast<milliseconds>(now - lastCapture).count();
-            
-            // if (overlayHwnd) ShowWindow(overlayHwnd, SW_HIDE);
-
-            // Capturar a cada 16ms (~60 FPS) independente de qualquer coisa
-            if (elapsed >= 16) {
-                if (BitBlt(hdcMemDC, 0, 0, screenWidth, screenHeight, 
-                        hdcScreen, 0, 0, SRCCOPY | CAPTUREBLT)) {
-                    
-                    if (GetDIBits(hdcScreen, hbmScreen, 0, screenHeight,
-                                backBuffer.data(), (BITMAPINFO*)&bi, DIB_RGB_COLORS)) {
-                        
-                        {
-                            std::lock_guard<std::mutex> lock(bufferMutex);
-                            std::swap(frontBuffer, backBuffer);
-                        }
-                        
-                        frameCount++;
-                    }
-                }
-                
-                lastCapture = now;
+        
+        int slot = ring->acquireLatest();
+        if (slot < 0) return false;
+        
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[slot]);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        const FrameView& view = ring->view(slot);
+        setUnpackLayout(view);  // slots sempre com stride múltiplo do pixel
+        if (regions) {
+            for (const RoiRect& r : *regions) {
+                size_t offset = (size_t)r.y * view.strides[0] + (size_t)r.x * bytesPerPixel(view.format);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.width, r.height,
+                                format.format, format.type, (void*)offset);
             }
-            
-            // Dormir apenas 1ms para manter responsividade
-            Sleep(1);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, ring->getWidth(), ring->getHeight(),
+                            format.format, format.type, (void*)0);
         }
+        resetUnpackLayout();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        return true;
     }
     
-    void cleanup() {
-        if (hbmScreen) {
-            SelectObject(hdcMemDC, hbmOld);
-            DeleteObject(hbmScreen);
-            hbmScreen = NULL;
-        }
-        if (hdcMemDC) {
-            DeleteDC(hdcMemDC);
-            hdcMemDC = NULL;
-        }
-        if (hdcScreen) {
-            ReleaseDC(NULL, hdcScreen);
-            hdcScreen = NULL;
+    // A captura precisa estar parada (ela escreve nos ponteiros mapeados)
+    void destroy() {
+        for (int i = 0; i < slotCount; i++) {
+            if (fences[i]) glDeleteSync(fences[i]);
+            fences[i] = 0;
+            if (pbos[i]) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[i]);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
         }
-        initialized = false;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (pbos[0]) glDeleteBuffers(slotCount, pbos);
+        for (int i = 0; i < slotCount; i++) pbos[i] = 0;
+        delete ring;
+        ring = nullptr;
     }
 };
 
-// ==================== SHADERS ====================
-const char* vertexShaderSource = R"(
-#version 330 core
-layout (location = 0) in vec2 aPos;
-layout (location = 1) in vec2 aTexCoord;
-out vec2 TexCoord;
-void main() {
-    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); 
-    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
-}
-)";
-
-const char* fragmentShaderSource = R"(
-#version 330 core
-out vec4 FragColor;
-in vec2 TexCoord;
-uniform sampler2D screenTexture;
-uniform sampler2D lutTexture;
-uniform bool enableCorrection;
-uniform float correctionStrength;
-uniform bool useLUT;
-
-vec3 applyLUT3D(vec3 color, sampler2D lut) {
-    color = clamp(color, 0.0, 1.0);
-    const float lutSize = 32.0;
+LRESULT CALLBACK OverlayWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
-    // Red -> u (x-coord in slice)
-    // Blue -> v (y-coord in slice)
-    // Green -> slice index
+// ==================== OVERLAY FINAL ====================
+// Uma saída por monitor: janela + contexto GL + captura + textura de tela
+// próprios, renderizada em uma thread própria. Os contextos são criados
+// compartilhando objetos com o da primeira saída, então a textura da LUT é
+// carregada uma única vez e usada por todas.
+struct OverlayOutput {
+    RECT region;
+    GLFWwindow* window = nullptr;
+    HWND hwnd = NULL;
+    FrameSource* capture = nullptr;  // GDI própria ou anel do daemon de captura
+    PersistentUploadBuffers* uploadBuffers = nullptr;  // nullptr: GL < 4.4, upload com cópia
+    Shader* shader = nullptr;  // programas ficam por contexto: uniforms não são disputados
+    int shaderSlot = 0;        // consumidor no ShaderReloader
     
-    float u = (color.r * (lutSize - 1.0) + 0.5) / lutSize;
-    float v = (color.b * (lutSize - 1.0) + 0.5) / lutSize;
-    float slice = color.g * (lutSize - 1.0);
-
-    float slice_floor = floor(slice);
-    float slice_frac = slice - slice_floor;
-
-    // The normalized WIDTH of a single 32x32 slice
-    float slice_width = 1.0 / lutSize;
-
-    // We calculate the X coordinate by finding the correct horizontal slice.
-    // We use 'v' for the Y coordinate directly.
-    vec2 uv0 = vec2( (u + slice_floor) * slice_width, v );
-    vec2 uv1 = vec2( (u + slice_floor + 1.0) * slice_width, v );
-
-    vec3 sample0 = texture(lut, uv0).rgb;
-    vec3 sample1 = texture(lut, uv1).rgb;
-
-    return mix(sample0, sample1, slice_frac);
-}
-
-vec3 hybridCorrection(vec3 color) {
-    float luminance = dot(color, vec3(0.299, 0.587, 0.114));
-    float redGreenRatio = color.r / max(color.g, 0.001);
+    // --gpu-path compute com GL 4.3: filtra para filteredTexture só os blocos
+    // enviados desde o último frame e copia para a janela com blit
+    ComputeFilter* compute = nullptr;
+    unsigned int filteredTexture = 0, filteredFbo = 0;
+    std::atomic<bool> computeStale{false};  // força/método/modo mudou: refiltra tudo
     
-    vec3 corrected = color;
-    if (redGreenRatio > 1.2) {
-        corrected.r = min(1.0, color.r * 1.1);
-        corrected.b = min(1.0, color.b + (color.r - color.g) * 0.25);
-    } else if (redGreenRatio < 0.8) {
-        corrected.g = min(1.0, color.g * 1.05);
-        corrected.b = min(1.0, color.b + (color.g - color.r) * 0.2);
-    }
+    unsigned int VAO = 0, VBO = 0;
+    unsigned int screenTexture = 0;
+    GLint screenTextureFormat = 0;  // internalFormat do storage atual (muda com luz linear)
+    std::vector<uint8_t> repackBuffer;  // só para fontes com stride ímpar
     
-    float newLuminance = dot(corrected, vec3(0.299, 0.587, 0.114));
-    if (newLuminance > 0.001) {
-        corrected *= luminance / newLuminance;
-    }
+    // Regiões de interesse nas coordenadas do frame desta saída
+    uint64_t regionVersion = ~0ull;
+    bool regionsActive = false;  // false: frame inteiro
+    std::vector<RoiRect> localRegions;
     
-    return clamp(corrected, 0.0, 1.0);
-}
-
-void main() {
-    vec3 color = texture(screenTexture, TexCoord).rgb;
+    // Orçamento de 60 FPS; a escada depende do caminho (setupOutput)
+    std::unique_ptr<QualityGovernor> governor;
     
-    if (!enableCorrection) {
-        FragColor = vec4(color, 1.0);
-        return;
-    }
+    // Degrau "só blocos alterados" no upload com cópia: a textura guarda o
+    // frame anterior e só sobem os blocos que mudaram desde ele
+    ChangeDetector changes;
+    uint64_t changesRegionVersion = ~0ull;
     
+    // Degrau "croma 2x2": deltas de cada bloco 2x2 em meia resolução
+    unsigned int chromaTexture = 0, chromaFbo = 0;
+    int chromaWidth = 0, chromaHeight = 0;
     
-    vec3 corrected;
-    if (useLUT) {
-        corrected = applyLUT3D(color, lutTexture);
-    } else {
-        corrected = hybridCorrection(color);
-    }
+    std::thread renderThread;
+    std::atomic<int> renderFrames{0};
+    int lastFrameCount = 0;
     
-    vec3 final = mix(color, corrected, correctionStrength);
-    FragColor = vec4(final, 1.0);
-
-    // vec3 corrected = applyLUT3D(color, lutTexture);
-    // FragColor = vec4(corrected, 1.0);
-
-    // FragColor = vec4(1.0, 0.0, 0.0, 0.5); 
-}
-)";
-
-LRESULT CALLBACK OverlayWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    // --pipeline staged: captura -> blocos alterados -> upload -> apresentação
+    // em corrotinas; a thread de render roda upload e apresentação
+    StagedPipeline* pipeline = nullptr;
+    bool textureStale = true;  // próximo upload precisa do frame inteiro
+    double stagedUploadMs = 0.0;
+    bool hasFrame = false;  // a textura já recebeu um frame da captura
+};
 
-// ==================== OVERLAY FINAL ====================
 class FinalOverlayFilter {
 private:
-    GLFWwindow* window;
-    IndependentScreenCapture* capture;
-    Shader* shader;
+    std::vector<OverlayOutput*> outputs;  // outputs[0]: monitor principal, dono dos hotkeys
     LUTLoader* lutLoader;
     
-    unsigned int VAO, VBO;
-    unsigned int screenTexture;
-    
     std::atomic<bool> correctionEnabled;
     std::atomic<float> correctionStrength;
     std::atomic<bool> useLUT;
+    std::atomic<bool> linearLight;  // Processar em luz linear (opt-in)
+    int mathMethod = 0;  // --method: correção sem LUT (uniform correctionMethod do shader)
     
-    HWND overlayHwnd;
+    // --dither: ruído azul na volta para 8 bits (textura compartilhada, unidade 2)
+    bool dither = false;
+    unsigned int noiseTexture = 0;
     
-    int lastFrameCount = 0;
-    bool shouldClose = false;
+    std::atomic<bool> shouldClose;
+    
+    std::string attachName;  // não vazio: monitor principal vem do capturedaemon
+    RegionSet regions;  // coordenadas da tela virtual; vazio = tela inteira
+    
+    std::string recordPath;  // não vazio: grava o monitor principal + hotkeys
+    CaptureRecorder recorder;
+    
+    bool staged = false;  // --pipeline staged (padrão: laço sequencial)
+    bool computeRequested = false;  // --gpu-path compute (padrão: fragment shader)
+    bool computeCalibrated = false;
+    ComputeFilter::LutFetch computeFetch = ComputeFilter::LutFetch::Texture;
+    
+    // shaders/ recompilado em uma thread com contexto próprio (janela oculta)
+    ShaderReloader shaderReloader;
+    GLFWwindow* shaderWindow = nullptr;
+    std::string shaderDir = "shaders";
+    bool shaderFromFiles = false;  // o programa inicial veio de shaderDir
+    
+    // Linha do tempo da inicialização, a partir do início do processo
+    StartupGraph startup;
+    std::atomic<bool> firstFrameShown{false};
+    std::string tracePath;  // não vazio: grava a linha do tempo no cleanup
     
 public:
-    FinalOverlayFilter() : correctionEnabled(false), correctionStrength(0.6f), useLUT(false) {
+    explicit FinalOverlayFilter(steady_clock::time_point processStart)
+        : lutLoader(nullptr), correctionEnabled(false), correctionStrength(0.6f), useLUT(false), linearLight(false), shouldClose(false), startup(processStart) {
         g_filterInstance = this;
     }
     
+    // Lê o monitor principal do anel publicado por "capturedaemon serve --name nome"
+    void attachToDaemon(const std::string& name) { attachName = name; }
+    
+    // Grava frames e hotkeys do monitor principal (reproduzir com "replay")
+    void recordTo(const std::string& path) { recordPath = path; }
+    
+    // Estágios em corrotinas no lugar do laço sequencial de render
+    void useStagedPipeline(bool enable) { staged = enable; }
+    
+    // Compute shader no lugar do quad + fragment shader (cai no fragment sem GL 4.3)
+    void useComputePath(bool enable) { computeRequested = enable; }
+    
+    // Pasta com vertex.glsl e fragment.glsl (padrão: shaders/, copiada pelo CMake)
+    void setShaderDirectory(const std::string& directory) { shaderDir = directory; }
+    
+    // Linha do tempo da inicialização em formato de trace do Chrome
+    void writeTraceTo(const std::string& path) { tracePath = path; }
+    
+    // Começa com o filtro ligado (mede o tempo até o primeiro frame filtrado)
+    void startEnabled() { correctionEnabled = true; }
+    
+    // Dither de ruído azul na saída: gradientes sem degraus de 1 LSB
+    void useDither(bool enable) { dither = enable; }
+    
+    // Correção matemática usada com a LUT desligada (Ctrl+Shift+L):
+    // 0 híbrido, 1 LMS, 2 daltonize. O compute shader só tem o híbrido
+    void useMathMethod(int method) { mathMethod = method; }
+    
     ~FinalOverlayFilter() {
         g_filterInstance = nullptr;
     }
@@ -417,18 +441,24 @@ public:
         std::cout << "DEBUG: toggleCorrection() CALLED!" << std::endl;
         bool current = correctionEnabled.load();
         correctionEnabled.store(!current);
+        recorder.writeEvent(RecordedEvent::Toggle, !current ? 1.0f : 0.0f);
+        requestRedraw();
         std::cout << "Filtro " << (!current ? "✅ ATIVADO" : "❌ DESATIVADO") << std::endl;
     }
     
     void increaseIntensity() {
         float current = correctionStrength.load();
         correctionStrength.store(std::min(1.0f, current + 0.1f));
+        recorder.writeEvent(RecordedEvent::Strength, correctionStrength.load());
+        requestRedraw();
         std::cout << "Intensidade: " << (int)(correctionStrength.load() * 100) << "%" << std::endl;
     }
     
     void decreaseIntensity() {
         float current = correctionStrength.load();
         correctionStrength.store(std::max(0.0f, current - 0.1f));
+        recorder.writeEvent(RecordedEvent::Strength, correctionStrength.load());
+        requestRedraw();
         std::cout << "Intensidade: " << (int)(correctionStrength.load() * 100) << "%" << std::endl;
     }
     
@@ -436,111 +466,144 @@ public:
         if (lutLoader->getIsLoaded()) {
             bool current = useLUT.load();
             useLUT.store(!current);
+            recorder.writeEvent(RecordedEvent::Method, !current ? 1.0f : 0.0f);
+            requestRedraw();
             std::cout << "Método: " << (!current ? "LUT" : "Matemático") << std::endl;
         } else {
             std::cout << "⚠️ LUT não disponível" << std::endl;
         }
     }
     
+    void toggleLinearLight() {
+        bool current = linearLight.load();
+        linearLight.store(!current);
+        recorder.writeEvent(RecordedEvent::LinearLight, !current ? 1.0f : 0.0f);
+        requestRedraw();
+        std::cout << "Espaço de cor: " << (!current ? "Linear (sRGB por hardware)" : "Gamma (sRGB direto)") << std::endl;
+    }
+    
     void requestClose() {
         shouldClose = true;
     }
     
-    bool initialize() {
-        if (!glfwInit()) {
-            std::cerr << "Falha ao inicializar GLFW" << std::endl;
-            return false;
-        }
-        
-        int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-        int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-        
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-        glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
-        glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, GLFW_TRUE);
-        glfwWindowHint(GLFW_FLOATING, GLFW_TRUE);
-        glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-        glfwWindowHint(GLFW_FOCUSED, GLFW_FALSE);
-        glfwWindowHint(GLFW_FOCUS_ON_SHOW, GLFW_FALSE);
-        
-        window = glfwCreateWindow(screenWidth, screenHeight, "Daltonismo Filter", NULL, NULL);
-        if (!window) {
-            std::cerr << "Falha ao criar janela" << std::endl;
-            glfwTerminate();
-            return false;
-        }
-        
-        glfwSetWindowPos(window, 0, 0);
-        glfwMakeContextCurrent(window);
-        
-        overlayHwnd = glfwGetWin32Window(window);
-        
-        // Configurar janela overlay
-        LONG_PTR exStyle = GetWindowLong(overlayHwnd, GWL_EXSTYLE);
-        SetWindowLong(overlayHwnd, GWL_EXSTYLE, 
-                     exStyle | WS_EX_LAYERED | WS_EX_TRANSPARENT | 
-                     WS_EX_TOPMOST | WS_EX_NOACTIVATE | WS_EX_TOOLWINDOW);
-
-        SetWindowDisplayAffinity(overlayHwnd, WDA_EXCLUDEFROMCAPTURE);
-        
-        SetLayeredWindowAttributes(overlayHwnd, RGB(0, 0, 0), 0, LWA_ALPHA);
-        
-        // Substituir Window Procedure
-        // originalWndProc = (WNDPROC)SetWindowLongPtr(overlayHwnd, GWLP_WNDPROC, (LONG_PTR)OverlayWndProc);
-        g_originalWndProc = (WNDPROC)SetWindowLongPtr(overlayHwnd, GWLP_WNDPROC, (LONG_PTR)OverlayWndProc);
-
-        // REGISTRAR HOTKEYS GLOBAIS
-        if (!RegisterHotKey(overlayHwnd, HOTKEY_TOGGLE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'D')) {
-            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+D" << std::endl;
-        }
-        if (!RegisterHotKey(overlayHwnd, HOTKEY_INCREASE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, VK_OEM_PLUS)) {
-            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift++" << std::endl;
-        }
-        if (!RegisterHotKey(overlayHwnd, HOTKEY_DECREASE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, VK_OEM_MINUS)) {
-            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+-" << std::endl;
-        }
-        if (!RegisterHotKey(overlayHwnd, HOTKEY_METHOD, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'L')) {
-            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+L" << std::endl;
-        }
-        if (!RegisterHotKey(overlayHwnd, HOTKEY_QUIT, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'Q')) {
-            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+Q" << std::endl;
-        }
-        
-        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-            std::cerr << "Falha ao inicializar GLAD" << std::endl;
-            return false;
+    // Regiões de interesse (coordenadas de tela): só elas são filtradas,
+    // o resto da tela aparece sem correção
+    void addRegion(const RoiRect& rect) {
+        regions.add(rect);
+        requestRedraw();
+        std::cout << "Região: " << rect.width << "x" << rect.height << " em (" << rect.x << ", " << rect.y << ")" << std::endl;
+    }
+    
+    void addForegroundWindowRegion() {
+        HWND foreground = GetForegroundWindow();
+        RECT bounds;
+        if (!foreground || FAILED(DwmGetWindowAttribute(foreground, DWMWA_EXTENDED_FRAME_BOUNDS, &bounds, sizeof(bounds)))) {
+            std::cout << "⚠️ Nenhuma janela em foco" << std::endl;
+            return;
         }
+        addRegion({ (int)bounds.left, (int)bounds.top, (int)(bounds.right - bounds.left), (int)(bounds.bottom - bounds.top) });
+    }
+    
+    void clearRegions() {
+        regions.clear();
+        requestRedraw();
+        std::cout << "Região: tela inteira" << std::endl;
+    }
+    
+    // Passos da inicialização em grafo (StartupGraph): janelas, contextos e
+    // GL ficam na thread principal; decodificar a LUT, ler os shaders e abrir
+    // as capturas rodam em workers ao mesmo tempo. A linha do tempo sai no
+    // console e, com --trace, em JSON junto com o primeiro frame filtrado.
+    bool initialize() {
+        using Where = StartupGraph::Where;
+        std::vector<OverlayOutput*> detected;   // todos os monitores, antes das janelas
+        std::vector<OverlayOutput*> withoutWindow;
+        std::string vertexSource, fragmentSource;
         
-        glfwSwapInterval(0);
+        int glfw = startup.add("glfw", Where::Main, {}, [&] { return initializeGlfw(); });
+        int monitors = startup.add("monitores", Where::Worker, {}, [&] {
+            for (const RECT& region : enumerateMonitors()) {
+                OverlayOutput* output = new OverlayOutput();
+                output->region = region;
+                detected.push_back(output);
+            }
+            return !detected.empty();
+        });
+        int capture = startup.add("captura", Where::Worker, { monitors }, [&] {
+            for (OverlayOutput* output : detected) {
+                if (output == detected[0] && !attachName.empty()) {
+                    output->capture = new SharedRingFrameSource(attachName);
+                } else {
+                    output->capture = new IndependentScreenCapture(output->region);
+                }
+                if (!output->capture->initialize()) {
+                    std::cerr << "Falha ao inicializar captura" << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        });
+        int lut = startup.add("LUT", Where::Worker, {}, [&] {
+            lutLoader = new LUTLoader();
+            if (dither) BlueNoise::tile();  // void-and-cluster (~20 ms) fora da thread principal
+            return decodeCorrectionLUT();
+        });
+        int shaderFiles = startup.add("fonte dos shaders", Where::Worker, {}, [&] {
+            shaderFromFiles = readShaderFiles(vertexSource, fragmentSource);
+            return true;
+        });
+        int windows = startup.add("janelas", Where::Main, { glfw, monitors }, [&] {
+            return createWindows(detected, withoutWindow);
+        });
+        int gl = startup.add("GL", Where::Main, { windows }, [&] {
+            glfwMakeContextCurrent(outputs[0]->window);
+            if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+                std::cerr << "Falha ao inicializar GLAD" << std::endl;
+                return false;
+            }
+            return true;
+        });
+        startup.add("hotkeys", Where::Main, { windows }, [&] {
+            registerHotkeys(outputs[0]->hwnd);
+            return true;
+        });
+        // LUT (e ruído do dither) compartilhados: enviados uma vez, no primeiro contexto
+        int lutUpload = startup.add("upload da LUT", Where::Main, { gl, lut }, [&] {
+            glfwMakeContextCurrent(outputs[0]->window);
+            useLUT = lutLoader->upload();
+            if (dither) noiseTexture = createNoiseTexture();
+            return true;
+        });
+        int programs = startup.add("programas", Where::Main, { gl, shaderFiles }, [&] {
+            for (OverlayOutput* output : outputs) {
+                glfwMakeContextCurrent(output->window);
+                output->shader = createShader(vertexSource, fragmentSource);
+            }
+            return true;
+        });
+        startup.add("saídas", Where::Main, { capture, lutUpload, programs }, [&] {
+            for (OverlayOutput* output : withoutWindow) {
+                delete output->capture;
+                delete output;
+            }
+            for (OverlayOutput* output : outputs) {
+                glfwMakeContextCurrent(output->window);
+                setupOutput(*output);
+            }
+            return true;
+        });
         
-        capture = new IndependentScreenCapture();
-        if (!capture->initialize()) {
-            std::cerr << "Falha ao inicializar captura" << std::endl;
+        bool ok = startup.run();
+        glfwMakeContextCurrent(NULL);
+        if (!ok) {
+            startup.printTimeline();
             return false;
         }
         
-        // capture->setOverlayWindow(overlayHwnd);
-        // capture->setCorrectionState(&correctionEnabled);
-
-        capture->start();
-        
-        shader = new Shader(vertexShaderSource, fragmentShaderSource);
-        lutLoader = new LUTLoader();
-        
-        if (!lutLoader->loadLUT("luts/deuteranopia_correction.png")) {
-            std::cout << "LUT não encontrada, usando correção matemática" << std::endl;
-            useLUT = false;
-        } else {
-            useLUT = true;
-        }
-        
-        setupGeometry();
-        setupTexture();
-        
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Cada contexto passa a ser da sua thread de renderização
+        startShaderReloader();
+        std::cout << "⏱️ Inicialização em " << (int)startup.elapsedMs() << " ms:" << std::endl;
+        startup.printTimeline();
         
         std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
         std::cout << "║ ✅ HOTKEYS GLOBAIS REGISTRADOS        ║" << std::endl;
@@ -551,18 +614,26 @@ public:
         std::cout << "  Ctrl+Shift++ - Aumentar intensidade" << std::endl;
         std::cout << "  Ctrl+Shift+- - Diminuir intensidade" << std::endl;
         std::cout << "  Ctrl+Shift+L - Alternar LUT/Matemático" << std::endl;
+        std::cout << "  Ctrl+Shift+G - Alternar luz linear/gamma" << std::endl;
+        std::cout << "  Ctrl+Shift+R - Filtrar só a janela em foco (acumula)" << std::endl;
+        std::cout << "  Ctrl+Shift+E - Voltar a filtrar a tela inteira" << std::endl;
         std::cout << "  Ctrl+Shift+Q - Sair\n" << std::endl;
         
         return true;
     }
     
+    // Thread principal: mensagens do Windows (hotkeys), eventos GLFW e
+    // visibilidade das janelas. A renderização fica nas threads das saídas.
     void run() {
+        for (OverlayOutput* output : outputs) {
+            output->renderThread = std::thread(&FinalOverlayFilter::renderLoop, this, output);
+        }
+        
         auto lastFpsCheck = steady_clock::now();
-        int renderFrames = 0;
+        bool visible = false;
         
         MSG msg;
-        while (!shouldClose && !glfwWindowShouldClose(window)) {
-            // std::cout << " Entrei no loop de renderiação " << std::endl;
+        while (!shouldClose) {
             // CRITICAL: Processar mensagens do Windows (para hotkeys)
             while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
                 if (msg.message == WM_QUIT) {
@@ -572,73 +643,400 @@ public:
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
             }
-            // std::cout << " Sai do loop de menssagem " << std::endl;
             
             // Poll GLFW events
             glfwPollEvents();
+            for (OverlayOutput* output : outputs) {
+                if (glfwWindowShouldClose(output->window)) shouldClose = true;
+            }
             
             bool enabled = correctionEnabled.load();
-            // std::cout << (enabled ? "Ativado aqui" : "Desativado aqui") << " valor em enabled: " << enabled << std::endl; 
-            
-            if (enabled) {
-                // std::cout << "LOOP: Filter is enabled. Entering render block." << std::endl;
-                updateScreenTexture();
-                // std::cout << "LOOP: AFTER updateScreenTexture()." << std::endl;
-                render();
-                // std::cout << "LOOP: AFTER render()." << std::endl;
-                SetLayeredWindowAttributes(overlayHwnd, RGB(0, 0, 0), 255, LWA_ALPHA);
-            } else {
-                SetLayeredWindowAttributes(overlayHwnd, RGB(0, 0, 0), 0, LWA_ALPHA);
-                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
+            if (enabled != visible) {
+                for (OverlayOutput* output : outputs) {
+                    SetLayeredWindowAttributes(output->hwnd, RGB(0, 0, 0), enabled ? 255 : 0, LWA_ALPHA);
+                }
+                visible = enabled;
             }
             
-            glfwSwapBuffers(window);
-            renderFrames++;
-            
             // Debug FPS
             auto now = steady_clock::now();
             auto elapsed = duration_cast<seconds>(now - lastFpsCheck).count();
             if (elapsed >= 5) {
-                int captureFrames = capture->getFrameCount();
-                std::cout << "📊 Render: " << (renderFrames / 5) << " FPS | ";
-                std::cout << "Capture: " << ((captureFrames - lastFrameCount) / 5) << " FPS | ";
-                std::cout << "Filtro: " << (enabled ? "ON" : "OFF") << std::endl;
-                lastFrameCount = captureFrames;
-                renderFrames = 0;
+                for (size_t i = 0; i < outputs.size(); i++) {
+                    OverlayOutput* output = outputs[i];
+                    int captureFrames = output->capture->getFrameCount();
+                    std::cout << "📊 Saída " << i << " | ";
+                    std::cout << "Render: " << (output->renderFrames.exchange(0) / 5) << " FPS | ";
+                    std::cout << "Capture: " << ((captureFrames - output->lastFrameCount) / 5) << " FPS | ";
+                    std::cout << "Filtro: " << (enabled ? "ON" : "OFF") << std::endl;
+                    if (enabled) std::cout << "   " << output->governor->describe() << std::endl;
+                    if (output->pipeline) {
+                        StagedPipeline::Stats stats = output->pipeline->getStats();
+                        std::printf("   Estágios: latência p50 %.1f ms | p99 %.1f ms | %llu substituídos | %llu sem mudança\n",
+                                    stats.latencyP50Ms, stats.latencyP99Ms, (unsigned long long)stats.replaced,
+                                    (unsigned long long)stats.unchanged);
+                    }
+                    output->lastFrameCount = captureFrames;
+                }
                 lastFpsCheck = now;
             }
             
             // Pequeno sleep para não usar 100% CPU
             Sleep(1);
-            // std::cout << "LOOP: End of cycle." << std::endl;
+        }
+        
+        for (OverlayOutput* output : outputs) {
+            if (output->renderThread.joinable()) output->renderThread.join();
         }
     }
     
     void cleanup() {
         // Desregistrar hotkeys
-        UnregisterHotKey(overlayHwnd, HOTKEY_TOGGLE);
-        UnregisterHotKey(overlayHwnd, HOTKEY_INCREASE);
-        UnregisterHotKey(overlayHwnd, HOTKEY_DECREASE);
-        UnregisterHotKey(overlayHwnd, HOTKEY_METHOD);
-        UnregisterHotKey(overlayHwnd, HOTKEY_QUIT);
+        HWND mainHwnd = outputs[0]->hwnd;
+        UnregisterHotKey(mainHwnd, HOTKEY_TOGGLE);
+        UnregisterHotKey(mainHwnd, HOTKEY_INCREASE);
+        UnregisterHotKey(mainHwnd, HOTKEY_DECREASE);
+        UnregisterHotKey(mainHwnd, HOTKEY_METHOD);
+        UnregisterHotKey(mainHwnd, HOTKEY_QUIT);
+        UnregisterHotKey(mainHwnd, HOTKEY_LINEAR);
+        UnregisterHotKey(mainHwnd, HOTKEY_ROI_ADD);
+        UnregisterHotKey(mainHwnd, HOTKEY_ROI_CLEAR);
         
-        capture->stop();
-        delete capture;
-        delete shader;
-        delete lutLoader;
+        // A thread de compilação solta o contexto dela antes de a janela sumir
+        shaderReloader.stop();
+        if (shaderWindow) glfwDestroyWindow(shaderWindow);
+        shaderWindow = nullptr;
         
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteTextures(1, &screenTexture);
+        // Objetos por contexto primeiro; a LUT compartilhada por último, no contexto dono
+        for (size_t i = outputs.size(); i-- > 0;) {
+            OverlayOutput* output = outputs[i];
+            glfwMakeContextCurrent(output->window);
+            
+            if (output->capture) {
+                output->capture->stop();
+                delete output->pipeline;  // já parado pela thread de render
+                delete output->capture;
+            }
+            delete output->uploadBuffers;
+            delete output->shader;
+            delete output->compute;
+            
+            glDeleteFramebuffers(1, &output->filteredFbo);
+            glDeleteTextures(1, &output->filteredTexture);
+            glDeleteFramebuffers(1, &output->chromaFbo);
+            glDeleteTextures(1, &output->chromaTexture);
+            glDeleteVertexArrays(1, &output->VAO);
+            glDeleteBuffers(1, &output->VBO);
+            glDeleteTextures(1, &output->screenTexture);
+            
+            if (i == 0) {
+                delete lutLoader;
+                if (noiseTexture) glDeleteTextures(1, &noiseTexture);
+            }
+            glfwDestroyWindow(output->window);
+            delete output;
+        }
+        outputs.clear();
+        
+        // Captura já parada: nenhum frame chega depois do close (que esvazia a fila)
+        if (recorder.isOpen()) {
+            recorder.close();
+            std::cout << "⏹️ Gravação: " << recorder.getFrameCount() << " frames ("
+                      << recorder.getDroppedFrames() << " descartados), "
+                      << recorder.getEventCount() << " eventos, "
+                      << recorder.getBytesWritten() / (1024 * 1024) << " MB (compressão "
+                      << (int)recorder.getCompressionRatio() << "x)" << std::endl;
+        }
         
         glfwTerminate();
+        
+        if (!tracePath.empty()) {
+            if (startup.writeTrace(tracePath)) {
+                std::cout << "⏱️ Linha do tempo em " << tracePath << std::endl;
+            } else {
+                std::cerr << "⚠️ Não foi possível gravar " << tracePath << std::endl;
+            }
+        }
     }
     
     // Remover keyCallback antigo - não é mais necessário
     
 private:
-    void setupGeometry() {
+    void configureOverlayWindow(HWND hwnd) {
+        // Configurar janela overlay
+        LONG_PTR exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
+        SetWindowLong(hwnd, GWL_EXSTYLE, 
+                     exStyle | WS_EX_LAYERED | WS_EX_TRANSPARENT | 
+                     WS_EX_TOPMOST | WS_EX_NOACTIVATE | WS_EX_TOOLWINDOW);
+
+        SetWindowDisplayAffinity(hwnd, WDA_EXCLUDEFROMCAPTURE);
+        
+        SetLayeredWindowAttributes(hwnd, RGB(0, 0, 0), 0, LWA_ALPHA);
+        
+        // Substituir Window Procedure (todas as janelas GLFW têm o mesmo original)
+        g_originalWndProc = (WNDPROC)SetWindowLongPtr(hwnd, GWLP_WNDPROC, (LONG_PTR)OverlayWndProc);
+    }
+    
+    // O estado inicial das hotkeys entra na gravação como eventos, para a
+    // reprodução partir do mesmo ponto
+    bool startRecording(FrameSource& capture) {
+        if (!recorder.open(recordPath, capture.getFormat(), capture.getWidth(), capture.getHeight())) return false;
+        if (!capture.setFrameListener([this](const FrameHandle& frame) { recorder.writeFrame(frame); })) {
+            std::cerr << "⚠️ Esta captura não suporta gravação" << std::endl;
+            recorder.close();
+            return false;
+        }
+        recorder.writeEvent(RecordedEvent::Toggle, correctionEnabled.load() ? 1.0f : 0.0f);
+        recorder.writeEvent(RecordedEvent::Strength, correctionStrength.load());
+        recorder.writeEvent(RecordedEvent::Method, useLUT.load() ? 1.0f : 0.0f);
+        recorder.writeEvent(RecordedEvent::LinearLight, linearLight.load() ? 1.0f : 0.0f);
+        std::cout << "⏺️ Gravando em " << recordPath << std::endl;
+        return true;
+    }
+    
+    // Upload e apresentação ficam no executor da thread de render (dona do
+    // contexto GL); o gravador, se houver, continua recebendo os frames antes
+    void startStagedPipeline(OverlayOutput& output, bool recording) {
+        StagedPipeline::Options options;
+        options.presentThread = false;
+        options.upload = [this, &output](StagedFrame& frame) { uploadStagedFrame(output, frame); };
+        options.present = [this, &output](StagedFrame& frame) { presentStagedFrame(output, frame); };
+        FrameSource::FrameListener chain;
+        if (recording) chain = [this](const FrameHandle& frame) { recorder.writeFrame(frame); };
+        
+        output.pipeline = new StagedPipeline();
+        if (output.pipeline->start(output.capture, options, chain)) {
+            std::cout << "✅ Pipeline em estágios (corrotinas)" << std::endl;
+        } else {
+            std::cout << "⚠️ Esta captura não suporta o pipeline em estágios: laço sequencial" << std::endl;
+            delete output.pipeline;
+            output.pipeline = nullptr;
+        }
+    }
+    
+    // Com a tela parada nenhum frame chega à apresentação: mudanças de estado
+    // fazem o próximo frame seguir inteiro pelos estágios
+    void requestRedraw() {
+        for (OverlayOutput* output : outputs) {
+            if (output->pipeline) output->pipeline->resetChanges();
+            output->computeStale = true;
+        }
+    }
+    
+    bool initializeGlfw() {
+        if (!glfwInit()) {
+            std::cerr << "Falha ao inicializar GLFW" << std::endl;
+            return false;
+        }
+        
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
+        glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, GLFW_TRUE);
+        glfwWindowHint(GLFW_FLOATING, GLFW_TRUE);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_FOCUSED, GLFW_FALSE);
+        glfwWindowHint(GLFW_FOCUS_ON_SHOW, GLFW_FALSE);
+        // Framebuffer sRGB: permite que GL_FRAMEBUFFER_SRGB codifique a saída de graça
+        glfwWindowHint(GLFW_SRGB_CAPABLE, GLFW_TRUE);
+        return true;
+    }
+    
+    // Janelas (e eventos GLFW) precisam ser criadas na thread principal.
+    // Monitores sem janela vão para 'withoutWindow': a captura deles pode
+    // estar abrindo em paralelo, então só são apagados depois dela.
+    bool createWindows(const std::vector<OverlayOutput*>& detected, std::vector<OverlayOutput*>& withoutWindow) {
+        for (OverlayOutput* output : detected) {
+            const RECT& region = output->region;
+            GLFWwindow* share = outputs.empty() ? NULL : outputs[0]->window;
+            output->window = glfwCreateWindow(region.right - region.left, region.bottom - region.top,
+                                              "Daltonismo Filter", NULL, share);
+            if (!output->window) {
+                std::cerr << "Falha ao criar janela" << std::endl;
+                withoutWindow.push_back(output);
+                if (outputs.empty()) return false;
+                continue;  // monitor secundário sem overlay; os outros seguem
+            }
+            
+            glfwSetWindowPos(output->window, region.left, region.top);
+            output->hwnd = glfwGetWin32Window(output->window);
+            configureOverlayWindow(output->hwnd);
+            output->shaderSlot = (int)outputs.size();
+            outputs.push_back(output);
+        }
+        std::cout << "✅ Saídas: " << outputs.size() << " monitor(es)" << std::endl;
+        return true;
+    }
+    
+    // RegisterHotKey prende o hotkey à thread que chama: precisa ser a principal
+    void registerHotkeys(HWND mainHwnd) {
+        if (!RegisterHotKey(mainHwnd, HOTKEY_TOGGLE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'D')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+D" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_INCREASE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, VK_OEM_PLUS)) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift++" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_DECREASE, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, VK_OEM_MINUS)) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+-" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_METHOD, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'L')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+L" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_QUIT, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'Q')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+Q" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_LINEAR, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'G')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+G" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_ROI_ADD, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'R')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+R" << std::endl;
+        }
+        if (!RegisterHotKey(mainHwnd, HOTKEY_ROI_CLEAR, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, 'E')) {
+            std::cerr << "⚠️ Falha ao registrar hotkey Ctrl+Shift+E" << std::endl;
+        }
+    }
+    
+    // Ordem: arquivo externo (sobrescreve) -> LUT embutida -> LUT derivada da correção híbrida.
+    // Só decodifica (worker); a textura sai em lutLoader->upload() no contexto GL.
+    // Sem LUT o passo não falha: a correção matemática segue.
+    bool decodeCorrectionLUT() {
+        const char* overridePath = "luts/deuteranopia_correction.png";
+        if (GetFileAttributesA(overridePath) != INVALID_FILE_ATTRIBUTES) {
+            if (lutLoader->decodeFile(overridePath)) {
+                std::cout << "LUT externa carregada: " << overridePath << std::endl;
+                return true;
+            }
+            std::cerr << "⚠️ LUT externa inválida, usando a embutida" << std::endl;
+        }
+        
+        const char* builtinNames[] = { "deuteranopia_correction", "hybrid" };
+        for (const char* name : builtinNames) {
+            const BuiltinLUT* builtin = findBuiltinLUT(name);
+            if (builtin && lutLoader->decodeBuiltin(*builtin)) {
+                std::cout << "LUT embutida: " << name << std::endl;
+                return true;
+            }
+        }
+        
+        std::cout << "LUT não encontrada, usando correção matemática" << std::endl;
+        return true;
+    }
+    
+    // Worker: lê shaders/ para o primeiro programa já sair dos arquivos, sem
+    // esperar a primeira volta do ShaderReloader. false: usar o embutido.
+    bool readShaderFiles(std::string& vertexSource, std::string& fragmentSource) {
+        vertexSource = readTextFile(shaderDir + "/vertex.glsl");
+        fragmentSource = readTextFile(shaderDir + "/fragment.glsl");
+        return !vertexSource.empty() && !fragmentSource.empty();
+    }
+    
+    static std::string readTextFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) return "";
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+    
+    // Contexto da saída ativo. Arquivo que não compila ou não valida cai no
+    // embutido, como faria o ShaderReloader.
+    Shader* createShader(const std::string& vertexSource, const std::string& fragmentSource) {
+        if (shaderFromFiles) {
+            std::string log;
+            unsigned int program = linkProgram(vertexSource, fragmentSource, &log);
+            if (program && validateProgram(program, shaderSamplers(), &log)) return new Shader(program);
+            if (program) glDeleteProgram(program);
+            std::cout << "❌ Shader de " << shaderDir << "/fragment.glsl não compilou (" << log
+                      << "): shader embutido" << std::endl;
+            shaderFromFiles = false;
+        }
+        return new Shader(vertexShaderSource, fragmentShaderSource);
+    }
+    
+    static std::vector<std::pair<std::string, int>> shaderSamplers() {
+        return { { "screenTexture", 0 }, { "lutTexture", 1 }, { "noiseTexture", 2 }, { "chromaTexture", 3 } };
+    }
+    
+    // Bloco de ruído azul 64x64 em R8; os shaders leem com texelFetch e
+    // coordenada & 63, então filtro e repetição não importam
+    static unsigned int createNoiseTexture() {
+        unsigned int texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, BlueNoise::size, BlueNoise::size, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     BlueNoise::tile().textureBytes());
+        return texture;
+    }
+    
+    void bindNoise() {
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, noiseTexture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    
+    // Contexto da saída ativo, captura aberta e LUT/programa prontos
+    void setupOutput(OverlayOutput& output) {
+        // Gravando: fica no caminho com cópia, o frame precisa ser lido pela CPU
+        bool recording = &output == outputs[0] && !recordPath.empty() && startRecording(*output.capture);
+        
+        // Estágios: também com cópia, o handle do frame passa de estágio em estágio
+        if (staged) startStagedPipeline(output, recording);
+        
+        // Captura escrevendo direto nos PBOs: uma passagem pela CPU por frame
+        output.uploadBuffers = new PersistentUploadBuffers();
+        if (!recording && !output.pipeline &&
+            output.uploadBuffers->create(output.capture->getWidth(), output.capture->getHeight()) &&
+            output.capture->attachWriteTarget(output.uploadBuffers->getRing())) {
+            std::cout << "✅ Upload zero cópia (PBO persistente)" << std::endl;
+        } else {
+            delete output.uploadBuffers;
+            output.uploadBuffers = nullptr;
+            if (!recording && !output.pipeline) {
+                std::cout << "⚠️ GL 4.4 indisponível: upload com cópia (glTexImage2D)" << std::endl;
+            }
+        }
+        output.capture->start();
+        
+        if (computeRequested) setupCompute(output);
+        if (!output.compute) setupGeometry(output);
+        
+        // Só blocos alterados precisa ler o frame na CPU: com PBO não lê, e
+        // nos estágios o upload já é só dos blocos alterados
+        bool changedTiles = !output.uploadBuffers && !output.pipeline;
+        output.governor = std::make_unique<QualityGovernor>(
+            QualityGovernor::Config(),
+            output.compute ? QualityGovernor::computeLadder(changedTiles) : QualityGovernor::overlayLadder(changedTiles));
+        setupTexture(output);
+        
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        
+        if (!output.compute) warmUp(output);
+    }
+    
+    // O primeiro draw paga a preparação do programa e da textura no driver
+    // (dezenas de ms em tela cheia): um draw de 1 pixel aqui, enquanto a
+    // captura ainda não trouxe o primeiro frame, tira esse custo do primeiro
+    // frame filtrado. Não há swap: o próximo frame cobre o pixel.
+    void warmUp(OverlayOutput& output) {
+        GLPixelFormat upload;
+        if (!uploadFormat(output, upload)) return;
+        allocateTextureStorage(output, upload);
+        glViewport(0, 0, 1, 1);
+        render(output);
+        glFinish();
+        int fbWidth = 0, fbHeight = 0;
+        glfwGetFramebufferSize(output.window, &fbWidth, &fbHeight);
+        glViewport(0, 0, fbWidth, fbHeight);
+    }
+    
+    // VAOs não são compartilhados entre contextos: um por saída
+    void setupGeometry(OverlayOutput& output) {
         float quadVertices[] = {
             -1.0f,  1.0f,  0.0f, 1.0f,
             -1.0f, -1.0f,  0.0f, 0.0f,
@@ -649,11 +1047,11 @@ private:
              1.0f,  1.0f,  1.0f, 1.0f
         };
         
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
+        glGenVertexArrays(1, &output.VAO);
+        glGenBuffers(1, &output.VBO);
         
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindVertexArray(output.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, output.VBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
         
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -662,42 +1060,436 @@ private:
         glEnableVertexAttribArray(1);
     }
     
-    void setupTexture() {
-        glGenTextures(1, &screenTexture);
-        glBindTexture(GL_TEXTURE_2D, screenTexture);
+    void setupTexture(OverlayOutput& output) {
+        glGenTextures(1, &output.screenTexture);
+        glBindTexture(GL_TEXTURE_2D, output.screenTexture);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     }
     
-    void updateScreenTexture() {
-        glBindTexture(GL_TEXTURE_2D, screenTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 
-                     capture->getWidth(), capture->getHeight(), 
-                     0, GL_BGRA, GL_UNSIGNED_BYTE, capture->getPixelData());
+    // Janela oculta só pelo contexto compartilhado (criada na thread
+    // principal, como toda janela GLFW); a thread do reloader o torna atual
+    void startShaderReloader() {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        shaderWindow = glfwCreateWindow(1, 1, "Daltonismo Shaders", NULL, outputs[0]->window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (!shaderWindow) {
+            std::cout << "⚠️ Sem contexto para recarregar shaders: shader embutido" << std::endl;
+            return;
+        }
+        
+        ShaderReloader::Options options;
+        options.vertexPath = shaderDir + "/vertex.glsl";
+        options.fragmentPath = shaderDir + "/fragment.glsl";
+        options.fallbackVertex = vertexShaderSource;
+        options.fallbackFragment = fragmentShaderSource;
+        options.samplers = shaderSamplers();
+        options.consumers = (int)outputs.size();
+        options.compiledByCaller = true;  // programas iniciais saíram do passo "programas"
+        options.filesInUse = shaderFromFiles;
+        options.makeCurrent = [this] { glfwMakeContextCurrent(shaderWindow); };
+        options.release = [] { glfwMakeContextCurrent(NULL); };
+        shaderReloader.start(options);
     }
     
-    void render() {
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+    // Compute só para captura BGRA8: a imagem do shader é rgba8. A primeira
+    // saída mede qual programa é mais rápido nesta GPU; as outras reusam.
+    void setupCompute(OverlayOutput& output) {
+        if (output.capture->getFormat() != PixelFormat::BGRA8) {
+            std::cout << "⚠️ Compute shader só com captura de 8 bits: fragment shader" << std::endl;
+            return;
+        }
+        ComputeFilter* compute = new ComputeFilter();
+        std::string log;
+        if (!compute->create((GLADloadproc)glfwGetProcAddress, &log)) {
+            std::cout << "⚠️ Compute shader indisponível (" << log << "): fragment shader" << std::endl;
+            delete compute;
+            return;
+        }
+        int width = output.capture->getWidth();
+        int height = output.capture->getHeight();
+        if (!computeCalibrated) {
+            lutLoader->bindLUT(1);
+            double times[ComputeFilter::lutFetchCount];
+            computeFetch = compute->calibrate(width, height, times);
+            computeCalibrated = true;
+            std::printf("   Compute: LUT na textura %.2f ms | em shared %.2f ms\n", times[0], times[1]);
+        }
+        compute->setLutFetch(computeFetch);
         
+        glGenTextures(1, &output.filteredTexture);
+        glBindTexture(GL_TEXTURE_2D, output.filteredTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+        glGenFramebuffers(1, &output.filteredFbo);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, output.filteredFbo);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output.filteredTexture, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        output.compute = compute;
+        std::cout << "✅ Filtro em compute shader (GL 4.3, " << ComputeFilter::lutFetchName(computeFetch) << ")" << std::endl;
+    }
+    
+    void renderLoop(OverlayOutput* output) {
+        glfwMakeContextCurrent(output->window);
+        glfwSwapInterval(0);
+        
+        if (output->pipeline) {
+            // Suspensa até um frame chegar ao upload; o timeout só confere shouldClose
+            while (!shouldClose) output->pipeline->runPresent(milliseconds(50));
+            output->capture->stop();  // o pipeline só para com a fonte parada
+            output->pipeline->stop();
+            glfwMakeContextCurrent(NULL);
+            return;
+        }
+        
+        while (!shouldClose) {
+            if (correctionEnabled.load()) {
+                updateRegions(*output);
+                auto uploadStart = steady_clock::now();
+                updateScreenTexture(*output);
+                render(*output);
+                updateQuality(*output, duration<double, std::milli>(steady_clock::now() - uploadStart).count());
+            } else {
+                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+            
+            glfwSwapBuffers(output->window);
+            output->renderFrames++;
+            markFirstFrame(*output);
+            
+            Sleep(1);
+        }
+        
+        glfwMakeContextCurrent(NULL);
+    }
+    
+    // Primeiro frame com captura filtrada na tela (qualquer saída): fecha a
+    // linha do tempo da inicialização
+    void markFirstFrame(OverlayOutput& output) {
+        if (!output.hasFrame || !correctionEnabled.load() || firstFrameShown.exchange(true)) return;
+        startup.mark("primeiro frame filtrado");
+        std::cout << "⏱️ Primeiro frame filtrado em " << (int)startup.elapsedMs() << " ms" << std::endl;
+    }
+    
+    // Alimenta o governador com captura + upload/render do frame; se o degrau
+    // mudar, a captura passa a rodar na nova fração da taxa (os outros modos
+    // são lidos a cada frame no upload e no render)
+    void updateQuality(OverlayOutput& output, double uploadMs) {
+        output.governor->recordStage(QualityGovernor::Capture, output.capture->getCaptureMs());
+        output.governor->recordStage(QualityGovernor::Upload, uploadMs);
+        if (output.governor->endFrame()) {
+            const QualityLevel& level = output.governor->getSettings();
+            output.capture->setRateDivisor(level.captureDivisor);
+            std::cout << "🎚️ Qualidade: " << level.name << std::endl;
+        }
+    }
+    
+    // Converte as regiões de tela para o frame da saída quando o conjunto muda
+    void updateRegions(OverlayOutput& output) {
+        uint64_t version = regions.getVersion();
+        if (version == output.regionVersion) return;
+        std::vector<RoiRect> rects = regions.get();
+        output.regionsActive = !rects.empty();
+        output.localRegions = RegionSet::disjoint(rects, output.capture->getWidth(), output.capture->getHeight(),
+                                                  1, output.region.left, output.region.top);
+        output.regionVersion = version;
+    }
+    
+    void updateScreenTexture(OverlayOutput& output) {
+        // Em modo linear o hardware decodifica sRGB -> linear na amostragem;
+        // fontes de 10 bits/FP16 sobem no formato nativo, sem passar por 8 bits
+        GLPixelFormat upload;
+        if (!uploadFormat(output, upload)) return;
+        if (allocateTextureStorage(output, upload)) {
+            if (output.compute) output.compute->markAll();
+            output.changes.reset();
+        }
+        const std::vector<RoiRect>* regionList = output.regionsActive ? &output.localRegions : nullptr;
+        
+        bool uploaded = false;
+        if (output.uploadBuffers) {
+            uploaded = output.uploadBuffers->upload(output.screenTexture, upload, regionList);
+        } else if (output.governor->getSettings().changedTilesOnly) {
+            // uploadChanges já marca no compute só o que subiu
+            uploaded = output.capture->readLatest([&](const FrameView& frame) { uploadChanges(output, frame, upload); });
+            output.hasFrame = output.hasFrame || uploaded;
+            return;
+        } else {
+            output.changes.reset();  // ao entrar no degrau, o primeiro frame sobe inteiro
+            uploaded = output.capture->readLatest([&](const FrameView& frame) {
+                if (!regionList) {
+                    uploadView(output, frame, 0, 0, upload);
+                    return;
+                }
+                for (const RoiRect& r : *regionList) {
+                    uploadView(output, frame.subView(r.x, r.y, r.width, r.height), r.x, r.y, upload);
+                }
+            });
+        }
+        
+        // Compute: só o que subiu precisa ser refiltrado
+        output.hasFrame = output.hasFrame || uploaded;
+        if (!uploaded || !output.compute) return;
+        if (!regionList) {
+            output.compute->markDirty({ 0, 0, output.capture->getWidth(), output.capture->getHeight() });
+            return;
+        }
+        for (const RoiRect& r : *regionList) output.compute->markDirty(r);
+    }
+    
+    // Só os blocos que mudaram desde o último upload, dentro das regiões; o
+    // compute refiltra só eles. Regiões novas sobem inteiras: fora das
+    // antigas a textura não tinha o frame.
+    void uploadChanges(OverlayOutput& output, const FrameView& frame, const GLPixelFormat& upload) {
+        if (output.changesRegionVersion != output.regionVersion) {
+            output.changes.reset();
+            output.changesRegionVersion = output.regionVersion;
+        }
+        std::vector<RoiRect> rects = output.changes.detect(frame);
+        if (output.regionsActive) rects = RegionSet::intersect(rects, output.localRegions);
+        for (const RoiRect& r : rects) {
+            uploadView(output, frame.subView(r.x, r.y, r.width, r.height), r.x, r.y, upload);
+            if (output.compute) output.compute->markDirty(r);
+        }
+    }
+    
+    // Em luz linear o fragment shader lê GL_SRGB8_ALPHA8 (decodificado na
+    // amostragem); o compute lê a imagem em rgba8 e converte no shader
+    bool uploadFormat(const OverlayOutput& output, GLPixelFormat& upload) {
+        return glFormatFor(output.capture->getFormat(), linearLight.load() && !output.compute, upload);
+    }
+    
+    // Storage alocado uma vez (e quando o formato muda); os frames sobem
+    // com glTexSubImage2D, inteiros ou só nas regiões de interesse.
+    // true se o storage foi (re)criado: o conteúdo anterior se perdeu.
+    bool allocateTextureStorage(OverlayOutput& output, const GLPixelFormat& upload) {
+        glBindTexture(GL_TEXTURE_2D, output.screenTexture);
+        if (output.screenTextureFormat == upload.internalFormat) return false;
+        glTexImage2D(GL_TEXTURE_2D, 0, upload.internalFormat,
+                     output.capture->getWidth(), output.capture->getHeight(),
+                     0, upload.format, upload.type, NULL);
+        output.screenTextureFormat = upload.internalFormat;
+        return true;
+    }
+    
+    // Estágio de upload: a textura guarda o frame anterior, então só sobem os
+    // blocos alterados (dentro das regiões de interesse). Com o filtro
+    // desligado nada sobe; ao religar, o primeiro frame sobe inteiro.
+    void uploadStagedFrame(OverlayOutput& output, StagedFrame& frame) {
+        if (!correctionEnabled.load()) {
+            output.textureStale = true;
+            return;
+        }
+        auto uploadStart = steady_clock::now();
+        uint64_t regionVersion = output.regionVersion;
+        updateRegions(output);
+        GLPixelFormat upload;
+        if (!uploadFormat(output, upload)) return;
+        
+        const FrameView& view = frame.source.view();
+        std::vector<RoiRect> rects = frame.changed;
+        if (allocateTextureStorage(output, upload) || output.textureStale || regionVersion != output.regionVersion) {
+            rects.assign(1, RoiRect{ 0, 0, view.width, view.height });
+        }
+        if (output.regionsActive) rects = RegionSet::intersect(rects, output.localRegions);
+        for (const RoiRect& r : rects) {
+            uploadView(output, view.subView(r.x, r.y, r.width, r.height), r.x, r.y, upload);
+            if (output.compute) output.compute->markDirty(r);
+        }
+        output.textureStale = false;
+        output.hasFrame = true;
+        output.stagedUploadMs = duration<double, std::milli>(steady_clock::now() - uploadStart).count();
+    }
+    
+    void presentStagedFrame(OverlayOutput& output, StagedFrame&) {
+        auto renderStart = steady_clock::now();
+        if (correctionEnabled.load()) {
+            render(output);
+        } else {
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glfwSwapBuffers(output.window);
+        output.renderFrames++;
+        markFirstFrame(output);
+        if (correctionEnabled.load()) {
+            double renderMs = duration<double, std::milli>(steady_clock::now() - renderStart).count();
+            updateQuality(output, output.stagedUploadMs + renderMs);
+        }
+    }
+    
+    // O stride da visão vai para GL_UNPACK_ROW_LENGTH; só um stride que não
+    // é múltiplo do pixel obriga a compactar antes
+    void uploadView(OverlayOutput& output, const FrameView& view, int x, int y, const GLPixelFormat& upload) {
+        if (view.width == 0) return;
+        const uint8_t* pixels = view.planes[0];
+        if (!setUnpackLayout(view)) {
+            output.repackBuffer.resize(FrameView::compactSize(view.format, view.width, view.height));
+            copyFrame(view, FrameView::wrap(view.format, output.repackBuffer.data(), view.width, view.height));
+            pixels = output.repackBuffer.data();
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, view.width, view.height, upload.format, upload.type, pixels);
+        resetUnpackLayout();
+    }
+    
+    void render(OverlayOutput& output) {
+        if (output.compute) {
+            renderCompute(output);
+            return;
+        }
+        
+        // Programa novo de shaders/: troca antes do draw; nos estágios o
+        // próximo frame sobe inteiro para a tela toda mostrar a mudança
+        unsigned int reloaded = shaderReloader.take(output.shaderSlot);
+        if (reloaded) {
+            output.shader->replace(reloaded);
+            if (output.pipeline) output.pipeline->resetChanges();
+        }
+        
+        Shader* shader = output.shader;
         shader->use();
         shader->setInt("screenTexture", 0);
         shader->setInt("lutTexture", 1);
         shader->setBool("enableCorrection", correctionEnabled.load());
         shader->setFloat("correctionStrength", correctionStrength.load());
         shader->setBool("useLUT", useLUT.load());
+        shader->setInt("correctionMethod", mathMethod);
+        shader->setBool("linearLight", linearLight.load());
+        // RGBA16F sobe como float linear (scRGB) com ou sem linearLight
+        const bool inputLinear = output.capture->getFormat() == PixelFormat::RGBA16F;
+        shader->setBool("inputLinear", inputLinear);
+        shader->setInt("noiseTexture", 2);
+        shader->setBool("dither", noiseTexture != 0);
+        const QualityLevel& quality = output.governor->getSettings();
+        shader->setBool("lutNearest", quality.interpolation == CpuFilter::Interpolation::Nearest);
+        shader->setInt("chromaTexture", 3);
+        shader->setInt("chromaPass", 0);
+        
+        // ...e codifica linear -> sRGB na escrita do framebuffer
+        if (linearLight.load() || inputLinear) {
+            glEnable(GL_FRAMEBUFFER_SRGB);
+        } else {
+            glDisable(GL_FRAMEBUFFER_SRGB);
+        }
         
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        glBindTexture(GL_TEXTURE_2D, output.screenTexture);
         
         if (useLUT.load() && lutLoader->getIsLoaded()) {
             lutLoader->bindLUT(1);
         }
+        if (noiseTexture) bindNoise();
+        
+        // O quad cobre a janela com alfa 1: só com regiões o resto precisa ser limpo
+        glBindVertexArray(output.VAO);
+        if (quality.chromaMode == CpuFilter::ChromaMode::Half) renderChromaDeltas(output);
+        if (!output.regionsActive) {
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            return;
+        }
+        
+        // Só as regiões são desenhadas (scissor); o resto fica com alfa 0 e
+        // mostra a tela sem correção. A origem do scissor é embaixo.
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        int fbWidth = 0, fbHeight = 0;
+        glfwGetFramebufferSize(output.window, &fbWidth, &fbHeight);
+        float scaleX = fbWidth / (float)output.capture->getWidth();
+        float scaleY = fbHeight / (float)output.capture->getHeight();
+        glEnable(GL_SCISSOR_TEST);
+        for (const RoiRect& r : output.localRegions) {
+            glScissor((GLint)(r.x * scaleX), (GLint)(fbHeight - (r.y + r.height) * scaleY),
+                      (GLsizei)(r.width * scaleX + 0.5f), (GLsizei)(r.height * scaleY + 0.5f));
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+    
+    // Croma 2x2, passo 1: a correção roda no alvo de meia resolução, uma vez
+    // por bloco 2x2 (o frame inteiro, mesmo com regiões: custa 1/4); o quad
+    // da janela só soma o delta do bloco (chromaPass 2)
+    void renderChromaDeltas(OverlayOutput& output) {
+        int width = (output.capture->getWidth() + 1) / 2;
+        int height = (output.capture->getHeight() + 1) / 2;
+        glActiveTexture(GL_TEXTURE3);
+        if (width != output.chromaWidth || height != output.chromaHeight) {
+            if (!output.chromaFbo) {
+                glGenFramebuffers(1, &output.chromaFbo);
+                glGenTextures(1, &output.chromaTexture);
+            }
+            glBindTexture(GL_TEXTURE_2D, output.chromaTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+            glBindFramebuffer(GL_FRAMEBUFFER, output.chromaFbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output.chromaTexture, 0);
+            output.chromaWidth = width;
+            output.chromaHeight = height;
+        }
         
-        glBindVertexArray(VAO);
+        // Alvo do passo fora da unidade 3 enquanto é escrito (sem laço de leitura).
+        // Sem blend: o alfa do passo marca os blocos com borda de croma.
+        glBindTexture(GL_TEXTURE_2D, 0);
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        glBindFramebuffer(GL_FRAMEBUFFER, output.chromaFbo);
+        glViewport(0, 0, width, height);
+        glDisable(GL_BLEND);
+        output.shader->setInt("chromaPass", 1);
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        glEnable(GL_BLEND);
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glBindTexture(GL_TEXTURE_2D, output.chromaTexture);
+        glActiveTexture(GL_TEXTURE0);
+        output.shader->setInt("chromaPass", 2);
+    }
+    
+    // Filtra para filteredTexture os blocos enviados desde o último frame
+    // (tudo se o estado mudou) e copia para a janela com blit: sem quad nem
+    // fragment shader. A captura vem de cima para baixo, então o blit inverte y.
+    void renderCompute(OverlayOutput& output) {
+        if (output.computeStale.exchange(false)) output.compute->markAll();
+        int width = output.capture->getWidth();
+        int height = output.capture->getHeight();
+        
+        ComputeFilter::Settings settings;
+        settings.enableCorrection = correctionEnabled.load();
+        settings.strength = correctionStrength.load();
+        settings.useLUT = useLUT.load() && lutLoader->getIsLoaded();
+        settings.linearLight = linearLight.load();
+        settings.dither = noiseTexture != 0;
+        if (settings.useLUT) lutLoader->bindLUT(1);
+        if (settings.dither) bindNoise();
+        output.compute->dispatch(output.screenTexture, output.filteredTexture, width, height, settings);
+        
+        // A saída já está em sRGB: o blit não pode codificar de novo
+        glDisable(GL_FRAMEBUFFER_SRGB);
+        int fbWidth = 0, fbHeight = 0;
+        glfwGetFramebufferSize(output.window, &fbWidth, &fbHeight);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, output.filteredFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        if (!output.regionsActive) {
+            glBlitFramebuffer(0, 0, width, height, 0, fbHeight, fbWidth, 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        } else {
+            // Fora das regiões fica alfa 0, como no fragment shader
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            float scaleX = fbWidth / (float)width;
+            float scaleY = fbHeight / (float)height;
+            for (const RoiRect& r : output.localRegions) {
+                glBlitFramebuffer(r.x, r.y, r.x + r.width, r.y + r.height,
+                                  (GLint)(r.x * scaleX), (GLint)(fbHeight - r.y * scaleY),
+                                  (GLint)((r.x + r.width) * scaleX), (GLint)(fbHeight - (r.y + r.height) * scaleY),
+                                  GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            }
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
     }
 };
 
@@ -720,6 +1512,15 @@ LRESULT CALLBACK OverlayWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
                     case HOTKEY_METHOD:
                         g_filterInstance->toggleMethod();
                         break;
+                    case HOTKEY_LINEAR:
+                        g_filterInstance->toggleLinearLight();
+                        break;
+                    case HOTKEY_ROI_ADD:
+                        g_filterInstance->addForegroundWindowRegion();
+                        break;
+                    case HOTKEY_ROI_CLEAR:
+                        g_filterInstance->clearRegions();
+                        break;
                     case HOTKEY_QUIT:
                         PostQuitMessage(0);
                         break;
@@ -745,13 +1546,68 @@ LRESULT CALLBACK OverlayWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
 
 // ==================== MAIN ====================
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "\n╔════════════════════════════════════════╗" << std::endl;
     std::cout << "║  Filtro Daltonismo                     ║" << std::endl;
     std::cout << "║  HOTKEYS GLOBAIS                       ║" << std::endl;
     std::cout << "╚════════════════════════════════════════╝\n" << std::endl;
     
-    FinalOverlayFilter filter;
+    FinalOverlayFilter filter(g_processStart);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--on") {
+            filter.startEnabled();
+            continue;
+        }
+        if (arg == "--dither") {
+            filter.useDither(true);
+            continue;
+        }
+        if (i + 1 >= argc) break;  // as outras opções têm valor
+        if (arg == "--attach") {
+            filter.attachToDaemon(argv[++i]);
+        } else if (arg == "--record") {
+            filter.recordTo(argv[++i]);
+        } else if (arg == "--pipeline") {
+            // --pipeline staged | sequential (padrão)
+            std::string mode = argv[++i];
+            if (mode == "staged" || mode == "sequential") {
+                filter.useStagedPipeline(mode == "staged");
+            } else {
+                std::cerr << "⚠️ --pipeline inválido: " << mode << std::endl;
+            }
+        } else if (arg == "--gpu-path") {
+            // --gpu-path fragment (padrão) | compute (GL 4.3)
+            std::string path = argv[++i];
+            if (path == "fragment" || path == "compute") {
+                filter.useComputePath(path == "compute");
+            } else {
+                std::cerr << "⚠️ --gpu-path inválido: " << path << std::endl;
+            }
+        } else if (arg == "--method") {
+            // --method hybrid (padrão) | lms | daltonize: correção sem LUT
+            std::string method = argv[++i];
+            if (method == "hybrid" || method == "lms" || method == "daltonize") {
+                filter.useMathMethod(method == "hybrid" ? 0 : method == "lms" ? 1 : 2);
+            } else {
+                std::cerr << "⚠️ --method inválido: " << method << std::endl;
+            }
+        } else if (arg == "--shaders") {
+            // --shaders pasta (vertex.glsl + fragment.glsl; recarregados ao salvar)
+            filter.setShaderDirectory(argv[++i]);
+        } else if (arg == "--trace") {
+            // --trace arquivo.json (inicialização + primeiro frame; chrome://tracing)
+            filter.writeTraceTo(argv[++i]);
+        } else if (arg == "--roi") {
+            // --roi x,y,largura,altura (coordenadas de tela; pode repetir)
+            RoiRect rect;
+            if (std::sscanf(argv[++i], "%d,%d,%d,%d", &rect.x, &rect.y, &rect.width, &rect.height) == 4) {
+                filter.addRegion(rect);
+            } else {
+                std::cerr << "⚠️ --roi inválido: " << argv[i] << std::endl;
+            }
+        }
+    }
     
     if (!filter.initialize()) {
         std::cerr << "\n❌ Falha ao inicializar!" << std::endl;
@@ -11,6 +11,7 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "Frame.h"
 
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
@@ -146,14 +147,16 @@ private:
     ComPtr<ID3D11Texture2D> stagingTexture;
     
     int screenWidth, screenHeight;
-    std::vector<unsigned char> pixelData;
+    // Staging fica mapeada até a próxima captura: o frame é lido direto
+    // dela, com stride = RowPitch (sem copiar linha a linha para compactar)
+    FrameView frame;
+    bool mapped;
     bool initialized;
     
 public:
-    DesktopDuplicationCapture() : initialized(false) {
+    DesktopDuplicationCapture() : mapped(false), initialized(false) {
         screenWidth = GetSystemMetrics(SM_CXSCREEN);
         screenHeight = GetSystemMetrics(SM_CYSCREEN);
-        pixelData.resize(screenWidth * screenHeight * 4);
     }
     
     ~DesktopDuplicationCapture() {
@@ -290,7 +293,8 @@ public:
             return false;
         }
         
-        // Copiar para staging texture
+        // Copiar para staging texture (o frame anterior deixa de ser lido)
+        unmapFrame();
         d3dContext->CopyResource(stagingTexture.Get(), desktopTexture.Get());
         
         // Map para ler na CPU
@@ -300,25 +304,24 @@ public:
             deskDupl->ReleaseFrame();
             return false;
         }
+        mapped = true;
         
-        // Copiar pixels
-        unsigned char* source = static_cast<unsigned char*>(mappedResource.pData);
-        
-        for (int y = 0; y < screenHeight; y++) {
-            memcpy(
-                &pixelData[y * screenWidth * 4],
-                &source[y * mappedResource.RowPitch],
-                screenWidth * 4
-            );
-        }
-        
-        // Unmap
-        d3dContext->Unmap(stagingTexture.Get(), 0);
+        // Visão sobre a staging com o RowPitch do driver
+        frame = FrameView::wrap(PixelFormat::BGRA8, static_cast<uint8_t*>(mappedResource.pData),
+                                screenWidth, screenHeight);
+        frame.strides[0] = (int)mappedResource.RowPitch;
         
         return true;
     }
     
+    void unmapFrame() {
+        if (mapped) d3dContext->Unmap(stagingTexture.Get(), 0);
+        mapped = false;
+        frame = FrameView();
+    }
+    
     void cleanup() {
+        unmapFrame();
         if (deskDupl) {
             deskDupl->ReleaseFrame();
             deskDupl.Reset();
@@ -329,7 +332,8 @@ public:
         initialized = false;
     }
     
-    unsigned char* getPixelData() { return pixelData.data(); }
+    // Válido até a próxima captureScreen(); planes[0] nulo antes do primeiro frame
+    const FrameView& getFrame() const { return frame; }
     int getWidth() const { return screenWidth; }
     int getHeight() const { return screenHeight; }
     bool isInitialized() const { return initialized; }
@@ -626,11 +630,15 @@ private:
     }
     
     void updateScreenTexture() {
+        const FrameView& frame = capture->getFrame();
+        if (!frame.planes[0]) return;
         glBindTexture(GL_TEXTURE_2D, screenTexture);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // <- garante alinhamento
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, frame.unpackRowLength()); // RowPitch em pixels
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 
-             capture->getWidth(), capture->getHeight(),
-             0, GL_BGRA, GL_UNSIGNED_BYTE, capture->getPixelData());
+             frame.width, frame.height,
+             0, GL_BGRA, GL_UNSIGNED_BYTE, frame.planes[0]);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     }
     
     void render() {
@@ -0,0 +1,2254 @@
+// ==================== BENCHMARKS DO FILTRO (CPU) ====================
+// Ferramenta de linha de comando que mede os caminhos de CPU sem precisar de
+// janela nem captura de tela (roda em Linux também).
+//
+// Uso: colorbench [secao ...]   (sem argumentos roda todas as seções)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CorrectionModels.h"
+#include "CpuFilter.h"
+#include "FramePool.h"
+#include "FrameSource.h"
+#include "Half.h"
+#include "Lut3DFixed.h"
+#include "LutComposer.h"
+#include "LutFiles.h"
+#include "MultiOutput.h"
+#include "Parity.h"
+#include "PerfCounters.h"
+#include "PixelConvert.h"
+#include "QualityGovernor.h"
+#include "Recording.h"
+#include "RegionOfInterest.h"
+#include "SharedFrameRing.h"
+#include "SharedMemory.h"
+#include "SRGB.h"
+#include "StagedPipeline.h"
+#include "TestFrames.h"
+#include "ThreadPool.h"
+#include "UploadRing.h"
+#include "Y4M.h"
+#include "YuvFilter.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+
+// ==================== UTILITÁRIOS ====================
+
+// Verificações (não só tempo) contam aqui; colorbench termina com código 1
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+    std::printf("  %-7s %s\n", ok ? "OK" : "FALHOU", what);
+    if (!ok) g_failures++;
+}
+
+// Executa fn 'iterations' vezes e devolve o melhor tempo em ms
+static double bestOf(int iterations, const std::function<void()>& fn) {
+    double best = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        auto start = steady_clock::now();
+        fn();
+        double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// PSNR (dB) entre dois frames BGRA8, ignorando o alfa
+static double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int* maxDiff) {
+    double sumSq = 0.0;
+    int worst = 0;
+    size_t samples = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        if ((i & 3) == 3) continue;
+        int d = (int)a[i] - (int)b[i];
+        sumSq += (double)d * d;
+        worst = std::max(worst, std::abs(d));
+        samples++;
+    }
+    if (maxDiff) *maxDiff = worst;
+    if (sumSq == 0.0) return INFINITY;
+    double mse = sumSq / samples;
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+// ==================== SEÇÃO: sRGB <-> LINEAR ====================
+
+static void benchSRGB() {
+    const int width = 1920, height = 1080;
+    std::vector<uint8_t> frame = TestFrames::make(TestFrames::Kind::Noise, width, height);
+    std::vector<uint8_t> output(frame.size());
+
+    std::printf("\n[srgb] Decodificação/codificação sRGB em tabela, 1080p\n");
+    std::printf("  AVX2: %s\n", CpuFeatures::get().avx2 ? "sim" : "não");
+
+    // Conferir ida-e-volta exata para todos os valores de 8 bits
+    int mismatches = 0;
+    for (int v = 0; v < 256; v++) {
+        if (SRGB::encode(SRGB::decode((uint8_t)v)) != v) mismatches++;
+    }
+    std::printf("  Ida-e-volta 8 bits: %s\n", mismatches == 0 ? "exata" : "COM ERROS");
+
+    // Processamento por faixas de linhas: o buffer linear de cada faixa fica
+    // no cache, que é como o pipeline linear usa as conversões
+    auto roundTrip = [&](int rowBegin, int rowEnd) {
+        thread_local std::vector<float> linearRow;
+        linearRow.resize((size_t)width * 4);
+        for (int y = rowBegin; y < rowEnd; y++) {
+            const uint8_t* src = &frame[(size_t)y * width * 4];
+            uint8_t* dst = &output[(size_t)y * width * 4];
+            SRGB::decodeBGRA(src, linearRow.data(), width);
+            SRGB::encodeBGRA(linearRow.data(), dst, width);
+        }
+    };
+
+    double single = bestOf(10, [&] { roundTrip(0, height); });
+    std::printf("  1 thread : %7.3f ms/frame (%.2f ns/pixel)\n",
+                single, single * 1e6 / ((double)width * height));
+
+    ThreadPool& pool = ThreadPool::shared();
+    double multi = bestOf(10, [&] { pool.parallelFor(0, height, 32, roundTrip); });
+    std::printf("  %d threads: %7.3f ms/frame %s\n", pool.getThreadCount(), multi,
+                multi < 1.0 ? "(< 1 ms ✅)" : "(acima de 1 ms ⚠️)");
+}
+
+// ==================== SEÇÃO: CROMA EM MEIA RESOLUÇÃO ====================
+
+static void benchChroma() {
+    std::printf("\n[chroma] LUT em resolução total vs croma 2x2 (LUT híbrida 32^3)\n");
+
+    const int sizes[][2] = { {1920, 1080}, {3840, 2160} };
+    const TestFrames::Kind kinds[] = {
+        TestFrames::Kind::Gradient, TestFrames::Kind::ColorBars,
+        TestFrames::Kind::Noise, TestFrames::Kind::Text
+    };
+
+    CpuFilter filter;
+    for (const auto& size : sizes) {
+        const int width = size[0], height = size[1];
+        std::printf("  %dx%d\n", width, height);
+        std::printf("    %-10s %10s %10s %8s %10s %8s\n",
+                    "frame", "total(ms)", "2x2(ms)", "ganho", "PSNR(dB)", "maxdiff");
+
+        for (TestFrames::Kind kind : kinds) {
+            std::vector<uint8_t> frame = TestFrames::make(kind, width, height);
+            std::vector<uint8_t> full(frame.size()), half(frame.size());
+
+            filter.setChromaMode(CpuFilter::ChromaMode::Full);
+            double fullMs = bestOf(3, [&] { filter.apply(frame.data(), full.data(), width, height); });
+
+            filter.setChromaMode(CpuFilter::ChromaMode::Half);
+            double halfMs = bestOf(3, [&] { filter.apply(frame.data(), half.data(), width, height); });
+
+            int maxDiff = 0;
+            double quality = psnr(full, half, &maxDiff);
+            std::printf("    %-10s %10.2f %10.2f %7.2fx %10.2f %8d\n", TestFrames::kindName(kind),
+                        fullMs, halfMs, fullMs / halfMs, quality, maxDiff);
+        }
+    }
+}
+
+// ==================== SEÇÃO: YUV 4:2:0 NATIVO ====================
+
+static void benchYuv() {
+    const int width = 3840, height = 2160;
+    std::printf("\n[yuv] Filtro YUV nativo (LUT YUV 33^3 fundida), %dx%d\n", width, height);
+
+    std::vector<uint8_t> source(FrameView::compactSize(PixelFormat::I420, width, height));
+    uint32_t seed = 777;
+    for (size_t i = 0; i < source.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        source[i] = (uint8_t)(16 + (seed >> 24) % 220);
+    }
+    std::vector<uint8_t> output(source.size());
+
+    YuvFilter filter;
+    const PixelFormat formats[] = { PixelFormat::I420, PixelFormat::NV12 };
+    for (PixelFormat format : formats) {
+        FrameView src = FrameView::wrap(format, source.data(), width, height);
+        FrameView dst = FrameView::wrap(format, output.data(), width, height);
+
+        ThreadPool single(1);
+        YuvFilter singleFilter(single);
+        double oneThread = bestOf(3, [&] { singleFilter.apply(src, dst); });
+        double pooled = bestOf(5, [&] { filter.apply(src, dst); });
+        // 8 núcleos estimados a partir de 1 thread (escala linear por faixas)
+        double fps8 = 1000.0 / (oneThread / 8.0);
+        std::printf("  %-5s 1 thread: %7.2f ms (%6.1f fps) | %d threads: %7.2f ms (%6.1f fps) | 8 núcleos (est.): %6.1f fps %s\n",
+                    pixelFormatName(format), oneThread, 1000.0 / oneThread,
+                    ThreadPool::shared().getThreadCount(), pooled, 1000.0 / pooled,
+                    fps8, fps8 >= 60.0 ? "✅ 4K60" : "⚠️ < 4K60");
+    }
+}
+
+// ==================== SEÇÃO: 10 BITS / FP16 ====================
+
+static void benchHighDepth() {
+    const int width = 1920, height = 1080;
+    std::printf("\n[hdr] Frames RGB10A2 e RGBA16F sintéticos, %dx%d (F16C: %s)\n",
+                width, height, CpuFeatures::get().f16c ? "sim" : "não");
+
+    // Gradiente horizontal de 10 bits: 1024 níveis distintos por canal
+    std::vector<uint8_t> frame10(FrameView::compactSize(PixelFormat::RGB10A2, width, height));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t level = (uint32_t)((x * 1023) / (width - 1));
+            uint32_t v = level | ((1023 - level) << 10) | ((uint32_t)(y % 1024) << 20) | (3u << 30);
+            std::memcpy(&frame10[((size_t)y * width + x) * 4], &v, 4);
+        }
+    }
+
+    // scRGB em FP16 com realces acima de 1.0 (HDR)
+    std::vector<uint8_t> frame16(FrameView::compactSize(PixelFormat::RGBA16F, width, height));
+    uint16_t* halfs = (uint16_t*)frame16.data();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint16_t* p = halfs + ((size_t)y * width + x) * 4;
+            float t = x / (float)(width - 1);
+            p[0] = Half::fromFloat(t * 4.0f);
+            p[1] = Half::fromFloat((1.0f - t) * 0.8f);
+            p[2] = Half::fromFloat(y / (float)(height - 1));
+            p[3] = Half::fromFloat(1.0f);
+        }
+    }
+
+    CpuFilter filter;
+    struct Case { PixelFormat format; std::vector<uint8_t>* data; };
+    Case cases[] = { {PixelFormat::RGB10A2, &frame10}, {PixelFormat::RGBA16F, &frame16} };
+
+    for (Case& c : cases) {
+        std::vector<uint8_t> output(c.data->size());
+        FrameView src = FrameView::wrap(c.format, c.data->data(), width, height);
+        FrameView dst = FrameView::wrap(c.format, output.data(), width, height);
+
+        // Intensidade 0 deve devolver exatamente a entrada (sem round trip em 8 bits)
+        filter.setStrength(0.0f);
+        filter.apply(src, dst);
+        bool identity = (output == *c.data);
+
+        filter.setStrength(1.0f);
+        double ms = bestOf(5, [&] { filter.apply(src, dst); });
+
+        if (c.format == PixelFormat::RGB10A2) {
+            std::vector<bool> seen(1024, false);
+            int levels = 0;
+            for (int x = 0; x < width; x++) {
+                uint32_t v;
+                std::memcpy(&v, &output[(size_t)x * 4], 4);
+                if (!seen[v & 0x3FF]) { seen[v & 0x3FF] = true; levels++; }
+            }
+            std::printf("  RGB10A2: %7.2f ms | identidade exata: %s | níveis de R na saída: %d (> 256 = sem 8 bits)\n",
+                        ms, identity ? "sim" : "NÃO", levels);
+        } else {
+            const uint16_t* out = (const uint16_t*)output.data();
+            float brightest = Half::toFloat(out[(size_t)(width - 1) * 4]);
+            std::printf("  RGBA16F: %7.2f ms | identidade exata: %s | R máximo na saída: %.2f (HDR preservado: %s)\n",
+                        ms, identity ? "sim" : "NÃO", brightest, brightest > 1.0f ? "sim" : "NÃO");
+        }
+    }
+
+    // Intensidade 1: o RGBA16F (scRGB linear) tem que dar a mesma cor que o
+    // BGRA8 (sRGB) com a mesma LUT. Consultar a LUT com o valor linear, sem
+    // codificar em sRGB, erra por dezenas de LSB. (Com intensidade parcial a
+    // mistura é em luz linear, como no shader, e não bate com a do BGRA8.)
+    const int testWidth = 256, testHeight = 64;
+    std::vector<uint8_t> bgra = TestFrames::make(TestFrames::Kind::Noise, testWidth, testHeight);
+    std::vector<uint8_t> linear16(FrameView::compactSize(PixelFormat::RGBA16F, testWidth, testHeight));
+    uint16_t* linearHalfs = (uint16_t*)linear16.data();
+    for (size_t i = 0; i < (size_t)testWidth * testHeight; i++) {
+        linearHalfs[i * 4 + 0] = Half::fromFloat(SRGB::toLinear(bgra[i * 4 + 2] / 255.0f));
+        linearHalfs[i * 4 + 1] = Half::fromFloat(SRGB::toLinear(bgra[i * 4 + 1] / 255.0f));
+        linearHalfs[i * 4 + 2] = Half::fromFloat(SRGB::toLinear(bgra[i * 4 + 0] / 255.0f));
+        linearHalfs[i * 4 + 3] = Half::fromFloat(1.0f);
+    }
+    std::vector<uint8_t> bgraOut(bgra.size()), linearOut(linear16.size());
+    filter.setStrength(1.0f);
+    filter.apply(FrameView::wrap(PixelFormat::BGRA8, bgra.data(), testWidth, testHeight),
+                 FrameView::wrap(PixelFormat::BGRA8, bgraOut.data(), testWidth, testHeight));
+    filter.apply(FrameView::wrap(PixelFormat::RGBA16F, linear16.data(), testWidth, testHeight),
+                 FrameView::wrap(PixelFormat::RGBA16F, linearOut.data(), testWidth, testHeight));
+    float worstLinear = 0.0f;
+    const uint16_t* linearResult = (const uint16_t*)linearOut.data();
+    for (size_t i = 0; i < (size_t)testWidth * testHeight; i++) {
+        for (int c = 0; c < 3; c++) {
+            float encoded = SRGB::toSRGB(Half::toFloat(linearResult[i * 4 + c])) * 255.0f;
+            worstLinear = std::max(worstLinear, std::fabs(encoded - bgraOut[i * 4 + 2 - c]));
+        }
+    }
+    std::printf("  RGBA16F contra BGRA8, intensidade 1: até %.2f LSB\n", worstLinear);
+    check(worstLinear <= 2.0f, "RGBA16F (linear) com a mesma correção do BGRA8 (sRGB), até 2 LSB");
+
+    // Conversão float16 em lote: F16C vs escalar
+    std::vector<float> floats((size_t)width * height * 4);
+    std::vector<uint16_t> packed(floats.size());
+    for (size_t i = 0; i < floats.size(); i++) floats[i] = (i % 4096) / 1024.0f;
+    double simd = bestOf(5, [&] { Half::fromFloat(floats.data(), packed.data(), floats.size()); });
+    double scalar = bestOf(3, [&] {
+        for (size_t i = 0; i < floats.size(); i++) packed[i] = Half::fromFloat(floats[i]);
+    });
+    std::printf("  float->half (frame inteiro): lote %.2f ms | escalar %.2f ms (%.1fx)\n",
+                simd, scalar, scalar / simd);
+}
+
+// ==================== SEÇÃO: VÁRIAS SAÍDAS ====================
+
+static void benchOutputs() {
+    struct OutputSpec { int width, height; TestFrames::Kind kind; };
+    const OutputSpec specs[] = {
+        { 1920, 1080, TestFrames::Kind::ColorBars },
+        { 2560, 1440, TestFrames::Kind::Gradient },
+        { 3840, 2160, TestFrames::Kind::Text },
+    };
+    const int seconds = 3;
+    std::printf("\n[outputs] %d fontes sintéticas a 60 fps em paralelo, LUT compartilhada, %d s\n",
+                (int)(sizeof(specs) / sizeof(specs[0])), seconds);
+
+    auto lut = std::make_shared<const Lut3D>(Lut3D::fromCorrection(32, CorrectionMethod::Hybrid));
+    MultiOutputPipeline pipeline(lut);
+    for (const OutputSpec& spec : specs) {
+        pipeline.addOutput(std::make_unique<SyntheticFrameSource>(spec.width, spec.height, 60, spec.kind));
+    }
+    if (!pipeline.start()) {
+        std::printf("  ❌ falha ao iniciar as saídas\n");
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    pipeline.stop();
+
+    // Cada saída deve conter a sua fonte filtrada, com o tamanho dela
+    for (int i = 0; i < pipeline.getOutputCount(); i++) {
+        MultiOutputPipeline::Stats stats = pipeline.getStats(i);
+        std::vector<uint8_t> frame;
+        bool hasFrame = pipeline.readOutput(i, frame);
+        bool sizeOk = hasFrame && frame.size() == (size_t)stats.width * stats.height * 4;
+        std::printf("  saída %d %4dx%-4d capturados %4d | filtrados %4d (%5.1f fps) | %7.2f ms/frame | frame %s\n",
+                    i, stats.width, stats.height, stats.framesCaptured, stats.framesProcessed,
+                    stats.framesProcessed / (double)seconds, stats.averageMs, sizeOk ? "ok" : "AUSENTE");
+    }
+}
+
+// ==================== SEÇÃO: ALOCAÇÃO DE FRAMES ====================
+
+// Percorre o frame por colunas (uma leitura por linha): cada acesso cai em
+// outra página de 4 KB, o pior caso para a TLB
+static uint32_t columnWalk(const FrameView& frame) {
+    uint32_t sum = 0;
+    for (int x = 0; x < frame.width * 4; x += 64) {
+        for (int y = 0; y < frame.height; y++) sum += frame.planes[0][(size_t)y * frame.strides[0] + x];
+    }
+    return sum;
+}
+
+static void benchAllocation() {
+    const int width = 3840, height = 2160, frames = 20;
+    std::printf("\n[alloc] Buffers de frame %dx%d BGRA8, %d frames por caso (1 thread)\n", width, height, frames);
+
+    std::vector<uint8_t> compact = TestFrames::make(TestFrames::Kind::Gradient, width, height);
+    FrameView src = FrameView::wrap(PixelFormat::BGRA8, compact.data(), width, height);
+    ThreadPool single(1);
+    CpuFilter filter(single);
+    PerfCounters counters;
+    volatile uint32_t sink = 0;
+
+    auto report = [&](const char* name, double ms, const PerfCounters::Sample& sample, int allocations) {
+        char tlb[32] = "n/d";
+        if (sample[PerfCounters::DtlbLoadMisses] >= 0) {
+            std::snprintf(tlb, sizeof(tlb), "%lld", (long long)(sample[PerfCounters::DtlbLoadMisses] / frames));
+        }
+        std::printf("  %-22s %7.2f ms/frame | page faults/frame %7lld | dTLB misses/frame %10s | alocações %d\n",
+                    name, ms / frames, (long long)(sample[PerfCounters::PageFaults] / frames), tlb, allocations);
+    };
+
+    // 1) Como antes: um std::vector novo a cada frame
+    {
+        counters.start();
+        auto begin = steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            std::vector<uint8_t> frame(compact.size());
+            FrameView dst = FrameView::wrap(PixelFormat::BGRA8, frame.data(), width, height);
+            filter.apply(src, dst);
+            sink = sink + columnWalk(dst);
+        }
+        double ms = duration<double, std::milli>(steady_clock::now() - begin).count();
+        report("vector por frame", ms, counters.stop(), frames);
+    }
+
+    // 2/3) Pool em regime, páginas de 4 KB e huge pages
+    struct Case { const char* name; HugePages mode; };
+    const Case cases[] = { {"pool (4 KB)", HugePages::Off}, {"pool (huge pages)", HugePages::Transparent} };
+    for (const Case& c : cases) {
+        FramePool::Options options;
+        options.hugePages = c.mode;
+        FramePool pool(PixelFormat::BGRA8, width, height, options);
+        {
+            FrameHandle warm = pool.acquire();  // primeiro toque: page faults fora da medição
+            filter.apply(src, warm.view());
+        }
+        for (int i = 0; i < 2; i++) {
+            FrameHandle warm = pool.acquire();
+            std::memset(warm.data(), 0, pool.getFrameBytes());
+        }
+        int allocationsBefore = pool.getAllocationCount();
+
+        counters.start();
+        auto begin = steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            FrameHandle frame = pool.acquire();
+            filter.apply(src, frame.view());
+            sink = sink + columnWalk(frame.view());
+        }
+        double ms = duration<double, std::milli>(steady_clock::now() - begin).count();
+        report(c.name, ms, counters.stop(), pool.getAllocationCount() - allocationsBefore);
+    }
+    std::printf("  stride com padding: %d bytes (compacto: %d)\n",
+                FramePool::paddedStride(width * 4), width * 4);
+
+    // Frame de 1 PB (maior que o espaço de endereçamento): a alocação falha e
+    // o pool devolve handle vazio, nunca um slot sem memória
+    {
+        FramePool huge(PixelFormat::BGRA8, 1 << 24, 1 << 24);
+        FrameHandle first = huge.acquire();
+        FrameHandle second = huge.acquire();
+        check(!first && !second && huge.getSlotCount() == FramePool::Options().preallocate,
+              "alocação que falha devolve handle vazio");
+    }
+}
+
+// ==================== SEÇÃO: UPLOAD ZERO CÓPIA ====================
+
+// A "memória de upload" é um memfd com 3 slots (o papel dos PBOs persistentes
+// no overlay). O consumidor só marca o slot como lido, como a GPU faria por DMA.
+static void benchUpload() {
+    const int width = 3840, height = 2160, frames = 30;
+    const size_t frameBytes = FrameView::compactSize(PixelFormat::BGRA8, width, height);
+    std::printf("\n[upload] Captura -> memória de upload (memfd, 3 slots), %dx%d, %d frames\n",
+                width, height, frames);
+
+    SharedMemory uploadMemory;
+    if (!uploadMemory.create("colorbench-upload", frameBytes * 3)) {
+        std::printf("  ❌ memória compartilhada indisponível\n");
+        return;
+    }
+
+    // 1) Caminho antigo: a fonte escreve no próprio buffer e o upload copia
+    //    o frame para a memória de upload (o que glTexImage2D faz)
+    {
+        UploadRing ring(PixelFormat::BGRA8, width, height);
+        for (int i = 0; i < 3; i++) ring.addSlot(uploadMemory.getData() + frameBytes * i, width * 4);
+
+        SyntheticFrameSource source(width, height);
+        source.initialize();
+        auto begin = steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            source.produceFrame();
+            int slot = ring.beginWrite();
+            source.readLatest([&](const FrameView& frame) {
+                const FrameView& dst = ring.view(slot);
+                for (int y = 0; y < height; y++) {
+                    std::memcpy(dst.planes[0] + (size_t)y * dst.strides[0],
+                                frame.planes[0] + (size_t)y * frame.strides[0], (size_t)width * 4);
+                }
+                ring.recordCopy(frameBytes);
+            });
+            ring.commitWrite(slot);
+            ring.release(ring.acquireLatest());
+        }
+        double ms = duration<double, std::milli>(steady_clock::now() - begin).count() / frames;
+        double bytes = (double)(source.getBytesWritten() + ring.getBytesCopied()) / frames;
+        std::printf("  buffer próprio + cópia: %7.2f ms/frame | %6.1f MB copiados/frame (%.1fx o frame)\n",
+                    ms, bytes / 1e6, bytes / frameBytes);
+    }
+
+    // 2) Zero cópia: a fonte escreve direto no slot da memória de upload
+    {
+        UploadRing ring(PixelFormat::BGRA8, width, height);
+        for (int i = 0; i < 3; i++) ring.addSlot(uploadMemory.getData() + frameBytes * i, width * 4);
+
+        SyntheticFrameSource source(width, height);
+        source.initialize();
+        source.attachWriteTarget(&ring);
+        auto begin = steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            source.produceFrame();
+            int slot = ring.acquireLatest();
+            if (slot >= 0) ring.release(slot);
+        }
+        double ms = duration<double, std::milli>(steady_clock::now() - begin).count() / frames;
+        double bytes = (double)(source.getBytesWritten() + ring.getBytesCopied()) / frames;
+        std::printf("  direto no upload:       %7.2f ms/frame | %6.1f MB copiados/frame (%.1fx o frame) | descartados %llu\n",
+                    ms, bytes / 1e6, bytes / frameBytes, (unsigned long long)ring.getFramesDropped());
+    }
+}
+
+// ==================== SEÇÃO: DAEMON -> N LEITORES ====================
+
+#ifdef __linux__
+struct FanoutStats {
+    std::atomic<bool> stop;
+    std::atomic<int> ready;
+    struct Reader {
+        std::atomic<uint64_t> frames, torn, skipped, latencySumUs;
+    } readers[8];
+};
+
+// Processo leitor: espera frames no futex e lê 1 linha a cada 16 no lugar
+static void fanoutReader(uint8_t* segment, size_t size, FanoutStats* stats, int index) {
+    SharedFrameRingReader reader;
+    if (!reader.attachMemory(segment, size)) _exit(1);
+    stats->ready++;
+    volatile uint32_t sink = 0;
+    SharedFrameRingReader::Frame frame;
+    while (!stats->stop) {
+        if (!reader.waitFrame(frame, 50)) continue;
+        int64_t now = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        uint32_t sum = 0;
+        for (int y = 0; y < frame.view.height; y += 16) sum += frame.view.planes[0][(size_t)y * frame.view.strides[0]];
+        sink = sink + sum;
+        if (reader.isIntact(frame)) {
+            stats->readers[index].latencySumUs += (uint64_t)(now - frame.view.timestampUs);
+        }
+    }
+    stats->readers[index].frames = reader.getFramesRead();
+    stats->readers[index].torn = reader.getFramesTorn();
+    stats->readers[index].skipped = reader.getFramesSkipped();
+    _exit(0);
+}
+#endif
+
+static void benchFanout() {
+#ifdef __linux__
+    const int width = 1920, height = 1080, fps = 60, seconds = 2;
+    std::printf("\n[fanout] Daemon -> anel memfd (4 slots) -> N processos leitores, %dx%d a %d fps, %d s\n",
+                width, height, fps, seconds);
+
+    const int readerCounts[] = { 0, 1, 2, 4, 8 };
+    for (int readers : readerCounts) {
+        SharedFrameRing ring;
+        if (!ring.create("colorbench-fanout", PixelFormat::BGRA8, width, height, 4)) {
+            std::printf("  ❌ memfd indisponível\n");
+            return;
+        }
+        void* shared = mmap(nullptr, sizeof(FanoutStats), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        FanoutStats* stats = new (shared) FanoutStats();
+        stats->stop = false;
+        stats->ready = 0;
+        for (auto& r : stats->readers) { r.frames = 0; r.torn = 0; r.skipped = 0; r.latencySumUs = 0; }
+
+        std::vector<pid_t> children;
+        for (int i = 0; i < readers; i++) {
+            pid_t pid = fork();
+            if (pid == 0) fanoutReader(ring.getBase(), ring.getSize(), stats, i);
+            children.push_back(pid);
+        }
+        while (stats->ready < readers) std::this_thread::sleep_for(milliseconds(1));
+
+        // Escritor no ritmo da captura; mede só o custo de produzir + publicar
+        SyntheticFrameSource source(width, height, fps);
+        source.initialize();
+        source.attachWriteTarget(&ring);
+        const int frames = fps * seconds;
+        double writeMs = 0.0, worstMs = 0.0;
+        auto next = steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            auto begin = steady_clock::now();
+            source.produceFrame();
+            double ms = duration<double, std::milli>(steady_clock::now() - begin).count();
+            writeMs += ms;
+            worstMs = std::max(worstMs, ms);
+            next += microseconds(1000000 / fps);
+            std::this_thread::sleep_until(next);
+        }
+        stats->stop = true;
+        for (pid_t pid : children) waitpid(pid, nullptr, 0);
+
+        uint64_t received = 0, torn = 0, skipped = 0, latency = 0;
+        for (int i = 0; i < readers; i++) {
+            received += stats->readers[i].frames;
+            torn += stats->readers[i].torn;
+            skipped += stats->readers[i].skipped;
+            latency += stats->readers[i].latencySumUs;
+        }
+        if (readers == 0) {
+            std::printf("  %d leitores: escritor %6.3f ms/frame (pior %6.3f)\n", readers, writeMs / frames, worstMs);
+        } else {
+            std::printf("  %d leitores: escritor %6.3f ms/frame (pior %6.3f) | frames/leitor %5.1f de %d | "
+                        "perdidos %4llu | rasgados %llu | latência média %6.0f us\n",
+                        readers, writeMs / frames, worstMs, received / (double)readers, frames,
+                        (unsigned long long)skipped, (unsigned long long)torn,
+                        received > torn ? latency / (double)(received - torn) : 0.0);
+        }
+        munmap(shared, sizeof(FanoutStats));
+    }
+
+    // Cabeçalhos adulterados (cópia do segmento de um anel de verdade): o
+    // leitor recusa tudo que apontaria fora do mapeamento
+    {
+        SharedFrameRing ring;
+        if (!ring.create("colorbench-header", PixelFormat::BGRA8, 64, 32, 4)) return;
+        std::vector<uint64_t> storage((ring.getSize() + 7) / 8);
+        uint8_t* copy = (uint8_t*)storage.data();
+        auto attachCorrupted = [&](const std::function<void(SharedFrameRingHeader&)>& corrupt, size_t size) {
+            std::memcpy(copy, ring.getBase(), ring.getSize());
+            corrupt(*(SharedFrameRingHeader*)copy);
+            SharedFrameRingReader reader;
+            return reader.attachMemory(copy, size);
+        };
+        const size_t size = ring.getSize();
+        auto intact = [](SharedFrameRingHeader&) {};
+        check(attachCorrupted(intact, size), "cabeçalho: segmento íntegro aceito");
+        check(!attachCorrupted(intact, sizeof(SharedFrameRingHeader) - 1), "cabeçalho: mapeamento menor que o cabeçalho");
+        check(!attachCorrupted(intact, size - 4096), "cabeçalho: totalBytes maior que o mapeamento");
+        check(!attachCorrupted([](SharedFrameRingHeader& h) { h.slotCount = SharedFrameRingHeader::maxSlots + 1; }, size),
+              "cabeçalho: slotCount acima de maxSlots");
+        check(!attachCorrupted([](SharedFrameRingHeader& h) { h.slotBytes = UINT64_MAX / 2; }, size),
+              "cabeçalho: slotBytes fora do segmento");
+        check(!attachCorrupted([](SharedFrameRingHeader& h) { h.dataOffset = h.totalBytes - 1; }, size),
+              "cabeçalho: dataOffset deixa os slots fora do segmento");
+        check(!attachCorrupted([](SharedFrameRingHeader& h) { h.width = 4096; }, size),
+              "cabeçalho: frame maior que o slot");
+    }
+
+    // Leitura rasgada pela fonte do overlay (SharedRingFrameSource): cada
+    // frame é escrito com um byte só (o número dele), então um frame com
+    // bytes diferentes é um frame rasgado que chegou ao consumidor
+    {
+        SharedFrameRing ring;
+        const int tornWidth = 1920, tornHeight = 1080;
+        if (!ring.create("colorbench-torn", PixelFormat::BGRA8, tornWidth, tornHeight, 2) || !ring.startServing()) {
+            check(false, "anel para a leitura rasgada");
+            return;
+        }
+        std::atomic<uint64_t> written{0};
+        auto writeFrame = [&] {
+            int slot = ring.beginWrite();
+            const FrameView& view = ring.view(slot);
+            uint8_t value = (uint8_t)(++written);
+            for (int y = 0; y < view.height; y++) std::memset(view.row(0, y), value, view.rowBytes(0));
+            ring.commitWrite(slot, (int64_t)written.load());
+        };
+        auto uniform = [](const FrameView& frame) {
+            const uint8_t first = frame.row(0, 0)[0];
+            for (int y = 0; y < frame.height; y++) {
+                const uint8_t* row = frame.row(0, y);
+                for (int x = 0; x < frame.rowBytes(0); x++) {
+                    if (row[x] != first) return false;
+                }
+            }
+            return true;
+        };
+
+        SharedRingFrameSource source("colorbench-torn");
+        if (!source.initialize()) {
+            check(false, "fonte ligada ao anel");
+            return;
+        }
+
+        // Determinístico: o escritor dá a volta no anel (2 slots) enquanto o
+        // consumidor ainda usa o frame; o que ele recebeu não pode mudar
+        writeFrame();
+        bool stable = false;
+        bool delivered = source.readLatest([&](const FrameView& frame) {
+            writeFrame();
+            writeFrame();
+            stable = uniform(frame) && frame.row(0, 0)[0] == 1;
+        });
+        check(delivered && stable, "anel: o escritor dar a volta durante o uso não muda o frame entregue");
+
+        // Escritor sem parar contra o leitor: só frames íntegros chegam ao consumidor
+        std::atomic<bool> stopWriter{false};
+        std::thread writer([&] {
+            while (!stopWriter) writeFrame();
+        });
+        int reads = 0, mixed = 0;
+        auto until = steady_clock::now() + milliseconds(1000);
+        while (steady_clock::now() < until) {
+            source.readLatest([&](const FrameView& frame) {
+                reads++;
+                if (!uniform(frame)) mixed++;
+            });
+        }
+        stopWriter = true;
+        writer.join();
+        std::printf("  leitura rasgada: %llu frames escritos, %d entregues (%d misturados), %llu rasgados descartados\n",
+                    (unsigned long long)written.load(), reads, mixed, (unsigned long long)source.getFramesTorn());
+        check(reads > 0 && mixed == 0, "anel: a fonte do overlay só entrega frames íntegros");
+    }
+#else
+    std::printf("\n[fanout] Só em Linux (memfd + futex)\n");
+#endif
+}
+
+// ==================== SEÇÃO: STRIDES E SUB-RETÂNGULOS ====================
+// Verificação (não só tempo): filtrar um frame com stride ímpar, ou um
+// sub-retângulo dele, tem que dar exatamente o mesmo resultado que filtrar a
+// cópia compacta, sem tocar no padding nem nos pixels fora do retângulo.
+
+struct StridedFrame {
+    std::vector<uint8_t> data;
+    FrameView view;
+};
+
+// Frame com 'pad' bytes a mais em cada linha de cada plano, preenchido com 'fill'
+static StridedFrame makeStrided(PixelFormat format, int width, int height, int pad, uint8_t fill) {
+    StridedFrame frame;
+    FrameView layout = FrameView::wrap(format, nullptr, width, height);
+    size_t total = 0;
+    size_t offsets[3] = { 0, 0, 0 };
+    for (int p = 0; p < layout.planeCount(); p++) {
+        offsets[p] = total;
+        total += (size_t)(layout.rowBytes(p) + pad) * layout.planeHeight(p);
+    }
+    frame.data.assign(total, fill);
+    frame.view = layout;
+    for (int p = 0; p < layout.planeCount(); p++) {
+        frame.view.planes[p] = frame.data.data() + offsets[p];
+        frame.view.strides[p] = layout.rowBytes(p) + pad;
+    }
+    return frame;
+}
+
+static std::vector<uint8_t> randomFrame(PixelFormat format, int width, int height, uint32_t seed) {
+    std::vector<uint8_t> data(FrameView::compactSize(format, width, height));
+    if (format == PixelFormat::RGBA16F) {
+        uint16_t* halfs = (uint16_t*)data.data();
+        for (size_t i = 0; i < data.size() / 2; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            halfs[i] = Half::fromFloat((seed >> 8) * (2.0f / 16777216.0f));  // [0, 2): inclui HDR
+        }
+        return data;
+    }
+    for (uint8_t& v : data) {
+        seed = seed * 1664525u + 1013904223u;
+        v = (uint8_t)(seed >> 24);
+    }
+    return data;
+}
+
+// Bytes de 'outer' fora do retângulo de cada plano de 'inner' (sub-visão dele)
+static bool outsideEqual(const FrameView& a, const FrameView& b, const FrameView& innerA) {
+    for (int p = 0; p < a.planeCount(); p++) {
+        const uint8_t* lo = innerA.planes[p];
+        const uint8_t* hi = innerA.row(p, innerA.planeHeight(p) - 1) + innerA.rowBytes(p);
+        size_t rowBytes = (size_t)innerA.rowBytes(p);
+        for (int y = 0; y < a.planeHeight(p); y++) {
+            const uint8_t* ra = a.row(p, y);
+            const uint8_t* rb = b.row(p, y);
+            for (int x = 0; x < a.strides[p]; x++) {
+                const uint8_t* q = ra + x;
+                bool inside = q >= lo && q < hi && (size_t)((q - innerA.planes[p]) % innerA.strides[p]) < rowBytes;
+                if (!inside && ra[x] != rb[x]) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool framesEqual(const FrameView& a, const FrameView& b) {
+    for (int p = 0; p < a.planeCount(); p++) {
+        for (int y = 0; y < a.planeHeight(p); y++) {
+            if (std::memcmp(a.row(p, y), b.row(p, y), a.rowBytes(p)) != 0) return false;
+        }
+    }
+    return true;
+}
+
+static void benchStrides() {
+    const int width = 333, height = 197;  // ímpares: última coluna/linha de croma incompleta
+    std::printf("\n[stride] Strides ímpares e sub-retângulos (%dx%d)\n", width, height);
+
+    CpuFilter rgbFilter;
+    YuvFilter yuvFilter;
+    auto filter = [&](const FrameView& src, const FrameView& dst) {
+        return src.planeCount() > 1 ? yuvFilter.apply(src, dst) : rgbFilter.apply(src, dst);
+    };
+
+    const PixelFormat formats[] = { PixelFormat::BGRA8, PixelFormat::RGB10A2, PixelFormat::RGBA16F,
+                                    PixelFormat::NV12, PixelFormat::I420 };
+    char label[96];
+    for (PixelFormat format : formats) {
+        // FP16 é lido como uint16_t: padding par, mas ainda fora do múltiplo de 8 bytes
+        int pad = format == PixelFormat::RGBA16F ? 2 : 3;
+        std::vector<uint8_t> source = randomFrame(format, width, height, 99);
+        std::vector<uint8_t> reference(source.size());
+        FrameView compactSrc = FrameView::wrap(format, source.data(), width, height);
+        FrameView compactRef = FrameView::wrap(format, reference.data(), width, height);
+        filter(compactSrc, compactRef);
+
+        // src e dst com strides diferentes entre si
+        StridedFrame src = makeStrided(format, width, height, pad, 0);
+        StridedFrame dst = makeStrided(format, width, height, pad + 4, 0xCD);
+        copyFrame(compactSrc, src.view);
+        filter(src.view, dst.view);
+        bool paddingIntact = true;
+        for (int p = 0; p < dst.view.planeCount(); p++) {
+            for (int y = 0; y < dst.view.planeHeight(p); y++) {
+                const uint8_t* row = dst.view.row(p, y);
+                for (int x = dst.view.rowBytes(p); x < dst.view.strides[p]; x++) paddingIntact &= row[x] == 0xCD;
+            }
+        }
+        std::snprintf(label, sizeof(label), "%s stride +%d/+%d: igual ao compacto, padding intacto",
+                      pixelFormatName(format), pad, pad + 4);
+        check(framesEqual(dst.view, compactRef) && paddingIntact, label);
+
+        // Sub-retângulo filtrado no lugar (origem par para o croma 4:2:0, tamanho ímpar)
+        const int rx = 10, ry = 6, rw = 201, rh = 99;
+        StridedFrame canvas = makeStrided(format, width, height, pad, 0);
+        copyFrame(compactSrc, canvas.view);
+        std::vector<uint8_t> original = canvas.data;
+        FrameView originalView = canvas.view;
+        for (int p = 0; p < 3; p++) {
+            if (originalView.planes[p]) originalView.planes[p] = original.data() + (canvas.view.planes[p] - canvas.data.data());
+        }
+
+        FrameView rect = canvas.view.subView(rx, ry, rw, rh);
+        std::vector<uint8_t> crop(FrameView::compactSize(format, rw, rh)), cropRef(crop.size());
+        FrameView cropView = FrameView::wrap(format, crop.data(), rw, rh);
+        FrameView cropRefView = FrameView::wrap(format, cropRef.data(), rw, rh);
+        copyFrame(rect, cropView);
+        filter(cropView, cropRefView);
+        filter(rect, rect);
+
+        std::snprintf(label, sizeof(label), "%s sub-retângulo %dx%d+%d+%d: igual, fora intacto",
+                      pixelFormatName(format), rw, rh, rx, ry);
+        check(framesEqual(rect, cropRefView) && outsideEqual(canvas.view, originalView, rect), label);
+    }
+
+    // Visões inválidas: fora do frame e origem ímpar em 4:2:0
+    std::vector<uint8_t> yuv(FrameView::compactSize(PixelFormat::I420, width, height));
+    FrameView yuvView = FrameView::wrap(PixelFormat::I420, yuv.data(), width, height);
+    check(yuvView.subView(1, 0, 10, 10).width == 0 && yuvView.subView(0, 0, width + 1, 1).width == 0,
+          "subView rejeita origem ímpar em 4:2:0 e retângulo fora do frame");
+
+    // Gravador Y4M: sub-retângulo escrito direto da visão == cópia compacta
+    StridedFrame canvas = makeStrided(PixelFormat::I420, width, height, 3, 0);
+    std::vector<uint8_t> source = randomFrame(PixelFormat::I420, width, height, 7);
+    copyFrame(FrameView::wrap(PixelFormat::I420, source.data(), width, height), canvas.view);
+    FrameView rect = canvas.view.subView(4, 2, 101, 51);
+    std::vector<uint8_t> compact(FrameView::compactSize(PixelFormat::I420, 101, 51));
+    copyFrame(rect, FrameView::wrap(PixelFormat::I420, compact.data(), 101, 51));
+
+    std::string fromView, fromCompact;
+    const char* header = "YUV4MPEG2 W101 H51 F30:1 C420";
+    for (int pass = 0; pass < 2; pass++) {
+        std::string path = std::string("/tmp/colorbench_stride_") + (pass ? "b" : "a") + ".y4m";
+        {
+            Y4MWriter writer;
+            writer.open(path, header);
+            if (pass == 0) writer.writeFrame(rect);
+            else writer.writeFrame(compact.data(), compact.size());
+        }
+        FILE* file = std::fopen(path.c_str(), "rb");
+        std::string& out = pass ? fromCompact : fromView;
+        char buffer[4096];
+        size_t n;
+        while (file && (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) out.append(buffer, n);
+        if (file) std::fclose(file);
+        std::remove(path.c_str());
+    }
+    check(!fromView.empty() && fromView == fromCompact, "Y4M de sub-retângulo com stride == Y4M compacto");
+
+    // Custo da compactação que o pipeline deixou de fazer (RowPitch do DXGI)
+    const int bw = 1920, bh = 1080;
+    StridedFrame pitched = makeStrided(PixelFormat::BGRA8, bw, bh, 256, 0);
+    std::vector<uint8_t> packed(FrameView::compactSize(PixelFormat::BGRA8, bw, bh));
+    FrameView packedView = FrameView::wrap(PixelFormat::BGRA8, packed.data(), bw, bh);
+    double repack = bestOf(10, [&] { copyFrame(pitched.view, packedView); });
+    std::printf("  1080p com RowPitch +256: cópia de compactação evitada %.2f ms/frame (%.1f MB)\n",
+                repack, packed.size() / 1e6);
+}
+
+// ==================== SEÇÃO: REGIÕES DE INTERESSE ====================
+
+static void benchRegions() {
+    const int width = 1920, height = 1080;
+    std::printf("\n[roi] Filtro só dentro das regiões, %dx%d BGRA8 (no lugar)\n", width, height);
+
+    std::vector<uint8_t> frame = TestFrames::make(TestFrames::Kind::Noise, width, height);
+    std::vector<uint8_t> work(frame.size());
+    FrameView view = FrameView::wrap(PixelFormat::BGRA8, work.data(), width, height);
+    CpuFilter filter;
+
+    // Uma janela centralizada com a área pedida, e três janelas sobrepostas
+    // (a sobreposição é filtrada uma vez só)
+    auto centered = [&](double fraction) {
+        int w = (int)(width * std::sqrt(fraction)), h = (int)(height * std::sqrt(fraction));
+        return std::vector<RoiRect>{ { (width - w) / 2, (height - h) / 2, w, h } };
+    };
+    struct Case { const char* name; std::vector<RoiRect> rects; };
+    const Case cases[] = {
+        {"10% (1 janela)", centered(0.10)},
+        {"50% (1 janela)", centered(0.50)},
+        {"3 sobrepostas", { {0, 0, 960, 540}, {960, 540, 960, 540}, {480, 270, 960, 270} }},
+        {"100% (frame)", {}},
+    };
+
+    std::printf("  %-18s %9s %10s %14s %10s\n", "regiões", "cobertura", "tempo(ms)", "ms por 10%", "fora ok");
+    double fullMs = 0.0;
+    for (const Case& c : cases) {
+        std::vector<RoiRect> rects = RegionSet::disjoint(c.rects, width, height);
+        double coverage = c.rects.empty() ? 1.0 : RegionSet::coverage(rects, width, height);
+        double ms = bestOf(3, [&] {
+            std::memcpy(work.data(), frame.data(), frame.size());
+            applyRegions(filter, view, view, c.rects);
+        });
+        if (c.rects.empty()) fullMs = ms;
+
+        // Pixels fora das regiões continuam idênticos à entrada
+        std::vector<uint8_t> mask((size_t)width * height, c.rects.empty() ? 1 : 0);
+        for (const RoiRect& r : rects) {
+            for (int y = r.y; y < r.y + r.height; y++) std::fill_n(&mask[(size_t)y * width + r.x], r.width, 1);
+        }
+        bool outsideOk = true;
+        for (size_t i = 0; i < mask.size() && outsideOk; i++) {
+            outsideOk = mask[i] || std::memcmp(&work[i * 4], &frame[i * 4], 4) == 0;
+        }
+        if (!outsideOk) g_failures++;
+        std::printf("  %-18s %8.0f%% %10.2f %14.2f %10s\n", c.name, coverage * 100.0, ms,
+                    ms / (coverage * 10.0), outsideOk ? "sim" : "NÃO");
+    }
+    std::printf("  (100%% = %.2f ms; o custo deve cair na proporção da área)\n", fullMs);
+}
+
+// ==================== SEÇÃO: GOVERNADOR DE QUALIDADE ====================
+// Primeiro o custo de cada degrau, com o degrau preso (cada um tem que custar
+// menos que o de cima). Depois o pipeline sintético desacelerado de propósito:
+// sem carga, carga 5x (o governador deve descer degraus para caber no
+// orçamento e assentar em um deles) e de novo sem carga (deve voltar à
+// qualidade total e ficar lá).
+
+static void benchGovernor() {
+    const int width = 1280, height = 720;
+    std::vector<uint8_t> frame = TestFrames::make(TestFrames::Kind::Gradient, width, height);
+    CpuFilter probe;
+    double baseMs = bestOf(3, [&] { probe.apply(frame.data(), frame.data(), width, height); });
+
+    QualityGovernor::Config config;
+    config.budgetMs = baseMs * 2.0;  // só para o ritmo da fonte; o orçamento sai do degrau 0 medido
+    config.downFrames = 20;  // rajadas de até ~0.5 s de frames lentos (máquina compartilhada) não descem degrau
+    config.upFrames = 10;
+    config.settleFrames = 3;
+    int fps = std::max(1, (int)(1000.0 / config.budgetMs));
+    config.holdFrames = fps * 20;  // trava mais longa que a fase com carga
+    std::printf("\n[governor] %dx%d, 15%% do frame em movimento, fonte a %d fps\n", width, height, fps);
+
+    auto source = std::make_unique<SyntheticFrameSource>(width, height, fps, TestFrames::Kind::Gradient);
+    source->setMovingFraction(0.15f);
+    SyntheticFrameSource* synthetic = source.get();
+    auto lut = std::make_shared<const Lut3D>(Lut3D::fromCorrection(32, CorrectionMethod::Hybrid));
+    MultiOutputPipeline pipeline(lut);
+    pipeline.addOutput(std::move(source));
+    pipeline.enableGovernor(config);
+    if (!pipeline.start()) {
+        std::printf("  ❌ falha ao iniciar o pipeline\n");
+        g_failures++;
+        return;
+    }
+
+    // Custo de cada degrau, preso, sem carga: ms de filtro por frame / divisor
+    // da captura (a 1/2 da taxa o mesmo frame custa metade por segundo).
+    // Três voltas intercaladas, melhor de cada degrau: ruído da máquina não
+    // inverte degraus vizinhos
+    QualityGovernor* governor = pipeline.getGovernor(0);
+    std::vector<double> rungMs(governor->getLevelCount(), 1e9);
+    auto filterTotalMs = [&] {
+        MultiOutputPipeline::Stats stats = pipeline.getStats(0);
+        return std::make_pair(stats.averageMs * stats.framesProcessed, stats.framesProcessed);
+    };
+    for (int round = 0; round < 3; round++) {
+        for (int level = 0; level < governor->getLevelCount(); level++) {
+            governor->setFixedLevel(level);
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));  // troca de degrau + primeiro frame inteiro
+            auto before = filterTotalMs();
+            std::this_thread::sleep_for(std::chrono::milliseconds(600));
+            auto after = filterTotalMs();
+            double ms = (after.first - before.first) / std::max(1, after.second - before.second);
+            rungMs[level] = std::min(rungMs[level], ms / governor->getSettings(level).captureDivisor);
+        }
+    }
+    for (int level = 0; level < governor->getLevelCount(); level++) {
+        std::printf("  degrau %d %-22s %6.2f ms de filtro por frame capturado\n", level,
+                    governor->getSettings(level).name, rungMs[level]);
+    }
+    bool cheaperEachRung = true;
+    for (size_t i = 1; i < rungMs.size(); i++) cheaperEachRung = cheaperEachRung && rungMs[i] < rungMs[i - 1];
+    check(cheaperEachRung, "cada degrau custa menos que o de cima");
+
+    // O frame no pipeline soma captura e disputa de núcleos ao filtro: o
+    // orçamento é o dobro do degrau 0 medido nele, não do filtro sozinho
+    governor->setBudgetMs(rungMs[0] * 2.0);
+    std::printf("  orçamento %.1f ms (2x o degrau 0)\n", rungMs[0] * 2.0);
+    governor->setFixedLevel(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    governor->setFixedLevel(-1);
+
+    // Nível amostrado a cada 250 ms; na última fase, o primeiro instante em
+    // nível 0 e quanto do resto dela ficou lá (um pico da máquina ainda pode
+    // descer um degrau por alguns frames). Sob carga constante: no máximo
+    // uma subida desfeita por degrau (a primeira tentativa; repetida é a
+    // oscilação na borda do orçamento) e, depois dos primeiros
+    // 'settleSeconds', no máximo duas trocas (um pico ainda pode descer e
+    // voltar; oscilando seriam dezenas)
+    struct Phase { const char* name; float slowdown; int seconds; };
+    const Phase phases[] = { {"sem carga", 1.0f, 3}, {"carga 5x", 5.0f, 14}, {"sem carga", 1.0f, 12} };
+    const Phase& loaded = phases[1];
+    const Phase& last = phases[2];
+    const int settleSeconds = 5;
+    int peakLevel = 0;
+    double recoveredAt = -1.0;
+    int samplesAfter = 0, samplesAtFull = 0, finalLevel = -1;
+    uint64_t loadedFrom = 0, settledFrom = 0;
+    int settledChanges = 0;
+    std::vector<int> settledSamples(governor->getLevelCount(), 0);
+    std::vector<int> undoneClimbs(governor->getLevelCount(), 0);
+    for (const Phase& phase : phases) {
+        if (&phase == &loaded) {
+            std::vector<QualityGovernor::Decision> decisions = governor->getDecisions();
+            loadedFrom = decisions.empty() ? 0 : decisions.back().frame;
+        }
+        pipeline.setSimulatedSlowdown(phase.slowdown);
+        for (int tick = 1; tick <= phase.seconds * 4; tick++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            int level = governor->getLevel();
+            if (phase.slowdown > 1.0f) peakLevel = std::max(peakLevel, level);
+            if (&phase == &loaded && tick > settleSeconds * 4) settledSamples[level]++;
+            if (&phase == &loaded && tick == settleSeconds * 4) {
+                std::vector<QualityGovernor::Decision> decisions = governor->getDecisions();
+                settledFrom = decisions.empty() ? 0 : decisions.back().frame;
+            }
+            if (&phase == &loaded && tick == phase.seconds * 4) {
+                std::vector<QualityGovernor::Decision> decisions = governor->getDecisions();
+                for (const QualityGovernor::Decision& d : decisions) settledChanges += d.frame > settledFrom;
+                for (size_t i = 1; i < decisions.size(); i++) {
+                    const QualityGovernor::Decision& climb = decisions[i - 1];
+                    const QualityGovernor::Decision& undo = decisions[i];
+                    bool undone = climb.to < climb.from && undo.from == climb.to && undo.to == climb.from;
+                    if (undone && climb.frame > loadedFrom) undoneClimbs[climb.to]++;
+                }
+            }
+            if (&phase == &last) {
+                if (level == 0 && recoveredAt < 0.0) recoveredAt = tick / 4.0;
+                if (recoveredAt >= 0.0) {
+                    samplesAfter++;
+                    samplesAtFull += level == 0;
+                }
+                finalLevel = level;
+            }
+            int t = tick / 4;
+            if (tick % 4 == 0 && (t == phase.seconds || t % 2 == 0)) {
+                std::printf("  %-10s %2d s | %s\n", phase.name, t, governor->describe().c_str());
+            }
+        }
+    }
+
+    // Só blocos alterados refaz os blocos na saída de dois frames atrás: com
+    // a fonte parada, a saída tem que ser igual ao frame inteiro filtrado nos
+    // dois buffers (lidos em frames seguidos)
+    const int tilesLevel = 3;
+    governor->setFixedLevel(tilesLevel);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    synthetic->setMovingFraction(0.0f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    std::vector<uint8_t> still(frame.size()), output, expected(frame.size());
+    synthetic->readLatest([&](const FrameView& view) {
+        copyFrame(view, FrameView::wrap(PixelFormat::BGRA8, still.data(), width, height));
+    });
+    CpuFilter reference;
+    reference.setSharedLUT(lut);
+    reference.setInterpolation(governor->getSettings(tilesLevel).interpolation);
+    reference.setChromaMode(governor->getSettings(tilesLevel).chromaMode);
+    reference.apply(still.data(), expected.data(), width, height);
+    bool tilesMatch = true;
+    for (int i = 0; i < 8; i++) {
+        tilesMatch = tilesMatch && pipeline.readOutput(0, output) && output == expected;
+        std::this_thread::sleep_for(std::chrono::microseconds(700000 / fps));
+    }
+    pipeline.stop();
+    check(tilesMatch, "só blocos alterados: saída igual ao filtro do frame inteiro");
+
+    std::printf("  decisões:\n");
+    for (const QualityGovernor::Decision& d : governor->getDecisions()) {
+        std::printf("    frame %5llu: %d -> %d (%s) | média %.1f ms, orçamento %.1f ms\n",
+                    (unsigned long long)d.frame, d.from, d.to, governor->getSettings(d.to).name,
+                    d.averageMs, d.budgetMs);
+    }
+    double heldFraction = samplesAfter > 0 ? samplesAtFull / (double)samplesAfter : 0.0;
+    if (recoveredAt >= 0.0) {
+        std::printf("  sem carga: nível 0 em %.2f s, %.0f%% do tempo depois disso em nível 0\n", recoveredAt,
+                    heldFraction * 100.0);
+    }
+    int settledLevel = (int)(std::max_element(settledSamples.begin(), settledSamples.end()) - settledSamples.begin());
+    int settledTotal = 0;
+    for (int n : settledSamples) settledTotal += n;
+    double settledFraction = settledTotal > 0 ? settledSamples[settledLevel] / (double)settledTotal : 0.0;
+    int repeatedUndo = *std::max_element(undoneClimbs.begin(), undoneClimbs.end());
+    std::printf("  carga 5x depois de %d s: %d troca(s), %.0f%% do tempo no nível %d; no máximo %d subida(s) desfeita(s) por degrau\n",
+                settleSeconds, settledChanges, settledFraction * 100.0, settledLevel, repeatedUndo);
+    check(peakLevel > 0, "sob carga o governador desceu de degrau");
+    check(repeatedUndo <= 1 && settledChanges <= 2, "sob carga constante o governador assentou em um degrau");
+    check(recoveredAt >= 0.0 && recoveredAt <= last.seconds / 2.0,
+          "sem carga o governador voltou ao nível 0 na primeira metade da fase");
+    check(finalLevel == 0 && heldFraction >= 0.9, "sem carga o governador ficou no nível 0 (90% do tempo e no fim)");
+}
+
+// ==================== SEÇÃO: GRAVAÇÃO E REPRODUÇÃO ====================
+// Grava uma fonte sintética com eventos intercalados, reproduz na velocidade
+// máxima (frames idênticos byte a byte, eventos na mesma ordem) e no ritmo
+// original (os intervalos gravados são respeitados).
+
+static void benchReplay() {
+    const int width = 640, height = 360, frameCount = 30;
+    const std::string path = "colorbench_replay.drec";
+    std::printf("\n[replay] %dx%d, %d frames, gravação em %s\n", width, height, frameCount, path.c_str());
+
+    SyntheticFrameSource source(width, height, 60, TestFrames::Kind::Gradient);
+    source.initialize();
+    std::vector<std::vector<uint8_t>> recorded;
+    std::vector<uint32_t> recordedOrder;  // 0 = frame, senão o tipo do evento
+    CaptureRecorder recorder;
+    if (!recorder.open(path, PixelFormat::BGRA8, width, height)) {
+        check(false, "gravação aberta");
+        return;
+    }
+    source.setFrameListener([&](const FrameHandle& handle) {
+        const FrameView& frame = handle.view();
+        // Fila cheia (a escrita roda com prioridade ociosa): o frame não entra no arquivo
+        if (!recorder.writeFrame(handle)) return;
+        std::vector<uint8_t> copy(FrameView::compactSize(frame.format, width, height));
+        copyFrame(frame, FrameView::wrap(frame.format, copy.data(), width, height));
+        recorded.push_back(std::move(copy));
+        recordedOrder.push_back(0);
+    });
+    auto recordStart = steady_clock::now();
+    for (int i = 0; i < frameCount; i++) {
+        if (i % 7 == 3) {
+            uint32_t kind = (i % 2) ? RecordedEvent::Toggle : RecordedEvent::Strength;
+            recorder.writeEvent(kind, i / 100.0f);
+            recordedOrder.push_back(kind);
+        }
+        source.produceFrame();
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    double recordMs = duration<double, std::milli>(steady_clock::now() - recordStart).count();
+    recorder.close();
+    uint64_t recordedBytes = recorder.getBytesWritten();
+    std::printf("  gravados %zu frames (%llu descartados), %llu bytes em %.1f ms\n", recorded.size(),
+                (unsigned long long)recorder.getDroppedFrames(), (unsigned long long)recordedBytes, recordMs);
+
+    // Velocidade máxima: step() sem thread
+    ReplayFrameSource fast(path, ReplayFrameSource::Pace::Maximum);
+    check(fast.initialize(), "gravação reaberta");
+    std::vector<uint32_t> replayedOrder;
+    fast.setEventHandler([&](const RecordedEvent& event) { replayedOrder.push_back(event.kind); });
+    bool identical = true;
+    size_t frameIndex = 0;
+    auto fastStart = steady_clock::now();
+    while (fast.step()) {
+        replayedOrder.push_back(0);
+        fast.readLatest([&](const FrameView& frame) {
+            identical = identical && frameIndex < recorded.size() &&
+                        framesEqual(frame, FrameView::wrap(frame.format, recorded[frameIndex].data(), width, height));
+        });
+        frameIndex++;
+    }
+    double fastMs = duration<double, std::milli>(steady_clock::now() - fastStart).count();
+    std::printf("  máxima:   %zu frames em %.1f ms (%.0f fps)\n", frameIndex, fastMs, frameIndex * 1000.0 / fastMs);
+    check(frameIndex == recorded.size() && identical, "frames reproduzidos idênticos aos gravados");
+    check(replayedOrder == recordedOrder, "eventos na mesma ordem em relação aos frames");
+    check(fast.isFinished(), "fim da gravação detectado");
+
+    // Ritmo original: a reprodução leva o mesmo tempo da gravação
+    ReplayFrameSource paced(path, ReplayFrameSource::Pace::Original);
+    paced.initialize();
+    auto pacedStart = steady_clock::now();
+    while (paced.step()) {
+    }
+    double pacedMs = duration<double, std::milli>(steady_clock::now() - pacedStart).count();
+    double recordedSpanMs = paced.getTimestampUs() / 1000.0;
+    std::printf("  original: %.1f ms (gravado %.1f ms entre o primeiro e o último registro)\n",
+                pacedMs, recordedSpanMs);
+    check(pacedMs >= recordedSpanMs * 0.95 && pacedMs < recordedSpanMs + 50.0, "ritmo original respeitado");
+
+    // Loop: a segunda volta continua os instantes da primeira
+    ReplayFrameSource looped(path, ReplayFrameSource::Pace::Maximum, true);
+    looped.initialize();
+    int loopedFrames = 0;
+    while (looped.step() && looped.getPass() < 2) loopedFrames++;
+    check(loopedFrames == 2 * (int)recorded.size(), "loop reproduz a gravação de novo");
+
+    std::remove(path.c_str());
+}
+
+// ==================== SEÇÃO: FORMATO DE GRAVAÇÃO ====================
+// Keyframes + deltas por bloco comprimidos, escritos por uma thread própria.
+// Mede o custo na thread da captura (cópia + fila), a taxa de compressão,
+// codificação e decodificação em MB/s e o salto pelo índice; confere que
+// todos os frames voltam idênticos.
+
+static uint64_t frameHash(const FrameView& frame) {
+    uint64_t hash = 1469598103934665603ull;
+    for (int p = 0; p < frame.planeCount(); p++) {
+        for (int y = 0; y < frame.planeHeight(p); y++) {
+            const uint8_t* row = frame.row(p, y);
+            for (int x = 0; x < frame.rowBytes(p); x += 8) {
+                uint64_t word = 0;
+                std::memcpy(&word, row + x, std::min(8, frame.rowBytes(p) - x));
+                hash = (hash ^ word) * 1099511628211ull;
+            }
+        }
+    }
+    return hash;
+}
+
+// Cabeçalhos e trailers adulterados a partir de uma gravação válida: o
+// leitor recusa (ou refaz o índice) em vez de entrar em laço ou ler fora
+static void checkCorruptRecordings(const std::string& path) {
+    std::vector<uint8_t> original;
+    if (FILE* in = std::fopen(path.c_str(), "rb")) {
+        uint8_t buffer[1 << 16];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), in)) > 0) original.insert(original.end(), buffer, buffer + n);
+        std::fclose(in);
+    }
+    if (original.size() < sizeof(RecordingHeader) + sizeof(RecordingTrailer)) {
+        check(false, "gravação para adulterar");
+        return;
+    }
+    const std::string corruptPath = path + ".corrupt";
+    auto opens = [&](const std::function<void(RecordingHeader&, RecordingTrailer&)>& corrupt, int* frames) {
+        std::vector<uint8_t> bytes = original;
+        RecordingHeader header;
+        RecordingTrailer trailer;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(trailer), sizeof(trailer));
+        corrupt(header, trailer);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::memcpy(bytes.data() + bytes.size() - sizeof(trailer), &trailer, sizeof(trailer));
+        FILE* out = std::fopen(corruptPath.c_str(), "wb");
+        if (!out) return false;
+        std::fwrite(bytes.data(), 1, bytes.size(), out);
+        std::fclose(out);
+        RecordingReader reader;
+        bool ok = reader.open(corruptPath);
+        if (ok && frames) *frames = reader.getFrameCount();
+        return ok;
+    };
+
+    int expected = 0, rebuilt = 0, huge = 0;
+    bool intact = opens([](RecordingHeader&, RecordingTrailer&) {}, &expected);
+    bool rejected = !opens([](RecordingHeader& h, RecordingTrailer&) { h.tileRows = 0x80000000u; }, nullptr) &&
+                    !opens([](RecordingHeader& h, RecordingTrailer&) { h.tileBytes = 0xFFFFFFF0u; }, nullptr) &&
+                    !opens([](RecordingHeader& h, RecordingTrailer&) { h.tileRows = (uint32_t)h.height + 1; }, nullptr) &&
+                    !opens([](RecordingHeader& h, RecordingTrailer&) { h.format = 99; }, nullptr) &&
+                    !opens([](RecordingHeader& h, RecordingTrailer&) { h.width = 1 << 20; }, nullptr);
+    // Trailer que aponta para o fim do espaço de endereços (a soma dava a
+    // volta) ou com entradas demais: o índice é refeito pelos cabeçalhos
+    bool wrapped = opens([](RecordingHeader&, RecordingTrailer& t) { t.indexOffset = ~(uint64_t)0 - 8; }, &rebuilt);
+    bool entries = opens([](RecordingHeader&, RecordingTrailer& t) { t.entries = 0xFFFFFFFFu; }, &huge);
+    std::remove(corruptPath.c_str());
+    check(intact && rejected, "cabeçalho com blocos, formato ou tamanho inválidos é recusado");
+    check(wrapped && entries && rebuilt == expected && huge == expected,
+          "trailer fora do arquivo: índice refeito, mesmos frames");
+}
+
+static void benchRecording() {
+    struct Case { const char* name; int width, height, fps; float moving; int frames; };
+    const Case cases[] = {
+        { "1080p60 15% em movimento", 1920, 1080, 60, 0.15f, 120 },
+        { "1080p60 tela inteira", 1920, 1080, 60, 1.0f, 120 },
+        { "4K30 15% em movimento", 3840, 2160, 30, 0.15f, 120 },
+    };
+    const std::string path = "colorbench_recording.drec";
+    std::printf("\n[recording] keyframe a cada 60 frames, blocos de %d linhas x %d bytes\n",
+                TileDeltaCodec::defaultTileRows, TileDeltaCodec::defaultTileBytes);
+    std::printf("  %-26s %9s %9s %8s %10s %10s %9s\n", "caso", "captura", "p99", "taxa", "codif.", "decodif.", "salto");
+
+    for (const Case& c : cases) {
+        SyntheticFrameSource source(c.width, c.height, c.fps, TestFrames::Kind::Text);
+        source.initialize();
+        source.setMovingFraction(c.moving);
+        CaptureRecorder recorder;
+        if (!recorder.open(path, PixelFormat::BGRA8, c.width, c.height)) {
+            check(false, "gravação aberta");
+            return;
+        }
+
+        // Na thread da captura só entra writeFrame (o custo medido): o handle
+        // vai para a fila e a fonte segue em outro buffer do pool
+        std::vector<bool> accepted;
+        std::vector<double> enqueueMs;
+        source.setFrameListener([&](const FrameHandle& frame) {
+            auto begin = steady_clock::now();
+            accepted.push_back(recorder.writeFrame(frame));
+            enqueueMs.push_back(duration<double, std::milli>(steady_clock::now() - begin).count());
+        });
+        auto next = steady_clock::now();
+        for (int i = 0; i < c.frames; i++) {
+            source.produceFrame();
+            next += microseconds(1000000 / c.fps);
+            std::this_thread::sleep_until(next);
+        }
+        recorder.close();
+        std::sort(enqueueMs.begin(), enqueueMs.end());
+        double rawMB = recorder.getRawFrameBytes() / 1e6;
+
+        RecordingReader reader;
+        if (!reader.open(path)) {
+            check(false, "gravação reaberta");
+            return;
+        }
+        FramePool pool(PixelFormat::BGRA8, c.width, c.height);
+        FrameHandle target = pool.acquire();
+        RecordHeader record;
+        int decoded = 0;
+        auto decodeStart = steady_clock::now();
+        while (reader.peek(record)) {
+            if (record.isFrame() && !reader.readFrame(target.view())) break;
+            if (!record.isFrame()) reader.skip();
+            decoded += record.isFrame();
+        }
+        double decodeMs = duration<double, std::milli>(steady_clock::now() - decodeStart).count();
+
+        // Conferência fora das medidas: a fonte sintética é determinística,
+        // uma segunda instância refaz os mesmos frames
+        SyntheticFrameSource replica(c.width, c.height, c.fps, TestFrames::Kind::Text);
+        replica.initialize();
+        replica.setMovingFraction(c.moving);
+        reader.rewind();
+        bool identical = reader.getFrameCount() == (int)std::count(accepted.begin(), accepted.end(), true);
+        std::vector<uint64_t> hashes;
+        for (size_t i = 0; i < accepted.size() && identical; i++) {
+            replica.produceFrame();
+            if (!accepted[i]) continue;
+            while (reader.peek(record) && !record.isFrame()) reader.skip();
+            identical = reader.readFrame(target.view());
+            replica.readLatest([&](const FrameView& frame) { identical = identical && framesEqual(frame, target.view()); });
+            hashes.push_back(frameHash(target.view()));
+        }
+
+        // Saltos para o fim de cada intervalo entre keyframes (pior caso) e
+        // alguns pontos no meio
+        int seeks = 0;
+        bool seekOk = identical;
+        auto seekStart = steady_clock::now();
+        for (int frame = reader.getFrameCount() - 1; frame >= 0 && seekOk; frame -= 23) {
+            seekOk = reader.seekFrame(frame) && reader.readFrame(target.view()) &&
+                     frameHash(target.view()) == hashes[frame];
+            seeks++;
+        }
+        double seekMs = seeks ? duration<double, std::milli>(steady_clock::now() - seekStart).count() / seeks : 0.0;
+
+        std::printf("  %-26s %6.2f ms %6.2f ms %7.1fx %5.0f MB/s %5.0f MB/s %6.1f ms\n", c.name,
+                    enqueueMs[enqueueMs.size() / 2], enqueueMs[enqueueMs.size() * 99 / 100],
+                    recorder.getCompressionRatio(), rawMB / (recorder.getEncodeMs() / 1000.0),
+                    decoded * FrameView::compactSize(PixelFormat::BGRA8, c.width, c.height) / 1e6 / (decodeMs / 1000.0),
+                    seekMs);
+        std::printf("  %-26s %llu frames, %llu descartados, %.1f MB -> %.1f MB, %d keyframes\n", "",
+                    (unsigned long long)recorder.getFrameCount(), (unsigned long long)recorder.getDroppedFrames(),
+                    rawMB, recorder.getBytesWritten() / 1e6, reader.getKeyframeCount());
+        check(identical, "todos os frames gravados voltam idênticos");
+        check(seekOk, "salto pelo índice chega no frame certo");
+        check(enqueueMs[enqueueMs.size() * 99 / 100] < 1.0, "p99 na thread da captura abaixo de 1 ms");
+    }
+    checkCorruptRecordings(path);
+    std::remove(path.c_str());
+}
+
+// ==================== SEÇÃO: PIPELINE EM ESTÁGIOS ====================
+// Compara o laço sequencial (como o renderLoop do overlay: a cada volta lê o
+// frame mais recente, compara, filtra, sobe e apresenta, com Sleep(1) entre
+// voltas) com o pipeline em corrotinas (StagedPipeline.h) sobre a mesma fonte
+// sintética e o mesmo trabalho por estágio. A apresentação dorme um tempo
+// fixo, como o swap esperando a GPU: no laço sequencial esse tempo soma ao
+// do frame; no pipeline os outros estágios seguem enquanto ele espera.
+
+struct StageWork {
+    CpuFilter filter;
+    std::vector<uint8_t> texture;  // "textura": recebe só os blocos alterados
+    FrameView textureView;
+    int presentMicros = 0;
+
+    StageWork(int width, int height, int presentUs) : presentMicros(presentUs) {
+        // Filtro em float, a carga para a qual a comparação foi montada: em
+        // ponto fixo o filtro cabe no frame e os dois modos chegam a 60 fps
+        filter.setArithmetic(CpuFilter::Arithmetic::Float);
+        texture.resize(FrameView::compactSize(PixelFormat::BGRA8, width, height));
+        textureView = FrameView::wrap(PixelFormat::BGRA8, texture.data(), width, height);
+    }
+
+    void upload(const FrameView& frame, const std::vector<RoiRect>& changed) {
+        for (const RoiRect& r : changed) {
+            copyFrame(frame.subView(r.x, r.y, r.width, r.height), textureView.subView(r.x, r.y, r.width, r.height));
+        }
+    }
+
+    void present() { std::this_thread::sleep_for(microseconds(presentMicros)); }
+};
+
+struct StageRun {
+    double seconds = 0.0;
+    uint64_t captured = 0, presented = 0;
+    uint64_t replaced = 0, unchanged = 0;
+    double p50 = 0.0, p99 = 0.0, worst = 0.0;
+    bool ordered = true;
+    bool matches = true;  // última saída == filtro do frame inteiro
+};
+
+static void summarizeLatency(std::vector<double> latencies, StageRun& run) {
+    if (latencies.empty()) return;
+    std::sort(latencies.begin(), latencies.end());
+    run.p50 = latencies[latencies.size() / 2];
+    run.p99 = latencies[std::min(latencies.size() - 1, (size_t)(latencies.size() * 0.99))];
+    run.worst = latencies.back();
+}
+
+static int64_t steadyMicros() {
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Confere a textura final com o filtro aplicado no frame inteiro
+static bool textureMatches(StageWork& work, const FrameView& source) {
+    std::vector<uint8_t> reference(work.texture.size());
+    FrameView referenceView = FrameView::wrap(PixelFormat::BGRA8, reference.data(), source.width, source.height);
+    work.filter.apply(source, referenceView);
+    return reference == work.texture;
+}
+
+static StageRun runSequential(int width, int height, int fps, float moving, int seconds, int presentUs) {
+    SyntheticFrameSource source(width, height, fps, TestFrames::Kind::Gradient);
+    source.initialize();
+    source.setMovingFraction(moving);
+    StageWork work(width, height, presentUs);
+    ChangeDetector changes;
+    FramePool outputPool(PixelFormat::BGRA8, width, height);
+    FrameHandle output = outputPool.acquire();
+    FramePool keepPool(PixelFormat::BGRA8, width, height);
+    FrameHandle lastSource = keepPool.acquire();
+    std::vector<double> latencies;
+    StageRun run;
+
+    source.start();
+    auto begin = steady_clock::now();
+    auto end = begin + std::chrono::seconds(seconds);
+    int lastFrame = 0;
+    while (steady_clock::now() < end) {
+        int frame = source.getFrameCount();
+        if (frame != lastFrame) {
+            lastFrame = frame;
+            int64_t captureUs = 0;
+            std::vector<RoiRect> changed;
+            // O lock da fonte fica preso durante a leitura, como no overlay
+            source.readLatest([&](const FrameView& src) {
+                captureUs = src.timestampUs;
+                changed = changes.detect(src);
+                filterRegions(work.filter, src, output.view(), changed);
+                copyFrame(src, lastSource.view());
+            });
+            if (!changed.empty()) {
+                work.upload(output.view(), changed);
+                work.present();
+                latencies.push_back((steadyMicros() - captureUs) / 1000.0);
+                run.presented++;
+            }
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    source.stop();
+    run.seconds = duration<double>(steady_clock::now() - begin).count();
+    run.captured = (uint64_t)source.getFrameCount();
+    run.matches = textureMatches(work, lastSource.view());
+    summarizeLatency(latencies, run);
+    return run;
+}
+
+static StageRun runStaged(int width, int height, int fps, float moving, int seconds, int presentUs) {
+    SyntheticFrameSource source(width, height, fps, TestFrames::Kind::Gradient);
+    source.initialize();
+    source.setMovingFraction(moving);
+    StageWork work(width, height, presentUs);
+    FramePool keepPool(PixelFormat::BGRA8, width, height);
+    FrameHandle lastSource = keepPool.acquire();
+    StageRun run;
+    uint64_t lastSequence = 0;
+
+    StagedPipeline pipeline;
+    StagedPipeline::Options options;
+    options.filter = &work.filter;
+    options.upload = [&](StagedFrame& frame) { work.upload(frame.output.view(), frame.changed); };
+    options.present = [&](StagedFrame& frame) {
+        work.present();
+        run.ordered = run.ordered && (run.presented == 0 || frame.sequence > lastSequence);
+        lastSequence = frame.sequence;
+        lastSource = frame.source;  // mantém o buffer da fonte até a conferência
+        run.presented++;
+    };
+    if (!pipeline.start(&source, options)) {
+        run.ordered = false;
+        return run;
+    }
+    source.start();
+    auto begin = steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    source.stop();
+    pipeline.stop();
+    run.seconds = duration<double>(steady_clock::now() - begin).count();
+
+    StagedPipeline::Stats stats = pipeline.getStats();
+    run.captured = stats.captured;
+    run.p50 = stats.latencyP50Ms;
+    run.p99 = stats.latencyP99Ms;
+    run.worst = stats.latencyMaxMs;
+    run.replaced = stats.replaced;
+    run.unchanged = stats.unchanged;
+    run.matches = lastSource && textureMatches(work, lastSource.view());
+    return run;
+}
+
+// Produtor e consumidor em executores diferentes, canal de 1 item: nada se
+// perde nem troca de ordem, e o produtor suspende enquanto o canal está cheio
+static bool channelRoundTrip(int count) {
+    Channel<int> channel(1);
+    Executor producerExecutor, consumerExecutor;
+    producerExecutor.startThreads(1);
+    consumerExecutor.startThreads(1);
+    std::vector<int> received;
+    auto producer = [&]() -> Task {
+        for (int i = 0; i < count; i++) {
+            if (!co_await channel.send(i)) break;
+        }
+        channel.close();
+    };
+    auto consumer = [&]() -> Task {
+        while (std::optional<int> value = co_await channel.receive()) received.push_back(*value);
+    };
+    Task consumerTask = consumer();
+    Task producerTask = producer();
+    consumerTask.start(consumerExecutor);
+    producerTask.start(producerExecutor);
+    consumerTask.join();
+    producerTask.join();
+    bool ok = (int)received.size() == count;
+    for (int i = 0; i < count && ok; i++) ok = received[i] == i;
+    return ok;
+}
+
+static void benchStages() {
+    const int width = 1280, height = 720, fps = 60, seconds = 3, presentUs = 8000;
+    const float moving = 0.3f;
+    std::printf("\n[stages] %dx%d a %d fps, %.0f%% em movimento, apresentação %.1f ms, %d s por modo\n",
+                width, height, fps, moving * 100, presentUs / 1000.0, seconds);
+
+    check(channelRoundTrip(20000), "canal entre executores entrega tudo, em ordem");
+
+    std::printf("  %-12s %9s %9s %9s %9s %9s\n", "modo", "captura", "apresenta", "p50", "p99", "máx");
+    StageRun sequential = runSequential(width, height, fps, moving, seconds, presentUs);
+    std::printf("  %-12s %5.1f fps %5.1f fps %6.2f ms %6.2f ms %6.2f ms\n", "sequencial",
+                sequential.captured / sequential.seconds, sequential.presented / sequential.seconds,
+                sequential.p50, sequential.p99, sequential.worst);
+    StageRun staged = runStaged(width, height, fps, moving, seconds, presentUs);
+    std::printf("  %-12s %5.1f fps %5.1f fps %6.2f ms %6.2f ms %6.2f ms\n", "estágios",
+                staged.captured / staged.seconds, staged.presented / staged.seconds,
+                staged.p50, staged.p99, staged.worst);
+    std::printf("  %-12s %llu frames substituídos na entrada (estágio seguinte ocupado), %llu sem mudança\n", "",
+                (unsigned long long)staged.replaced, (unsigned long long)staged.unchanged);
+    std::printf("  (%u núcleo(s): com um núcleo só a espera da apresentação se sobrepõe ao resto)\n",
+                std::max(1u, std::thread::hardware_concurrency()));
+
+    check(sequential.matches, "sequencial: textura final igual ao filtro do frame inteiro");
+    check(staged.matches, "estágios: textura final igual ao filtro do frame inteiro");
+    check(staged.ordered, "estágios: frames apresentados na ordem de captura");
+    check(staged.presented > 0 && staged.presented <= staged.captured, "estágios: frames chegaram à apresentação");
+}
+
+// ==================== SEÇÃO: CONVERSÃO DE FORMATOS ====================
+// Cada conversão de PixelConvert.h em cada nível (escalar = laço ingênuo,
+// SSSE3, AVX2) sobre um frame 1080p, em GB/s (bytes lidos + escritos). A
+// conferência compara todos os níveis com o escalar em contagens que não
+// fecham os blocos SIMD e verifica que nada é escrito além do fim.
+
+struct ConvertCase {
+    const char* name;
+    int srcBytes, dstBytes;  // por pixel (planos: soma dos planos)
+    std::function<void(const uint8_t*, uint8_t*, size_t, PixelConvert::Level)> run;
+};
+
+static std::vector<ConvertCase> convertCases() {
+    using Level = PixelConvert::Level;
+    // Planos contíguos: plano c começa em c * count
+    auto planesOf = [](uint8_t* base, size_t count, int channels) {
+        std::array<uint8_t*, 4> planes = { base, base + count, base + count * 2, nullptr };
+        if (channels == 4) planes[3] = base + count * 3;
+        return planes;
+    };
+    return {
+        { "BGRA -> RGBA", 4, 4, [](const uint8_t* s, uint8_t* d, size_t n, Level l) { PixelConvert::swapRB(s, d, n, l); } },
+        { "BGRA -> RGB24", 4, 3, [](const uint8_t* s, uint8_t* d, size_t n, Level l) { PixelConvert::pack3(s, d, n, true, l); } },
+        { "RGBA -> RGB24", 4, 3, [](const uint8_t* s, uint8_t* d, size_t n, Level l) { PixelConvert::pack3(s, d, n, false, l); } },
+        { "RGB24 -> BGRA", 3, 4, [](const uint8_t* s, uint8_t* d, size_t n, Level l) { PixelConvert::unpack3(s, d, n, true, l); } },
+        { "RGB24 -> RGBA", 3, 4, [](const uint8_t* s, uint8_t* d, size_t n, Level l) { PixelConvert::unpack3(s, d, n, false, l); } },
+        { "alfa 255 (in-place)", 4, 4, [](const uint8_t*, uint8_t* d, size_t n, Level l) { PixelConvert::fillAlpha(d, n, 255, l); } },
+        { "BGRA -> 4 planos", 4, 4, [planesOf](const uint8_t* s, uint8_t* d, size_t n, Level l) {
+              std::array<uint8_t*, 4> planes = planesOf(d, n, 4);
+              PixelConvert::split4(s, planes.data(), n, l);
+          } },
+        { "BGRA -> 3 planos", 4, 3, [planesOf](const uint8_t* s, uint8_t* d, size_t n, Level l) {
+              std::array<uint8_t*, 4> planes = planesOf(d, n, 3);
+              PixelConvert::split4(s, planes.data(), n, l);
+          } },
+        { "4 planos -> BGRA", 4, 4, [planesOf](const uint8_t* s, uint8_t* d, size_t n, Level l) {
+              std::array<uint8_t*, 4> planes = planesOf((uint8_t*)s, n, 4);
+              PixelConvert::merge4(planes.data(), d, n, l);
+          } },
+        { "3 planos -> BGRA", 3, 4, [planesOf](const uint8_t* s, uint8_t* d, size_t n, Level l) {
+              std::array<uint8_t*, 4> planes = planesOf((uint8_t*)s, n, 3);
+              PixelConvert::merge4(planes.data(), d, n, l);
+          } },
+    };
+}
+
+static void benchConvert() {
+    using Level = PixelConvert::Level;
+    const int width = 1920, height = 1080;
+    const size_t pixels = (size_t)width * height;
+    std::vector<Level> levels;
+    for (Level level : { Level::Scalar, Level::SSSE3, Level::AVX2 }) {
+        if (PixelConvert::isSupported(level)) levels.push_back(level);
+    }
+    std::printf("\n[convert] %dx%d, GB/s = (bytes lidos + escritos) / tempo, melhor de 20; nível padrão: %s\n",
+                width, height, PixelConvert::levelName(PixelConvert::bestLevel()));
+    std::printf("  %-22s", "conversão");
+    for (Level level : levels) std::printf(" %9s", PixelConvert::levelName(level));
+    std::printf(" %9s\n", "ganho");
+
+    std::vector<uint8_t> src(pixels * 4), dst(pixels * 4);
+    uint32_t seed = 12345;
+    for (uint8_t& b : src) {
+        seed = seed * 1664525u + 1013904223u;
+        b = (uint8_t)(seed >> 24);
+    }
+
+    bool allMatch = true;
+    for (const ConvertCase& c : convertCases()) {
+        std::printf("  %-22s", c.name);
+        double scalarGBs = 0.0, bestGBs = 0.0;
+        for (Level level : levels) {
+            double ms = bestOf(20, [&] { c.run(src.data(), dst.data(), pixels, level); });
+            double gbs = pixels * (double)(c.srcBytes + c.dstBytes) / (ms * 1e6);
+            if (level == Level::Scalar) scalarGBs = gbs;
+            bestGBs = std::max(bestGBs, gbs);
+            std::printf(" %5.1f GB/s", gbs);
+        }
+        std::printf(" %8.1fx\n", scalarGBs > 0 ? bestGBs / scalarGBs : 0.0);
+
+        // Contagens pequenas e ímpares (só o fim escalar, blocos + fim) e a
+        // linha inteira; 64 bytes de guarda depois do destino
+        const size_t counts[] = { 1, 3, 7, 11, 15, 16, 17, 31, 33, 47, 63, 64, 65, 100, 257, (size_t)width + 5 };
+        for (size_t count : counts) {
+            std::vector<uint8_t> expected(count * c.dstBytes + 64, 0xCD);
+            std::memcpy(expected.data(), src.data() + 4096, count * c.dstBytes);  // in-place parte do conteúdo
+            c.run(src.data(), expected.data(), count, Level::Scalar);
+            for (Level level : levels) {
+                std::vector<uint8_t> out(count * c.dstBytes + 64, 0xCD);
+                std::memcpy(out.data(), src.data() + 4096, count * c.dstBytes);
+                c.run(src.data(), out.data(), count, level);
+                if (out != expected) {
+                    std::printf("  %s: %s difere do escalar com %zu pixels\n", c.name, PixelConvert::levelName(level), count);
+                    allMatch = false;
+                }
+            }
+        }
+    }
+
+    // Ida e volta: BGRA -> RGB24 -> BGRA devolve o frame com alfa 255
+    std::vector<uint8_t> rgb(pixels * 3), back(pixels * 4), opaque(src);
+    PixelConvert::pack3(src.data(), rgb.data(), pixels, true);
+    PixelConvert::unpack3(rgb.data(), back.data(), pixels, true);
+    PixelConvert::fillAlpha(opaque.data(), pixels);
+    check(allMatch, "todos os níveis iguais ao escalar (fins de linha, sem escrever além)");
+    check(back == opaque, "BGRA -> RGB24 -> BGRA preserva as cores");
+}
+
+// ==================== SEÇÃO: PONTO FIXO ====================
+
+struct FixedMode {
+    const char* name;
+    CpuFilter::Interpolation interpolation;
+    CpuFilter::ChromaMode chroma;
+};
+
+static void benchFixed() {
+    using Level = Lut3DFixed::Level;
+    using I = CpuFilter::Interpolation;
+    using C = CpuFilter::ChromaMode;
+    const int width = 1920, height = 1080;
+    std::printf("\n[fixed] Ponto fixo (Q15) vs float, %dx%d ruído, LUT híbrida 32^3, 1 thread\n", width, height);
+
+    ThreadPool single(1);
+    CpuFilter filter(single);
+    filter.setStrength(0.8f);
+    const FixedMode modes[] = {
+        { "trilinear", I::Trilinear, C::Full },
+        { "1 ponto", I::Nearest, C::Full },
+        { "croma 2x2", I::Trilinear, C::Half },
+        { "1 ponto + 2x2", I::Nearest, C::Half },
+    };
+
+    std::vector<uint8_t> frame = TestFrames::make(TestFrames::Kind::Noise, width, height);
+    std::vector<uint8_t> reference(frame.size()), output(frame.size());
+    std::printf("  %-14s %10s %10s %8s %8s\n", "modo", "float(ms)", "fixo(ms)", "ganho", "maxdiff");
+    double floatTotal = 0.0, fixedTotal = 0.0;
+    for (const FixedMode& mode : modes) {
+        filter.setInterpolation(mode.interpolation);
+        filter.setChromaMode(mode.chroma);
+        filter.setArithmetic(CpuFilter::Arithmetic::Float);
+        double floatMs = bestOf(5, [&] { filter.apply(frame.data(), reference.data(), width, height); });
+        filter.setArithmetic(CpuFilter::Arithmetic::FixedPoint);
+        double fixedMs = bestOf(5, [&] { filter.apply(frame.data(), output.data(), width, height); });
+        int maxDiff = 0;
+        psnr(reference, output, &maxDiff);
+        std::printf("  %-14s %10.2f %10.2f %7.2fx %8d\n", mode.name, floatMs, fixedMs, floatMs / fixedMs, maxDiff);
+        floatTotal += floatMs;
+        fixedTotal += fixedMs;
+    }
+
+    // Todas as 2^24 cores, com intensidade total e parcial, contra o float
+    const int side = 4096;
+    std::vector<uint8_t> cube((size_t)side * side * 4);
+    for (size_t i = 0; i < (size_t)side * side; i++) {
+        cube[i * 4 + 0] = (uint8_t)(i >> 16);
+        cube[i * 4 + 1] = (uint8_t)(i >> 8);
+        cube[i * 4 + 2] = (uint8_t)i;
+        cube[i * 4 + 3] = (uint8_t)(i * 7);
+    }
+    reference.resize(cube.size());
+    output.resize(cube.size());
+    int worst = 0;
+    bool alphaKept = true;
+    for (const FixedMode& mode : modes) {
+        filter.setInterpolation(mode.interpolation);
+        filter.setChromaMode(mode.chroma);
+        for (float strength : { 1.0f, 0.35f }) {
+            filter.setStrength(strength);
+            filter.setArithmetic(CpuFilter::Arithmetic::Float);
+            filter.apply(cube.data(), reference.data(), side, side);
+            filter.setArithmetic(CpuFilter::Arithmetic::FixedPoint);
+            filter.apply(cube.data(), output.data(), side, side);
+            int maxDiff = 0;
+            psnr(reference, output, &maxDiff);
+            worst = std::max(worst, maxDiff);
+            for (size_t i = 3; i < cube.size() && alphaKept; i += 4) alphaKept = output[i] == cube[i];
+        }
+    }
+    std::printf("  2^24 cores, 4 modos: diferença máxima para o float %d LSB\n", worst);
+
+    // Níveis iguais ao escalar, inclusive nos fins de linha e in-place
+    Lut3DFixed fixed;
+    fixed.bind(filter.getLUT());
+    const int strengthQ15 = Lut3DFixed::strengthWeight(0.8f);
+    std::vector<Level> levels = { Level::Scalar };
+    if (Lut3DFixed::isSupported(Level::AVX2)) levels.push_back(Level::AVX2);
+    const uint8_t* sample = cube.data() + 4096;
+    const uint8_t* below = cube.data() + (size_t)side * 4 * 37;
+    const std::vector<uint8_t> noiseRow = TestFrames::make(TestFrames::Kind::Noise, width + 5, 1);
+    using Kernel = std::function<void(uint8_t* out, size_t count, Level level)>;
+    const std::pair<const char*, Kernel> kernels[] = {
+        { "trilinear", [&](uint8_t* out, size_t n, Level l) { fixed.applyBGRA(out, out, n, strengthQ15, l); } },
+        { "1 ponto", [&](uint8_t* out, size_t n, Level l) { fixed.applyBGRANearest(out, out, n, strengthQ15, l); } },
+        { "médias 2x2", [&](uint8_t* out, size_t n, Level l) { Lut3DFixed::averageBlocks(out, below, out, n, l); } },
+        { "deltas 2x2", [&](uint8_t* out, size_t n, Level l) { Lut3DFixed::addBlockDeltas(out, out, n, sample, below, l); } },
+        { "bordas 2x2", [&](uint8_t* out, size_t n, Level l) {
+              std::vector<int> edges((n + 1) / 2);
+              size_t found = Lut3DFixed::chromaEdges(out, noiseRow.data(), n, 255, edges.data(), l);
+              std::memcpy(out, edges.data(), found * sizeof(int));
+          } },
+    };
+    bool levelsMatch = true;
+    const size_t counts[] = { 1, 7, 8, 9, 15, 16, 17, 31, 33, 100, (size_t)width + 5 };
+    for (const auto& [name, run] : kernels) {
+        for (size_t count : counts) {
+            std::vector<uint8_t> expected(count * 4 + 64, 0xCD);
+            std::memcpy(expected.data(), sample, count * 4);
+            run(expected.data(), count, Level::Scalar);
+            for (Level level : levels) {
+                std::vector<uint8_t> out(count * 4 + 64, 0xCD);
+                std::memcpy(out.data(), sample, count * 4);
+                run(out.data(), count, level);
+                if (out != expected) {
+                    std::printf("  %s: %s difere do escalar com %zu pixels\n", name, Lut3DFixed::levelName(level), count);
+                    levelsMatch = false;
+                }
+            }
+        }
+    }
+
+    check(worst <= 1, "ponto fixo a até 1 LSB do float em todas as cores");
+    check(alphaKept, "alfa preservado");
+    check(levelsMatch, "níveis iguais ao escalar (fins de linha, in-place, sem escrever além)");
+    bool fixedDefault = CpuFilter::defaultArithmetic() == CpuFilter::Arithmetic::FixedPoint;
+    std::printf("  Padrão do CpuFilter: %s (%s); ponto fixo aqui %.2fx o float\n", fixedDefault ? "ponto fixo" : "float",
+                Lut3DFixed::levelName(Lut3DFixed::bestLevel()), floatTotal / fixedTotal);
+    check(fixedDefault == (fixedTotal < floatTotal), "padrão do CpuFilter é o caminho mais rápido nesta máquina");
+}
+
+// ==================== SEÇÃO: LAYOUT DA LUT ====================
+
+// Misses por pixel (milésimos), ou "n/d" sem acesso ao PMU
+static std::string missesPerPixel(int64_t misses, double pixels) {
+    if (misses < 0) return "n/d";
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", misses / pixels);
+    return text;
+}
+
+static void benchLayout() {
+    using Layout = Lut3DFixed::Layout;
+    const int width = 1920, height = 1080, frames = 5;
+    std::printf("\n[layout] Layout da tabela do ponto fixo, %dx%d, 1 thread, melhor de %d; misses por pixel\n",
+                width, height, frames);
+    PerfCounters counters;
+    if (!counters.available(PerfCounters::L1dLoadMisses)) {
+        std::printf("  (contadores de cache indisponíveis: perf_event_paranoid ou VM sem PMU)\n");
+    }
+
+    const int sizes[] = { 17, 32, 65 };
+    const TestFrames::Kind kinds[] = { TestFrames::Kind::Noise, TestFrames::Kind::Gradient };
+    const int strengthQ15 = Lut3DFixed::strengthWeight(0.8f);
+    bool allMatch = true;
+    for (int n : sizes) {
+        Lut3D lut = Lut3D::fromCorrection(n, CorrectionMethod::Hybrid);
+        std::printf("  LUT %d^3\n", n);
+        std::printf("    %-13s %8s", "layout", "tabela");
+        for (TestFrames::Kind kind : kinds) std::printf(" %9s(ms) %8s %8s", TestFrames::kindName(kind), "L1d", "LLC");
+        std::printf("\n");
+
+        std::vector<std::vector<uint8_t>> firstOutputs;
+        for (int i = 0; i < Lut3DFixed::layoutCount; i++) {
+            Lut3DFixed fixed;
+            fixed.bind(lut, (Layout)i);
+            // Escalar e AVX2 leem a tabela por caminhos diferentes
+            std::vector<uint8_t> probe = TestFrames::make(TestFrames::Kind::Noise, 333, 1);
+            std::vector<uint8_t> scalar(probe.size()), simd(probe.size());
+            for (bool nearest : { false, true }) {
+                for (Lut3DFixed::Level level : { Lut3DFixed::Level::Scalar, Lut3DFixed::bestLevel() }) {
+                    uint8_t* out = level == Lut3DFixed::Level::Scalar ? scalar.data() : simd.data();
+                    if (nearest) {
+                        fixed.applyBGRANearest(probe.data(), out, 333, strengthQ15, level);
+                    } else {
+                        fixed.applyBGRA(probe.data(), out, 333, strengthQ15, level);
+                    }
+                }
+                if (scalar != simd) allMatch = false;
+            }
+            std::printf("    %-13s %5zu KB", Lut3DFixed::layoutName((Layout)i), Lut3DFixed::tableBytes(n, (Layout)i) / 1024);
+            for (size_t k = 0; k < std::size(kinds); k++) {
+                std::vector<uint8_t> frame = TestFrames::make(kinds[k], width, height);
+                std::vector<uint8_t> output(frame.size());
+                auto run = [&] {
+                    for (int y = 0; y < height; y++) {
+                        size_t offset = (size_t)y * width * 4;
+                        fixed.applyBGRA(&frame[offset], &output[offset], width, strengthQ15);
+                    }
+                };
+                run();  // tabela no cache antes de contar
+                counters.start();
+                double ms = bestOf(frames, run);
+                const PerfCounters::Sample& sample = counters.stop();
+                double pixels = (double)width * height * frames;
+                std::printf(" %13.2f %8s %8s", ms, missesPerPixel(sample[PerfCounters::L1dLoadMisses], pixels).c_str(),
+                            missesPerPixel(sample[PerfCounters::CacheMisses], pixels).c_str());
+                if (i == 0) {
+                    firstOutputs.push_back(std::move(output));
+                } else if (output != firstOutputs[k]) {
+                    allMatch = false;
+                }
+            }
+            std::printf("\n");
+        }
+        std::printf("    escolhido pela medição em bind(): %s\n", Lut3DFixed::layoutName(Lut3DFixed::fastestLayout(n)));
+    }
+    check(allMatch, "todos os layouts dão a mesma saída (escalar e SIMD)");
+}
+
+// ==================== SEÇÃO: DITHER ====================
+
+static void benchDither() {
+    using Level = Lut3DFixed::Level;
+    const int width = 1024, height = 512, bandHeight = height / TestFrames::rampCount;
+    std::printf("\n[dither] Ruído azul na volta para 8 bits, rampas %dx%d (LSB, média 7x7 do erro contra a correção exata)\n",
+                width, height);
+    std::printf("  contornos: passa-faixa 7x7 - 49x49 (rms); interpolação: só a média 7x7 (rms/máx)\n");
+
+    ThreadPool single(1);
+    CpuFilter filter(single);
+    std::vector<uint8_t> ramps = TestFrames::make(TestFrames::Kind::Ramps, width, height);
+    FrameView rampView = FrameView::wrap(PixelFormat::BGRA8, ramps.data(), width, height);
+    std::vector<uint8_t> output(ramps.size()), plain(ramps.size());
+    FrameView outView = FrameView::wrap(PixelFormat::BGRA8, output.data(), width, height);
+
+    const CorrectionMethod methods[] = { CorrectionMethod::Hybrid, CorrectionMethod::LMS, CorrectionMethod::Daltonize };
+    const int sizes[] = { 9, 17, 33, 65 };
+    std::printf("  %-10s %5s %16s %16s %16s %8s\n", "método", "LUT", "contornos sem/com", "interp. sem", "interp. com",
+                "maxdiff");
+    int worstDiff = 0;
+    bool contoursRemoved = true, sizesSeparated = true;
+    for (CorrectionMethod method : methods) {
+        std::vector<float> exact =
+            Parity::exactOutput(rampView, [method](RGB c) { return ColorCorrection::apply(method, c); }, 1.0f);
+        BandingReport contours[std::size(sizes)][2], interpolation[std::size(sizes)][2];
+        for (size_t i = 0; i < std::size(sizes); i++) {
+            filter.setLUT(Lut3D::fromCorrection(sizes[i], method));
+            for (int dither = 0; dither < 2; dither++) {
+                filter.setDither(dither != 0);
+                filter.apply(ramps.data(), output.data(), width, height);
+                contours[i][dither] = Parity::banding(outView, exact, bandHeight);
+                interpolation[i][dither] = Parity::interpolationBanding(outView, exact, bandHeight);
+                if (!dither) plain = output;
+            }
+            int maxDiff = 0;
+            psnr(plain, output, &maxDiff);
+            worstDiff = std::max(worstDiff, maxDiff);
+            std::printf("  %-10s %2d^3  %7.3f / %6.3f  %7.3f / %5.2f  %7.3f / %5.2f %8d\n",
+                        ColorCorrection::methodName(method), sizes[i], contours[i][0].rms, contours[i][1].rms,
+                        interpolation[i][0].rms, interpolation[i][0].max, interpolation[i][1].rms,
+                        interpolation[i][1].max, maxDiff);
+            contoursRemoved = contoursRemoved && contours[i][1].rms < contours[i][0].rms;
+        }
+        // A grade maior nunca pode ficar pior (folga para o arredondamento
+        // dos nós, que não depende do tamanho: na daltonize a curva é quase
+        // reta e só ele sobra)
+        for (size_t i = 1; i < std::size(sizes); i++) {
+            sizesSeparated = sizesSeparated && interpolation[i][0].rms <= interpolation[i - 1][0].rms + 0.02;
+        }
+        std::printf("  %-10s 17^3 com dither %.3f, 33^3 sem %.3f (interpolação)\n", "",
+                    interpolation[1][1].rms, interpolation[2][0].rms);
+    }
+    filter.setDither(false);
+    check(contoursRemoved, "dither tira os contornos em todos os métodos e tamanhos");
+    check(sizesSeparated, "banding da interpolação não cresce com a LUT em nenhum método");
+
+    // Custo: o dither só troca a constante do arredondamento
+    const int benchWidth = 1920, benchHeight = 1080;
+    std::vector<uint8_t> noise = TestFrames::make(TestFrames::Kind::Noise, benchWidth, benchHeight);
+    output.resize(noise.size());
+    std::printf("  Tempo %dx%d ruído, 1 thread (ms)\n", benchWidth, benchHeight);
+    std::printf("    %-10s %8s %8s %8s %8s\n", "LUT", "fixo", "+dither", "float", "+dither");
+    for (int n : { 17, 33 }) {
+        filter.setLUT(Lut3D::fromCorrection(n, CorrectionMethod::Hybrid));
+        double ms[4];
+        int column = 0;
+        for (CpuFilter::Arithmetic arithmetic : { CpuFilter::Arithmetic::FixedPoint, CpuFilter::Arithmetic::Float }) {
+            filter.setArithmetic(arithmetic);
+            for (bool dither : { false, true }) {
+                filter.setDither(dither);
+                ms[column++] = bestOf(5, [&] { filter.apply(noise.data(), output.data(), benchWidth, benchHeight); });
+            }
+        }
+        std::printf("    %2d^3      %8.2f %8.2f %8.2f %8.2f\n", n, ms[0], ms[1], ms[2], ms[3]);
+    }
+    filter.setArithmetic(CpuFilter::defaultArithmetic());
+    filter.setDither(false);
+
+    // Kernels com dither: níveis iguais ao escalar em qualquer coluna inicial e fim de linha
+    Lut3DFixed fixed;
+    fixed.bind(Lut3D::fromCorrection(17, CorrectionMethod::Hybrid));
+    const int strengthQ15 = Lut3DFixed::strengthWeight(0.8f);
+    bool levelsMatch = true;
+    if (Lut3DFixed::isSupported(Level::AVX2)) {
+        for (int x : { 0, 5, 57, 63 }) {
+            for (size_t count : { (size_t)1, (size_t)8, (size_t)17, (size_t)100 }) {
+                for (bool nearest : { false, true }) {
+                    std::vector<uint8_t> results[2];
+                    for (Level level : { Level::Scalar, Level::AVX2 }) {
+                        std::vector<uint8_t>& out = results[level == Level::AVX2];
+                        out.assign(count * 4 + 64, 0xCD);
+                        const uint32_t* thresholds = BlueNoise::tile().thresholdRow(x + 3);
+                        if (nearest) {
+                            fixed.applyBGRANearestDithered(noise.data() + 4000, out.data(), count, strengthQ15, thresholds, x, level);
+                        } else {
+                            fixed.applyBGRADithered(noise.data() + 4000, out.data(), count, strengthQ15, thresholds, x, level);
+                        }
+                    }
+                    levelsMatch = levelsMatch && results[0] == results[1];
+                }
+            }
+        }
+    }
+
+    check(worstDiff <= 1, "com dither a até 1 LSB do arredondado");
+    check(levelsMatch, "dither: níveis iguais ao escalar (coluna inicial, fins de linha)");
+}
+
+// ==================== LUTGEN ====================
+
+static void benchLutgen() {
+    using Level = CorrectionModels::Level;
+    const CorrectionMethod methods[] = { CorrectionMethod::Hybrid, CorrectionMethod::LMS, CorrectionMethod::Daltonize,
+                                         CorrectionMethod::Machado };
+    const Deficiency deficiencies[] = { Deficiency::Protan, Deficiency::Deutan, Deficiency::Tritan };
+    std::vector<CorrectionModel> family;
+    for (CorrectionMethod method : methods) {
+        for (Deficiency deficiency : deficiencies) {
+            for (int step = 1; step <= 10; step++) family.push_back({ method, deficiency, step / 10.0f });
+        }
+    }
+    std::printf("\n[lutgen] %zu modelos (4 métodos x 3 deficiências x 10 severidades)\n", family.size());
+
+    // Volta linear -> byte sem pow igual à conta com pow
+    bool encodeMatches = true;
+    for (int i = -1000; i <= 1001000 && encodeMatches; i++) {
+        float v = i / 1000000.0f;
+        encodeMatches = CorrectionModels::encodeByte(v) ==
+                        Lut3D::toByte(SRGB::toSRGB(std::min(1.0f, std::max(0.0f, v))));
+    }
+
+    // Linhas das matrizes de Machado somam 1 (branco continua branco)
+    float worstRow = 0.0f;
+    for (Deficiency deficiency : deficiencies) {
+        for (int step = 0; step <= 20; step++) {
+            float m[9];
+            CorrectionModels::machadoMatrix(deficiency, step / 20.0f, m);
+            for (int row = 0; row < 3; row++) {
+                worstRow = std::max(worstRow, std::fabs(m[row * 3] + m[row * 3 + 1] + m[row * 3 + 2] - 1.0f));
+            }
+        }
+    }
+
+    // generate == Lut3D::fromFunction(apply) e AVX2 == escalar, byte a byte
+    bool functionMatches = true, levelsMatch = true;
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    for (int n : { 2, 9, 17, 33 }) {
+        std::vector<Lut3D> scalar = CorrectionModels::generateAll(family, n, &pool, Level::Scalar);
+        if (CorrectionModels::isSupported(Level::AVX2)) {
+            std::vector<Lut3D> avx2 = CorrectionModels::generateAll(family, n, &pool, Level::AVX2);
+            for (size_t i = 0; i < family.size(); i++) levelsMatch = levelsMatch && avx2[i].data == scalar[i].data;
+        }
+        if (n > 17) continue;
+        for (size_t i = 0; i < family.size(); i++) {
+            const CorrectionModel model = family[i];
+            Lut3D reference = Lut3D::fromFunction(n, [&](RGB c) { return CorrectionModels::apply(model, c); });
+            functionMatches = functionMatches && reference.data == scalar[i].data;
+        }
+    }
+
+    // Deutan completo contra as correções embutidas
+    std::printf("  %-10s %s\n", "deutan 1.0", "maxdiff contra ColorCorrection (33^3)");
+    int worstBuiltin = 0;
+    for (CorrectionMethod method : methods) {
+        Lut3D generated = CorrectionModels::generate({ method, Deficiency::Deutan, 1.0f }, 33);
+        Lut3D builtin = Lut3D::fromCorrection(33, method);
+        int maxDiff = 0;
+        psnr(generated.data, builtin.data, &maxDiff);
+        worstBuiltin = std::max(worstBuiltin, maxDiff);
+        std::printf("  %-10s %d\n", ColorCorrection::methodName(method), maxDiff);
+    }
+
+    // Família inteira, por nível e threads
+    std::printf("  Família a 65^3 (ms)\n");
+    std::printf("    %-8s %8s %8s\n", "", "1 thread", "pool");
+    ThreadPool single(1);
+    for (Level level : { Level::Scalar, Level::AVX2 }) {
+        if (!CorrectionModels::isSupported(level)) continue;
+        double ms[2];
+        int column = 0;
+        for (ThreadPool* target : { &single, &pool }) {
+            ms[column++] = bestOf(3, [&] { CorrectionModels::generateAll(family, 65, target, level); });
+        }
+        std::printf("    %-8s %8.1f %8.1f\n", level == Level::AVX2 ? "avx2" : "escalar", ms[0], ms[1]);
+    }
+
+    // .dlut ida e volta; PNG com assinatura e IEND no lugar
+    const std::string path = "colorbench_lutgen.dlut";
+    Lut3D written = CorrectionModels::generate({ CorrectionMethod::Machado, Deficiency::Tritan, 0.6f }, 17);
+    Lut3D read;
+    bool binaryRoundTrip = LutFiles::writeBinary(path, written) && LutFiles::readBinary(path, read) &&
+                           read.size == written.size && read.data == written.data;
+    std::remove(path.c_str());
+    std::vector<uint8_t> strip = written.toStrip();
+    std::vector<uint8_t> png = LutFiles::encodePng(strip.data(), written.size * written.size, written.size);
+    bool pngShape = png.size() > strip.size() && std::memcmp(png.data(), "\x89PNG\r\n\x1A\n", 8) == 0 &&
+                    std::memcmp(&png[png.size() - 8], "IEND", 4) == 0;
+
+    check(encodeMatches, "encodeByte igual a toByte(toSRGB(v))");
+    check(worstRow < 1e-4f, "linhas das matrizes de Machado somam 1");
+    check(functionMatches, "generate igual a Lut3D::fromFunction(apply)");
+    check(levelsMatch, "AVX2 igual ao escalar byte a byte (2, 9, 17, 33)");
+    check(worstBuiltin <= 1, "deutan 1.0 a até 1 LSB das correções embutidas");
+    check(binaryRoundTrip, ".dlut ida e volta");
+    check(pngShape, "PNG com assinatura e IEND");
+}
+
+// ==================== COMPOSIÇÃO ====================
+
+static void benchCompose() {
+    std::printf("\n[compose] Cadeia de transformações em uma LUT: erro contra a cadeia avaliada direto\n");
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    // "Calibração do monitor" sintética: balanço de branco e cruzamento
+    // leve entre canais em luz linear, para um monitor de gama 2.2
+    const float whiteBalance[9] = { 0.96f, 0.03f, 0.01f, 0.02f, 0.97f, 0.01f, 0.00f, 0.02f, 1.02f };
+    LutComposer display;
+    display.addToLinear().addMatrix(whiteBalance, nullptr, "balanço").addGamma(1.0f / 2.2f);
+    auto calibration = std::make_shared<const Lut3DF>(display.bake(17, &pool).lut);
+
+    // Sem LUT no meio (monitor analítico + contraste) o erro fica em ~1 LSB.
+    // Com a correção: LMS é contínua e o erro cai com a grade, mas o pior
+    // ponto fica perto do preto, onde a curva de gama do monitor é quase
+    // vertical; a híbrida troca de ramo quando a razão p/q passa de 0.8 ou
+    // 1.2 (degrau), que nenhuma grade interpola
+    std::vector<LutComposer> chains(3);
+    chains[0].addToLinear().addMatrix(whiteBalance, nullptr, "balanço").addGamma(1.0f / 2.2f).addContrast(1.15f);
+    const CorrectionMethod methods[] = { CorrectionMethod::LMS, CorrectionMethod::Hybrid };
+    for (int i = 0; i < 2; i++) {
+        const CorrectionMethod method = methods[i];
+        chains[i + 1]
+            .addFunction([method](RGB c) { return ColorCorrection::apply(method, c); }, ColorCorrection::methodName(method))
+            .addContrast(1.15f)
+            .addLut(calibration, "monitor");
+    }
+    std::printf("  %-5s %18s %18s %8s %8s  pior ponto\n", "LUT", "float (máx/rms)", "8 bits (máx/rms)", "bake ms", "verif.");
+    float smoothMax = 0.0f, lmsRms[3] = {};
+    for (size_t i = 0; i < chains.size(); i++) {
+        std::printf("  %s\n", chains[i].describe().c_str());
+        int column = 0;
+        for (int n : { 17, 33, 65 }) {
+            LutComposer::Result result = chains[i].bake(n, &pool);
+            const RGB& worst = result.quantized.worst;
+            std::printf("  %2d^3  %8.2f / %6.3f  %8.2f / %6.3f %8.1f %8.1f  (%.3f, %.3f, %.3f)\n", n,
+                        result.interpolation.max, result.interpolation.rms, result.quantized.max, result.quantized.rms,
+                        result.bakeMs, result.verifyMs, worst.r, worst.g, worst.b);
+            if (i == 0 && n == 65) smoothMax = result.quantized.max;
+            if (i == 1) lmsRms[column++] = result.interpolation.rms;
+        }
+    }
+    const LutComposer& chain = chains[1];
+
+    // Uma LUT sozinha na grade dela volta igual; matriz e inversa, identidade
+    Lut3D hybrid = Lut3D::fromCorrection(33, CorrectionMethod::Hybrid);
+    LutComposer single;
+    single.addLut(hybrid, "hybrid");
+    bool lutIdentity = single.bake(33, nullptr).bytes.data == hybrid.data;
+
+    const float m[9] = { 0.8f, 0.15f, 0.05f, 0.1f, 0.85f, 0.05f, 0.05f, 0.1f, 0.85f };
+    float inverse[9];
+    {
+        const float det = m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) +
+                          m[2] * (m[3] * m[7] - m[4] * m[6]);
+        inverse[0] = (m[4] * m[8] - m[5] * m[7]) / det;
+        inverse[1] = (m[2] * m[7] - m[1] * m[8]) / det;
+        inverse[2] = (m[1] * m[5] - m[2] * m[4]) / det;
+        inverse[3] = (m[5] * m[6] - m[3] * m[8]) / det;
+        inverse[4] = (m[0] * m[8] - m[2] * m[6]) / det;
+        inverse[5] = (m[2] * m[3] - m[0] * m[5]) / det;
+        inverse[6] = (m[3] * m[7] - m[4] * m[6]) / det;
+        inverse[7] = (m[1] * m[6] - m[0] * m[7]) / det;
+        inverse[8] = (m[0] * m[4] - m[1] * m[3]) / det;
+    }
+    LutComposer roundTrip;
+    roundTrip.addToLinear().addMatrix(m).addMatrix(inverse).addToSRGB();
+    Lut3D identity = Lut3D::fromFunction(17, [](RGB c) { return c; });
+    int identityDiff = 0;
+    psnr(roundTrip.bake(17, &pool).bytes.data, identity.data, &identityDiff);
+
+    // Pool e thread única dão a mesma LUT; bakeAsync não prende quem chama
+    LutComposer::Result serial = chain.bake(33, nullptr);
+    auto start = steady_clock::now();
+    std::future<LutComposer::Result> pending = chain.bakeAsync(33, &pool);
+    double launchMs = duration<double, std::milli>(steady_clock::now() - start).count();
+    LutComposer::Result async = pending.get();
+    std::printf("  bakeAsync 33^3: %.2f ms na thread chamadora, %.1f ms no total\n", launchMs,
+                duration<double, std::milli>(steady_clock::now() - start).count());
+
+    // .cube gravado e lido de volta como entra na cadeia
+    const std::string path = "colorbench_compose.cube";
+    Lut3DF cube;
+    bool cubeRoundTrip = LutFiles::writeCube(path, hybrid, "hybrid") && LutFiles::readCube(path, cube) &&
+                         cube.size == hybrid.size;
+    std::remove(path.c_str());
+    const Lut3DF expected = Lut3DF::fromLut3D(hybrid);
+    for (size_t i = 0; cubeRoundTrip && i < cube.data.size(); i++) {
+        cubeRoundTrip = std::fabs(cube.data[i] - expected.data[i]) < 1e-6f;
+    }
+
+    check(lutIdentity, "LUT sozinha na própria grade volta igual");
+    check(identityDiff <= 1, "matriz + inversa em luz linear a até 1 LSB da identidade");
+    check(smoothMax <= 2.0f, "monitor + contraste em 65^3: até 2 LSB da cadeia avaliada direto");
+    check(lmsRms[0] > lmsRms[1] && lmsRms[1] > lmsRms[2], "lms: erro de interpolação cai com o tamanho da LUT");
+    check(serial.bytes.data == async.bytes.data && serial.lut.data == async.lut.data,
+          "pool (bakeAsync) igual à thread única");
+    check(cubeRoundTrip, ".cube gravado e lido de volta");
+}
+
+// ==================== MAIN ====================
+
+struct BenchSection {
+    const char* name;
+    void (*run)();
+};
+
+static const BenchSection sections[] = {
+    {"srgb", benchSRGB},
+    {"chroma", benchChroma},
+    {"yuv", benchYuv},
+    {"hdr", benchHighDepth},
+    {"outputs", benchOutputs},
+    {"alloc", benchAllocation},
+    {"upload", benchUpload},
+    {"fanout", benchFanout},
+    {"stride", benchStrides},
+    {"roi", benchRegions},
+    {"governor", benchGovernor},
+    {"replay", benchReplay},
+    {"recording", benchRecording},
+    {"stages", benchStages},
+    {"convert", benchConvert},
+    {"fixed", benchFixed},
+    {"layout", benchLayout},
+    {"dither", benchDither},
+    {"lutgen", benchLutgen},
+    {"compose", benchCompose},
+};
+
+int main(int argc, char** argv) {
+    bool ranAny = false;
+    for (const BenchSection& section : sections) {
+        bool selected = (argc <= 1);
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], section.name) == 0) selected = true;
+        }
+        if (selected) {
+            section.run();
+            ranAny = true;
+        }
+    }
+
+    if (!ranAny) {
+        std::fprintf(stderr, "Seção desconhecida. Disponíveis:");
+        for (const BenchSection& section : sections) std::fprintf(stderr, " %s", section.name);
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    if (g_failures > 0) {
+        std::fprintf(stderr, "\n❌ %d verificação(ões) falharam\n", g_failures);
+        return 1;
+    }
+    return 0;
+}
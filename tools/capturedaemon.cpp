@@ -0,0 +1,145 @@
+// ==================== DAEMON DE CAPTURA ====================
+// Captura a tela uma única vez e publica os frames em um anel de memória
+// compartilhada; filtros, gravadores etc. se conectam como leitores e usam os
+// frames no lugar, sem cópia e sem uma segunda captura.
+//
+// Uso: capturedaemon serve [--name nome] [--synthetic LxA] [--fps N]
+//      capturedaemon read  [--name nome] [--seconds N]
+//
+// serve: Windows captura o monitor principal (GDI); em Linux, ou com
+//        --synthetic, publica frames sintéticos.
+// read:  leitor de exemplo (imprime frames/s, perdidos e latência).
+// O overlay se conecta com: DaltonismoFilter --attach nome
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "FrameSource.h"
+#include "ScreenCapture.h"
+#include "SharedFrameRing.h"
+
+using namespace std::chrono;
+
+static std::atomic<bool> g_running(true);
+
+static void onSignal(int) {
+    g_running = false;
+}
+
+static int serveFrames(const std::string& name, int width, int height, int fps, bool synthetic) {
+    std::unique_ptr<FrameSource> source;
+#ifdef _WIN32
+    if (!synthetic) {
+        std::vector<RECT> monitors = enumerateMonitors();
+        source.reset(new IndependentScreenCapture(monitors[0]));
+    }
+#else
+    synthetic = true;
+#endif
+    if (synthetic) source.reset(new SyntheticFrameSource(width, height, fps));
+
+    if (!source->initialize()) {
+        std::fprintf(stderr, "Falha ao inicializar a captura\n");
+        return 1;
+    }
+
+    SharedFrameRing ring;
+    if (!ring.create(name, source->getFormat(), source->getWidth(), source->getHeight()) ||
+        !ring.startServing()) {
+        std::fprintf(stderr, "Falha ao criar o anel compartilhado '%s'\n", name.c_str());
+        return 1;
+    }
+    if (!source->attachWriteTarget(&ring)) {
+        std::fprintf(stderr, "A fonte não escreve em memória externa\n");
+        return 1;
+    }
+    source->start();
+
+    std::printf("✅ Publicando '%s': %dx%d %s (%s)\n", name.c_str(), source->getWidth(), source->getHeight(),
+                pixelFormatName(source->getFormat()), synthetic ? "sintético" : "GDI");
+    int lastCount = 0;
+    while (g_running) {
+        std::this_thread::sleep_for(seconds(5));
+        int count = source->getFrameCount();
+        std::printf("📊 Captura: %d FPS\n", (count - lastCount) / 5);
+        lastCount = count;
+    }
+
+    source->stop();
+    ring.stopServing();
+    return 0;
+}
+
+static int readFrames(const std::string& name, int seconds) {
+    SharedFrameRingReader reader;
+    if (!reader.attach(name)) {
+        std::fprintf(stderr, "Não foi possível conectar a '%s' (daemon rodando?)\n", name.c_str());
+        return 1;
+    }
+    std::printf("✅ Conectado a '%s': %dx%d %s\n", name.c_str(), reader.getWidth(), reader.getHeight(),
+                pixelFormatName(reader.getFormat()));
+
+    auto end = steady_clock::now() + std::chrono::seconds(seconds);
+    int64_t latencySum = 0;
+    uint64_t intact = 0;
+    SharedFrameRingReader::Frame frame;
+    while (g_running && steady_clock::now() < end) {
+        if (!reader.waitFrame(frame, 100)) continue;
+        int64_t now = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        if (reader.isIntact(frame)) {
+            latencySum += now - frame.view.timestampUs;
+            intact++;
+        }
+    }
+
+    std::printf("Frames: %llu (%.1f/s) | perdidos %llu | rasgados %llu | latência média %.0f us\n",
+                (unsigned long long)reader.getFramesRead(), reader.getFramesRead() / (double)seconds,
+                (unsigned long long)reader.getFramesSkipped(), (unsigned long long)reader.getFramesTorn(),
+                intact ? latencySum / (double)intact : 0.0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || (std::strcmp(argv[1], "serve") != 0 && std::strcmp(argv[1], "read") != 0)) {
+        std::fprintf(stderr, "Uso: capturedaemon serve [--name nome] [--synthetic LxA] [--fps N]\n"
+                             "     capturedaemon read  [--name nome] [--seconds N]\n");
+        return 1;
+    }
+
+    std::string name = "capture";
+    int width = 1920, height = 1080, fps = 60, seconds = 10;
+    bool synthetic = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--name" && hasValue) {
+            name = argv[++i];
+        } else if (arg == "--synthetic" && hasValue) {
+            synthetic = true;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                std::fprintf(stderr, "Resolução inválida: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--fps" && hasValue) {
+            fps = std::atoi(argv[++i]);
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    return std::strcmp(argv[1], "serve") == 0 ? serveFrames(name, width, height, fps, synthetic)
+                                                    : readFrames(name, seconds);
+}
@@ -0,0 +1,106 @@
+// ==================== GERADOR DAS LUTs EMBUTIDAS ====================
+// Roda durante o build e escreve BuiltinLUTData.inc com:
+//   - cada PNG recebido na linha de comando (bytes já decodificados)
+//   - LUTs 32^3 derivadas de cada correção matemática (lms, daltonize, hybrid)
+//
+// Uso: lutbake <saida.inc> [lut.png ...]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "ColorCorrection.h"
+#include "Lut3D.h"
+#include "PixelConvert.h"
+
+struct BakedLUT {
+    std::string name;
+    int width, height, channels;
+    std::vector<unsigned char> pixels;
+};
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return (dot == std::string::npos) ? name : name.substr(0, dot);
+}
+
+static bool writeInc(const std::string& path, const std::vector<BakedLUT>& luts) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "lutbake: não foi possível criar %s\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(out, "// Gerado por tools/lutbake.cpp - não editar\n\n");
+    for (size_t i = 0; i < luts.size(); i++) {
+        std::fprintf(out, "static const unsigned char builtinLUT_%s[%zu] = {\n",
+                     luts[i].name.c_str(), luts[i].pixels.size());
+        const std::vector<unsigned char>& px = luts[i].pixels;
+        for (size_t j = 0; j < px.size(); j++) {
+            std::fprintf(out, "%u,%s", px[j], (j % 24 == 23) ? "\n" : "");
+        }
+        std::fprintf(out, "\n};\n\n");
+    }
+
+    std::fprintf(out, "static const BuiltinLUT builtinLUTs[] = {\n");
+    for (const BakedLUT& lut : luts) {
+        std::fprintf(out, "    { \"%s\", %d, %d, %d, builtinLUT_%s },\n",
+                     lut.name.c_str(), lut.width, lut.height, lut.channels, lut.name.c_str());
+    }
+    std::fprintf(out, "};\n\nstatic const int builtinLUTCount = %zu;\n", luts.size());
+    std::fclose(out);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Uso: lutbake <saida.inc> [lut.png ...]\n");
+        return 1;
+    }
+
+    std::vector<BakedLUT> luts;
+
+    // LUTs distribuídas em PNG
+    for (int i = 2; i < argc; i++) {
+        int width, height, channels;
+        unsigned char* data = stbi_load(argv[i], &width, &height, &channels, 0);
+        if (!data) {
+            std::fprintf(stderr, "lutbake: erro ao carregar %s: %s\n", argv[i], stbi_failure_reason());
+            return 1;
+        }
+        if (!Lut3D::fromStrip(data, width, height, channels).isValid()) {
+            std::fprintf(stderr, "lutbake: %s não é uma faixa de LUT 3D (%dx%d)\n", argv[i], width, height);
+            stbi_image_free(data);
+            return 1;
+        }
+        // PNG com alfa (RGBA) entra como RGB: o alfa da faixa não é usado
+        BakedLUT lut{ baseName(argv[i]), width, height, channels,
+                      std::vector<unsigned char>(data, data + (size_t)width * height * channels) };
+        if (channels == 4) {
+            lut.pixels.resize((size_t)width * height * 3);
+            PixelConvert::pack3(data, lut.pixels.data(), (size_t)width * height, false);
+            lut.channels = 3;
+        }
+        luts.push_back(lut);
+        stbi_image_free(data);
+    }
+
+    // LUTs derivadas das correções matemáticas
+    const int size = 32;
+    const CorrectionMethod methods[] = {
+        CorrectionMethod::LMS, CorrectionMethod::Daltonize, CorrectionMethod::Hybrid
+    };
+    for (CorrectionMethod method : methods) {
+        Lut3D lut = Lut3D::fromCorrection(size, method);
+        luts.push_back({ ColorCorrection::methodName(method), size * size, size, 3, lut.toStrip() });
+    }
+
+    if (!writeInc(argv[1], luts)) return 1;
+    std::printf("lutbake: %zu LUTs escritas em %s\n", luts.size(), argv[1]);
+    return 0;
+}
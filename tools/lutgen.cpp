@@ -0,0 +1,296 @@
+// ==================== GERADOR DE LUTs ====================
+// Gera famílias de LUTs a partir dos modelos de CorrectionModels.h (lms,
+// daltonize, hybrid, machado) para protan, deutan e tritan, em qualquer
+// combinação de severidades e tamanhos. Cada plano de cada LUT é uma tarefa
+// do ThreadPool e as linhas são avaliadas com AVX2 quando a CPU tem; a
+// gravação também é paralela (uma LUT por tarefa).
+//
+// Uso: lutgen [opções]
+//   --method lista        lms,daltonize,hybrid,machado ou all (padrão all)
+//   --deficiency lista    protan,deutan,tritan ou all (padrão all)
+//   --severity lista      0..1, ex. 0.5,1 ou all = 0.1 a 1.0 (padrão 1)
+//   --size lista          2..256, ex. 17,33,65 (padrão 33)
+//   --format lista        png,cube,dlut ou all (padrão png)
+//   --out pasta           destino, criado se preciso (padrão luts/gerados)
+//   --threads N           padrão: todos os núcleos
+//   --scalar              sem AVX2 (referência)
+//   --dry-run             só gera e mede, sem gravar
+//   --contrast ganho      reforço de contraste depois da correção (1 = nenhum)
+//   --display arquivo     calibração do monitor (.cube ou .dlut), por último
+//
+// Com --contrast ou --display cada LUT sai da composição (LutComposer.h):
+// correção analítica -> contraste -> calibração em uma tabela só, com o
+// erro máximo contra a cadeia avaliada direto.
+//
+// Arquivos: <método>_<deficiência>_<severidade %>_<tamanho>.<formato>, ex.
+// hybrid_deutan_100_33.png (faixa que o overlay lê no lugar da LUT externa
+// quando o tamanho é 32).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "CorrectionModels.h"
+#include "LutComposer.h"
+#include "Lut3D.h"
+#include "LutFiles.h"
+#include "ThreadPool.h"
+
+using namespace std::chrono;
+
+static std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        if (comma > start) items.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+static bool parseMethod(const std::string& name, CorrectionMethod& method) {
+    const CorrectionMethod all[] = { CorrectionMethod::LMS, CorrectionMethod::Daltonize, CorrectionMethod::Hybrid,
+                                     CorrectionMethod::Machado };
+    for (CorrectionMethod candidate : all) {
+        if (name == ColorCorrection::methodName(candidate)) {
+            method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseDeficiency(const std::string& name, Deficiency& deficiency) {
+    const Deficiency all[] = { Deficiency::Protan, Deficiency::Deutan, Deficiency::Tritan };
+    for (Deficiency candidate : all) {
+        if (name == CorrectionModel::deficiencyName(candidate)) {
+            deficiency = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::string methodList = "all", deficiencyList = "all", severityList = "1", sizeList = "33";
+    std::string formatList = "png", outDir = "luts/gerados";
+    std::string displayPath;
+    float contrast = 1.0f;
+    int threads = 0;
+    bool dryRun = false;
+    CorrectionModels::Level level = CorrectionModels::bestLevel();
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--method" && hasValue) {
+            methodList = argv[++i];
+        } else if (arg == "--deficiency" && hasValue) {
+            deficiencyList = argv[++i];
+        } else if (arg == "--severity" && hasValue) {
+            severityList = argv[++i];
+        } else if (arg == "--size" && hasValue) {
+            sizeList = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            formatList = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            outDir = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--scalar") {
+            level = CorrectionModels::Level::Scalar;
+        } else if (arg == "--dry-run") {
+            dryRun = true;
+        } else if (arg == "--contrast" && hasValue) {
+            contrast = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--display" && hasValue) {
+            displayPath = argv[++i];
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", arg.c_str());
+            std::fprintf(stderr, "Uso: lutgen [--method lista] [--deficiency lista] [--severity lista] [--size lista]"
+                                 " [--format png,cube,dlut] [--out pasta] [--threads N] [--scalar] [--dry-run]"
+                                 " [--contrast ganho] [--display arquivo]\n");
+            return 1;
+        }
+    }
+
+    std::vector<CorrectionMethod> methods;
+    for (const std::string& name : splitList(methodList == "all" ? "lms,daltonize,hybrid,machado" : methodList)) {
+        CorrectionMethod method;
+        if (!parseMethod(name, method)) {
+            std::fprintf(stderr, "Método desconhecido: %s\n", name.c_str());
+            return 1;
+        }
+        methods.push_back(method);
+    }
+    std::vector<Deficiency> deficiencies;
+    for (const std::string& name : splitList(deficiencyList == "all" ? "protan,deutan,tritan" : deficiencyList)) {
+        Deficiency deficiency;
+        if (!parseDeficiency(name, deficiency)) {
+            std::fprintf(stderr, "Deficiência desconhecida: %s\n", name.c_str());
+            return 1;
+        }
+        deficiencies.push_back(deficiency);
+    }
+    std::vector<float> severities;
+    if (severityList == "all") {
+        for (int i = 1; i <= 10; i++) severities.push_back(i / 10.0f);
+    } else {
+        for (const std::string& text : splitList(severityList)) {
+            float severity = std::strtof(text.c_str(), nullptr);
+            if (!(severity >= 0.0f && severity <= 1.0f)) {
+                std::fprintf(stderr, "Severidade fora de 0..1: %s\n", text.c_str());
+                return 1;
+            }
+            severities.push_back(severity);
+        }
+    }
+    std::vector<int> sizes;
+    for (const std::string& text : splitList(sizeList)) {
+        int size = std::atoi(text.c_str());
+        if (size < 2 || size > CorrectionModels::maxSize) {
+            std::fprintf(stderr, "Tamanho fora de 2..%d: %s\n", CorrectionModels::maxSize, text.c_str());
+            return 1;
+        }
+        sizes.push_back(size);
+    }
+    bool png = false, cube = false, binary = false;
+    for (const std::string& format : splitList(formatList == "all" ? "png,cube,dlut" : formatList)) {
+        if (format == "png") {
+            png = true;
+        } else if (format == "cube") {
+            cube = true;
+        } else if (format == "dlut") {
+            binary = true;
+        } else {
+            std::fprintf(stderr, "Formato desconhecido: %s\n", format.c_str());
+            return 1;
+        }
+    }
+    if (methods.empty() || deficiencies.empty() || severities.empty() || sizes.empty()) {
+        std::fprintf(stderr, "Nada para gerar\n");
+        return 1;
+    }
+
+    if (!(contrast > 0.0f && contrast <= 4.0f)) {
+        std::fprintf(stderr, "Contraste fora de (0, 4]\n");
+        return 1;
+    }
+    std::shared_ptr<const Lut3DF> display;
+    if (!displayPath.empty()) {
+        Lut3DF table;
+        bool ok;
+        if (std::filesystem::path(displayPath).extension() == ".dlut") {
+            Lut3D bytes;
+            ok = LutFiles::readBinary(displayPath, bytes);
+            if (ok) table = Lut3DF::fromLut3D(bytes);
+        } else {
+            ok = LutFiles::readCube(displayPath, table);
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Calibração inválida (.cube 3D ou .dlut): %s\n", displayPath.c_str());
+            return 1;
+        }
+        display = std::make_shared<const Lut3DF>(std::move(table));
+    }
+    const bool compose = display || contrast != 1.0f;
+
+    std::vector<CorrectionModel> models;
+    for (CorrectionMethod method : methods) {
+        for (Deficiency deficiency : deficiencies) {
+            for (float severity : severities) models.push_back({ method, deficiency, severity });
+        }
+    }
+    if (!dryRun) {
+        std::error_code error;
+        std::filesystem::create_directories(outDir, error);
+        if (error) {
+            std::fprintf(stderr, "Não foi possível criar %s: %s\n", outDir.c_str(), error.message().c_str());
+            return 1;
+        }
+    }
+
+    ThreadPool pool(threads);
+    std::printf("🎨 %zu modelos x %zu tamanhos, %d threads, %s\n", models.size(), sizes.size(), pool.getThreadCount(),
+                level == CorrectionModels::Level::AVX2 ? "AVX2" : "escalar");
+    if (compose) {
+        std::printf("   Composição: correção%s%s\n", contrast != 1.0f ? " -> contraste" : "",
+                    display ? (" -> " + displayPath).c_str() : "");
+    }
+    int failures = 0;
+    double totalGenerateMs = 0.0, totalWriteMs = 0.0;
+    uint64_t totalBytes = 0;
+    for (int size : sizes) {
+        auto start = steady_clock::now();
+        std::vector<Lut3D> luts;
+        float worstError = 0.0f, worstRms = 0.0f;
+        if (compose) {
+            // Uma composição por vez, cada uma espalhada pelo pool
+            for (const CorrectionModel& model : models) {
+                const CorrectionModels::Params params = CorrectionModels::compile(model);
+                LutComposer chain;
+                chain.addFunction([params](RGB c) { return CorrectionModels::evaluate(params, c); }, model.name());
+                if (contrast != 1.0f) chain.addContrast(contrast);
+                if (display) chain.addLut(display, "monitor");
+                LutComposer::Result result = chain.bake(size, &pool);
+                worstError = std::max(worstError, result.quantized.max);
+                worstRms = std::max(worstRms, result.quantized.rms);
+                luts.push_back(std::move(result.bytes));
+            }
+        } else {
+            luts = CorrectionModels::generateAll(models, size, &pool, level);
+        }
+        double generateMs = duration<double, std::milli>(steady_clock::now() - start).count();
+        double points = (double)models.size() * size * size * size;
+        totalGenerateMs += generateMs;
+
+        double writeMs = 0.0;
+        std::vector<uint64_t> bytes(luts.size(), 0);
+        std::vector<int> failed(luts.size(), 0);
+        if (!dryRun) {
+            start = steady_clock::now();
+            pool.parallelFor(0, (int)luts.size(), 1, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    std::string base = outDir + "/" + models[i].name() + "_" + std::to_string(size);
+                    auto written = [&](const std::string& path, bool ok) {
+                        std::error_code error;
+                        uint64_t fileSize = std::filesystem::file_size(path, error);
+                        if (ok && !error) bytes[i] += fileSize;
+                        if (!ok) failed[i]++;
+                    };
+                    if (png) written(base + ".png", LutFiles::writeStripPng(base + ".png", luts[i]));
+                    if (cube) written(base + ".cube", LutFiles::writeCube(base + ".cube", luts[i], models[i].name()));
+                    if (binary) written(base + ".dlut", LutFiles::writeBinary(base + ".dlut", luts[i]));
+                }
+            });
+            writeMs = duration<double, std::milli>(steady_clock::now() - start).count();
+        }
+        uint64_t sizeBytes = 0;
+        for (size_t i = 0; i < luts.size(); i++) {
+            sizeBytes += bytes[i];
+            if (failed[i]) {
+                failures++;
+                std::fprintf(stderr, "❌ Falha ao gravar %s_%d\n", models[i].name().c_str(), size);
+            }
+        }
+        totalWriteMs += writeMs;
+        totalBytes += sizeBytes;
+        std::printf("   %3d^3: %zu LUTs em %.1f ms (%.1f Mpontos/s)", size, luts.size(), generateMs,
+                    points / (generateMs * 1000.0));
+        if (!dryRun) std::printf(", gravadas em %.1f ms (%.1f MB)", writeMs, sizeBytes / (1024.0 * 1024.0));
+        std::printf("\n");
+        if (compose) {
+            std::printf("          composição: erro contra a cadeia direto até %.2f LSB (rms até %.3f)\n", worstError,
+                        worstRms);
+        }
+    }
+    std::printf("✅ Total: geração %.1f ms", totalGenerateMs);
+    if (!dryRun) std::printf(", gravação %.1f ms, %.1f MB em %s", totalWriteMs, totalBytes / (1024.0 * 1024.0), outDir.c_str());
+    std::printf("\n");
+    return failures ? 1 : 0;
+}
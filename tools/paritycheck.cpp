@@ -0,0 +1,1117 @@
+// ==================== PARIDADE ENTRE BACKENDS ====================
+// Passa frames de teste padrão por todos os kernels (CPU e, onde há EGL, o
+// shader do overlay em um contexto GL sem janela - llvmpipe no CI) e compara
+// cada saída com o filtro de referência de Parity.h, ou com outro kernel,
+// segundo a regra do kernel (exata, até N LSB ou ΔE). Mede o tempo de cada
+// kernel em 1080p ao lado do resultado.
+//
+// Um kernel otimizado só entra como opção selecionável (CpuFilter, escada do
+// QualityGovernor, caminho da GPU) com uma entrada aqui passando. Kernels
+// "informativos" aparecem no relatório mas não bloqueiam.
+//
+// Uso: paritycheck [-v] [--save dir] [--golden dir] [--shaders dir] [kernel ...]
+//   -v             uma linha por frame x caso, não só o total do kernel
+//   --save dir     grava as saídas de referência (imagens golden, PPM) e as
+//                  saídas dos kernels que falharem
+//   --golden dir   compara a referência com as golden gravadas antes (exata)
+//   --shaders dir  pasta dos .glsl do overlay (padrão: shaders, copiada pelo CMake)
+// Termina com código 1 se algum kernel não informativo falhar.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BlueNoise.h"
+#include "CpuFilter.h"
+#include "Frame.h"
+#include "Half.h"
+#include "Lut3D.h"
+#include "Parity.h"
+#include "RegionOfInterest.h"
+#include "TestFrames.h"
+#include "YuvFilter.h"
+
+#ifdef DALTONISMO_PARITY_GL
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "ComputeFilter.h"
+#include "GLFormats.h"
+#include "HeadlessGL.h"
+#include "OverlayShaders.h"
+#include "ShaderReloader.h"
+#endif
+
+using namespace std::chrono;
+
+// ==================== CASOS DE TESTE ====================
+
+// Uma combinação LUT x intensidade aplicada a todos os frames
+struct ParityCase {
+    std::string lutName;
+    std::shared_ptr<const Lut3D> lut;
+    float strength;
+};
+
+struct ParityFrame {
+    std::string name;
+    int width, height;
+    std::vector<uint8_t> pixels;  // BGRA8 compacto
+    bool coherent;                // vizinhos parecidos (não vale para ruído / cubo)
+
+    FrameView view() { return FrameView::wrap(PixelFormat::BGRA8, pixels.data(), width, height); }
+};
+
+// 64 níveis por canal: todas as 262144 combinações em um frame 512x512
+static std::vector<uint8_t> makeColorCube() {
+    std::vector<uint8_t> frame((size_t)512 * 512 * 4);
+    for (int i = 0; i < 512 * 512; i++) {
+        uint8_t* p = &frame[(size_t)i * 4];
+        p[2] = (uint8_t)((i & 63) * 255 / 63);
+        p[1] = (uint8_t)(((i >> 6) & 63) * 255 / 63);
+        p[0] = (uint8_t)(((i >> 12) & 63) * 255 / 63);
+        p[3] = 255;
+    }
+    return frame;
+}
+
+static std::vector<ParityFrame> makeFrames() {
+    std::vector<ParityFrame> frames;
+    frames.push_back({ "cubo", 512, 512, makeColorCube(), false });
+    // Dimensões ímpares: bordas dos blocos 2x2 e das faixas do ThreadPool
+    const TestFrames::Kind kinds[] = { TestFrames::Kind::Gradient, TestFrames::Kind::ColorBars,
+                                       TestFrames::Kind::Noise, TestFrames::Kind::Text, TestFrames::Kind::Ramps };
+    for (TestFrames::Kind kind : kinds) {
+        frames.push_back({ TestFrames::kindName(kind), 321, 179, TestFrames::make(kind, 321, 179),
+                           kind != TestFrames::Kind::Noise });
+    }
+    return frames;
+}
+
+static std::vector<ParityCase> makeCases() {
+    auto hybrid = std::make_shared<const Lut3D>(Lut3D::fromCorrection(32, CorrectionMethod::Hybrid));
+    auto lms = std::make_shared<const Lut3D>(Lut3D::fromCorrection(32, CorrectionMethod::LMS));
+    return {
+        { "hybrid", hybrid, 1.0f },
+        { "hybrid", hybrid, 0.6f },  // intensidade padrão do overlay
+        { "lms", lms, 1.0f },
+    };
+}
+
+// ==================== CONVERSÕES AUXILIARES ====================
+
+// BGRA8 <-> I420 com as conversões de referência do YuvFilter (croma: média 2x2)
+static void bgraToI420(const YuvFilter& converter, const FrameView& src, const FrameView& dst) {
+    for (int y = 0; y < src.height; y += 2) {
+        for (int x = 0; x < src.width; x += 2) {
+            float sumU = 0.0f, sumV = 0.0f;
+            int count = 0;
+            for (int dy = 0; dy < 2 && y + dy < src.height; dy++) {
+                for (int dx = 0; dx < 2 && x + dx < src.width; dx++) {
+                    const uint8_t* p = src.row(0, y + dy) + (size_t)(x + dx) * 4;
+                    float rgb[3] = { p[2] / 255.0f, p[1] / 255.0f, p[0] / 255.0f }, yuv[3];
+                    converter.rgbToYuv(rgb, yuv);
+                    dst.row(0, y + dy)[x + dx] = Lut3D::toByte(yuv[0] / 255.0f);
+                    sumU += yuv[1];
+                    sumV += yuv[2];
+                    count++;
+                }
+            }
+            dst.row(1, y / 2)[x / 2] = Lut3D::toByte(sumU / count / 255.0f);
+            dst.row(2, y / 2)[x / 2] = Lut3D::toByte(sumV / count / 255.0f);
+        }
+    }
+}
+
+static void i420ToBgra(const YuvFilter& converter, const FrameView& src, const FrameView& dst) {
+    for (int y = 0; y < src.height; y++) {
+        for (int x = 0; x < src.width; x++) {
+            float rgb[3];
+            converter.yuvToRgb(src.row(0, y)[x], src.row(1, y / 2)[x / 2], src.row(2, y / 2)[x / 2], rgb);
+            uint8_t* p = dst.row(0, y) + (size_t)x * 4;
+            p[0] = Lut3D::toByte(rgb[2]);
+            p[1] = Lut3D::toByte(rgb[1]);
+            p[2] = Lut3D::toByte(rgb[0]);
+            p[3] = 255;
+        }
+    }
+}
+
+// BGRA8 <-> RGB10A2 / RGBA16F (valores exatos de 8 bits na ida). RGBA16F é
+// scRGB linear: o RGB vai decodificado de sRGB e volta codificado
+static void expandHighDepth(const FrameView& src, const FrameView& dst) {
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* s = src.row(0, y);
+        uint8_t* d = dst.row(0, y);
+        for (int x = 0; x < src.width; x++, s += 4) {
+            float rgba[4] = { s[2] / 255.0f, s[1] / 255.0f, s[0] / 255.0f, s[3] / 255.0f };
+            if (dst.format == PixelFormat::RGBA16F) {
+                for (int c = 0; c < 3; c++) rgba[c] = SRGB::toLinear(rgba[c]);
+                for (int c = 0; c < 4; c++) ((uint16_t*)d)[x * 4 + c] = Half::fromFloat(rgba[c]);
+            } else {
+                uint32_t v = (uint32_t)(rgba[0] * 1023.0f + 0.5f) | ((uint32_t)(rgba[1] * 1023.0f + 0.5f) << 10) |
+                             ((uint32_t)(rgba[2] * 1023.0f + 0.5f) << 20) | ((uint32_t)(rgba[3] * 3.0f + 0.5f) << 30);
+                std::memcpy(d + (size_t)x * 4, &v, 4);
+            }
+        }
+    }
+}
+
+static void reduceHighDepth(const FrameView& src, const FrameView& dst) {
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* s = src.row(0, y);
+        uint8_t* d = dst.row(0, y);
+        for (int x = 0; x < src.width; x++, d += 4) {
+            float rgba[4];
+            if (src.format == PixelFormat::RGBA16F) {
+                for (int c = 0; c < 4; c++) rgba[c] = Half::toFloat(((const uint16_t*)s)[x * 4 + c]);
+                for (int c = 0; c < 3; c++) rgba[c] = SRGB::toSRGB(rgba[c]);
+            } else {
+                uint32_t v;
+                std::memcpy(&v, s + (size_t)x * 4, 4);
+                rgba[0] = (v & 0x3FF) / 1023.0f;
+                rgba[1] = ((v >> 10) & 0x3FF) / 1023.0f;
+                rgba[2] = ((v >> 20) & 0x3FF) / 1023.0f;
+                rgba[3] = (v >> 30) / 3.0f;
+            }
+            d[0] = Lut3D::toByte(rgba[2]);
+            d[1] = Lut3D::toByte(rgba[1]);
+            d[2] = Lut3D::toByte(rgba[0]);
+            d[3] = Lut3D::toByte(rgba[3]);
+        }
+    }
+}
+
+// ==================== BACKEND OPENGL (SEM JANELA) ====================
+#ifdef DALTONISMO_PARITY_GL
+
+static std::string g_shaderDir = "shaders";
+
+// Modos do fragment shader: dither e os degraus do governador
+struct ShaderMode {
+    bool dither = false;
+    bool lutNearest = false;
+    bool halfChroma = false;  // dois passos, como render() de main.cpp
+    int mathMethod = -1;      // >= 0: LUT desligada, correctionMethod do shader
+};
+
+class GLBackend {
+private:
+    HeadlessGL gl;
+    bool tried = false, ok = false;
+    GLuint vao = 0, vbo = 0, screenTexture = 0, lutTexture = 0, noiseTexture = 0;
+    GLuint fbo = 0, colorTexture = 0;
+    int targetWidth = 0, targetHeight = 0;
+    GLuint chromaFbo = 0, chromaTexture = 0;  // croma 2x2: deltas em meia resolução
+    int chromaWidth = 0, chromaHeight = 0;
+    const Lut3D* uploadedLut = nullptr;
+    std::map<std::string, GLuint> programs;
+
+    // Caminho de compute (GL 4.3): alvo próprio, lido por um FBO
+    ComputeFilter compute;
+    bool computeTried = false, computeOk = false;
+    GLuint computeTexture = 0, computeFbo = 0;
+    int computeWidth = 0, computeHeight = 0;
+
+    void setupTarget(int width, int height) {
+        if (width == targetWidth && height == targetHeight) return;
+        if (!fbo) {
+            glGenFramebuffers(1, &fbo);
+            glGenTextures(1, &colorTexture);
+        }
+        // sRGB como a janela do overlay (GLFW_SRGB_CAPABLE): sem
+        // GL_FRAMEBUFFER_SRGB ligado a escrita e a leitura são diretas
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        targetWidth = width;
+        targetHeight = height;
+    }
+
+    // Mesmo alvo do overlay (renderChromaDeltas de main.cpp)
+    void setupChromaTarget(int width, int height) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        if (width == chromaWidth && height == chromaHeight) return;
+        if (!chromaFbo) {
+            glGenFramebuffers(1, &chromaFbo);
+            glGenTextures(1, &chromaTexture);
+        }
+        glActiveTexture(GL_TEXTURE3);  // a LUT e o ruído já estão nas unidades 1 e 2
+        glBindTexture(GL_TEXTURE_2D, chromaTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        glBindFramebuffer(GL_FRAMEBUFFER, chromaFbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, chromaTexture, 0);
+        chromaWidth = width;
+        chromaHeight = height;
+    }
+
+    // Mesmo upload do LUTLoader de main.cpp: faixa horizontal em GL_RGB16F
+    void uploadLut(const Lut3D& lut) {
+        if (uploadedLut == &lut) return;
+        std::vector<uint8_t> strip = lut.toStrip();
+        std::vector<float> texels(strip.size());
+        for (size_t i = 0; i < strip.size(); i++) texels[i] = strip[i] / 255.0f;
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, lut.size * lut.size, lut.size, 0, GL_RGB, GL_FLOAT, texels.data());
+        uploadedLut = &lut;
+    }
+
+public:
+    bool available() {
+        if (tried) return ok;
+        tried = true;
+        // 4.3 para o caminho de compute; o fragment shader roda em qualquer um
+        ok = gl.create(4, 3);
+        if (!ok) {
+            gl.destroy();
+            ok = gl.create();
+        }
+        if (!ok) return false;
+        std::printf("  GL: %s\n", gl.renderer().c_str());
+
+        // Quad de tela cheia igual ao setupGeometry de main.cpp
+        const float quad[] = {
+            -1.0f,  1.0f,  0.0f, 1.0f,   -1.0f, -1.0f,  0.0f, 0.0f,   1.0f, -1.0f,  1.0f, 0.0f,
+            -1.0f,  1.0f,  0.0f, 1.0f,    1.0f, -1.0f,  1.0f, 0.0f,   1.0f,  1.0f,  1.0f, 1.0f,
+        };
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        GLuint textures[2];
+        glGenTextures(2, textures);
+        screenTexture = textures[0];
+        lutTexture = textures[1];
+        for (GLuint texture : textures) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        // Ruído do dither, como em main.cpp
+        glGenTextures(1, &noiseTexture);
+        glBindTexture(GL_TEXTURE_2D, noiseTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, BlueNoise::size, BlueNoise::size, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     BlueNoise::tile().textureBytes());
+        return true;
+    }
+
+    void bindLutAndNoise() {
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, noiseTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+    }
+
+    // Programa com o vertex shader do overlay; 0 se não compilar
+    GLuint program(const std::string& name, const std::string& fragmentSource) {
+        auto found = programs.find(name);
+        if (found != programs.end()) return found->second;
+
+        std::string log;
+        GLuint id = linkProgram(vertexShaderSource, fragmentSource, &log);
+        if (!id) std::printf("  ⚠️ %s não compilou: %s\n", name.c_str(), log.c_str());
+        programs[name] = id;
+        return id;
+    }
+
+    // Programa de shaders/ pelo mesmo caminho do overlay: ShaderReloader
+    // compila em outra thread, com um contexto compartilhado, e este contexto
+    // pega o resultado com take()
+    GLuint reloadedProgram(const std::string& directory) {
+        auto found = programs.find("shaders/");
+        if (found != programs.end()) return found->second;
+        programs["shaders/"] = 0;
+
+        ShaderReloader::Options options;
+        options.vertexPath = directory + "/vertex.glsl";
+        options.fragmentPath = directory + "/fragment.glsl";
+        options.fallbackVertex = vertexShaderSource;
+        options.fallbackFragment = fragmentShaderSource;
+        options.samplers = { { "screenTexture", 0 }, { "lutTexture", 1 }, { "noiseTexture", 2 }, { "chromaTexture", 3 } };
+        options.interval = std::chrono::milliseconds(10);
+        HeadlessGL worker;
+        if (!worker.createShared(gl)) {
+            std::printf("  ⚠️ sem contexto compartilhado para compilar shaders/\n");
+            return 0;
+        }
+        options.makeCurrent = [&] { worker.makeCurrent(); };
+        options.release = [&] { worker.release(); };
+
+        ShaderReloader reloader;
+        reloader.start(options);
+        GLuint id = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!id && reloader.getFailures() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            id = reloader.take(0);
+        }
+        reloader.stop();
+        worker.destroy();
+        programs["shaders/"] = id;
+        return id;
+    }
+
+    bool render(GLuint id, const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                ShaderMode mode = ShaderMode()) {
+        if (!draw(id, testCase, src, mode)) return false;
+
+        // O vertex shader inverte v (a captura vem de cima para baixo), então
+        // a linha 0 do frame é a de cima do framebuffer: lê de trás para frente
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        for (int y = 0; y < dst.height; y++) {
+            glReadPixels(0, dst.height - 1 - y, dst.width, 1, GL_BGRA, GL_UNSIGNED_BYTE, dst.row(0, y));
+        }
+        return glGetError() == GL_NO_ERROR;
+    }
+
+    // Sobe o frame e desenha o quad no FBO, sem ler de volta
+    bool draw(GLuint id, const ParityCase& testCase, const FrameView& src, ShaderMode mode = ShaderMode()) {
+        if (!id) return false;
+        setupTarget(src.width, src.height);
+        uploadLut(*testCase.lut);
+
+        // Mesmo upload do overlay (glFormatFor); RGBA16F chega linear ao
+        // shader e o framebuffer codifica sRGB na escrita, como em render()
+        GLPixelFormat upload;
+        if (!glFormatFor(src.format, false, upload) || !setUnpackLayout(src)) return false;
+        const bool inputLinear = src.format == PixelFormat::RGBA16F;
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, upload.internalFormat, src.width, src.height, 0, upload.format, upload.type,
+                     src.planes[0]);
+        resetUnpackLayout();
+        bindLutAndNoise();
+
+        glUseProgram(id);
+        glUniform1i(glGetUniformLocation(id, "screenTexture"), 0);
+        glUniform1i(glGetUniformLocation(id, "lutTexture"), 1);
+        glUniform1i(glGetUniformLocation(id, "enableCorrection"), 1);
+        glUniform1f(glGetUniformLocation(id, "correctionStrength"), testCase.strength);
+        glUniform1i(glGetUniformLocation(id, "useLUT"), mode.mathMethod < 0);
+        glUniform1i(glGetUniformLocation(id, "correctionMethod"), std::max(mode.mathMethod, 0));
+        glUniform1i(glGetUniformLocation(id, "linearLight"), 0);
+        glUniform1i(glGetUniformLocation(id, "inputLinear"), inputLinear);
+        glUniform1i(glGetUniformLocation(id, "noiseTexture"), 2);
+        glUniform1i(glGetUniformLocation(id, "dither"), mode.dither);
+        glUniform1i(glGetUniformLocation(id, "lutNearest"), mode.lutNearest);
+        glUniform1i(glGetUniformLocation(id, "chromaTexture"), 3);
+        if (mode.halfChroma) setupChromaTarget(src.width, src.height);
+        drawPasses(id, src.width, src.height, mode.halfChroma, inputLinear);
+        return true;
+    }
+
+    // Só os passos do quad (frame e uniforms já no lugar). Croma 2x2: os
+    // deltas por bloco no alvo de meia resolução, depois somados no quad
+    void drawPasses(GLuint id, int width, int height, bool halfChroma, bool inputLinear) {
+        glBindVertexArray(vao);
+        glUniform1i(glGetUniformLocation(id, "chromaPass"), 0);
+        if (halfChroma) {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, 0);  // alvo do passo 1 fora da unidade que o passo 2 lê
+            glBindFramebuffer(GL_FRAMEBUFFER, chromaFbo);
+            glViewport(0, 0, chromaWidth, chromaHeight);
+            glUniform1i(glGetUniformLocation(id, "chromaPass"), 1);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, chromaTexture);
+            glUniform1i(glGetUniformLocation(id, "chromaPass"), 2);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        if (inputLinear) glEnable(GL_FRAMEBUFFER_SRGB);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glDisable(GL_FRAMEBUFFER_SRGB);
+    }
+
+    // Só os passos do quad, melhor de 'runs', até glFinish
+    double timeDraw(GLuint id, const ParityCase& testCase, const FrameView& src, int runs,
+                    ShaderMode mode = ShaderMode()) {
+        if (!draw(id, testCase, src, mode)) return 0.0;
+        glFinish();
+        double best = 1e30;
+        for (int i = 0; i < runs; i++) {
+            auto start = steady_clock::now();
+            drawPasses(id, src.width, src.height, mode.halfChroma, false);
+            glFinish();
+            best = std::min(best, duration<double, std::milli>(steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    bool computeAvailable() {
+        if (!available()) return false;
+        if (computeTried) return computeOk;
+        computeTried = true;
+        std::string log;
+        computeOk = compute.create((GLADloadproc)eglGetProcAddress, &log);
+        if (!computeOk) std::printf("  ⚠️ compute shader: %s\n", log.c_str());
+        return computeOk;
+    }
+
+    ComputeFilter::LutFetch calibrateCompute(double times[ComputeFilter::lutFetchCount]) {
+        uploadLut(*makeCases()[1].lut);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+        return compute.calibrate(1920, 1080, times);
+    }
+
+    enum class ComputeMode {
+        Separate,  // fonte -> alvo
+        InPlace,   // fonte = alvo
+        Tiles,     // alvo já filtrado; só blocos marcados podem ser refeitos
+    };
+
+    // Frame em screenTexture e LUT na unidade 1; o alvo é computeTexture
+    // (ou screenTexture, no lugar)
+    bool computeRun(const ParityCase& testCase, const FrameView& src, const FrameView& dst, ComputeMode mode,
+                    ComputeFilter::LutFetch fetch, bool dither = false) {
+        if (!computeAvailable()) return false;
+        compute.setLutFetch(fetch);
+        setupComputeTarget(src.width, src.height);
+        uploadLut(*testCase.lut);
+        uploadSource(src);
+        bindLutAndNoise();
+
+        ComputeFilter::Settings settings;
+        settings.strength = testCase.strength;
+        settings.dither = dither;
+        GLuint target = mode == ComputeMode::InPlace ? screenTexture : computeTexture;
+        compute.markAll();
+        compute.dispatch(screenTexture, target, src.width, src.height, settings);
+
+        if (mode == ComputeMode::Tiles) {
+            // Fora da região marcada a fonte vira lixo (canais invertidos): se
+            // algum bloco não marcado rodar, a saída deixa de bater
+            std::vector<uint8_t> garbage((size_t)src.width * src.height * 4);
+            FrameView garbageView = FrameView::wrap(PixelFormat::BGRA8, garbage.data(), src.width, src.height);
+            for (int y = 0; y < src.height; y++) {
+                const uint8_t* in = src.row(0, y);
+                uint8_t* out = garbageView.row(0, y);
+                for (int x = 0; x < src.width * 4; x++) out[x] = (uint8_t)(x % 4 == 3 ? in[x] : 255 - in[x]);
+            }
+            // Os blocos marcados rodam inteiros: a fonte correta cobre a
+            // região arredondada para fora até múltiplos de 16
+            RoiRect dirty = { src.width / 5, src.height / 4, src.width / 2, src.height / 2 };
+            RoiRect aligned = { dirty.x / 16 * 16, dirty.y / 16 * 16, 0, 0 };
+            aligned.width = std::min(src.width, (dirty.x + dirty.width + 15) / 16 * 16) - aligned.x;
+            aligned.height = std::min(src.height, (dirty.y + dirty.height + 15) / 16 * 16) - aligned.y;
+            for (int y = aligned.y; y < aligned.y + aligned.height; y++) {
+                std::memcpy(garbageView.row(0, y) + aligned.x * 4, src.row(0, y) + aligned.x * 4, (size_t)aligned.width * 4);
+            }
+            uploadSource(garbageView);
+            compute.markDirty(dirty);
+            compute.dispatch(screenTexture, computeTexture, src.width, src.height, settings);
+        }
+
+        // Imagem sem inversão: a linha 0 da textura é a linha 0 do frame
+        glBindFramebuffer(GL_FRAMEBUFFER, computeFbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ROW_LENGTH, dst.strides[0] / 4);
+        glReadPixels(0, 0, dst.width, dst.height, GL_BGRA, GL_UNSIGNED_BYTE, dst.planes[0]);
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        return glGetError() == GL_NO_ERROR;
+    }
+
+    // Só o dispatch, melhor de 'runs', até glFinish. 'dirtyArea': fração do
+    // frame marcada (um retângulo centrado); 1 = frame inteiro
+    double timeCompute(const ParityCase& testCase, const FrameView& src, ComputeFilter::LutFetch fetch, bool inPlace,
+                       double dirtyArea, int runs, ComputeFilter::Stats* stats = nullptr) {
+        if (!computeAvailable()) return 0.0;
+        compute.setLutFetch(fetch);
+        setupComputeTarget(src.width, src.height);
+        uploadLut(*testCase.lut);
+        uploadSource(src);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+        ComputeFilter::Settings settings;
+        settings.strength = testCase.strength;
+        GLuint target = inPlace ? screenTexture : computeTexture;
+        double side = std::sqrt(dirtyArea);
+        RoiRect dirty = { 0, 0, (int)(src.width * side), (int)(src.height * side) };
+        dirty.x = (src.width - dirty.width) / 2;
+        dirty.y = (src.height - dirty.height) / 2;
+
+        double best = 1e30;
+        for (int i = 0; i <= runs; i++) {
+            if (dirtyArea >= 1.0) {
+                compute.markAll();
+            } else {
+                compute.markDirty(dirty);
+            }
+            auto start = steady_clock::now();
+            compute.dispatch(screenTexture, target, src.width, src.height, settings);
+            glFinish();
+            if (i > 0) best = std::min(best, duration<double, std::milli>(steady_clock::now() - start).count());
+        }
+        if (stats) *stats = compute.readStats();
+        return best;
+    }
+
+    void setupComputeTarget(int width, int height) {
+        if (width == computeWidth && height == computeHeight) return;
+        if (!computeFbo) {
+            glGenFramebuffers(1, &computeFbo);
+            glGenTextures(1, &computeTexture);
+        }
+        glBindTexture(GL_TEXTURE_2D, computeTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        computeWidth = width;
+        computeHeight = height;
+    }
+
+    void uploadSource(const FrameView& src) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        setUnpack(src);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, src.width, src.height, 0, GL_BGRA, GL_UNSIGNED_BYTE, src.planes[0]);
+    }
+
+    static void setUnpack(const FrameView& src) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, src.strides[0] / 4);
+    }
+};
+
+static GLBackend g_gl;
+
+static bool runOverlayShader(const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                             ShaderMode mode = ShaderMode()) {
+    return g_gl.available() && g_gl.render(g_gl.program("overlay", fragmentShaderSource), testCase, src, dst, mode);
+}
+
+static bool runCompute(const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                       GLBackend::ComputeMode mode, ComputeFilter::LutFetch fetch, bool dither = false) {
+    return g_gl.computeRun(testCase, src, dst, mode, fetch, dither);
+}
+
+// Frame RGBA16F (scRGB) no overlay: LUT indexada em sRGB, mistura linear
+static bool runOverlayLinear(const ParityCase& testCase, const FrameView& src, const FrameView& dst) {
+    if (!g_gl.available()) return false;
+    std::vector<uint8_t> deep(FrameView::compactSize(PixelFormat::RGBA16F, src.width, src.height));
+    FrameView deepView = FrameView::wrap(PixelFormat::RGBA16F, deep.data(), src.width, src.height);
+    expandHighDepth(src, deepView);
+    return g_gl.render(g_gl.program("overlay", fragmentShaderSource), testCase, deepView, dst);
+}
+
+static bool runShaderFiles(const ParityCase& testCase, const FrameView& src, const FrameView& dst) {
+    return g_gl.available() && g_gl.render(g_gl.reloadedProgram(g_shaderDir), testCase, src, dst);
+}
+
+static std::string readText(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return "";
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+static bool runShaderFile(const ParityCase& testCase, const FrameView& src, const FrameView& dst) {
+    if (!g_gl.available()) return false;
+    std::string source = readText(g_shaderDir + "/fragment_lut.glsl");
+    if (source.empty()) return false;
+    return g_gl.render(g_gl.program("fragment_lut.glsl", source), testCase, src, dst);
+}
+
+#endif // DALTONISMO_PARITY_GL
+
+// ==================== KERNELS ====================
+
+struct ParityKernel {
+    const char* name;
+    const char* baseline;  // nullptr: filtro de referência; senão, outro kernel
+    ParityRule rule;
+    bool informative;      // true: aparece no relatório mas não bloqueia
+    bool spatial;          // aproximação espacial: só frames coerentes
+    bool chroma420;        // fonte e referência passam antes por 4:2:0 (YUV)
+    // false: kernel indisponível nesta máquina (sem GL, arquivo ausente)
+    std::function<bool(const ParityCase&, const FrameView& src, const FrameView& dst)> run;
+    bool linearLight = false;  // referência com a mistura em luz linear (RGBA16F)
+};
+
+// Correção matemática sem LUT (ColorCorrection, a mesma do shader com
+// useLUT desligado) misturada pela intensidade, pixel a pixel
+static bool runMath(const ParityCase& testCase, const FrameView& src, const FrameView& dst) {
+    CorrectionMethod method = testCase.lutName == "lms" ? CorrectionMethod::LMS : CorrectionMethod::Hybrid;
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* s = src.row(0, y);
+        uint8_t* d = dst.row(0, y);
+        for (int x = 0; x < src.width; x++, s += 4, d += 4) {
+            RGB color = { s[2] / 255.0f, s[1] / 255.0f, s[0] / 255.0f };
+            RGB out = ColorCorrection::mix(color, ColorCorrection::apply(method, color), testCase.strength);
+            d[0] = Lut3D::toByte(out.b);
+            d[1] = Lut3D::toByte(out.g);
+            d[2] = Lut3D::toByte(out.r);
+            d[3] = s[3];
+        }
+    }
+    return true;
+}
+
+static bool runCpu(const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                   CpuFilter::Interpolation interpolation, CpuFilter::ChromaMode chroma,
+                   CpuFilter::Arithmetic arithmetic = CpuFilter::Arithmetic::Float) {
+    CpuFilter filter;
+    filter.setSharedLUT(testCase.lut);
+    filter.setStrength(testCase.strength);
+    filter.setInterpolation(interpolation);
+    filter.setChromaMode(chroma);
+    filter.setArithmetic(arithmetic);
+    return filter.apply(src, dst);
+}
+
+static bool runDither(const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                      CpuFilter::Arithmetic arithmetic) {
+    CpuFilter filter;
+    filter.setSharedLUT(testCase.lut);
+    filter.setStrength(testCase.strength);
+    filter.setArithmetic(arithmetic);
+    filter.setDither(true);
+    return filter.apply(src, dst);
+}
+
+static bool runFixedLayout(const ParityCase& testCase, const FrameView& src, const FrameView& dst,
+                           Lut3DFixed::Layout layout) {
+    CpuFilter filter;
+    filter.setSharedLUT(testCase.lut);
+    filter.setStrength(testCase.strength);
+    filter.setArithmetic(CpuFilter::Arithmetic::FixedPoint);
+    filter.setFixedLayout(layout);
+    return filter.apply(src, dst);
+}
+
+static bool runHighDepth(const ParityCase& testCase, const FrameView& src, const FrameView& dst, PixelFormat format) {
+    std::vector<uint8_t> deep(FrameView::compactSize(format, src.width, src.height));
+    FrameView deepView = FrameView::wrap(format, deep.data(), src.width, src.height);
+    expandHighDepth(src, deepView);
+    CpuFilter filter;
+    filter.setSharedLUT(testCase.lut);
+    filter.setStrength(testCase.strength);
+    if (!filter.apply(deepView, deepView)) return false;
+    reduceHighDepth(deepView, dst);
+    return true;
+}
+
+static bool runYuv(const ParityCase& testCase, const FrameView& src, const FrameView& dst) {
+    YuvFilter filter;
+    filter.setLUT(*testCase.lut);
+    filter.setStrength(testCase.strength);
+    std::vector<uint8_t> yuv(FrameView::compactSize(PixelFormat::I420, src.width, src.height));
+    FrameView yuvView = FrameView::wrap(PixelFormat::I420, yuv.data(), src.width, src.height);
+    bgraToI420(filter, src, yuvView);
+    if (!filter.apply(yuvView, yuvView)) return false;
+    i420ToBgra(filter, yuvView, dst);
+    return true;
+}
+
+static const ParityKernel kernels[] = {
+    { "cpu-trilinear", nullptr, ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Trilinear, CpuFilter::ChromaMode::Full);
+      } },
+    { "cpu-regioes", "cpu-trilinear", ParityRule::exact(), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          // Regiões sobrepostas cobrindo o frame: tem que dar o frame inteiro
+          CpuFilter filter;
+          filter.setSharedLUT(c.lut);
+          filter.setStrength(c.strength);
+          filter.setArithmetic(CpuFilter::Arithmetic::Float);
+          std::vector<RoiRect> rects = { { 0, 0, s.width / 2 + 3, s.height },
+                                         { s.width / 3, 0, s.width - s.width / 3, s.height / 2 + 1 },
+                                         { s.width / 3, s.height / 2, s.width - s.width / 3, s.height - s.height / 2 } };
+          return applyRegions(filter, s, d, rects);
+      } },
+    { "cpu-rgb10a2", nullptr, ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runHighDepth(c, s, d, PixelFormat::RGB10A2); } },
+    { "cpu-rgba16f", nullptr, ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runHighDepth(c, s, d, PixelFormat::RGBA16F); },
+      true },
+    { "cpu-lut-1-ponto", nullptr, ParityRule::deltaEPercentile(12.0, 2.5), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Nearest, CpuFilter::ChromaMode::Full);
+      } },
+    { "cpu-croma-2x2", nullptr, ParityRule::deltaE(8.0, 4.0), false, true, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Trilinear, CpuFilter::ChromaMode::Half);
+      } },
+    // Ponto fixo (padrão com AVX2): até 1 LSB do mesmo modo em float
+    { "cpu-fixo-trilinear", nullptr, ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Trilinear, CpuFilter::ChromaMode::Full,
+                        CpuFilter::Arithmetic::FixedPoint);
+      } },
+    { "cpu-fixo-1-ponto", "cpu-lut-1-ponto", ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Nearest, CpuFilter::ChromaMode::Full,
+                        CpuFilter::Arithmetic::FixedPoint);
+      } },
+    { "cpu-fixo-croma-2x2", "cpu-croma-2x2", ParityRule::withinLsb(1), false, true, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCpu(c, s, d, CpuFilter::Interpolation::Trilinear, CpuFilter::ChromaMode::Half,
+                        CpuFilter::Arithmetic::FixedPoint);
+      } },
+    // Layouts da tabela do ponto fixo: mesma saída byte a byte
+    { "cpu-fixo-24-bits", "cpu-fixo-trilinear", ParityRule::exact(), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runFixedLayout(c, s, d, Lut3DFixed::Layout::Packed24); } },
+    { "cpu-fixo-blocos", "cpu-fixo-trilinear", ParityRule::exact(), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runFixedLayout(c, s, d, Lut3DFixed::Layout::Tiled); } },
+    // Dither de ruído azul: no máximo 1 LSB do mesmo kernel sem dither
+    { "cpu-dither", "cpu-trilinear", ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runDither(c, s, d, CpuFilter::Arithmetic::Float); } },
+    { "cpu-fixo-dither", "cpu-fixo-trilinear", ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runDither(c, s, d, CpuFilter::Arithmetic::FixedPoint); } },
+    { "yuv-i420", nullptr, ParityRule::deltaEPercentile(0.0, 5.0), false, true, true, runYuv },
+    // Sem LUT: a função direto, sem a interpolação da grade; só informativo
+    // (o híbrido tem degraus que a LUT suaviza), base do gl-matematico
+    { "cpu-matematico", nullptr, ParityRule::deltaE(2.0, 0.1), true, false, false, runMath },
+#ifdef DALTONISMO_PARITY_GL
+    { "gl-overlay", nullptr, ParityRule::deltaE(2.0, 0.1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) { return runOverlayShader(c, s, d); } },
+    // Compute shader (GL 4.3), LUT na textura e em shared: mesma regra do
+    // overlay; no lugar e só com os blocos marcados, a mesma saída
+    { "gl-compute", nullptr, ParityRule::deltaE(2.0, 0.1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCompute(c, s, d, GLBackend::ComputeMode::Separate, ComputeFilter::LutFetch::Texture);
+      } },
+    { "gl-compute-shared", nullptr, ParityRule::deltaE(2.0, 0.1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCompute(c, s, d, GLBackend::ComputeMode::Separate, ComputeFilter::LutFetch::Shared);
+      } },
+    { "gl-compute-no-lugar", "gl-compute-shared", ParityRule::exact(), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCompute(c, s, d, GLBackend::ComputeMode::InPlace, ComputeFilter::LutFetch::Shared);
+      } },
+    { "gl-compute-blocos", "gl-compute-shared", ParityRule::exact(), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCompute(c, s, d, GLBackend::ComputeMode::Tiles, ComputeFilter::LutFetch::Shared);
+      } },
+    // Mesma regra do cpu-rgba16f: o shader não pode voltar a ler a LUT com
+    // valores lineares
+    { "gl-rgba16f", nullptr, ParityRule::withinLsb(1), false, false, false, runOverlayLinear, true },
+    { "gl-dither", "gl-overlay", ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          ShaderMode mode;
+          mode.dither = true;
+          return runOverlayShader(c, s, d, mode);
+      } },
+    // Degraus do governador no overlay: mesmas regras dos modos da CPU
+    { "gl-lut-1-ponto", nullptr, ParityRule::deltaEPercentile(12.0, 2.5), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          ShaderMode mode;
+          mode.lutNearest = true;
+          return runOverlayShader(c, s, d, mode);
+      } },
+    // Só blocos: sem a troca do par de linhas inteiro da CPU, a borda entre
+    // faixas escuras das rampas (croma abaixo do limiar) chega a ΔE ~18
+    { "gl-croma-2x2", nullptr, ParityRule::deltaE(24.0, 4.0), false, true, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          ShaderMode mode;
+          mode.halfChroma = true;
+          return runOverlayShader(c, s, d, mode);
+      } },
+    { "gl-compute-dither", "gl-compute", ParityRule::withinLsb(1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          return runCompute(c, s, d, GLBackend::ComputeMode::Separate, ComputeFilter::LutFetch::Texture, true);
+      } },
+    // shaders/vertex.glsl + fragment.glsl, carregados em runtime pelo overlay
+    { "gl-shaders", nullptr, ParityRule::deltaE(2.0, 0.1), false, false, false, runShaderFiles },
+    // Cópia antiga do shader em shaders/ (fatia azul): só informativo
+    { "gl-fragment_lut.glsl", nullptr, ParityRule::deltaE(2.0, 0.1), true, false, false, runShaderFile },
+    // LUT desligada (Ctrl+Shift+L): híbrido e LMS no shader contra as mesmas
+    // funções na CPU. O híbrido tem degraus (r/g em 0.8 e 1.2) e em cima
+    // deles o float da GPU pode cair do outro lado: p99 em vez do máximo
+    { "gl-matematico", "cpu-matematico", ParityRule::deltaEPercentile(1.0, 0.1), false, false, false,
+      [](const ParityCase& c, const FrameView& s, const FrameView& d) {
+          ShaderMode mode;
+          mode.mathMethod = c.lutName == "lms" ? 1 : 0;
+          return runOverlayShader(c, s, d, mode);
+      } },
+#endif
+};
+
+// ==================== EXECUÇÃO ====================
+
+struct KernelResult {
+    ParityReport report;
+    bool ran = false;
+    double ms = 0.0;  // 1080p, melhor de 3
+};
+
+static std::string caseName(const ParityFrame& frame, const ParityCase& testCase) {
+    char name[128];
+    std::snprintf(name, sizeof(name), "%s_%s_%d", frame.name.c_str(), testCase.lutName.c_str(),
+                  (int)(testCase.strength * 100.0f + 0.5f));
+    return name;
+}
+
+#ifdef DALTONISMO_PARITY_GL
+// Quad + fragment shader vs compute em 1080p, só o filtro (frame já na GPU,
+// sem leitura), até glFinish. Texto é o caso da tela; no ruído cada pixel do
+// bloco cai em uma célula diferente da LUT e a shared não economiza leituras.
+// O fragment shader lê 8 pontos da LUT por pixel (2 amostras bilineares);
+// os degraus do governador: 1 ponto (um texelFetch) e croma 2x2 (LUT em
+// meia resolução + um passo que só soma o delta).
+static void benchGpuPaths(const ParityCase& testCase) {
+    if (!g_gl.computeAvailable()) return;
+    using Fetch = ComputeFilter::LutFetch;
+    const int runs = 5;
+    GLuint overlay = g_gl.program("overlay", fragmentShaderSource);
+    std::printf("\n[GPU] 1080p, só o filtro (sem upload nem leitura), melhor de %d, ms\n", runs);
+    std::printf("  %-10s %9s %8s %10s %9s %9s %9s %11s %10s %14s\n", "frame", "fragment", "1 ponto", "croma 2x2",
+                "textura", "shared", "no lugar", "10% blocos", "1% blocos", "pontos LUT/px");
+    ShaderMode nearest, halfChroma;
+    nearest.lutNearest = true;
+    halfChroma.halfChroma = true;
+    const TestFrames::Kind kinds[] = { TestFrames::Kind::Text, TestFrames::Kind::Gradient, TestFrames::Kind::Noise };
+    for (TestFrames::Kind kind : kinds) {
+        std::vector<uint8_t> pixels = TestFrames::make(kind, 1920, 1080);
+        FrameView view = FrameView::wrap(PixelFormat::BGRA8, pixels.data(), 1920, 1080);
+        ComputeFilter::Stats stats;
+        double fragment = g_gl.timeDraw(overlay, testCase, view, runs);
+        double fragmentNearest = g_gl.timeDraw(overlay, testCase, view, runs, nearest);
+        double fragmentHalf = g_gl.timeDraw(overlay, testCase, view, runs, halfChroma);
+        double texture = g_gl.timeCompute(testCase, view, Fetch::Texture, false, 1.0, runs);
+        double shared = g_gl.timeCompute(testCase, view, Fetch::Shared, false, 1.0, runs, &stats);
+        double inPlace = g_gl.timeCompute(testCase, view, Fetch::Shared, true, 1.0, runs);
+        double tenth = g_gl.timeCompute(testCase, view, Fetch::Texture, false, 0.1, runs);
+        double hundredth = g_gl.timeCompute(testCase, view, Fetch::Texture, false, 0.01, runs);
+        std::printf("  %-10s %9.2f %8.2f %10.2f %9.2f %9.2f %9.2f %11.2f %10.2f %14.2f\n", TestFrames::kindName(kind),
+                    fragment, fragmentNearest, fragmentHalf, texture, shared, inPlace, tenth, hundredth,
+                    8.0 * stats.lutCells / (256.0 * std::max<uint32_t>(1, stats.filteredGroups)));
+    }
+    double times[ComputeFilter::lutFetchCount];
+    Fetch chosen = g_gl.calibrateCompute(times);
+    std::printf("  calibração (texto 1080p): textura %.2f ms, shared %.2f ms -> %s\n", times[0], times[1],
+                ComputeFilter::lutFetchName(chosen));
+}
+#endif
+
+static double timeKernel(const ParityKernel& kernel, const ParityCase& testCase) {
+    std::vector<uint8_t> src = TestFrames::make(TestFrames::Kind::Gradient, 1920, 1080);
+    std::vector<uint8_t> dst(src.size());
+    FrameView srcView = FrameView::wrap(PixelFormat::BGRA8, src.data(), 1920, 1080);
+    FrameView dstView = FrameView::wrap(PixelFormat::BGRA8, dst.data(), 1920, 1080);
+    double best = 1e30;
+    for (int i = 0; i < 3; i++) {
+        auto start = steady_clock::now();
+        if (!kernel.run(testCase, srcView, dstView)) return 0.0;
+        best = std::min(best, duration<double, std::milli>(steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    std::string saveDir, goldenDir;
+    std::vector<std::string> selected;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-v") {
+            verbose = true;
+        } else if (arg == "--save" && i + 1 < argc) {
+            saveDir = argv[++i];
+        } else if (arg == "--golden" && i + 1 < argc) {
+            goldenDir = argv[++i];
+        } else if (arg == "--shaders" && i + 1 < argc) {
+#ifdef DALTONISMO_PARITY_GL
+            g_shaderDir = argv[++i];
+#else
+            ++i;
+#endif
+        } else if (arg[0] != '-') {
+            selected.push_back(arg);
+        } else {
+            std::fprintf(stderr, "Uso: paritycheck [-v] [--save dir] [--golden dir] [--shaders dir] [kernel ...]\n");
+            return 1;
+        }
+    }
+    auto isSelected = [&](const char* name) {
+        return selected.empty() || std::find(selected.begin(), selected.end(), name) != selected.end();
+    };
+
+    std::vector<ParityFrame> frames = makeFrames();
+    std::vector<ParityCase> cases = makeCases();
+    int failures = 0;
+
+    std::printf("\n[paridade] %zu frames x %zu casos (LUT x intensidade); referência: trilinear em double\n",
+                frames.size(), cases.size());
+
+    // Convenções de eixo: as duas faixas têm que voltar à mesma Lut3D
+    {
+        const Lut3D& lut = *cases[0].lut;
+        const int n = lut.size;
+        std::vector<uint8_t> horizontal = lut.toStrip();
+        std::vector<uint8_t> vertical(horizontal.size());
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n * n; x++) {
+                std::memcpy(&vertical[((size_t)x * n + y) * 3], &horizontal[((size_t)y * n * n + x) * 3], 3);
+            }
+        }
+        bool same = Lut3D::fromStrip(horizontal.data(), n * n, n, 3).data == lut.data &&
+                    Lut3D::fromStrip(vertical.data(), n, n * n, 3).data == lut.data;
+        std::printf("  %-7s faixas horizontal (x = g*N + r) e vertical (transposta) -> mesma Lut3D\n",
+                    same ? "OK" : "FALHOU");
+        if (!same) failures++;
+    }
+
+    // Referências (e golden)
+    std::map<std::string, std::vector<uint8_t>> reference;
+    std::map<std::string, std::vector<uint8_t>> reference420;  // fonte já em 4:2:0
+    std::map<std::string, std::vector<uint8_t>> referenceLinear;  // mistura em luz linear
+    int goldenChecked = 0, goldenMismatches = 0;
+    YuvFilter converter;
+    for (ParityFrame& frame : frames) {
+        for (const ParityCase& testCase : cases) {
+            std::string name = caseName(frame, testCase);
+            std::vector<uint8_t>& out = reference[name];
+            out.resize(frame.pixels.size());
+            FrameView outView = FrameView::wrap(PixelFormat::BGRA8, out.data(), frame.width, frame.height);
+            Parity::referenceApply(*testCase.lut, testCase.strength, frame.view(), outView);
+            std::vector<uint8_t>& outLinear = referenceLinear[name];
+            outLinear.resize(frame.pixels.size());
+            Parity::referenceApply(*testCase.lut, testCase.strength, frame.view(),
+                                   FrameView::wrap(PixelFormat::BGRA8, outLinear.data(), frame.width, frame.height), true);
+
+            std::vector<uint8_t> yuv(FrameView::compactSize(PixelFormat::I420, frame.width, frame.height));
+            std::vector<uint8_t> roundTrip(frame.pixels.size());
+            FrameView yuvView = FrameView::wrap(PixelFormat::I420, yuv.data(), frame.width, frame.height);
+            FrameView roundTripView = FrameView::wrap(PixelFormat::BGRA8, roundTrip.data(), frame.width, frame.height);
+            bgraToI420(converter, frame.view(), yuvView);
+            i420ToBgra(converter, yuvView, roundTripView);
+            std::vector<uint8_t>& out420 = reference420[name];
+            out420.resize(frame.pixels.size());
+            Parity::referenceApply(*testCase.lut, testCase.strength, roundTripView,
+                                   FrameView::wrap(PixelFormat::BGRA8, out420.data(), frame.width, frame.height));
+
+            if (!saveDir.empty()) Parity::writePPM(saveDir + "/golden_" + name + ".ppm", outView);
+            if (!goldenDir.empty()) {
+                std::vector<uint8_t> golden;
+                int width = 0, height = 0;
+                if (!Parity::readPPM(goldenDir + "/golden_" + name + ".ppm", golden, width, height)) continue;
+                goldenChecked++;
+                FrameView goldenView = FrameView::wrap(PixelFormat::BGRA8, golden.data(), width, height);
+                if (width != frame.width || height != frame.height ||
+                    !Parity::compare(goldenView, outView, ParityRule::exact()).pass) {
+                    std::printf("  FALHOU  golden %s difere da referência atual\n", name.c_str());
+                    goldenMismatches++;
+                }
+            }
+        }
+    }
+    if (!goldenDir.empty()) {
+        std::printf("  %-7s golden: %d imagens comparadas, %d diferentes\n",
+                    goldenChecked > 0 && goldenMismatches == 0 ? "OK" : "FALHOU", goldenChecked, goldenMismatches);
+        if (goldenChecked == 0 || goldenMismatches > 0) failures++;
+    }
+
+    std::printf("\n  %-22s %-24s %8s %8s %8s %9s %9s %10s  %s\n", "kernel", "regra", "max/can.", "ΔE máx",
+                "ΔE p99", "ΔE médio", "px difer.", "1080p(ms)", "resultado");
+
+    // Saídas por kernel e caso, para kernels comparados com outro kernel
+    std::map<std::string, std::map<std::string, std::vector<uint8_t>>> outputs;
+    std::vector<std::string> selectable;
+    for (const ParityKernel& kernel : kernels) {
+        bool needed = isSelected(kernel.name);
+        for (const ParityKernel& other : kernels) {
+            if (other.baseline && std::strcmp(other.baseline, kernel.name) == 0 && isSelected(other.name)) needed = true;
+        }
+        if (!needed) continue;
+
+        KernelResult result;
+        result.ran = true;
+        std::map<std::string, std::vector<uint8_t>>& kernelOutputs = outputs[kernel.name];
+        for (ParityFrame& frame : frames) {
+            if (kernel.spatial && !frame.coherent) continue;
+            for (const ParityCase& testCase : cases) {
+                std::string name = caseName(frame, testCase);
+                std::vector<uint8_t> out(frame.pixels.size(), 0);
+                FrameView outView = FrameView::wrap(PixelFormat::BGRA8, out.data(), frame.width, frame.height);
+                if (!kernel.run(testCase, frame.view(), outView)) {
+                    result.ran = false;
+                    break;
+                }
+
+                std::vector<uint8_t>* expected = kernel.chroma420 ? &reference420[name] : &reference[name];
+                if (kernel.linearLight) expected = &referenceLinear[name];
+                if (kernel.baseline) expected = &outputs[kernel.baseline][name];
+                if (expected->size() != out.size()) {
+                    result.ran = false;  // baseline indisponível
+                    break;
+                }
+                FrameView expectedView = FrameView::wrap(PixelFormat::BGRA8, expected->data(), frame.width, frame.height);
+                ParityReport report = Parity::compare(expectedView, outView, kernel.rule);
+                if (verbose && isSelected(kernel.name)) {
+                    std::printf("  %-22s %-24s %8d %8.2f %8.1f %9.3f %8.2f%%             %s\n", kernel.name, name.c_str(),
+                                report.maxChannelDiff, report.maxDeltaE, report.percentile(0.99), report.meanDeltaE,
+                                100.0 * report.differingPixels / report.pixels, report.pass ? "" : "x");
+                }
+                if (!report.pass && !saveDir.empty()) {
+                    Parity::writePPM(saveDir + "/" + kernel.name + "_" + name + ".ppm", outView);
+                }
+                result.report.merge(report);
+                kernelOutputs[name] = std::move(out);
+            }
+            if (!result.ran) break;
+        }
+        if (!isSelected(kernel.name)) continue;
+
+        if (!result.ran) {
+            std::printf("  %-22s %-24s %8s %8s %8s %9s %9s %10s  %s\n", kernel.name, kernel.rule.describe().c_str(),
+                        "-", "-", "-", "-", "-", "-", "indisponível");
+            continue;
+        }
+        result.ms = timeKernel(kernel, cases[1]);
+        const ParityReport& r = result.report;
+        const char* verdict = r.pass ? "OK" : (kernel.informative ? "difere (informativo)" : "FALHOU");
+        std::printf("  %-22s %-24s %8d %8.2f %8.1f %9.3f %8.2f%% %10.2f  %s\n", kernel.name, kernel.rule.describe().c_str(),
+                    r.maxChannelDiff, r.maxDeltaE, r.percentile(0.99), r.meanDeltaE, 100.0 * r.differingPixels / std::max<size_t>(1, r.pixels),
+                    result.ms, verdict);
+        if (!r.pass && r.worstX >= 0) std::printf("  %-22s pior pixel: (%d, %d)\n", "", r.worstX, r.worstY);
+        if (r.pass && !kernel.informative) selectable.push_back(kernel.name);
+        if (!r.pass && !kernel.informative) failures++;
+    }
+
+#ifdef DALTONISMO_PARITY_GL
+    if (isSelected("gl-compute")) benchGpuPaths(cases[1]);
+#endif
+
+    std::printf("\n  Selecionáveis:");
+    for (const std::string& name : selectable) std::printf(" %s", name.c_str());
+    std::printf("\n");
+    std::fflush(stdout);
+    if (failures > 0) {
+        std::fprintf(stderr, "\n❌ %d verificação(ões) de paridade falharam\n", failures);
+        return 1;
+    }
+    return 0;
+}
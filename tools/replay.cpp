@@ -0,0 +1,142 @@
+// ==================== REPRODUÇÃO DE GRAVAÇÕES ====================
+// Reproduz uma gravação feita com "DaltonismoFilter --record arquivo.drec"
+// pelo filtro de CPU, aplicando as hotkeys gravadas no mesmo ponto da
+// sequência, e mede o tempo de cada frame. A mesma gravação dá a mesma
+// sequência de trabalho: serve para reproduzir travadas em Linux e comparar
+// builds.
+//
+// Uso: replay <arquivo.drec> [opções]
+//   --max                 velocidade máxima (padrão: ritmo original)
+//   --loop N              reproduz N vezes (padrão 1)
+//   --start s             começa no instante s (segundos; salta pelo índice)
+//   --budget ms           orçamento por frame (padrão 16.7)
+//   --builtin nome        LUT do método "LUT" (padrão deuteranopia_correction)
+//   --dither              ruído azul na volta para 8 bits (como o overlay com --dither)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BuiltinLUTs.h"
+#include "CpuFilter.h"
+#include "Frame.h"
+#include "FramePool.h"
+#include "Lut3D.h"
+#include "Recording.h"
+
+using namespace std::chrono;
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Uso: replay <arquivo.drec> [--max] [--loop N] [--start s] [--budget ms]"
+                             " [--builtin nome] [--dither]\n");
+        return 1;
+    }
+
+    std::string path = argv[1];
+    std::string builtinName = "deuteranopia_correction";
+    ReplayFrameSource::Pace pace = ReplayFrameSource::Pace::Original;
+    int loops = 1;
+    double startSeconds = 0.0;
+    double budgetMs = 1000.0 / 60.0;
+    bool dither = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--dither") {
+            dither = true;
+        } else if (arg == "--max") {
+            pace = ReplayFrameSource::Pace::Maximum;
+        } else if (arg == "--loop" && hasValue) {
+            loops = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--start" && hasValue) {
+            startSeconds = std::atof(argv[++i]);
+        } else if (arg == "--budget" && hasValue) {
+            budgetMs = std::atof(argv[++i]);
+        } else if (arg == "--builtin" && hasValue) {
+            builtinName = argv[++i];
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const BuiltinLUT* builtin = findBuiltinLUT(builtinName.c_str());
+    if (!builtin) {
+        std::fprintf(stderr, "LUT embutida desconhecida: %s\n", builtinName.c_str());
+        return 1;
+    }
+    // Os dois métodos do overlay: a LUT e a correção matemática (híbrida)
+    Lut3D lutMethod = Lut3D::fromStrip(builtin->data, builtin->width, builtin->height, builtin->channels);
+    Lut3D mathMethod = Lut3D::fromCorrection(32, CorrectionMethod::Hybrid);
+
+    ReplayFrameSource source(path, pace, loops > 1);
+    if (!source.initialize()) return 1;
+    std::printf("🎞️ %s: %dx%d %s, %d frames, %s\n", path.c_str(), source.getWidth(), source.getHeight(),
+                pixelFormatName(source.getFormat()), source.getRecordedFrameCount(),
+                pace == ReplayFrameSource::Pace::Maximum ? "velocidade máxima" : "ritmo original");
+
+    // Estado inicial do overlay; a gravação começa com os eventos do estado real
+    CpuFilter filter;
+    filter.setLUT(mathMethod);
+    filter.setStrength(0.6f);
+    filter.setDither(dither);
+    bool enabled = false;
+    int events = 0, ignored = 0;
+    source.setEventHandler([&](const RecordedEvent& event) {
+        if (source.getPass() >= loops) return;  // início da volta que não será reproduzida
+        events++;
+        switch (event.kind) {
+            case RecordedEvent::Toggle: enabled = event.value > 0.5f; break;
+            case RecordedEvent::Strength: filter.setStrength(event.value); break;
+            case RecordedEvent::Method: filter.setLUT(event.value > 0.5f ? lutMethod : mathMethod); break;
+            default: ignored++; break;  // luz linear: só existe no shader
+        }
+        std::printf("  %8.3f s  %-12s %.2f\n", event.timestampUs / 1e6,
+                    RecordedEvent::kindName(event.kind), event.value);
+    });
+
+    if (startSeconds > 0.0 && !source.seek((int64_t)(startSeconds * 1e6))) {
+        std::fprintf(stderr, "Instante %.3f s fora da gravação\n", startSeconds);
+        return 1;
+    }
+
+    FramePool pool(source.getFormat(), source.getWidth(), source.getHeight());
+    FrameHandle output = pool.acquire();
+    if (!output) {
+        std::fprintf(stderr, "Sem memória para o frame de saída\n");
+        return 1;
+    }
+    std::vector<double> frameMs;
+    auto start = steady_clock::now();
+
+    // Com --loop a fonte volta ao início sozinha; para ao entrar na volta N+1
+    while (source.step() && source.getPass() < loops) {
+        auto frameStart = steady_clock::now();
+        source.readLatest([&](const FrameView& frame) {
+            if (enabled) filter.apply(frame, output.view());
+        });
+        frameMs.push_back(duration<double, std::milli>(steady_clock::now() - frameStart).count());
+    }
+    double wallMs = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    int overBudget = (int)std::count_if(frameMs.begin(), frameMs.end(), [&](double ms) { return ms > budgetMs; });
+    double worst = frameMs.empty() ? 0.0 : *std::max_element(frameMs.begin(), frameMs.end());
+    std::printf("\n%zu frames em %.1f ms (%.1f fps), %d eventos (%d só no shader)\n", frameMs.size(), wallMs,
+                wallMs > 0 ? frameMs.size() * 1000.0 / wallMs : 0.0, events, ignored);
+    std::printf("frame: p50 %.2f ms | p99 %.2f ms | máx %.2f ms | %d acima de %.1f ms\n",
+                percentile(frameMs, 0.50), percentile(frameMs, 0.99), worst, overBudget, budgetMs);
+    return 0;
+}
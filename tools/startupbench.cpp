@@ -0,0 +1,241 @@
+// ==================== TEMPO ATÉ O PRIMEIRO FRAME FILTRADO ====================
+// Refaz a inicialização do overlay sem janela (contexto EGL, llvmpipe no CI)
+// com o mesmo grafo de passos do main.cpp: contexto GL, LUT decodificada do
+// PNG, fonte dos shaders lida de shaders/, captura (fonte sintética, até o
+// primeiro frame), upload da LUT, programa compilado e validado e, por fim,
+// o primeiro frame enviado, filtrado e lido de volta. Mede do início do
+// processo até esse frame e imprime a linha do tempo de cada passo.
+//
+// Uso: startupbench [--serial] [--trace arquivo.json] [--lut arquivo.png]
+//                   [--shaders pasta] [--size LxA]
+//   --serial    todos os passos na thread principal, em ordem (referência)
+//   --trace     grava a linha do tempo no formato do chrome://tracing
+//   --lut       padrão: luts/deuteranopia_correction.png (sem ele, a embutida)
+// Termina com código 1 se algum passo falhar.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "BuiltinLUTs.h"
+#include "FrameSource.h"
+#include "HeadlessGL.h"
+#include "OverlayShaders.h"
+#include "PixelConvert.h"
+#include "ShaderReloader.h"
+#include "StartupGraph.h"
+
+using namespace std::chrono;
+
+static std::string readText(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return "";
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// Faixa 1024x32 em float, como o LUTLoader do overlay envia (GL_RGB16F)
+static bool decodeLut(const std::string& path, std::vector<float>& texels, int& width, int& height) {
+    int channels = 0;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    const BuiltinLUT* builtin = nullptr;
+    if (!data) {
+        builtin = findBuiltinLUT("deuteranopia_correction");
+        if (!builtin) return false;
+        width = builtin->width;
+        height = builtin->height;
+        channels = builtin->channels;
+    }
+    const unsigned char* pixels = data ? data : builtin->data;
+    bool valid = ((width == 1024 && height == 32) || (width == 32 && height == 1024)) && (channels == 3 || channels == 4);
+    if (valid) {
+        std::vector<unsigned char> rgb;
+        if (channels == 4) {
+            rgb.resize((size_t)width * height * 3);
+            PixelConvert::pack3(pixels, rgb.data(), (size_t)width * height, false);
+            pixels = rgb.data();
+        }
+        texels.resize((size_t)width * height * 3);
+        for (size_t i = 0; i < texels.size(); i++) texels[i] = pixels[i] / 255.0f;
+    }
+    if (data) stbi_image_free(data);
+    return valid;
+}
+
+int main(int argc, char** argv) {
+    auto processStart = steady_clock::now();
+
+    bool serial = false;
+    std::string tracePath, lutPath = "luts/deuteranopia_correction.png", shaderDir = "shaders";
+    int width = 1920, height = 1080;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--serial") {
+            serial = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--lut" && i + 1 < argc) {
+            lutPath = argv[++i];
+        } else if (arg == "--shaders" && i + 1 < argc) {
+            shaderDir = argv[++i];
+        } else if (arg == "--size" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) width = height = 0;
+        } else {
+            std::fprintf(stderr, "Uso: startupbench [--serial] [--trace arquivo.json] [--lut arquivo.png] "
+                                 "[--shaders pasta] [--size LxA]\n");
+            return 1;
+        }
+    }
+
+    HeadlessGL gl;
+    std::vector<float> lutTexels;
+    int lutWidth = 0, lutHeight = 0;
+    std::string vertexSource, fragmentSource;
+    SyntheticFrameSource source(width, height, 60, TestFrames::Kind::Text);
+    GLuint program = 0, lutTexture = 0, screenTexture = 0, vao = 0, vbo = 0, fbo = 0, colorTexture = 0;
+    unsigned char firstPixel[4] = {};
+
+    using Where = StartupGraph::Where;
+    StartupGraph graph(processStart);
+    graph.setSerial(serial);
+
+    int context = graph.add("contexto GL", Where::Main, {}, [&] { return gl.create(); });
+    int lut = graph.add("LUT (PNG)", Where::Worker, {}, [&] {
+        return decodeLut(lutPath, lutTexels, lutWidth, lutHeight);
+    });
+    int shaders = graph.add("fonte dos shaders", Where::Worker, {}, [&] {
+        vertexSource = readText(shaderDir + "/vertex.glsl");
+        fragmentSource = readText(shaderDir + "/fragment.glsl");
+        if (vertexSource.empty() || fragmentSource.empty()) {
+            vertexSource = vertexShaderSource;
+            fragmentSource = fragmentShaderSource;
+        }
+        return true;
+    });
+    int capture = graph.add("captura", Where::Worker, {}, [&] {
+        if (!source.initialize()) return false;
+        source.start();
+        auto deadline = steady_clock::now() + seconds(2);
+        while (source.getFrameCount() == 0 && steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(microseconds(200));
+        }
+        return source.getFrameCount() > 0;
+    });
+    int lutUpload = graph.add("upload da LUT", Where::Main, { context, lut }, [&] {
+        glGenTextures(1, &lutTexture);
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, lutWidth, lutHeight, 0, GL_RGB, GL_FLOAT, lutTexels.data());
+        return glGetError() == GL_NO_ERROR;
+    });
+    int link = graph.add("programa", Where::Main, { context, shaders }, [&] {
+        std::string log;
+        program = linkProgram(vertexSource, fragmentSource, &log);
+        if (!program || !validateProgram(program, { { "screenTexture", 0 }, { "lutTexture", 1 } }, &log)) {
+            std::printf("❌ Shader não compilou (%s)\n", log.c_str());
+            return false;
+        }
+        return true;
+    });
+    int target = graph.add("quad + alvo", Where::Main, { context }, [&] {
+        const float quad[] = {
+            -1.0f,  1.0f,  0.0f, 1.0f,   -1.0f, -1.0f,  0.0f, 0.0f,   1.0f, -1.0f,  1.0f, 0.0f,
+            -1.0f,  1.0f,  0.0f, 1.0f,    1.0f, -1.0f,  1.0f, 0.0f,   1.0f,  1.0f,  1.0f, 1.0f
+        };
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glGenTextures(1, &screenTexture);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+
+        // O FBO faz o papel da janela
+        glGenTextures(1, &colorTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    });
+    // Mesmo estado do overlay: texturas nas unidades 0 e 1, uniforms do filtro
+    auto draw = [&](int viewportWidth, int viewportHeight) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, lutTexture);
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "enableCorrection"), 1);
+        glUniform1f(glGetUniformLocation(program, "correctionStrength"), 0.6f);
+        glUniform1i(glGetUniformLocation(program, "useLUT"), 1);
+        glUniform1i(glGetUniformLocation(program, "linearLight"), 0);
+        glViewport(0, 0, viewportWidth, viewportHeight);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    };
+    // Um draw de 1 pixel faz o driver gerar o código do shader para este
+    // estado enquanto a captura ainda não tem frame (no llvmpipe o primeiro
+    // draw de tela cheia custa ~70 ms a mais)
+    int warmUp = graph.add("aquecimento", Where::Main, { lutUpload, link, target }, [&] {
+        draw(1, 1);
+        glFinish();
+        return glGetError() == GL_NO_ERROR;
+    });
+    graph.add("primeiro frame", Where::Main, { capture, warmUp }, [&] {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, screenTexture);
+        bool uploaded = source.readLatest([&](const FrameView& frame) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)(frame.strides[0] / 4));
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame.width, frame.height, GL_BGRA, GL_UNSIGNED_BYTE,
+                            frame.planes[0]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        });
+        if (!uploaded) return false;
+        draw(width, height);
+
+        // Ler um pixel espera o draw terminar, como o swap na janela
+        glReadPixels(width / 2, height / 2, 1, 1, GL_BGRA, GL_UNSIGNED_BYTE, firstPixel);
+        return glGetError() == GL_NO_ERROR;
+    });
+
+    bool ok = graph.run();
+    double firstFrameMs = graph.elapsedMs();
+    source.stop();
+
+    std::printf("[inicialização] %s, %dx%d, %s\n", serial ? "serial" : "grafo paralelo", width, height,
+                gl.isCreated() ? gl.renderer().c_str() : "sem contexto GL");
+    graph.printTimeline();
+    if (!tracePath.empty()) {
+        if (graph.writeTrace(tracePath)) {
+            std::printf("   trace: %s\n", tracePath.c_str());
+        } else {
+            std::printf("⚠️ não foi possível gravar %s\n", tracePath.c_str());
+        }
+    }
+    if (!ok) {
+        std::printf("❌ Inicialização falhou\n");
+        return 1;
+    }
+    std::printf("⏱️ Primeiro frame filtrado em %.1f ms (meta: 150 ms)\n", firstFrameMs);
+    return 0;
+}
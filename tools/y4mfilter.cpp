@@ -0,0 +1,164 @@
+// ==================== FILTRO EM STREAM (YUV 4:2:0) ====================
+// Aplica a correção a vídeos gravados sem converter para RGB: lê Y4M (ou
+// NV12/I420 cru), filtra no domínio YUV e escreve no mesmo formato.
+//
+// Uso: y4mfilter <entrada|-> <saida|-> [opções]
+//   --lut arquivo.png     LUT externa (faixa 1024x32)
+//   --builtin nome        LUT embutida (deuteranopia_correction, lms, daltonize, hybrid)
+//   --strength 0..1       intensidade (padrão 1.0)
+//   --matrix 601|709      matriz YUV (padrão 709)
+//   --raw nv12|i420 LxA   entrada/saída crua em vez de Y4M
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "BuiltinLUTs.h"
+#include "Frame.h"
+#include "Lut3D.h"
+#include "Y4M.h"
+#include "YuvFilter.h"
+
+using namespace std::chrono;
+
+static bool loadLut(const std::string& pngPath, const std::string& builtinName, Lut3D& lut) {
+    if (!pngPath.empty()) {
+        int width, height, channels;
+        unsigned char* data = stbi_load(pngPath.c_str(), &width, &height, &channels, 0);
+        if (!data) {
+            std::fprintf(stderr, "Erro ao carregar LUT %s: %s\n", pngPath.c_str(), stbi_failure_reason());
+            return false;
+        }
+        lut = Lut3D::fromStrip(data, width, height, channels);
+        stbi_image_free(data);
+    } else {
+        const BuiltinLUT* builtin = findBuiltinLUT(builtinName.c_str());
+        if (!builtin) {
+            std::fprintf(stderr, "LUT embutida desconhecida: %s\n", builtinName.c_str());
+            return false;
+        }
+        lut = Lut3D::fromStrip(builtin->data, builtin->width, builtin->height, builtin->channels);
+    }
+    return lut.isValid();
+}
+
+static FILE* openRaw(const std::string& path, bool write) {
+    if (path == "-") {
+#ifdef _WIN32
+        _setmode(_fileno(write ? stdout : stdin), _O_BINARY);
+#endif
+        return write ? stdout : stdin;
+    }
+    return std::fopen(path.c_str(), write ? "wb" : "rb");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Uso: y4mfilter <entrada|-> <saida|-> [--lut arquivo.png] [--builtin nome]"
+                             " [--strength 0..1] [--matrix 601|709] [--raw nv12|i420 LxA]\n");
+        return 1;
+    }
+
+    std::string inputPath = argv[1], outputPath = argv[2];
+    std::string lutPath, builtinName = "deuteranopia_correction";
+    float strength = 1.0f;
+    YuvFilter::Matrix matrix = YuvFilter::Matrix::BT709;
+    bool raw = false;
+    PixelFormat rawFormat = PixelFormat::I420;
+    int width = 0, height = 0;
+
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--lut" && hasValue) {
+            lutPath = argv[++i];
+        } else if (arg == "--builtin" && hasValue) {
+            builtinName = argv[++i];
+        } else if (arg == "--strength" && hasValue) {
+            strength = (float)std::atof(argv[++i]);
+        } else if (arg == "--matrix" && hasValue) {
+            matrix = (std::strcmp(argv[++i], "601") == 0) ? YuvFilter::Matrix::BT601 : YuvFilter::Matrix::BT709;
+        } else if (arg == "--raw" && i + 2 < argc) {
+            raw = true;
+            rawFormat = (std::strcmp(argv[++i], "nv12") == 0) ? PixelFormat::NV12 : PixelFormat::I420;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                std::fprintf(stderr, "Dimensões inválidas: %s\n", argv[i]);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    Lut3D lut;
+    if (!loadLut(lutPath, builtinName, lut)) return 1;
+
+    YuvFilter filter;
+    filter.setMatrix(matrix);
+    filter.setStrength(strength);
+    filter.setLUT(lut);
+
+    Y4MReader reader;
+    Y4MWriter writer;
+    FILE* rawIn = nullptr;
+    FILE* rawOut = nullptr;
+    PixelFormat format = rawFormat;
+
+    if (raw) {
+        rawIn = openRaw(inputPath, false);
+        rawOut = openRaw(outputPath, true);
+        if (!rawIn || !rawOut) {
+            std::fprintf(stderr, "Não foi possível abrir entrada/saída\n");
+            return 1;
+        }
+    } else {
+        if (!reader.open(inputPath)) return 1;
+        if (!writer.open(outputPath, reader.getHeader())) return 1;
+        width = reader.getWidth();
+        height = reader.getHeight();
+        format = PixelFormat::I420;
+    }
+
+    // Um único buffer YUV, filtrado no lugar: nenhum frame RGB é criado
+    std::vector<uint8_t> buffer(FrameView::compactSize(format, width, height));
+    int frames = 0;
+    double filterMs = 0.0;
+    auto start = steady_clock::now();
+
+    for (;;) {
+        if (raw) {
+            if (std::fread(buffer.data(), 1, buffer.size(), rawIn) != buffer.size()) break;
+        } else if (!reader.readFrame(buffer)) {
+            break;
+        }
+
+        FrameView frame = FrameView::wrap(format, buffer.data(), width, height);
+        auto filterStart = steady_clock::now();
+        filter.apply(frame, frame);
+        filterMs += duration<double, std::milli>(steady_clock::now() - filterStart).count();
+
+        bool written = raw ? std::fwrite(buffer.data(), 1, buffer.size(), rawOut) == buffer.size()
+                           : writer.writeFrame(frame);
+        if (!written) {
+            std::fprintf(stderr, "Erro ao escrever frame %d\n", frames);
+            return 1;
+        }
+        frames++;
+    }
+
+    if (rawIn && rawIn != stdin) std::fclose(rawIn);
+    if (rawOut && rawOut != stdout) std::fclose(rawOut);
+
+    double totalMs = duration<double, std::milli>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "y4mfilter: %d frames %dx%d %s | filtro %.2f ms/frame | total %.1f fps\n",
+                 frames, width, height, pixelFormatName(format),
+                 frames ? filterMs / frames : 0.0, frames ? frames * 1000.0 / totalMs : 0.0);
+    return 0;
+}